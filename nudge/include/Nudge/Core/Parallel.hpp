@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+
+using std::function;
+
+namespace Nudge
+{
+	/**
+	 * @brief Minimal fork-join helper for data-parallel loops
+	 *
+	 * Splits an index range into contiguous chunks and runs them on a pool of
+	 * WorkerCount() - 1 threads, started on the first parallel call and kept
+	 * until exit, with the calling thread claiming chunks as well. Chunking is
+	 * deterministic for a given count and batch size, so algorithms that keep
+	 * per-chunk state (histograms, partial reductions) can size that state with
+	 * ChunkCount() before calling For().
+	 */
+	class Parallel
+	{
+	public:
+		/**
+		 * @brief Number of hardware threads available for parallel work
+		 * @return Hardware concurrency, never less than 1
+		 */
+		static int WorkerCount();
+
+		/**
+		 * @brief Number of chunks For() will split a range into
+		 * @param count Number of items in the range
+		 * @param minBatch Smallest number of items worth handing to a thread
+		 * @return Chunk count in [1, WorkerCount()]
+		 */
+		static int ChunkCount(int count, int minBatch);
+
+		/**
+		 * @brief Runs a loop body over [0, count) split across worker threads
+		 * @param count Number of items in the range
+		 * @param minBatch Smallest number of items worth handing to a thread
+		 * @param body Callable receiving (chunk, begin, end) for each contiguous chunk
+		 *
+		 * Blocks until every chunk has completed. Ranges smaller than minBatch run
+		 * inline on the calling thread without waking any workers. If a chunk
+		 * throws, chunks not yet started are skipped and the first exception is
+		 * rethrown once the others have finished. Calls may be nested.
+		 */
+		static void For(int count, int minBatch, const function<void(int, int, int)>& body);
+	};
+}
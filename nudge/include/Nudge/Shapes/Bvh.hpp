@@ -0,0 +1,409 @@
+#pragma once
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/LinearBvh.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+
+#include <limits>
+#include <span>
+#include <vector>
+
+using std::span;
+using std::vector;
+
+// Stack capacity for Bvh traversals, enough for any hierarchy BuildMorton() produces
+constexpr int BVH_QUERY_STACK_SIZE = 1024;
+
+// Primitives measured per parallel task when gathering bounds
+constexpr int BVH_BOUNDS_BATCH = 4096;
+
+namespace Nudge
+{
+	class Line;
+	class Obb;
+	class Sphere;
+	class Triangle;
+
+	/**
+	 * @brief Tells Bvh how to measure a primitive type
+	 *
+	 * Specialize for any type to be indexed, providing:
+	 * - static Aabb Bounds(const Primitive&): box enclosing the primitive
+	 * - static Vector3 Centroid(const Primitive&): point the builder sorts by
+	 *
+	 * Specializations for Aabb, Line, Obb, Sphere and Triangle are provided.
+	 */
+	template <typename Primitive>
+	class BvhTraits;
+
+	template <>
+	class BvhTraits<Aabb>
+	{
+	public:
+		static Aabb Bounds(const Aabb& primitive);
+		static Vector3 Centroid(const Aabb& primitive);
+	};
+
+	template <>
+	class BvhTraits<Line>
+	{
+	public:
+		static Aabb Bounds(const Line& primitive);
+		static Vector3 Centroid(const Line& primitive);
+	};
+
+	template <>
+	class BvhTraits<Obb>
+	{
+	public:
+		static Aabb Bounds(const Obb& primitive);
+		static Vector3 Centroid(const Obb& primitive);
+	};
+
+	template <>
+	class BvhTraits<Sphere>
+	{
+	public:
+		static Aabb Bounds(const Sphere& primitive);
+		static Vector3 Centroid(const Sphere& primitive);
+	};
+
+	template <>
+	class BvhTraits<Triangle>
+	{
+	public:
+		static Aabb Bounds(const Triangle& primitive);
+		static Vector3 Centroid(const Triangle& primitive);
+	};
+
+	/**
+	 * @brief Measures every primitive in parallel
+	 * @param primitives Primitives to measure
+	 * @param count Number of primitives
+	 * @param bounds Receives one box per primitive
+	 * @param centroids Receives one centroid per primitive, or nullptr to skip them
+	 *
+	 * Output storage is reused, so measuring the same number of primitives
+	 * every frame performs no reallocation.
+	 */
+	template <typename Primitive>
+	void GatherBvhInputs(const Primitive* primitives, const int count, vector<Aabb>& bounds, vector<Vector3>* centroids)
+	{
+		bounds.resize(count);
+		if (centroids != nullptr)
+		{
+			centroids->resize(count);
+		}
+
+		Parallel::For(count, BVH_BOUNDS_BATCH, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				bounds[i] = BvhTraits<Primitive>::Bounds(primitives[i]);
+				if (centroids != nullptr)
+				{
+					(*centroids)[i] = BvhTraits<Primitive>::Centroid(primitives[i]);
+				}
+			}
+		});
+	}
+
+	/**
+	 * @brief Measures every triangle in parallel
+	 * @param primitives Triangles to measure
+	 * @param count Number of triangles
+	 * @param bounds Receives one box per triangle
+	 * @param centroids Receives one centroid per triangle, or nullptr to skip them
+	 *
+	 * Same result as the template, which overload resolution prefers this
+	 * over. Meshes rebuilt every frame measure millions of triangles, so the
+	 * components are written in place without Vector3 or Aabb temporaries.
+	 */
+	void GatherBvhInputs(const Triangle* primitives, int count, vector<Aabb>& bounds, vector<Vector3>* centroids);
+
+	/**
+	 * @brief Depth-first walk of a binary hierarchy, culling subtrees by their bounds
+	 * @param bvh Hierarchy to walk
+	 * @param enters Called as enters(index, min, max) for each node; false skips the node's subtree.
+	 *               The index lets callers consult per-node data such as LinearBvh::masks
+	 * @param visit Called as visit(primitive) for each primitive in an entered leaf; true stops the walk
+	 * @return Primitive the walk stopped at, or -1 if it ran to the end
+	 *
+	 * Primitives referenced from several leaves (spatial splits) may be
+	 * visited more than once.
+	 */
+	template <typename Enters, typename Visit>
+	int WalkBvh(const LinearBvh& bvh, Enters&& enters, Visit&& visit)
+	{
+		if (bvh.IsEmpty())
+		{
+			return -1;
+		}
+
+		const int* indices = bvh.indices.empty() ? nullptr : bvh.indices.data();
+
+		int stack[BVH_QUERY_STACK_SIZE];
+		int top = 0;
+		stack[top++] = 0;
+
+		while (top > 0)
+		{
+			const int index = stack[--top];
+			const LinearBvhNode& node = bvh.nodes[index];
+
+			if (!enters(index, node.min, node.max))
+			{
+				continue;
+			}
+
+			if (!node.IsLeaf())
+			{
+				stack[top++] = node.right;
+				stack[top++] = node.left;
+				continue;
+			}
+
+			for (int i = node.left; i < node.left + node.Count(); ++i)
+			{
+				const int primitive = indices != nullptr ? indices[i] : i;
+				if (visit(primitive))
+				{
+					return primitive;
+				}
+			}
+		}
+
+		return -1;
+	}
+
+	/**
+	 * @brief Walks the nodes a ray enters front to back, letting the caller narrow the ray as it goes
+	 * @param bvh Hierarchy to walk
+	 * @param ray Prepared ray; nodes beyond its maxDistance are skipped
+	 * @param enters Called as enters(index) for each node the ray reaches; false skips the node's subtree
+	 * @param visit Called as visit(primitive, maxDistance) for each primitive in an entered leaf;
+	 *              returns the new maxDistance (the argument itself to leave it unchanged)
+	 *
+	 * The nearer child of every node is opened first, and subtrees entered
+	 * beyond the current maxDistance are skipped without being opened. This
+	 * is the traversal behind the nearest-hit CastBvh() and the mesh ray
+	 * casts, whose collectors narrow the ray to their own bound.
+	 */
+	template <typename Enters, typename Visit>
+	void CastBvh(const LinearBvh& bvh, const PreparedRay& ray, Enters&& enters, Visit&& visit)
+	{
+		if (bvh.IsEmpty() || !enters(0))
+		{
+			return;
+		}
+
+		const int* indices = bvh.indices.empty() ? nullptr : bvh.indices.data();
+		PreparedRay bounded = ray;
+
+		const float rootEntry = bounded.Enter(bvh.nodes[0].min, bvh.nodes[0].max);
+		if (rootEntry < 0.f)
+		{
+			return;
+		}
+
+		int stack[BVH_QUERY_STACK_SIZE];
+		float entries[BVH_QUERY_STACK_SIZE];
+		int top = 0;
+		stack[top] = 0;
+		entries[top++] = rootEntry;
+
+		while (top > 0)
+		{
+			--top;
+			if (entries[top] > bounded.maxDistance)
+			{
+				continue;
+			}
+
+			const LinearBvhNode& node = bvh.nodes[stack[top]];
+
+			if (node.IsLeaf())
+			{
+				for (int i = node.left; i < node.left + node.Count(); ++i)
+				{
+					bounded.maxDistance = visit(indices != nullptr ? indices[i] : i, bounded.maxDistance);
+				}
+
+				continue;
+			}
+
+			const LinearBvhNode& left = bvh.nodes[node.left];
+			const LinearBvhNode& right = bvh.nodes[node.right];
+			const float leftEntry = enters(node.left) ? bounded.Enter(left.min, left.max) : -1.f;
+			const float rightEntry = enters(node.right) ? bounded.Enter(right.min, right.max) : -1.f;
+
+			// Push the farther child first so the nearer one is opened next
+			const bool leftFirst = leftEntry >= 0.f && (rightEntry < 0.f || leftEntry <= rightEntry);
+			const int closer = leftFirst ? node.left : node.right;
+			const int farther = leftFirst ? node.right : node.left;
+			const float closerEntry = leftFirst ? leftEntry : rightEntry;
+			const float fartherEntry = leftFirst ? rightEntry : leftEntry;
+
+			if (fartherEntry >= 0.f)
+			{
+				stack[top] = farther;
+				entries[top++] = fartherEntry;
+			}
+
+			if (closerEntry >= 0.f)
+			{
+				stack[top] = closer;
+				entries[top++] = closerEntry;
+			}
+		}
+	}
+
+	/**
+	 * @brief Finds the nearest primitive along a ray, visiting nodes front to back
+	 * @param bvh Hierarchy to walk
+	 * @param ray Prepared ray; primitives beyond its maxDistance are ignored
+	 * @param cast Called as cast(primitive, maxDistance); returns the hit distance, or a negative value on a miss
+	 * @param distance Receives the distance to the nearest hit (unchanged on a miss)
+	 * @return Nearest primitive hit, or -1 if there is none
+	 *
+	 * Each hit shrinks the ray's range, so subtrees entered beyond the
+	 * nearest hit so far are skipped without being opened.
+	 */
+	template <typename Cast>
+	int CastBvh(const LinearBvh& bvh, const PreparedRay& ray, Cast&& cast, float& distance)
+	{
+		int nearest = -1;
+		float nearestDistance = ray.maxDistance;
+
+		CastBvh(bvh, ray, [](const int)
+		{
+			return true;
+		}, [&](const int primitive, const float maxDistance)
+		{
+			const float hit = cast(primitive, maxDistance);
+			if (hit < 0.f || hit > maxDistance)
+			{
+				return maxDistance;
+			}
+
+			nearest = primitive;
+			nearestDistance = hit;
+			return hit;
+		});
+
+		if (nearest >= 0)
+		{
+			distance = nearestDistance;
+		}
+
+		return nearest;
+	}
+
+	/**
+	 * @brief Bounding Volume Hierarchy over an array of any primitive type
+	 * @tparam Primitive Indexed type, measured through BvhTraits<Primitive>
+	 *
+	 * Builds a LinearBvh with the Morton builder and walks it with WalkBvh()
+	 * and CastBvh(), the same code Mesh uses for its triangles. The tree
+	 * only knows primitive bounds: exact tests are left to the callbacks,
+	 * which receive indices into the primitive array.
+	 *
+	 * The primitives are not copied. The array passed to Build() must outlive
+	 * the queries, and the tree must be rebuilt after primitives move.
+	 */
+	template <typename Primitive>
+	class Bvh
+	{
+	public:
+		const Primitive* primitives;  ///< Primitives indexed by the last build (not owned)
+		int count;                    ///< Number of primitives
+		LinearBvh hierarchy;          ///< Tree over the primitives, leaves holding primitive indices
+		vector<Aabb> bounds;          ///< Bounds of each primitive at the last build
+		vector<Vector3> centroids;    ///< Centroid of each primitive at the last build
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty tree
+		 */
+		Bvh()
+			: primitives{ nullptr }, count{ 0 }
+		{
+		}
+
+	public:
+		/**
+		 * @brief Rebuilds the tree over a set of primitives
+		 * @param items Primitives to index
+		 * @param mortonBits Code precision: 30 (10 bits per axis) or 63 (21 bits per axis)
+		 *
+		 * Storage is reused, so rebuilding a tree of the same size every frame
+		 * performs no reallocation.
+		 */
+		void Build(span<const Primitive> items, const int mortonBits = 30)
+		{
+			primitives = items.data();
+			count = static_cast<int>(items.size());
+
+			GatherBvhInputs(primitives, count, bounds, &centroids);
+			hierarchy.BuildMorton(bounds.data(), count, mortonBits, centroids.data());
+		}
+
+		/**
+		 * @brief Removes every primitive reference
+		 */
+		void Clear()
+		{
+			primitives = nullptr;
+			count = 0;
+			hierarchy.Clear();
+			bounds.clear();
+			centroids.clear();
+		}
+
+		/**
+		 * @brief Tests whether the tree indexes any primitive
+		 * @return True if nothing has been built
+		 */
+		bool IsEmpty() const
+		{
+			return hierarchy.IsEmpty();
+		}
+
+		/**
+		 * @brief Visits the primitives whose bounds overlap a box
+		 * @param region Box to query
+		 * @param visit Called as visit(index) for each candidate; true stops the query
+		 * @return Index the query stopped at, or -1 if every candidate was visited
+		 */
+		template <typename Visit>
+		int Query(const Aabb& region, Visit&& visit) const
+		{
+			const Vector3 min = region.Min();
+			const Vector3 max = region.Max();
+
+			return WalkBvh(hierarchy, [&](const int, const Vector3& nodeMin, const Vector3& nodeMax)
+			{
+				return nodeMin.x <= max.x && nodeMax.x >= min.x &&
+					nodeMin.y <= max.y && nodeMax.y >= min.y &&
+					nodeMin.z <= max.z && nodeMax.z >= min.z;
+			}, visit);
+		}
+
+		/**
+		 * @brief Finds the nearest primitive hit by a ray
+		 * @param ray Ray to cast
+		 * @param cast Called as cast(index, maxDistance); returns the hit distance, or a negative value on a miss
+		 * @param distance Receives the distance to the nearest hit (unchanged on a miss)
+		 * @param maxDistance Primitives hit beyond this distance are ignored
+		 * @return Index of the nearest primitive hit, or -1 if there is none
+		 */
+		template <typename Cast>
+		int CastRay(const Ray& ray, Cast&& cast, float& distance, const float maxDistance = std::numeric_limits<float>::infinity()) const
+		{
+			return CastBvh(hierarchy, PreparedRay{ ray, maxDistance }, cast, distance);
+		}
+	};
+}
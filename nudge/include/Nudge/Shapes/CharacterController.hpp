@@ -0,0 +1,213 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Bvh.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <span>
+#include <vector>
+
+using std::span;
+using std::vector;
+
+// Default height of the ledges a grounded character walks onto without jumping
+constexpr float CHARACTER_DEFAULT_STEP_HEIGHT = .3f;
+
+// Default distance a grounded character is pulled down to stay on stairs and slopes
+constexpr float CHARACTER_DEFAULT_SNAP_DISTANCE = .2f;
+
+// Default steepest walkable slope, in degrees from horizontal
+constexpr float CHARACTER_DEFAULT_MAX_SLOPE = 45.f;
+
+// Default gap kept between characters and colliders, so resting contacts do
+// not register as penetrations on the next move
+constexpr float CHARACTER_DEFAULT_SKIN_WIDTH = .01f;
+
+// Default number of surfaces a move may slide along before it gives up
+constexpr int CHARACTER_DEFAULT_MAX_SLIDES = 4;
+
+namespace Nudge
+{
+	class Mesh;
+	class Obb;
+
+	/**
+	 * @brief Capsule or sphere moved by a CharacterController
+	 *
+	 * The capsule is the set of points within radius of a segment running
+	 * halfHeight above and below the position, along the controller's up
+	 * axis. A halfHeight of 0 makes a sphere.
+	 */
+	class Character
+	{
+	public:
+		Vector3 position;      ///< Center of the capsule
+		Vector3 displacement;  ///< Movement wanted by the next CharacterController::Move(), gravity included
+		float radius;          ///< Radius of the capsule
+		float halfHeight;      ///< Half the length of the capsule's core segment, 0 for a sphere
+		Vector3 groundNormal;  ///< Normal of the walkable surface under the character, valid while grounded
+		bool grounded;         ///< Standing on walkable ground after the last move
+
+	public:
+		/**
+		 * @brief Default constructor creating a unit sphere at the origin
+		 */
+		Character();
+
+		/**
+		 * @brief Creates a character at rest
+		 * @param position Center of the capsule
+		 * @param radius Radius of the capsule
+		 * @param halfHeight Half the length of the capsule's core segment, 0 for a sphere
+		 */
+		Character(const Vector3& position, float radius, float halfHeight = 0.f);
+	};
+
+	/**
+	 * @brief Box stored as its corners, so the many overlap tests of a move stay plain comparisons
+	 */
+	class CharacterBox
+	{
+	public:
+		Vector3 min;  ///< Minimum corner
+		Vector3 max;  ///< Maximum corner
+
+	public:
+		/**
+		 * @brief Tests whether two boxes overlap, touching included
+		 * @param other Box to test against
+		 * @return True if the boxes share at least one point
+		 */
+		bool Overlaps(const CharacterBox& other) const;
+	};
+
+	/**
+	 * @brief Per-triangle data a CharacterController computes once, when the triangle is added
+	 */
+	class CharacterTriangleData
+	{
+	public:
+		CharacterBox bounds;  ///< Box around the triangle
+		Vector3 normal;       ///< Unit normal of the triangle, zero if degenerate
+	};
+
+	/**
+	 * @brief Moves characters through static geometry with swept collide-and-slide
+	 *
+	 * Colliders are meshes (referenced, not copied) plus loose triangles and
+	 * spheres; boxes are stored as their 12 face triangles. The bounds of
+	 * every collider and the normal of every triangle are computed when it
+	 * is added, so moves only read them. Each move runs
+	 * three passes:
+	 * 1. Up: rise by the step height (grounded characters walking) plus any
+	 *    upward part of the displacement
+	 * 2. Across: slide the horizontal part of the displacement along every
+	 *    surface hit, following creases between two surfaces
+	 * 3. Down: undo the step, apply the downward part of the displacement
+	 *    and, for grounded characters not moving up, snap down onto ground
+	 *    within the snap distance. Steep surfaces are slid down; the first
+	 *    walkable one stops the pass and grounds the character
+	 *
+	 * Sweeps use conservative advancement: each collider is approached by
+	 * the distance to it divided by the closing speed, which never overshoots
+	 * since the distance between two convex shapes is convex along a
+	 * translation. Moves stop skinWidth away from surfaces.
+	 *
+	 * Move(span) sorts the characters along a Morton curve and groups
+	 * neighbours whose swept bounds overlap, so each group queries every
+	 * mesh and tree once; each character then only tests the gathered
+	 * colliders that touch its own swept bounds. Gathered colliders are
+	 * indices into the controller's and the meshes' own arrays, never
+	 * copies. Groups run in parallel.
+	 *
+	 * Gravity is not applied: callers add it to Character::displacement.
+	 */
+	class CharacterController
+	{
+	public:
+		Vector3 up;                   ///< Unit vector pointing away from gravity
+		float stepHeight;             ///< Tallest ledge a grounded character walks onto
+		float snapDistance;           ///< Largest drop a grounded character follows instead of leaving the ground
+		float maxSlopeCosine;         ///< Cosine of the steepest walkable slope
+		float skinWidth;              ///< Gap kept between characters and colliders
+		int maxSlides;                ///< Surfaces one pass may slide along
+		vector<const Mesh*> meshes;   ///< Static meshes collided against (not owned)
+		vector<vector<CharacterTriangleData>> meshData;  ///< Data of every triangle of each mesh, computed by Add()
+		vector<Triangle> triangles;   ///< Loose triangles, including the faces of added boxes
+		vector<CharacterTriangleData> triangleData;      ///< Data of each loose triangle
+		vector<Sphere> spheres;       ///< Sphere colliders
+		vector<CharacterBox> sphereBounds;               ///< Box around each sphere
+		Bvh<Triangle> triangleTree;   ///< Tree over triangles, rebuilt by Move() after changes
+		Bvh<Sphere> sphereTree;       ///< Tree over spheres, rebuilt by Move() after changes
+		bool dirty;                   ///< Colliders added since the trees were built
+
+	public:
+		/**
+		 * @brief Default constructor creating a controller without colliders, with +Y up and default settings
+		 */
+		CharacterController();
+
+	public:
+		/**
+		 * @brief Sets the steepest walkable slope
+		 * @param degrees Angle from horizontal
+		 */
+		void SetMaxSlope(float degrees);
+
+		/**
+		 * @brief Adds a mesh to collide against
+		 * @param mesh Mesh to reference; it must outlive the controller and should be accelerated
+		 *
+		 * The bounds and normal of every triangle are computed here, so the
+		 * mesh's vertices must not move afterwards. To collide against a mesh
+		 * that changes, Clear() the controller and add its colliders again.
+		 */
+		void Add(const Mesh& mesh);
+
+		/**
+		 * @brief Adds a triangle to collide against, from either side
+		 * @param triangle Triangle to copy
+		 */
+		void Add(const Triangle& triangle);
+
+		/**
+		 * @brief Adds a sphere to collide against
+		 * @param sphere Sphere to copy
+		 */
+		void Add(const Sphere& sphere);
+
+		/**
+		 * @brief Adds a box to collide against, as its 12 face triangles
+		 * @param box Box to copy
+		 */
+		void Add(const Aabb& box);
+
+		/**
+		 * @brief Adds an oriented box to collide against, as its 12 face triangles
+		 * @param box Box to copy
+		 */
+		void Add(const Obb& box);
+
+		/**
+		 * @brief Removes every collider
+		 */
+		void Clear();
+
+		/**
+		 * @brief Moves one character by its displacement
+		 * @param character Character to move; position, grounded and groundNormal are updated
+		 */
+		void Move(Character& character);
+
+		/**
+		 * @brief Moves many characters by their displacements
+		 * @param characters Characters to move; position, grounded and groundNormal are updated
+		 *
+		 * Characters do not collide with each other. The result for each
+		 * character is the same as moving it alone.
+		 */
+		void Move(span<Character> characters);
+	};
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Bvh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <limits>
+#include <span>
+#include <vector>
+
+using std::span;
+using std::vector;
+
+namespace Nudge
+{
+	class Line;
+	class Plane;
+	class Ray;
+	class Shape;
+
+	/**
+	 * @brief Kind of shape a CompoundChild refers to
+	 */
+	enum class CompoundShape
+	{
+		Sphere,    ///< Entry of Compound::spheres
+		Obb,       ///< Entry of Compound::boxes
+		Triangle   ///< Entry of Compound::triangles
+	};
+
+	/**
+	 * @brief One part of a Compound, as indexed by its internal tree
+	 */
+	class CompoundChild
+	{
+	public:
+		CompoundShape shape;  ///< Array the child lives in
+		int index;            ///< Index into that array
+		Aabb bounds;          ///< Local-space box enclosing the child
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty sphere child
+		 */
+		CompoundChild();
+
+		/**
+		 * @brief Creates a child reference
+		 * @param shape Array the child lives in
+		 * @param index Index into that array
+		 */
+		CompoundChild(CompoundShape shape, int index);
+	};
+
+	template <>
+	class BvhTraits<CompoundChild>
+	{
+	public:
+		static Aabb Bounds(const CompoundChild& primitive);
+		static Vector3 Centroid(const CompoundChild& primitive);
+	};
+
+	/**
+	 * @brief Pair of touching children reported by Compound::Overlaps()
+	 */
+	class CompoundPair
+	{
+	public:
+		int first;   ///< Child index in the compound queried
+		int second;  ///< Child index in the other compound
+	};
+
+	/**
+	 * @brief Rigid body made of several spheres, boxes and triangles
+	 *
+	 * Children are stored in the body's local frame and placed in the world
+	 * by position and orientation. A small Bvh indexes their local bounds, so
+	 * a query only reaches the exact test for children whose bounds it
+	 * overlaps instead of every part of the body. Queries are moved into the
+	 * local frame rather than the children into the world, so moving the body
+	 * costs nothing, and a run of Add() calls leaves the tree to be built
+	 * once, by the next query. That query writes the tree and must not run
+	 * concurrently with other queries on the same body.
+	 *
+	 * Compound-vs-compound queries descend both trees together and only pair
+	 * up children whose subtrees overlap, which keeps two bodies of a few
+	 * hundred parts each down to a handful of exact tests. The other body's
+	 * nodes and children are placed in this body's frame as the walk meets
+	 * them.
+	 *
+	 * The orientation must be a pure rotation: queries undo it with its
+	 * transpose.
+	 *
+	 * Child indices are assigned in the order the children were added, and
+	 * are shared by every query; an Aabb child is stored as an Obb.
+	 */
+	class Compound
+	{
+	public:
+		Vector3 position;                 ///< World position of the local origin
+		Matrix3 orientation;              ///< Rotation from local to world space
+		vector<Sphere> spheres;           ///< Sphere children, local space
+		vector<Obb> boxes;                ///< Box children, local space
+		vector<Triangle> triangles;       ///< Triangle children, local space
+		vector<CompoundChild> children;   ///< Every child in the order added
+		mutable Bvh<CompoundChild> tree;  ///< Tree over the children's local bounds
+		mutable bool dirty;               ///< Children were added since the tree was built
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty body at the origin
+		 */
+		Compound();
+
+		/**
+		 * @brief Creates an empty body
+		 * @param position World position of the local origin
+		 * @param orientation Rotation from local to world space
+		 */
+		Compound(const Vector3& position, const Matrix3& orientation);
+
+		/**
+		 * @brief Copies a body, re-pointing the tree at the copied children
+		 * @param other Body to copy
+		 */
+		Compound(const Compound& other);
+
+		/**
+		 * @brief Copies a body, re-pointing the tree at the copied children
+		 * @param other Body to copy
+		 * @return This body
+		 */
+		Compound& operator=(const Compound& other);
+
+	public:
+		/**
+		 * @brief Adds a sphere child
+		 * @param child Sphere in local space
+		 * @return Index of the new child
+		 */
+		int Add(const Sphere& child);
+
+		/**
+		 * @brief Adds an axis-aligned box child
+		 * @param child Box in local space, stored as an unrotated Obb
+		 * @return Index of the new child
+		 */
+		int Add(const Aabb& child);
+
+		/**
+		 * @brief Adds an oriented box child
+		 * @param child Box in local space
+		 * @return Index of the new child
+		 */
+		int Add(const Obb& child);
+
+		/**
+		 * @brief Adds a triangle child
+		 * @param child Triangle in local space
+		 * @return Index of the new child
+		 */
+		int Add(const Triangle& child);
+
+		/**
+		 * @brief Moves the body
+		 * @param position World position of the local origin
+		 * @param orientation Rotation from local to world space
+		 *
+		 * Children and tree stay in local space, so this costs the same for
+		 * any number of children.
+		 */
+		void SetTransform(const Vector3& position, const Matrix3& orientation);
+
+		/**
+		 * @brief Places a local-space sphere in the world
+		 * @param local Sphere in the body's frame, such as an entry of spheres
+		 * @return The same sphere in world space
+		 */
+		Sphere ToWorld(const Sphere& local) const;
+
+		/**
+		 * @brief Places a local-space oriented box in the world
+		 * @param local Box in the body's frame, such as an entry of boxes
+		 * @return The same box in world space
+		 */
+		Obb ToWorld(const Obb& local) const;
+
+		/**
+		 * @brief Places a local-space triangle in the world
+		 * @param local Triangle in the body's frame, such as an entry of triangles
+		 * @return The same triangle in world space
+		 */
+		Triangle ToWorld(const Triangle& local) const;
+
+		/**
+		 * @brief Tests whether the body has any child
+		 * @return True if nothing has been added
+		 */
+		bool IsEmpty() const;
+
+		/**
+		 * @brief Number of children
+		 * @return Count over every shape kind
+		 */
+		int ChildCount() const;
+
+		/**
+		 * @brief Box enclosing every child
+		 * @return World-space bounds, or a zero-size box at position if empty
+		 *
+		 * The tree's local root box placed in the world, so it grows with
+		 * the rotation rather than fitting the rotated children.
+		 */
+		Aabb Bounds() const;
+
+		/**
+		 * @brief Tests whether a box touches any child
+		 * @param other Box to test
+		 * @return True if any child intersects the box
+		 */
+		bool Intersects(const Aabb& other) const;
+
+		/**
+		 * @brief Tests whether an oriented box touches any child
+		 * @param other Oriented box to test
+		 * @return True if any child intersects the box
+		 */
+		bool Intersects(const Obb& other) const;
+
+		/**
+		 * @brief Tests whether a sphere touches any child
+		 * @param other Sphere to test
+		 * @return True if any child intersects the sphere
+		 */
+		bool Intersects(const Sphere& other) const;
+
+		/**
+		 * @brief Tests whether a triangle touches any child
+		 * @param other Triangle to test
+		 * @return True if any child intersects the triangle
+		 */
+		bool Intersects(const Triangle& other) const;
+
+		/**
+		 * @brief Tests whether a plane touches any child
+		 * @param other Plane to test
+		 * @return True if any child intersects the plane
+		 */
+		bool Intersects(const Plane& other) const;
+
+		/**
+		 * @brief Tests whether a line segment touches any child
+		 * @param other Segment to test
+		 * @return True if any child intersects the segment
+		 */
+		bool Intersects(const Line& other) const;
+
+		/**
+		 * @brief Tests whether a shape of any kind touches any child
+		 * @param other Shape to test
+		 * @return True if any child intersects the shape
+		 */
+		bool Intersects(const Shape& other) const;
+
+		/**
+		 * @brief Tests whether two bodies touch
+		 * @param other Body to test
+		 * @return True if any child of this body intersects any child of the other
+		 *
+		 * Stops at the first touching pair.
+		 */
+		bool Intersects(const Compound& other) const;
+
+		/**
+		 * @brief Finds every pair of touching children between two bodies
+		 * @param other Body to test
+		 * @param pairs Receives the touching pairs
+		 * @return Number of pairs written; stops early once pairs is full
+		 */
+		int Overlaps(const Compound& other, span<CompoundPair> pairs) const;
+
+		/**
+		 * @brief Casts a ray against every child
+		 * @param ray Ray to cast
+		 * @param child Receives the index of the child hit, if not nullptr (unchanged on a miss)
+		 * @param maxDistance Hits beyond this distance are ignored
+		 * @return Distance along the ray to the first hit, or -1 if there is none
+		 */
+		float CastRay(const Ray& ray, int* child = nullptr, float maxDistance = std::numeric_limits<float>::infinity()) const;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Nudge/Shapes/ConvexHull.hpp"
+
+#include <vector>
+
+using std::vector;
+
+namespace Nudge
+{
+	class Mesh;
+
+	/**
+	 * @brief Splits a mesh into a bounded set of convex hulls approximating its volume
+	 *
+	 * Voxel-driven, in the spirit of V-HACD: the mesh is voxelized with
+	 * VoxelGrid, the space enclosed by the surface is filled in, and the
+	 * solid voxels are split recursively by axis-aligned planes. The part
+	 * with the largest concavity is split next, along whichever candidate
+	 * plane leaves the smallest total hull volume on its two sides;
+	 * candidates are evaluated in parallel.
+	 *
+	 * Concavity of a part is the volume its hull covers beyond the part's
+	 * own voxels, as a fraction of the whole solid. Every hull encloses the
+	 * voxels of its part, and those voxels cover the mesh surface, so the
+	 * hulls together enclose the mesh (inflated by up to one voxel).
+	 */
+	class ConvexDecomposition
+	{
+	public:
+		int maxHulls;         ///< Largest number of hulls produced
+		float maxConcavity;   ///< Parts at or below this concavity are not split further
+		int resolution;       ///< Voxels along the longest side of the mesh bounds
+
+	public:
+		/**
+		 * @brief Default constructor allowing 16 hulls at 2% concavity on a 32-voxel grid
+		 */
+		ConvexDecomposition();
+
+		/**
+		 * @brief Creates a decomposition
+		 * @param maxHulls Largest number of hulls produced
+		 * @param maxConcavity Parts at or below this concavity are not split further
+		 * @param resolution Voxels along the longest side of the mesh bounds
+		 */
+		ConvexDecomposition(int maxHulls, float maxConcavity = .02f, int resolution = 32);
+
+	public:
+		/**
+		 * @brief Decomposes a mesh into convex hulls
+		 * @param mesh Mesh to decompose; should be closed so its inside can be filled
+		 * @param hulls Receives the hulls, in world space
+		 * @return Largest concavity among the hulls, 0 if the mesh is empty
+		 *
+		 * Splitting stops once maxHulls parts exist or every part is at or
+		 * below maxConcavity. An open mesh is decomposed as its voxelized
+		 * surface, which still gives valid but thin hulls. Hull vertex counts
+		 * grow with the resolution, since hulls follow the voxel staircase.
+		 */
+		float Decompose(const Mesh& mesh, vector<ConvexHull>& hulls) const;
+	};
+}
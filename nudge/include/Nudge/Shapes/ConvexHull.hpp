@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Plane.hpp"
+
+#include <span>
+#include <vector>
+
+using std::span;
+using std::vector;
+
+namespace Nudge
+{
+	/**
+	 * @brief Convex polyhedron stored as a triangulated boundary
+	 *
+	 * Faces are triangles wound counter-clockwise seen from outside, three
+	 * entries of indices per face, with one outward plane per face in
+	 * planes. Coplanar neighbouring triangles are kept separate, each with
+	 * its own (equal) plane. An empty hull has no vertices.
+	 */
+	class ConvexHull
+	{
+	public:
+		vector<Vector3> vertices;  ///< Hull vertices, each one extreme in some direction
+		vector<int> indices;       ///< Three vertex indices per face
+		vector<Plane> planes;      ///< Outward plane of each face
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty hull
+		 */
+		ConvexHull();
+
+		/**
+		 * @brief Builds the convex hull of a point set
+		 * @param points Points to enclose
+		 *
+		 * Incremental quickhull in double precision: the farthest point
+		 * outside any face is added next, so interior points are discarded
+		 * early. Points within a small tolerance of the hull, relative to the
+		 * size of the input, are treated as inside. Fewer than four points,
+		 * or points that are all coplanar, leave the hull empty.
+		 */
+		explicit ConvexHull(span<const Vector3> points);
+
+	public:
+		/**
+		 * @brief Tests whether the hull has any volume
+		 * @return True if the hull was built from degenerate input
+		 */
+		bool IsEmpty() const;
+
+		/**
+		 * @brief Tests whether a point lies inside or on the hull
+		 * @param point Point to classify
+		 * @return True if the point is behind every face plane
+		 */
+		bool Contains(const Vector3& point) const;
+
+		/**
+		 * @brief Vertex farthest along a direction
+		 * @param direction Direction to search along (need not be normalized)
+		 * @return Hull vertex with the largest projection onto the direction, or the origin for an empty hull
+		 */
+		Vector3 Support(const Vector3& direction) const;
+
+		/**
+		 * @brief Volume enclosed by the hull
+		 * @return Volume, 0 for an empty hull
+		 */
+		float Volume() const;
+
+		/**
+		 * @brief Box enclosing the hull
+		 * @return Bounds of the vertices, or a zero box at the origin for an empty hull
+		 */
+		Aabb Bounds() const;
+	};
+}
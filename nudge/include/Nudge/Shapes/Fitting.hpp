@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+
+#include <span>
+
+using std::span;
+
+namespace Nudge
+{
+	class Mesh;
+
+	/**
+	 * @brief Fits bounding volumes to point sets and meshes
+	 *
+	 * Every volume returned encloses all of its input points. Passes over
+	 * the whole input are split across worker threads, with one partial
+	 * result per chunk combined at the end, and are written as plain loops
+	 * over the points the compiler can vectorize. Meshes are fitted to the
+	 * vertices of their triangles.
+	 */
+	class Fitting
+	{
+	public:
+		/**
+		 * @brief Axis-aligned box of a point set
+		 * @param points Points to enclose
+		 * @return Smallest enclosing box, or a zero box at the origin if there are no points
+		 */
+		static Aabb Bounds(span<const Vector3> points);
+
+		/**
+		 * @brief Smallest sphere enclosing a point set
+		 * @param points Points to enclose
+		 * @return Minimal sphere, or a zero sphere at the origin if there are no points
+		 *
+		 * Welzl's algorithm over a fixed pseudo-random permutation of the
+		 * points, in expected linear time. The support set is solved in
+		 * double precision, then the radius is measured over every point so
+		 * rounding never leaves one outside.
+		 */
+		static Sphere MinimalSphere(span<const Vector3> points);
+
+		/**
+		 * @brief Smallest sphere enclosing a mesh
+		 * @param mesh Mesh to enclose
+		 * @return Minimal sphere over the mesh's vertices
+		 */
+		static Sphere MinimalSphere(const Mesh& mesh);
+
+		/**
+		 * @brief Tight oriented box enclosing a point set
+		 * @param points Points to enclose
+		 * @return Enclosing box with the smallest surface area among the candidate orientations,
+		 *         or a zero box at the origin if there are no points
+		 *
+		 * Candidates are the world axes, the principal axes of the points'
+		 * covariance (PCA), and the edges of the ditetrahedron spanned by the
+		 * points' extremes along 7 fixed directions (DiTO-14, Larsson and
+		 * Kallberg). Ditetrahedron candidates are ranked on those 14 extreme
+		 * points only; the best of them is then measured over every point.
+		 */
+		static Obb TightObb(span<const Vector3> points);
+
+		/**
+		 * @brief Tight oriented box enclosing a mesh
+		 * @param mesh Mesh to enclose
+		 * @return Oriented box over the mesh's vertices, see TightObb(span<const Vector3>)
+		 */
+		static Obb TightObb(const Mesh& mesh);
+	};
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+using std::size_t;
+using std::span;
+using std::uint16_t;
+using std::vector;
+
+// Cells along each side of the finest min/max mip tile. Rays and region
+// queries walk individual cells only inside tiles they cannot reject.
+constexpr int HEIGHTFIELD_TILE_SIZE = 4;
+
+namespace Nudge
+{
+	class Obb;
+	class Ray;
+	class Sphere;
+	class Triangle;
+
+	/**
+	 * @brief One level of a Heightfield's min/max pyramid
+	 *
+	 * Level 0 stores the height range of each HEIGHTFIELD_TILE_SIZE square
+	 * tile of cells; every further level merges 2x2 entries of the one below,
+	 * up to a single entry covering the whole field. Ranges are relative to
+	 * Heightfield::origin.y.
+	 */
+	class HeightfieldMip
+	{
+	public:
+		int columns;        ///< Entries along x
+		int rows;           ///< Entries along z
+		vector<float> min;  ///< Lowest height in each entry, row-major
+		vector<float> max;  ///< Highest height in each entry, row-major
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty level
+		 */
+		HeightfieldMip();
+	};
+
+	/**
+	 * @brief Point where a shape penetrates a Heightfield
+	 */
+	class HeightfieldContact
+	{
+	public:
+		Vector3 point;   ///< Closest point on the surface
+		Vector3 normal;  ///< Unit direction from the surface towards the shape
+		float depth;     ///< Penetration depth along the normal
+		int triangle;    ///< Index of the surface triangle, see Heightfield::CellTriangles()
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty contact
+		 */
+		HeightfieldContact();
+	};
+
+	/**
+	 * @brief Terrain surface stored as a regular grid of heights
+	 *
+	 * Sample (x, z) lies at origin + (x * spacingX, Height(x, z), z * spacingZ).
+	 * Each square cell between four samples is split into two triangles along
+	 * its (x, z) to (x + 1, z + 1) diagonal, both facing +y. Triangles are
+	 * generated on the fly for the cells a query touches, so the field costs
+	 * one float per sample, or two bytes when quantized, instead of the
+	 * 2 * 36 bytes per cell of an equivalent Mesh.
+	 *
+	 * Queries first descend the min/max pyramid (mips), rejecting whole tiles
+	 * whose height range the ray or region cannot reach. Like mesh ray casts,
+	 * only the upper side of the surface is hit.
+	 */
+	class Heightfield
+	{
+	public:
+		Vector3 origin;               ///< World position of sample (0, 0) at height 0
+		float spacingX;               ///< Distance between samples along x
+		float spacingZ;               ///< Distance between samples along z
+		int columns;                  ///< Samples along x (at least 2)
+		int rows;                     ///< Samples along z (at least 2)
+		vector<float> heights;        ///< Heights, row-major, empty when quantized
+		vector<uint16_t> quantized;   ///< 16-bit heights, row-major, empty unless quantized
+		float quantizationBase;       ///< Height of quantized value 0
+		float quantizationStep;       ///< Height between consecutive quantized values
+		vector<HeightfieldMip> mips;  ///< Min/max pyramid, finest level first
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty field
+		 */
+		Heightfield();
+
+		/**
+		 * @brief Creates a field from a grid of heights
+		 * @param columns Samples along x (at least 2)
+		 * @param rows Samples along z (at least 2)
+		 * @param samples Heights relative to origin.y, row-major (columns * rows values)
+		 * @param origin World position of sample (0, 0) at height 0
+		 * @param spacingX Distance between samples along x
+		 * @param spacingZ Distance between samples along z
+		 * @param quantize Store heights as 16-bit values spanning the sample range
+		 *
+		 * Quantization rounds each height to the nearest of 65536 levels between
+		 * the lowest and highest sample; queries then see the rounded surface.
+		 * An invalid size or sample count leaves the field empty.
+		 */
+		Heightfield(int columns, int rows, span<const float> samples, const Vector3& origin, float spacingX, float spacingZ, bool quantize = false);
+
+	public:
+		/**
+		 * @brief Tests whether the field has any cells
+		 * @return True if the field was not built from valid samples
+		 */
+		bool IsEmpty() const;
+
+		/**
+		 * @brief Height of a sample
+		 * @param x Sample column
+		 * @param z Sample row
+		 * @return Height relative to origin.y
+		 */
+		float Height(int x, int z) const;
+
+		/**
+		 * @brief Height of the surface below or above a world position
+		 * @param x World x coordinate
+		 * @param z World z coordinate
+		 * @param height Receives the world height of the surface
+		 * @return True if the position lies over the field
+		 */
+		bool HeightAt(float x, float z, float& height) const;
+
+		/**
+		 * @brief Box enclosing the whole surface
+		 * @return World-space bounds
+		 */
+		Aabb Bounds() const;
+
+		/**
+		 * @brief Generates the two triangles of a cell
+		 * @param x Cell column, in [0, columns - 1)
+		 * @param z Cell row, in [0, rows - 1)
+		 * @param first Receives triangle 2 * (z * (columns - 1) + x)
+		 * @param second Receives the triangle after it
+		 */
+		void CellTriangles(int x, int z, Triangle& first, Triangle& second) const;
+
+		/**
+		 * @brief Generates the triangles of the cells a box may touch
+		 * @param region World-space box
+		 * @param triangles Receives the triangles
+		 * @return Number of triangles written; stops early once triangles is full
+		 *
+		 * Cells are culled by their height range, so every triangle returned has
+		 * bounds overlapping the region, but not every one need intersect it.
+		 */
+		int CollectTriangles(const Aabb& region, span<Triangle> triangles) const;
+
+		/**
+		 * @brief Casts a ray against the upper side of the surface
+		 * @param ray Ray to cast
+		 * @param maxDistance Hits beyond this distance are ignored
+		 * @return Distance along the ray to the first hit, or -1 if there is none
+		 *
+		 * Visits pyramid entries front to back, then steps through the cells
+		 * of each tile the ray reaches in the order the ray crosses them
+		 * (Amanatides and Woo), so the first hit found is the nearest.
+		 */
+		float CastRay(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		/**
+		 * @brief Tests whether a box touches the surface
+		 * @param other Box to test
+		 * @return True if any surface triangle intersects the box
+		 */
+		bool Intersects(const Aabb& other) const;
+
+		/**
+		 * @brief Tests whether an oriented box touches the surface
+		 * @param other Oriented box to test
+		 * @return True if any surface triangle intersects the box
+		 */
+		bool Intersects(const Obb& other) const;
+
+		/**
+		 * @brief Tests whether a sphere touches the surface
+		 * @param other Sphere to test
+		 * @return True if any surface triangle intersects the sphere
+		 */
+		bool Intersects(const Sphere& other) const;
+
+		/**
+		 * @brief Generates contacts between a sphere and the surface
+		 * @param other Sphere to test
+		 * @param contacts Receives one contact per penetrated triangle
+		 * @return Number of contacts written; stops early once contacts is full
+		 */
+		int Contacts(const Sphere& other, span<HeightfieldContact> contacts) const;
+
+		/**
+		 * @brief Memory held by the heights and the pyramid
+		 * @return Size in bytes
+		 */
+		size_t ByteSize() const;
+	};
+}
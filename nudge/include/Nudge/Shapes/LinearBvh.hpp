@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Nudge/Shapes/AABB.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+// Relative widening of a slab test's exit distance. Without it, a ray grazing
+// a box face (common with flat leaf boxes) can be rejected by one ulp of
+// rounding even though it hits a triangle on that face (Ize 2013).
+constexpr float BVH_SLAB_TOLERANCE = 1.f + 6.f * std::numeric_limits<float>::epsilon();
+
+// Default extra references a spatial split build may create, as a fraction of the triangle count
+constexpr float SBVH_DUPLICATION_BUDGET = .3f;
+
+namespace Nudge
+{
+	class Triangle;
+
+	/**
+	 * @brief Strategy used by Mesh::Accelerate() to build the acceleration structure
+	 */
+	enum class BvhBuildMode
+	{
+		Octree,        ///< Fixed-depth octree of BvhNode (triangles duplicated across octants)
+		Morton,        ///< Linear BVH sorted by 30-bit Morton codes (10 bits per axis)
+		MortonPrecise, ///< Linear BVH sorted by 63-bit Morton codes (21 bits per axis)
+		Wide,          ///< 30-bit Morton BVH collapsed into a WideBvh with quantized child bounds
+		Spatial        ///< Linear BVH built top-down with SAH object and spatial (clipping) splits
+	};
+
+	/**
+	 * @brief Node of a flattened binary BVH stored in LinearBvh::nodes
+	 *
+	 * Nodes reference each other by index rather than by pointer, so a whole
+	 * hierarchy lives in one contiguous allocation and can be rebuilt in place.
+	 * Bounds are kept as min/max corners (rather than an Aabb's origin/extents)
+	 * because that is the form both the slab test and the bottom-up merge use,
+	 * and each node packs into 32 bytes.
+	 *
+	 * Encoding:
+	 * - Internal node: left and right hold the indices of the two child nodes
+	 * - Leaf node: left holds the first slot in LinearBvh::indices, right holds
+	 *   the negated number of primitives in the leaf (always < 0)
+	 */
+	class LinearBvhNode
+	{
+	public:
+		Vector3 min;  ///< Minimum corner of the bounds enclosing every primitive below this node
+		int left;     ///< Left child index (internal) or first primitive slot (leaf)
+		Vector3 max;  ///< Maximum corner of the bounds enclosing every primitive below this node
+		int right;    ///< Right child index (internal) or negated primitive count (leaf)
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty leaf
+		 */
+		LinearBvhNode();
+
+	public:
+		/**
+		 * @brief Tests whether this node is a leaf
+		 * @return True if the node references primitives instead of children
+		 */
+		bool IsLeaf() const;
+
+		/**
+		 * @brief Number of primitives referenced by a leaf
+		 * @return Primitive count for leaves, 0 for internal nodes
+		 */
+		int Count() const;
+
+		/**
+		 * @brief Bounds of this node as an axis-aligned box
+		 * @return Aabb spanning min to max
+		 */
+		Aabb Bounds() const;
+	};
+
+	/**
+	 * @brief Working storage of LinearBvh::BuildMorton(), kept between builds
+	 *
+	 * Every array is sized to the primitive count (or the node count) on each
+	 * build and only grows, so rebuilding a hierarchy of the same size every
+	 * frame allocates nothing.
+	 */
+	class LinearBvhScratch
+	{
+	public:
+		vector<uint64_t> keys;        ///< Morton code of each primitive (30-bit codes with the index in the low half), sorted in place
+		vector<uint64_t> sortedKeys;  ///< Radix sort destination for keys
+		vector<int> order;            ///< Primitive index paired with each 63-bit key
+		vector<int> sortedOrder;      ///< Radix sort destination for order
+		vector<int> offsets;          ///< Per-chunk radix histograms and scatter offsets
+		vector<float> chunkBounds;    ///< Per-chunk centroid bounds (6 floats per chunk)
+		vector<int> pending;          ///< Far end of the first child to reach each internal node, -1 until then
+	};
+
+	/**
+	 * @brief Flattened binary Bounding Volume Hierarchy over an indexed set of primitives
+	 *
+	 * The hierarchy only knows primitive bounds; leaves store indices into the
+	 * caller's primitive array (for a Mesh, indices into mesh.triangles). The root
+	 * is always nodes[0].
+	 *
+	 * BuildMorton() implements linear BVH construction (Karras 2012, with the
+	 * single bottom-up pass of Apetrei 2014):
+	 * 1. Primitive centroids are quantized into Morton codes
+	 * 2. Codes are sorted with a parallel LSD radix sort
+	 * 3. Every leaf climbs towards the root, joining the neighbouring subtree
+	 *    with the closer code; the second child to arrive at a parent emits
+	 *    it and computes its bounds
+	 *
+	 * Every step is O(n) and runs across all hardware threads, which makes the
+	 * builder suitable for geometry that changes every frame.
+	 *
+	 * BuildSpatial() is the slower, higher quality alternative for static
+	 * meshes with large or long thin triangles. Rather than assigning each
+	 * triangle to one side of a split, it may clip it at the split plane and
+	 * reference it from both children, so sibling nodes stop overlapping.
+	 * Leaves may then hold several primitives, and indices may repeat.
+	 *
+	 * The leaves of every subtree reference a contiguous range of indices,
+	 * which WideBvh::Collapse() relies on to fold small subtrees into one leaf.
+	 */
+	class LinearBvh
+	{
+	public:
+		vector<LinearBvhNode> nodes;  ///< Node storage, root at index 0
+		vector<int> indices;          ///< Primitive indices referenced by leaf nodes, empty if primitives are stored in leaf order
+		vector<uint32_t> masks;       ///< Bitwise OR of the flags below each node, empty unless built with BuildMasks()
+		LinearBvhScratch scratch;     ///< Morton build working storage, reused by the next BuildMorton()
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty hierarchy
+		 */
+		LinearBvh();
+
+	public:
+		/**
+		 * @brief Rebuilds the hierarchy using Morton-ordered linear construction
+		 * @param primitiveBounds Bounds of each primitive, indexed by primitive id
+		 * @param count Number of primitives
+		 * @param mortonBits Code precision: 30 (10 bits per axis) or 63 (21 bits per axis)
+		 * @param centroids Point of each primitive to sort by, or nullptr to use the bounds' centers
+		 *
+		 * Node, index and scratch storage are reused, so rebuilding a hierarchy
+		 * of the same size (or smaller) every frame performs no reallocation.
+		 * The result contains one leaf per primitive and 2 * count - 1 nodes in
+		 * total.
+		 */
+		void BuildMorton(const Aabb* primitiveBounds, int count, int mortonBits = 30, const Vector3* centroids = nullptr);
+
+		/**
+		 * @brief Rebuilds the hierarchy with SAH-driven object and spatial splits (SBVH)
+		 * @param triangles Triangles to organize, indexed by primitive id
+		 * @param count Number of triangles
+		 * @param duplicationBudget Extra references allowed, as a fraction of count
+		 *
+		 * Spatial splits are only taken while the budget lasts, so indices never
+		 * grows beyond count * (1 + duplicationBudget). A budget of 0 produces a
+		 * plain SAH object split hierarchy.
+		 */
+		void BuildSpatial(const Triangle* triangles, int count, float duplicationBudget = SBVH_DUPLICATION_BUDGET);
+
+		/**
+		 * @brief Aggregates per-primitive flags into every node
+		 * @param primitiveFlags Flags of each primitive, indexed by primitive id, or nullptr to drop the masks
+		 *
+		 * Each entry of masks becomes the bitwise OR of the flags of every
+		 * primitive below the node, so a query looking for some flags can skip
+		 * a subtree holding none of them. Building the hierarchy again drops
+		 * the masks; call this after every build.
+		 */
+		void BuildMasks(const uint32_t* primitiveFlags);
+
+		/**
+		 * @brief Removes all nodes and primitive references
+		 *
+		 * Keeps the scratch storage; use ReleaseScratch() to free it.
+		 */
+		void Clear();
+
+		/**
+		 * @brief Frees the working storage kept for the next BuildMorton()
+		 *
+		 * For hierarchies built once, the scratch is about as large as the
+		 * nodes themselves.
+		 */
+		void ReleaseScratch();
+
+		/**
+		 * @brief Tests whether the hierarchy contains any nodes
+		 * @return True if no hierarchy has been built
+		 */
+		bool IsEmpty() const;
+	};
+}
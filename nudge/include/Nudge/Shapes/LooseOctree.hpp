@@ -0,0 +1,230 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+using std::function;
+using std::vector;
+
+// Default half size of a LooseOctree's root cell, enough for a km-scale zone
+constexpr float LOOSE_OCTREE_DEFAULT_HALF_SIZE = 4096.f;
+
+// Default number of subdivision levels below the root
+constexpr int LOOSE_OCTREE_DEFAULT_DEPTH = 8;
+
+// Hard cap on subdivision levels, which also bounds the traversal stacks
+constexpr int LOOSE_OCTREE_MAX_DEPTH = 16;
+
+// Default ratio of a node's loose bounds to its cell. At 2, a node accepts any
+// object whose center lies in its cell and whose extents are at most its half size.
+constexpr float LOOSE_OCTREE_LOOSENESS = 2.f;
+
+namespace Nudge
+{
+	class Obb;
+	class Ray;
+	class Sphere;
+
+	/**
+	 * @brief Cell of a LooseOctree, stored by index in LooseOctree::nodes
+	 *
+	 * A node owns the cell center +/- halfSize, but holds objects anywhere
+	 * within center +/- halfSize * looseness. Its proxies form an intrusive
+	 * doubly-linked list through LooseOctreeProxy::previous and next.
+	 */
+	class LooseOctreeNode
+	{
+	public:
+		Vector3 center;    ///< Center of the cell
+		float halfSize;    ///< Half the edge length of the cell (without looseness)
+		int parent;        ///< Parent node index, -1 for the root
+		int children[8];   ///< Child node per octant (bit 0: +x, bit 1: +y, bit 2: +z), -1 where absent
+		int first;         ///< First proxy stored in this node, -1 if none
+		int population;    ///< Proxies stored in this node and all of its descendants
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty, unlinked node
+		 */
+		LooseOctreeNode();
+	};
+
+	/**
+	 * @brief Object stored in a LooseOctree, identified by its index in LooseOctree::proxies
+	 */
+	class LooseOctreeProxy
+	{
+	public:
+		Aabb bounds;   ///< Box enclosing the object
+		int node;      ///< Node holding the proxy, -1 if the slot is free
+		int previous;  ///< Previous proxy in the node's list, -1 if first
+		int next;      ///< Next proxy in the node's list, -1 if last
+		int depth;     ///< Depth of the node the bounds were sorted into
+		int cell[3];   ///< Cell coordinates of that node at its depth
+
+	public:
+		/**
+		 * @brief Default constructor creating a free proxy slot
+		 */
+		LooseOctreeProxy();
+	};
+
+	/**
+	 * @brief Loose octree over moving objects, for sparse scenes with large bounds
+	 *
+	 * Unlike the octree of BvhNode, which splits a fixed set of triangles and
+	 * duplicates those spanning several octants, every object is stored in
+	 * exactly one node, chosen directly from its size and center:
+	 * 1. The depth is the deepest level whose cells, enlarged by the
+	 *    looseness factor, still fit the object's largest extent
+	 * 2. The node at that depth is the cell containing the object's center
+	 *
+	 * Insert, remove and move therefore never search the tree. Nodes are
+	 * created along the path on first use and returned to a pool when their
+	 * subtree empties, so the tree only covers occupied space. A move that
+	 * stays in the same cell only updates the stored bounds.
+	 *
+	 * Objects whose center lies outside the root cell are kept in the root,
+	 * which every query visits. Node and proxy storage is pooled; proxy
+	 * indices stay valid until the proxy is removed.
+	 */
+	class LooseOctree
+	{
+	public:
+		vector<LooseOctreeNode> nodes;    ///< Node pool, root at index 0
+		vector<LooseOctreeProxy> proxies; ///< Proxy pool, indexed by proxy id
+		vector<int> freeNodes;            ///< Unused slots in nodes
+		vector<int> freeProxies;          ///< Unused slots in proxies
+		float looseness;                  ///< Ratio of a node's loose bounds to its cell
+		int maxDepth;                     ///< Deepest level nodes are created at
+		int count;                        ///< Number of live proxies
+
+	public:
+		/**
+		 * @brief Default constructor covering a cube of LOOSE_OCTREE_DEFAULT_HALF_SIZE around the origin
+		 */
+		LooseOctree();
+
+		/**
+		 * @brief Creates an empty tree over a cubic region
+		 * @param center Center of the root cell
+		 * @param halfSize Half the edge length of the root cell
+		 * @param maxDepth Subdivision levels below the root, clamped to [0, LOOSE_OCTREE_MAX_DEPTH]
+		 * @param looseness Ratio of a node's loose bounds to its cell, at least 1
+		 */
+		LooseOctree(const Vector3& center, float halfSize, int maxDepth = LOOSE_OCTREE_DEFAULT_DEPTH, float looseness = LOOSE_OCTREE_LOOSENESS);
+
+	public:
+		/**
+		 * @brief Adds an object
+		 * @param bounds Box enclosing the object
+		 * @return Id of the new proxy
+		 */
+		int Insert(const Aabb& bounds);
+
+		/**
+		 * @brief Adds an oriented box, stored by its world-space bounds
+		 * @param shape Oriented box
+		 * @return Id of the new proxy
+		 */
+		int Insert(const Obb& shape);
+
+		/**
+		 * @brief Adds a sphere, stored by its bounds
+		 * @param shape Sphere
+		 * @return Id of the new proxy
+		 */
+		int Insert(const Sphere& shape);
+
+		/**
+		 * @brief Removes an object
+		 * @param proxy Id returned by Insert(); unknown or removed ids are ignored
+		 */
+		void Remove(int proxy);
+
+		/**
+		 * @brief Updates the bounds of an object
+		 * @param proxy Id returned by Insert(); unknown or removed ids are ignored
+		 * @param bounds New box enclosing the object
+		 *
+		 * Relinks the proxy only if it changes cell or depth.
+		 */
+		void Move(int proxy, const Aabb& bounds);
+
+		/**
+		 * @brief Updates an object stored as an oriented box
+		 * @param proxy Id returned by Insert()
+		 * @param shape New oriented box
+		 */
+		void Move(int proxy, const Obb& shape);
+
+		/**
+		 * @brief Updates an object stored as a sphere
+		 * @param proxy Id returned by Insert()
+		 * @param shape New sphere
+		 */
+		void Move(int proxy, const Sphere& shape);
+
+		/**
+		 * @brief Removes every object and node, keeping the pooled storage
+		 */
+		void Clear();
+
+		/**
+		 * @brief Number of nodes in use, including the root
+		 * @return Live node count
+		 */
+		int NodeCount() const;
+
+		/**
+		 * @brief Visits the objects whose bounds overlap a box
+		 * @param region Box to query
+		 * @param visit Called with each proxy id; returns true to stop the query
+		 * @return Proxy the query stopped at, or -1 if every object was visited
+		 */
+		int Query(const Aabb& region, const function<bool(int)>& visit) const;
+
+		/**
+		 * @brief Visits the objects whose bounds overlap an oriented box
+		 * @param region Oriented box to query
+		 * @param visit Called with each proxy id; returns true to stop the query
+		 * @return Proxy the query stopped at, or -1 if every object was visited
+		 */
+		int Query(const Obb& region, const function<bool(int)>& visit) const;
+
+		/**
+		 * @brief Visits the objects whose bounds overlap a sphere
+		 * @param region Sphere to query
+		 * @param visit Called with each proxy id; returns true to stop the query
+		 * @return Proxy the query stopped at, or -1 if every object was visited
+		 */
+		int Query(const Sphere& region, const function<bool(int)>& visit) const;
+
+		/**
+		 * @brief Finds the nearest object bounds hit by a ray
+		 * @param ray Ray to cast
+		 * @param distance Receives the distance to the nearest box (unchanged on a miss)
+		 * @param maxDistance Boxes entered beyond this distance are ignored
+		 * @return Proxy whose bounds are entered first, or -1 if none is hit
+		 */
+		int CastRay(const Ray& ray, float& distance, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		/**
+		 * @brief Finds the nearest object hit by a ray, with an exact test per object
+		 * @param ray Ray to cast
+		 * @param cast Called as cast(proxy, maxDistance) for objects whose bounds the ray enters;
+		 *             returns the hit distance, or a negative value on a miss
+		 * @param distance Receives the distance to the nearest hit (unchanged on a miss)
+		 * @param maxDistance Hits beyond this distance are ignored
+		 * @return Nearest proxy hit, or -1 if there is none
+		 *
+		 * Nodes are visited front to back and skipped once they start beyond
+		 * the nearest hit so far.
+		 */
+		int CastRay(const Ray& ray, const function<float(int, float)>& cast, float& distance, float maxDistance = std::numeric_limits<float>::infinity()) const;
+	};
+}
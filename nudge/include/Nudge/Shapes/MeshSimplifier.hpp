@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Nudge/Shapes/Mesh.hpp"
+
+#include <limits>
+#include <vector>
+
+using std::vector;
+
+namespace Nudge
+{
+	class Triangle;
+
+	/**
+	 * @brief Reduces the triangle count of a mesh by quadric-error edge collapses
+	 *
+	 * Follows Garland and Heckbert: every vertex accumulates the planes of
+	 * its triangles as a quadric, and the edge whose collapse moves the
+	 * surface least, measured as the summed squared distance of the new
+	 * vertex to those planes, is collapsed first. Triangles are welded by
+	 * exact vertex position first, since Mesh stores unindexed triangles.
+	 *
+	 * Collapses that would flip a triangle, or join two sheets of the
+	 * surface (more than two vertices shared by the edge's endpoints), are
+	 * skipped, so a closed manifold input stays closed and manifold. With
+	 * preserveBoundaries, every open edge adds a heavily weighted plane
+	 * through it, perpendicular to its triangle: boundary vertices may then
+	 * slide along the boundary but not away from it.
+	 */
+	class MeshSimplifier
+	{
+	public:
+		int targetTriangles;      ///< Stop once at most this many triangles remain, -1 for half the source's count
+		float maxError;           ///< Largest distance error accepted, compared against the square root of a collapse's quadric error
+		bool preserveBoundaries;  ///< Constrain vertices on open edges to stay on the boundary
+
+	public:
+		/**
+		 * @brief Default constructor halving the triangle count with no error limit
+		 */
+		MeshSimplifier();
+
+		/**
+		 * @brief Creates a simplifier
+		 * @param targetTriangles Stop once at most this many triangles remain (0 to rely on maxError only)
+		 * @param maxError Largest distance error accepted
+		 * @param preserveBoundaries Constrain vertices on open edges to stay on the boundary
+		 */
+		MeshSimplifier(int targetTriangles, float maxError = std::numeric_limits<float>::infinity(), bool preserveBoundaries = true);
+
+	public:
+		/**
+		 * @brief Simplifies a mesh into new triangle storage
+		 * @param source Mesh to simplify; left untouched
+		 * @param triangles Receives the simplified triangles, which the returned mesh points into
+		 * @param mode Acceleration structure built for the returned mesh
+		 * @return Accelerated mesh over triangles; release its structure with ReleaseAccelerator()
+		 *
+		 * Stops when the target count is reached, or earlier when every
+		 * remaining collapse exceeds maxError or is rejected. Triangles that
+		 * are degenerate in the source are dropped.
+		 */
+		Mesh Simplify(const Mesh& source, vector<Triangle>& triangles, BvhBuildMode mode = BvhBuildMode::Wide) const;
+	};
+}
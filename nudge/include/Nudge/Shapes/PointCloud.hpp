@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+using std::function;
+using std::span;
+using std::vector;
+
+// Most points held by a leaf of a PointCloud's tree
+constexpr int POINT_CLOUD_LEAF_SIZE = 8;
+
+namespace Nudge
+{
+	class Aabb;
+	class Ray;
+	class Sphere;
+
+	/**
+	 * @brief Node of a PointCloud's tree: the points in one range of slots and their bounds
+	 */
+	class PointCloudNode
+	{
+	public:
+		Vector3 min;  ///< Minimum corner of the points' bounds
+		Vector3 max;  ///< Maximum corner of the points' bounds
+		int begin;    ///< First slot of the node's points
+		int end;      ///< One past the last slot of the node's points
+
+	public:
+		/**
+		 * @brief Default constructor creating a node with no points
+		 */
+		PointCloudNode();
+	};
+
+	/**
+	 * @brief Set of points indexed by a balanced kd-tree for neighbour queries
+	 *
+	 * Points are reordered into slots so every node covers a contiguous
+	 * range, and stored as separate x, y and z arrays so leaf scans read
+	 * whole cache lines of one coordinate. The tree is complete and
+	 * implicit: node i has children 2i + 1 and 2i + 2, every leaf sits at
+	 * the same depth and holds at most POINT_CLOUD_LEAF_SIZE points. Each
+	 * node splits its points at the median along the longest axis of their
+	 * bounds.
+	 *
+	 * Queries report points by their index in the array the cloud was built
+	 * from; indices maps each slot back to it. The cloud holds no reference
+	 * to the input, which may be released after Build().
+	 */
+	class PointCloud
+	{
+	public:
+		vector<float> x;                ///< X coordinate per slot
+		vector<float> y;                ///< Y coordinate per slot
+		vector<float> z;                ///< Z coordinate per slot
+		vector<int> indices;            ///< Input index of the point in each slot
+		vector<PointCloudNode> nodes;   ///< Tree nodes, root at index 0
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty cloud
+		 */
+		PointCloud();
+
+		/**
+		 * @brief Creates a cloud over a set of points
+		 * @param points Points to index
+		 */
+		explicit PointCloud(span<const Vector3> points);
+
+	public:
+		/**
+		 * @brief Rebuilds the tree over a set of points
+		 * @param points Points to index
+		 *
+		 * Each level of the tree is split in parallel, one node per task.
+		 * Storage is reused, so rebuilding a cloud of the same size every
+		 * frame performs no reallocation.
+		 */
+		void Build(span<const Vector3> points);
+
+		/**
+		 * @brief Number of points in the cloud
+		 * @return Point count
+		 */
+		int Count() const;
+
+		/**
+		 * @brief Tests whether the cloud has any points
+		 * @return True if the cloud is empty
+		 */
+		bool IsEmpty() const;
+
+		/**
+		 * @brief Finds the points closest to a position
+		 * @param point Query position
+		 * @param neighbours Receives input indices, nearest first; its size is the number of neighbours wanted
+		 * @param distances Receives the distance to each neighbour (at least as large as neighbours)
+		 * @param maxDistance Points farther than this are ignored
+		 * @return Number of neighbours written, less than requested only if the cloud runs out of points in range
+		 */
+		int Nearest(const Vector3& point, span<int> neighbours, span<float> distances, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		/**
+		 * @brief Finds the k nearest points of many positions in parallel
+		 * @param points Query positions
+		 * @param k Neighbours per position
+		 * @param neighbours Receives k input indices per position, nearest first, -1 past the last found
+		 * @param distances Receives k distances per position, -1 past the last found
+		 * @return Total number of neighbours found
+		 *
+		 * Results are the same as calling Nearest() for each position. At
+		 * most min(neighbours.size(), distances.size()) / k positions are
+		 * queried.
+		 */
+		int NearestBatch(span<const Vector3> points, int k, span<int> neighbours, span<float> distances) const;
+
+		/**
+		 * @brief Visits the points inside a sphere
+		 * @param region Sphere to query
+		 * @param visit Called with each input index; returns true to stop the query
+		 * @return Input index the query stopped at, or -1 if every point was visited
+		 */
+		int Query(const Sphere& region, const function<bool(int)>& visit) const;
+
+		/**
+		 * @brief Visits the points inside a box
+		 * @param region Box to query
+		 * @param visit Called with each input index; returns true to stop the query
+		 * @return Input index the query stopped at, or -1 if every point was visited
+		 */
+		int Query(const Aabb& region, const function<bool(int)>& visit) const;
+
+		/**
+		 * @brief Finds the point closest to a ray
+		 * @param ray Ray to test
+		 * @param distance Receives the distance from the point to the ray (unchanged if the cloud is empty)
+		 * @param maxDistance Length of the ray; points are measured against the segment it spans
+		 * @return Input index of the closest point, or -1 if the cloud is empty
+		 *
+		 * Points behind the origin are measured to the origin. Subtrees are
+		 * skipped once the ray, grown by the best distance so far, no longer
+		 * enters their bounds.
+		 */
+		int NearestToRay(const Ray& ray, float& distance, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		/**
+		 * @brief Finds the point closest to each of many rays in parallel
+		 * @param rays Rays to test
+		 * @param nearest Receives the input index of the closest point per ray, -1 if the cloud is empty
+		 * @param distances Receives the distance from that point to the ray
+		 * @param maxDistance Length of every ray
+		 * @return Number of rays processed, min(rays.size(), nearest.size(), distances.size())
+		 */
+		int NearestToRayBatch(span<const Ray> rays, span<int> nearest, span<float> distances, float maxDistance = std::numeric_limits<float>::infinity()) const;
+	};
+}
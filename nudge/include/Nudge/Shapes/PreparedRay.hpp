@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+
+#include <limits>
+
+namespace Nudge
+{
+	class Aabb;
+	class Ray;
+
+	/**
+	 * @brief Ray or segment prepared for repeated slab tests against boxes
+	 *
+	 * Holds the reciprocal of the direction and its sign bits, so a box test
+	 * is six subtractions and multiplications with no division and no min/max
+	 * per axis: the sign bits pick which slab plane is entered first. A zero
+	 * direction component has an infinite reciprocal; the tests are written
+	 * so the NaN of an origin lying exactly on that slab plane is ignored.
+	 *
+	 * Distances are in units of the direction's length: for a prepared ray
+	 * with a unit direction they are world distances, for a prepared segment
+	 * they are fractions of the segment in [0, 1].
+	 */
+	class PreparedRay
+	{
+	public:
+		float origin[3];            ///< Ray origin
+		float direction[3];         ///< Ray direction, as given
+		float inverseDirection[3];  ///< Component-wise reciprocal of the direction
+		int sign[3];                ///< 1 where the direction component is negative, 0 otherwise
+		float maxDistance;          ///< Boxes entered beyond this distance are missed
+
+	public:
+		/**
+		 * @brief Prepares a segment from start to end
+		 * @param start First endpoint
+		 * @param end Second endpoint
+		 * @return Prepared ray with direction end - start and a maximum distance of 1
+		 */
+		static PreparedRay FromSegment(const Vector3& start, const Vector3& end);
+
+	public:
+		/**
+		 * @brief Default constructor creating a ray at the origin along positive Z
+		 */
+		PreparedRay();
+
+		/**
+		 * @brief Prepares a ray
+		 * @param ray Ray to prepare
+		 * @param maxDistance Boxes entered beyond this distance are missed
+		 */
+		explicit PreparedRay(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity());
+
+	public:
+		/**
+		 * @brief Computes where the ray's line enters and leaves a box
+		 * @param min Minimum corner of the box
+		 * @param max Maximum corner of the box
+		 * @param enter Receives the distance at which the line enters the box (may be negative)
+		 * @param exit Receives the distance at which the line leaves the box (may be negative)
+		 * @return True if the line passes through the box
+		 *
+		 * Ignores the origin and maximum distance, like the slab intervals of
+		 * Ray::CastAgainst(const Aabb&).
+		 */
+		bool Clip(const Vector3& min, const Vector3& max, float& enter, float& exit) const;
+
+		/**
+		 * @brief Slab test against a box given by its corners
+		 * @param min Minimum corner of the box
+		 * @param max Maximum corner of the box
+		 * @return Distance at which the ray enters the box (0 if it starts inside), or -1 if it misses
+		 *
+		 * Misses boxes behind the origin or entered beyond maxDistance. Boxes
+		 * touched exactly at an edge or corner count as hit, with a relative
+		 * tolerance of BVH_SLAB_TOLERANCE so rounding never loses them.
+		 */
+		float Enter(const Vector3& min, const Vector3& max) const;
+
+		/**
+		 * @brief Slab test against an axis-aligned box
+		 * @param box Box to test
+		 * @return Distance at which the ray enters the box (0 if it starts inside), or -1 if it misses
+		 */
+		float Enter(const Aabb& box) const;
+
+		/**
+		 * @brief Slab test against many boxes
+		 * @param boxes Boxes to test
+		 * @param count Number of boxes
+		 * @param entries Receives each box's entry distance, or -1 where it is missed (count floats)
+		 * @return Number of boxes hit
+		 *
+		 * Written as straight-line arithmetic with selects, so the compiler can
+		 * vectorize it across boxes.
+		 */
+		int Enter(const Aabb* boxes, int count, float* entries) const;
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Nudge
+{
+	/**
+	 * @brief Remembers the triangle a repeated mesh query found last time
+	 *
+	 * Queries that are issued again every frame with nearly the same ray or
+	 * shape (sensors, character probes) usually find the same triangle. A
+	 * query given one of these tests that triangle before traversing:
+	 * - Ray casts use its hit distance as the initial bound, so traversal
+	 *   skips every node beyond it
+	 * - Overlap queries accept immediately if it still overlaps
+	 *
+	 * Results are the same as without the hint. A stale hint (moved geometry,
+	 * rebuilt mesh, index out of range) only costs one triangle test. Each
+	 * query stream should own its hint; one hint must not be shared between
+	 * threads.
+	 */
+	class QueryCoherence
+	{
+	public:
+		int triangle;     ///< Triangle found by the last query, -1 if none yet
+		uint64_t hits;    ///< Queries where the remembered triangle was hit or still overlapped
+		uint64_t misses;  ///< Queries where it was not, or no triangle was remembered
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty hint with zeroed counters
+		 */
+		QueryCoherence();
+
+	public:
+		/**
+		 * @brief Fraction of queries answered or bounded by the remembered triangle
+		 * @return hits / (hits + misses), or 0 before the first query
+		 */
+		float HitRate() const;
+
+		/**
+		 * @brief Forgets the remembered triangle and zeroes the counters
+		 */
+		void Reset();
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+using std::function;
+using std::uint32_t;
+
+// Filter mask matching triangles with any flag set
+constexpr uint32_t QUERY_FILTER_ALL = 0xFFFFFFFFu;
+
+namespace Nudge
+{
+	class Mesh;
+
+	/**
+	 * @brief Selects which triangles of a mesh a ray or overlap query may report
+	 *
+	 * A triangle passes when its Mesh::flags share at least one bit with mask
+	 * and, if set, accept returns true for its index. Triangles that fail are
+	 * treated as absent: a ray carries on to the next hit behind them and an
+	 * overlap query keeps looking, so nothing needs to be re-cast.
+	 *
+	 * The mask is also tested against the flags aggregated per hierarchy node
+	 * (see Mesh::RefreshFlags()), so subtrees without a single matching
+	 * triangle are skipped whole. The callback only sees triangles that pass
+	 * the mask, before their exact test. Meshes without flags match any mask.
+	 */
+	class QueryFilter
+	{
+	public:
+		uint32_t mask;                 ///< Triangles pass when their flags share a bit with this
+		function<bool(int)> accept;    ///< Optional final say on each triangle index, empty to accept all
+
+	public:
+		/**
+		 * @brief Default constructor creating a filter that passes every triangle
+		 */
+		QueryFilter();
+
+		/**
+		 * @brief Creates a filter from a mask and an optional callback
+		 * @param mask Flags a triangle needs at least one of
+		 * @param accept Called with each triangle index passing the mask; false skips the triangle
+		 */
+		QueryFilter(uint32_t mask, function<bool(int)> accept = nullptr);
+
+	public:
+		/**
+		 * @brief Tests whether a subtree with the given aggregated flags may hold a passing triangle
+		 * @param flags Bitwise OR of the flags of every triangle in the subtree
+		 * @return True if the subtree must be visited
+		 */
+		bool Matches(uint32_t flags) const;
+
+		/**
+		 * @brief Tests whether one triangle of a mesh passes the filter
+		 * @param mesh Mesh owning the triangle
+		 * @param triangle Triangle index
+		 * @return True if queries may report the triangle
+		 */
+		bool Accepts(const Mesh& mesh, int triangle) const;
+	};
+}
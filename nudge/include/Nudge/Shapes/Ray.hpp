@@ -2,15 +2,35 @@
 
 #include "Nudge/Maths/Vector3.hpp"
 
+#include <limits>
+#include <span>
+
+using std::span;
+
 namespace Nudge
 {
 	class Aabb;
+	class Compound;
+	class Heightfield;
 	class Mesh;
 	class Obb;
 	class Plane;
+	class QueryCoherence;
+	class QueryFilter;
+	class Shape;
 	class Sphere;
 	class Triangle;
 
+	/**
+	 * @brief One intersection reported by a multi-hit ray query
+	 */
+	class RayHit
+	{
+	public:
+		float distance; ///< Distance along the ray to the hit
+		int triangle;   ///< Index of the hit triangle in the mesh's triangle array
+	};
+
 	/**
 	 * @brief Represents a ray in 3D space with an origin point and direction vector
 	 *
@@ -31,6 +51,26 @@ namespace Nudge
 		 */
 		static Ray FromPoints(const Vector3& from, const Vector3& to);
 
+		/**
+		 * @brief Casts many rays against a mesh in parallel
+		 * @param mesh Mesh to test intersection against
+		 * @param rays Rays to cast
+		 * @param results Receives the nearest hit of each ray at the ray's index ({ -1, -1 } for a miss)
+		 * @param sortForCoherence Trace rays in an order that groups similar origins and directions
+		 * @param coherence Optional per-ray hints, at the ray's index, for rays repeated every frame
+		 * @return Number of rays that hit the mesh
+		 *
+		 * Splits the batch across all hardware threads, handing out small blocks
+		 * of rays dynamically so expensive rays do not stall one thread. Each
+		 * thread traverses with its own fixed-size stack; nothing is allocated
+		 * per ray. Sorting for coherence costs one sort of the batch and pays off
+		 * for large batches of scattered rays. Results are the same as calling
+		 * CastAgainst(mesh) for each ray. At most min(rays.size(), results.size())
+		 * rays are cast. When coherence hints are given, rays beyond
+		 * coherence.size() are cast without one.
+		 */
+		static int CastBatch(const Mesh& mesh, span<const Ray> rays, span<RayHit> results, bool sortForCoherence = false, span<QueryCoherence> coherence = {});
+
 	public:
 		Vector3 origin;     ///< Starting point of the ray in 3D space
 		Vector3 direction;  ///< Direction vector of the ray (should be normalized for most operations)
@@ -78,8 +118,73 @@ namespace Nudge
 		 */
 		float CastAgainst(const Aabb& other) const;
 
+		/**
+		 * @brief Casts the ray against every child of a compound body
+		 * @param other Compound to test intersection against
+		 * @return Distance along ray to the nearest child hit, or -1 if no intersection
+		 */
+		float CastAgainst(const Compound& other) const;
+
+		/**
+		 * @brief Casts the ray against the upper side of a heightfield
+		 * @param other Heightfield to test intersection against
+		 * @return Distance along ray to intersection point, or -1 if no intersection
+		 */
+		float CastAgainst(const Heightfield& other) const;
+
 		float CastAgainst(const Mesh& other) const;
 
+		/**
+		 * @brief Performs ray-mesh intersection, starting from the triangle hit last time
+		 * @param other Mesh to test intersection against
+		 * @param coherence Hint updated with the triangle hit and the hint's hit or miss
+		 * @return Distance to the nearest intersection point, or -1 if no intersection
+		 *
+		 * Casts against the remembered triangle first; when it is hit, its
+		 * distance bounds the traversal so only nodes in front of it are
+		 * visited. The result is the same as CastAgainst(other). A miss keeps
+		 * the remembered triangle.
+		 */
+		float CastAgainst(const Mesh& other, QueryCoherence& coherence) const;
+
+		/**
+		 * @brief Finds every triangle of a mesh the ray hits, nearest first
+		 * @param other Mesh to test intersection against
+		 * @param hits Caller-provided buffer receiving the hits sorted by distance
+		 * @param capacity Size of the buffer; when more triangles are hit, the nearest ones are kept
+		 * @param maxDistance Hits farther along the ray than this are ignored
+		 * @return Number of hits written to the buffer
+		 *
+		 * Performs one traversal of the mesh's acceleration structure and never
+		 * allocates. Each triangle is reported at most once, even when the
+		 * structure references it from several nodes. Like the single-hit cast,
+		 * only front faces are hit.
+		 */
+		int CastAgainst(const Mesh& other, RayHit* hits, int capacity, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		/**
+		 * @brief Performs ray-mesh intersection against the triangles passing a filter
+		 * @param other Mesh to test intersection against
+		 * @param filter Selects the triangles that may be hit; the ray passes through the others
+		 * @return Distance to the nearest accepted intersection point, or -1 if no intersection
+		 *
+		 * Unlike filtering the result of CastAgainst(other), a rejected triangle
+		 * in front does not hide an accepted one behind it, and subtrees without
+		 * a matching flag are never opened.
+		 */
+		float CastAgainst(const Mesh& other, const QueryFilter& filter) const;
+
+		/**
+		 * @brief Finds every triangle passing a filter the ray hits, nearest first
+		 * @param other Mesh to test intersection against
+		 * @param filter Selects the triangles that may be hit
+		 * @param hits Caller-provided buffer receiving the hits sorted by distance
+		 * @param capacity Size of the buffer; only the nearest capacity hits are kept
+		 * @param maxDistance Hits farther than this are ignored
+		 * @return Number of hits written to the buffer
+		 */
+		int CastAgainst(const Mesh& other, const QueryFilter& filter, RayHit* hits, int capacity, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
 		/**
 		 * @brief Performs ray-OBB intersection test
 		 * @param other Oriented Bounding Box to test intersection against
@@ -94,6 +199,13 @@ namespace Nudge
 		 */
 		float CastAgainst(const Plane& other) const;
 
+		/**
+		 * @brief Casts the ray against whichever primitive a shape holds
+		 * @param other Shape to test intersection against
+		 * @return Distance along ray to intersection point, or -1 if no intersection
+		 */
+		float CastAgainst(const Shape& other) const;
+
 		/**
 		 * @brief Performs ray-sphere intersection test
 		 * @param other Sphere to test intersection against
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Line.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Plane.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <cstdint>
+#include <span>
+#include <variant>
+
+using std::span;
+using std::uint8_t;
+using std::variant;
+
+// Number of alternatives a Shape can hold, the side of its dispatch tables
+constexpr int SHAPE_TYPE_COUNT = 6;
+
+namespace Nudge
+{
+	class Ray;
+
+	/**
+	 * @brief Kind of primitive held by a Shape, in the order of Shape::Storage
+	 */
+	enum class ShapeType : uint8_t
+	{
+		Sphere,
+		Aabb,
+		Obb,
+		Triangle,
+		Plane,
+		Line
+	};
+
+	/**
+	 * @brief Two shapes to test, as indices into a shape array
+	 */
+	class ShapePair
+	{
+	public:
+		int first;   ///< Index of the first shape
+		int second;  ///< Index of the second shape
+	};
+
+	/**
+	 * @brief Any one of the primitive shapes, with pairwise queries dispatched by type
+	 *
+	 * Generic code over heterogeneous shapes (a broadphase's output, a list of
+	 * trigger volumes) can hold Shape values and call Intersects(), Distance()
+	 * or CastRay() without a switch of its own. Each query looks its function
+	 * up in a SHAPE_TYPE_COUNT x SHAPE_TYPE_COUNT table of plain function
+	 * pointers generated at compile time, one entry per pair of types, that
+	 * forwards to the primitives' own overloads (Intersects(), Line::Test(),
+	 * Ray::CastAgainst()).
+	 *
+	 * The batch queries go one step further: pairs are bucketed by their two
+	 * types first, and each bucket runs through a loop specialized for those
+	 * types, so the per-pair work is the exact test alone.
+	 *
+	 * Distances between convex shapes come from GJK on the shapes' support
+	 * points; spheres are treated as a point plus a margin and planes are
+	 * measured against the other shape's extreme points along the normal.
+	 */
+	class Shape
+	{
+	public:
+		using Storage = variant<Sphere, Aabb, Obb, Triangle, Plane, Line>;
+
+	public:
+		Storage value;  ///< Primitive held, its alternative index matching ShapeType
+
+	public:
+		/**
+		 * @brief Default constructor holding a default sphere
+		 */
+		Shape();
+
+		/**
+		 * @brief Creates a shape holding a sphere
+		 * @param sphere Sphere to hold
+		 */
+		Shape(const Sphere& sphere);
+
+		/**
+		 * @brief Creates a shape holding an axis-aligned box
+		 * @param box Box to hold
+		 */
+		Shape(const Aabb& box);
+
+		/**
+		 * @brief Creates a shape holding an oriented box
+		 * @param box Box to hold
+		 */
+		Shape(const Obb& box);
+
+		/**
+		 * @brief Creates a shape holding a triangle
+		 * @param triangle Triangle to hold
+		 */
+		Shape(const Triangle& triangle);
+
+		/**
+		 * @brief Creates a shape holding a plane
+		 * @param plane Plane to hold
+		 */
+		Shape(const Plane& plane);
+
+		/**
+		 * @brief Creates a shape holding a line segment
+		 * @param line Segment to hold
+		 */
+		Shape(const Line& line);
+
+	public:
+		/**
+		 * @brief Tests a batch of pairs, bucketed by type
+		 * @param shapes Shapes the pairs index into
+		 * @param pairs Pairs to test
+		 * @param overlaps Receives 1 for each pair that intersects, 0 otherwise, at the pair's index
+		 * @return Number of pairs that intersect
+		 *
+		 * Results are the same as calling Intersects() for each pair. At most
+		 * min(pairs.size(), overlaps.size()) pairs are tested, split across
+		 * all hardware threads.
+		 */
+		static int IntersectsBatch(span<const Shape> shapes, span<const ShapePair> pairs, span<uint8_t> overlaps);
+
+		/**
+		 * @brief Measures a batch of pairs, bucketed by type
+		 * @param shapes Shapes the pairs index into
+		 * @param pairs Pairs to measure
+		 * @param distances Receives the distance of each pair, at the pair's index
+		 * @return Number of pairs measured, min(pairs.size(), distances.size())
+		 *
+		 * Results are the same as calling Distance() for each pair.
+		 */
+		static int DistanceBatch(span<const Shape> shapes, span<const ShapePair> pairs, span<float> distances);
+
+	public:
+		/**
+		 * @brief Kind of primitive held
+		 * @return Type matching the active alternative of value
+		 */
+		ShapeType Type() const;
+
+		/**
+		 * @brief Tests whether two shapes touch
+		 * @param other Shape to test
+		 * @return True if the shapes intersect
+		 *
+		 * Uses the primitives' own test for the pair; two segments, which have
+		 * none, touch when their distance is within a small tolerance.
+		 */
+		bool Intersects(const Shape& other) const;
+
+		/**
+		 * @brief Separation between two shapes
+		 * @param other Shape to measure against
+		 * @return Smallest distance between any two points of the shapes, 0 if they overlap
+		 */
+		float Distance(const Shape& other) const;
+
+		/**
+		 * @brief Casts a ray against the shape
+		 * @param ray Ray to cast
+		 * @return Distance along the ray to the hit, or -1 if there is none (always for segments)
+		 */
+		float CastRay(const Ray& ray) const;
+	};
+}
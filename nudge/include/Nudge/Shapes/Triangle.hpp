@@ -2,9 +2,14 @@
 
 #include "Nudge/Maths/Vector3.hpp"
 
+#include <span>
+
+using std::span;
+
 namespace Nudge
 {
 	class Aabb;
+	class Line;
 	class Obb;
 	class Plane;
 	class Sphere;
@@ -25,6 +30,20 @@ namespace Nudge
 	 */
 	class Triangle
 	{
+	public:
+		/**
+		 * @brief Tests one triangle against many
+		 * @param triangle Triangle to test
+		 * @param others Triangles to test it against
+		 * @param hits Receives the indices (into others) of the triangles that intersect it, in order
+		 * @return Number of indices written; stops early once hits is full
+		 *
+		 * The plane of the single triangle is computed once, and most
+		 * candidates are rejected by the side of that plane their vertices
+		 * lie on before anything is computed for them.
+		 */
+		static int IntersectsBatch(const Triangle& triangle, span<const Triangle> others, span<int> hits);
+
 	public:
 		/**
 		 * @brief Union providing multiple access patterns for triangle vertices
@@ -141,11 +160,27 @@ namespace Nudge
 		 * @param other Triangle to test intersection against
 		 * @return True if the triangles intersect, touch, or overlap
 		 *
-		 * Triangle-triangle intersection is complex and may involve:
-		 * - Edge-edge intersections
-		 * - Vertex-triangle containment
-		 * - Coplanar triangle overlap testing
+		 * Uses the interval overlap test of Moller ("A Fast Triangle-Triangle
+		 * Intersection Test"): each triangle is first rejected against the
+		 * other's plane, and only triangles straddling both planes compare
+		 * their intervals on the planes' line of intersection. Coplanar
+		 * triangles are tested with edge crossings and vertex containment in 2D.
+		 * Degenerate triangles fall back to Interval::TriangleTriangle().
 		 */
 		bool Intersects(const Triangle& other) const;
+
+		/**
+		 * @brief Tests if this triangle intersects another and computes where
+		 * @param other Triangle to test intersection against
+		 * @param segment Receives the segment the triangles share
+		 * @return True if the triangles intersect, touch, or overlap
+		 *
+		 * The segment is degenerate (start == end) when the triangles only touch
+		 * at a point. Coplanar triangles overlap in an area rather than a
+		 * segment; the segment is then degenerate at one point of the overlap.
+		 * The segment is left unchanged when the triangles do not intersect or
+		 * either triangle is degenerate.
+		 */
+		bool Intersects(const Triangle& other, Line& segment) const;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+
+#include <vector>
+
+using std::vector;
+
+namespace Nudge
+{
+	class Triangle;
+
+	/**
+	 * @brief Per-triangle data precomputed for the mesh query kernels, stored structure-of-arrays
+	 *
+	 * Holds for every triangle its first vertex, the two edges leaving it, the
+	 * (unnormalized) face normal with its plane distance, and the dot products
+	 * and inverse denominator of the barycentric solve. The ray, box and sphere
+	 * tests below then need no cross products, normalization or division.
+	 *
+	 * Takes 68 bytes per triangle on top of the 36 of the triangle itself.
+	 * The cache is a snapshot: it must be rebuilt whenever vertices move.
+	 */
+	class TriangleCache
+	{
+	public:
+		vector<float> ax, ay, az;       ///< First vertex (a)
+		vector<float> e0x, e0y, e0z;    ///< First edge (b - a)
+		vector<float> e1x, e1y, e1z;    ///< Second edge (c - a)
+		vector<float> nx, ny, nz;       ///< Face normal, cross(b - a, c - a), not normalized
+		vector<float> distance;         ///< Plane distance, dot(normal, a)
+		vector<float> d00, d01, d11;    ///< Edge dot products: e0.e0, e0.e1, e1.e1
+		vector<float> inverseDenominator; ///< 1 / (d00 * d11 - d01 * d01), 0 for degenerate triangles
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty cache
+		 */
+		TriangleCache();
+
+	public:
+		/**
+		 * @brief Recomputes the cache from triangle data
+		 * @param triangles Triangles to precompute
+		 * @param count Number of triangles
+		 */
+		void Build(const Triangle* triangles, int count);
+
+		/**
+		 * @brief Removes all cached data
+		 */
+		void Clear();
+
+		/**
+		 * @brief Number of triangles in the cache
+		 * @return Cached triangle count
+		 */
+		int Count() const;
+
+		/**
+		 * @brief Casts a ray against one cached triangle
+		 * @param index Triangle index
+		 * @param origin Ray origin
+		 * @param direction Ray direction
+		 * @return Distance along the ray to the hit, or -1 if no intersection
+		 *
+		 * Same semantics as Ray::CastAgainst(const Triangle&): only hits on the
+		 * front face (the side the normal points to) are reported.
+		 */
+		float CastRay(int index, const Vector3& origin, const Vector3& direction) const;
+
+		/**
+		 * @brief Tests one cached triangle against an axis-aligned box
+		 * @param index Triangle index
+		 * @param center Center of the box
+		 * @param extents Half-extents of the box
+		 * @return True if the triangle and box overlap
+		 */
+		bool IntersectsAabb(int index, const Vector3& center, const Vector3& extents) const;
+
+		/**
+		 * @brief Tests one cached triangle against a sphere
+		 * @param index Triangle index
+		 * @param center Center of the sphere
+		 * @param radius Radius of the sphere
+		 * @return True if the closest point of the triangle lies strictly inside the sphere
+		 */
+		bool IntersectsSphere(int index, const Vector3& center, float radius) const;
+	};
+}
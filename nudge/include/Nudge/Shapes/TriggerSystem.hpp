@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/LooseOctree.hpp"
+#include "Nudge/Shapes/Shape.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using std::span;
+using std::uint8_t;
+using std::vector;
+
+namespace Nudge
+{
+	/**
+	 * @brief Change of overlap state reported by TriggerSystem::Update()
+	 */
+	enum class TriggerEventType : uint8_t
+	{
+		Enter,  ///< The body started overlapping the trigger
+		Exit    ///< The body stopped overlapping the trigger, or one of them was removed
+	};
+
+	/**
+	 * @brief One trigger/body pair whose overlap state changed
+	 */
+	class TriggerEvent
+	{
+	public:
+		int trigger;            ///< Id of the trigger volume
+		int body;               ///< Id of the body
+		TriggerEventType type;  ///< Whether the pair started or stopped overlapping
+	};
+
+	/**
+	 * @brief Trigger or body tracked by a TriggerSystem, stored by id in TriggerSystem::volumes
+	 */
+	class TriggerVolume
+	{
+	public:
+		Aabb bounds;           ///< Box enclosing the shape
+		int proxy;             ///< Proxy in the tree of its kind
+		int stamp;             ///< Scratch mark used by Update()
+		bool isTrigger;        ///< Trigger (true) or body (false)
+		bool live;             ///< False once removed, until the next Update() frees the id
+		bool dirty;            ///< Added, moved or removed since the last Update()
+		vector<int> overlaps;  ///< Ids of the volumes of the other kind it currently overlaps
+
+	public:
+		/**
+		 * @brief Default constructor creating a free slot
+		 */
+		TriggerVolume();
+	};
+
+	/**
+	 * @brief Tracks which bodies overlap which trigger volumes, and reports the changes
+	 *
+	 * Triggers (gameplay regions) and bodies (the things that walk into them)
+	 * each live in their own LooseOctree. Add, move and remove only update the
+	 * tree and mark the volume as changed; the work happens in Update():
+	 * 1. A removed volume leaves every pair it was part of
+	 * 2. Each changed volume queries the other kind's tree with its bounds.
+	 *    Existing pairs whose bounds no longer touch exit right away
+	 * 3. The remaining candidates go through one Shape::IntersectsBatch() call
+	 * 4. Pairs whose result differs from the stored state enter or exit
+	 *
+	 * Pairs in which neither volume changed are never re-tested, so a frame
+	 * in which a few bodies move costs a few tree queries instead of a pass
+	 * over every trigger. Triggers never pair with triggers, nor bodies with
+	 * bodies.
+	 *
+	 * Shapes are any bounded Shape (not Plane). Ids are shared by both kinds
+	 * and stay valid until the Update() after the volume is removed.
+	 */
+	class TriggerSystem
+	{
+	public:
+		vector<Shape> shapes;          ///< Shape of each volume, indexed by id
+		vector<TriggerVolume> volumes; ///< State of each volume, indexed by id
+		vector<int> freeVolumes;       ///< Ids free for reuse
+		vector<int> changed;           ///< Ids added, moved or removed since the last Update()
+		LooseOctree triggerTree;       ///< Bounds of the live triggers
+		LooseOctree bodyTree;          ///< Bounds of the live bodies
+		vector<int> triggerOwners;     ///< Volume id of each trigger tree proxy
+		vector<int> bodyOwners;        ///< Volume id of each body tree proxy
+		vector<ShapePair> candidates;  ///< Update() scratch: trigger/body pairs to test
+		vector<uint8_t> previous;      ///< Update() scratch: whether each candidate overlapped before
+		vector<uint8_t> results;       ///< Update() scratch: whether each candidate overlaps now
+		int epoch;                     ///< Last stamp handed out by Update()
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty system over the default LooseOctree region
+		 */
+		TriggerSystem();
+
+		/**
+		 * @brief Creates an empty system whose trees cover a cubic region
+		 * @param center Center of the region
+		 * @param halfSize Half the edge length of the region
+		 */
+		TriggerSystem(const Vector3& center, float halfSize);
+
+	public:
+		/**
+		 * @brief Adds a trigger volume
+		 * @param shape Region of the trigger
+		 * @return Id of the trigger, or -1 if the shape is unbounded
+		 */
+		int AddTrigger(const Shape& shape);
+
+		/**
+		 * @brief Adds a body that can enter triggers
+		 * @param shape Shape of the body
+		 * @return Id of the body, or -1 if the shape is unbounded
+		 */
+		int AddBody(const Shape& shape);
+
+		/**
+		 * @brief Changes the shape of a trigger or body
+		 * @param id Id returned by AddTrigger() or AddBody(); unknown or removed ids are ignored
+		 * @param shape New shape; unbounded shapes are ignored
+		 *
+		 * Only this volume's pairs are re-tested by the next Update().
+		 */
+		void Move(int id, const Shape& shape);
+
+		/**
+		 * @brief Removes a trigger or body
+		 * @param id Id returned by AddTrigger() or AddBody(); unknown or removed ids are ignored
+		 *
+		 * The next Update() reports an exit for every pair it was part of and
+		 * frees the id.
+		 */
+		void Remove(int id);
+
+		/**
+		 * @brief Re-tests the pairs of every volume changed since the last call and reports the differences
+		 * @param events Receives one event per pair that entered or exited, appended
+		 * @return Number of events appended
+		 *
+		 * Exits caused by removals come first, then exits of pairs whose
+		 * bounds came apart, then the outcome of the exact tests; within each
+		 * group, changed volumes are taken in the order they were changed.
+		 */
+		int Update(vector<TriggerEvent>& events);
+
+		/**
+		 * @brief Tests whether a body overlapped a trigger at the last Update()
+		 * @param trigger Trigger id
+		 * @param body Body id
+		 * @return True if the pair is in the overlapping state
+		 */
+		bool Overlaps(int trigger, int body) const;
+
+		/**
+		 * @brief Volumes of the other kind a volume overlapped at the last Update()
+		 * @param id Trigger or body id
+		 * @return Ids of the bodies in a trigger, or of the triggers a body is in (empty for unknown ids)
+		 */
+		span<const int> Overlapping(int id) const;
+	};
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+using std::size_t;
+using std::span;
+using std::uint64_t;
+using std::vector;
+
+// Voxels along each side of a brick; a brick's occupancy fits one 64-bit mask
+constexpr int VOXEL_GRID_BRICK_SIZE = 4;
+
+namespace Nudge
+{
+	class Mesh;
+	class Ray;
+	class Triangle;
+
+	/**
+	 * @brief Sparse occupancy grid of the voxels touched by a set of triangles
+	 *
+	 * Voxel (x, y, z) covers origin + [x, x + 1) * voxelSize, and likewise
+	 * on y and z. Voxels are grouped into bricks of VOXEL_GRID_BRICK_SIZE
+	 * cubed, each stored as one 64-bit mask with bit x + 4 * y + 16 * z for
+	 * the voxel at (x, y, z) inside the brick. Only bricks holding at least
+	 * one occupied voxel get a mask; the rest are -1 in brickIndices.
+	 *
+	 * A voxel is occupied if any triangle touches its box, slightly
+	 * enlarged, so the grid is conservative: every point of every triangle
+	 * lies in an occupied voxel. Ray casts and box queries against the grid
+	 * can therefore reject work before exact Mesh queries, but may report
+	 * occupancy the triangles themselves do not reach.
+	 */
+	class VoxelGrid
+	{
+	public:
+		Vector3 origin;                ///< Minimum corner of voxel (0, 0, 0)
+		float voxelSize;               ///< Edge length of a voxel
+		int size[3];                   ///< Voxels along each axis, a multiple of VOXEL_GRID_BRICK_SIZE
+		int bricks[3];                 ///< Bricks along each axis
+		vector<int> brickIndices;      ///< Mask index per brick, x fastest, -1 where empty
+		vector<uint64_t> masks;        ///< Occupancy of each non-empty brick
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty grid
+		 */
+		VoxelGrid();
+
+		/**
+		 * @brief Voxelizes triangles
+		 * @param triangles Triangles to voxelize
+		 * @param voxelSize Edge length of a voxel
+		 *
+		 * The grid covers the bounds of the triangles. Bricks are filled in
+		 * parallel, one layer of bricks along z per task. No triangles or a
+		 * non-positive voxel size leave the grid empty.
+		 */
+		VoxelGrid(span<const Triangle> triangles, float voxelSize);
+
+		/**
+		 * @brief Voxelizes the triangles of a mesh
+		 * @param mesh Mesh to voxelize
+		 * @param voxelSize Edge length of a voxel
+		 */
+		VoxelGrid(const Mesh& mesh, float voxelSize);
+
+	public:
+		/**
+		 * @brief Tests whether the grid has any voxels
+		 * @return True if the grid was not built from valid input
+		 */
+		bool IsEmpty() const;
+
+		/**
+		 * @brief Tests whether a voxel is occupied
+		 * @param x Voxel column
+		 * @param y Voxel row
+		 * @param z Voxel layer
+		 * @return True if the voxel is inside the grid and occupied
+		 */
+		bool IsOccupied(int x, int y, int z) const;
+
+		/**
+		 * @brief Tests whether the voxel containing a point is occupied
+		 * @param point World position
+		 * @return True if the point lies in an occupied voxel
+		 */
+		bool IsOccupied(const Vector3& point) const;
+
+		/**
+		 * @brief Number of occupied voxels
+		 * @return Sum of the population counts of every brick
+		 */
+		int OccupiedCount() const;
+
+		/**
+		 * @brief Box enclosing the whole grid
+		 * @return World-space bounds
+		 */
+		Aabb Bounds() const;
+
+		/**
+		 * @brief Tests whether any voxel touching a box is occupied
+		 * @param region World-space box
+		 * @return True if the region may contain geometry
+		 */
+		bool Overlaps(const Aabb& region) const;
+
+		/**
+		 * @brief Counts the occupied voxels touching a box
+		 * @param region World-space box
+		 * @return Number of occupied voxels overlapping the region
+		 */
+		int CountOccupied(const Aabb& region) const;
+
+		/**
+		 * @brief Finds the first occupied voxel along a ray
+		 * @param ray Ray to cast
+		 * @param maxDistance Voxels entered beyond this distance are ignored
+		 * @return Distance at which the ray enters the voxel (0 if it starts inside), or -1 if there is none
+		 *
+		 * Steps through bricks in the order the ray crosses them, skipping
+		 * empty ones, then through the voxels of each occupied brick
+		 * (Amanatides and Woo). Since the grid is conservative, no triangle
+		 * is hit before the returned distance, and a miss means no triangle
+		 * is hit at all.
+		 */
+		float CastRay(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		/**
+		 * @brief Memory held by the brick indices and masks
+		 * @return Size in bytes
+		 */
+		size_t ByteSize() const;
+	};
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Nudge/Shapes/AABB.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using std::uint32_t;
+using std::uint8_t;
+using std::vector;
+
+// Children per wide node. Eight float lanes fill one AVX register, so a node's
+// child boxes are laid out to be tested against a ray in a single pass.
+constexpr int WIDE_BVH_WIDTH = 8;
+
+// Largest subtree folded into a single leaf slot when collapsing
+constexpr int WIDE_BVH_LEAF_SIZE = 4;
+
+namespace Nudge
+{
+	class PreparedRay;
+
+	class LinearBvh;
+
+	/**
+	 * @brief Node of a WideBvh holding up to WIDE_BVH_WIDTH children
+	 *
+	 * Child bounds are stored structure-of-arrays and quantized to 8 bits per
+	 * plane relative to this node's own box: child i spans
+	 * origin + lower[axis][i] * scale to origin + upper[axis][i] * scale.
+	 * Quantization always rounds outwards, so decoded boxes are conservative.
+	 * A node takes 112 bytes where the equivalent binary subtree of seven
+	 * LinearBvhNode takes 224.
+	 *
+	 * Slot encoding:
+	 * - Internal child: count[i] == 0 and child[i] is the index of a WideBvhNode
+	 * - Leaf child: count[i] > 0 and child[i] is the first slot in WideBvh::indices
+	 * - Empty slot: child[i] == -1, masked out of every test
+	 */
+	class WideBvhNode
+	{
+	public:
+		Vector3 origin;                           ///< Minimum corner of this node's bounds (quantization origin)
+		Vector3 scale;                            ///< World size of one quantization step on each axis
+		uint8_t lower[3][WIDE_BVH_WIDTH];         ///< Quantized minimum plane of each child, per axis
+		uint8_t upper[3][WIDE_BVH_WIDTH];         ///< Quantized maximum plane of each child, per axis
+		int child[WIDE_BVH_WIDTH];                ///< Node index (internal) or first primitive slot (leaf)
+		uint8_t count[WIDE_BVH_WIDTH];            ///< Primitive count for leaf slots, 0 otherwise
+
+	public:
+		/**
+		 * @brief Default constructor creating a node with every slot empty
+		 */
+		WideBvhNode();
+
+	public:
+		/**
+		 * @brief Tests whether a slot references primitives rather than a node
+		 * @param slot Child slot in [0, WIDE_BVH_WIDTH)
+		 * @return True for leaf slots
+		 */
+		bool IsLeaf(int slot) const;
+
+		/**
+		 * @brief Tests whether a slot is unused
+		 * @param slot Child slot in [0, WIDE_BVH_WIDTH)
+		 * @return True if the slot references nothing
+		 */
+		bool IsEmpty(int slot) const;
+
+		/**
+		 * @brief Decodes the conservative bounds of one child
+		 * @param slot Child slot in [0, WIDE_BVH_WIDTH)
+		 * @return Dequantized child bounds
+		 */
+		Aabb ChildBounds(int slot) const;
+
+		/**
+		 * @brief Slab-tests a ray against every child box at once
+		 * @param ray Prepared ray to test
+		 * @param maxDistance Hits entering beyond this distance are rejected
+		 * @param entries Receives the entry distance of each child (WIDE_BVH_WIDTH floats)
+		 * @return Bit mask with bit i set if child i is hit
+		 *
+		 * The ray's sign bits select the near and far quantized planes per axis,
+		 * so the eight children are tested with straight-line arithmetic.
+		 */
+		int IntersectChildren(const PreparedRay& ray, float maxDistance, float* entries) const;
+
+		/**
+		 * @brief Tests a box against every child box at once
+		 * @param min Minimum corner of the query box
+		 * @param max Maximum corner of the query box
+		 * @return Bit mask with bit i set if child i overlaps the box
+		 */
+		int OverlapChildren(const Vector3& min, const Vector3& max) const;
+	};
+
+	/**
+	 * @brief Bounding Volume Hierarchy with WIDE_BVH_WIDTH children per node
+	 *
+	 * Produced by collapsing a binary LinearBvh: starting from each binary
+	 * node, the child with the largest surface area is repeatedly replaced by
+	 * its own two children until the wide node is full. Subtrees of at most
+	 * WIDE_BVH_LEAF_SIZE primitives become a single leaf slot. The root is
+	 * always nodes[0].
+	 *
+	 * The hierarchy is self-contained once built, so the binary source can be
+	 * discarded.
+	 */
+	class WideBvh
+	{
+	public:
+		vector<WideBvhNode> nodes;  ///< Node storage, root at index 0
+		vector<int> indices;        ///< Primitive indices referenced by leaf slots, empty if primitives are stored in leaf order
+		vector<uint32_t> masks;     ///< Bitwise OR of the flags below each child slot (WIDE_BVH_WIDTH per node), empty unless built with BuildMasks()
+		vector<int> rangeFirst;     ///< Collapse() scratch: first index slot under each binary node
+		vector<int> rangeCount;     ///< Collapse() scratch: number of index slots under each binary node
+
+	public:
+		/**
+		 * @brief Default constructor creating an empty hierarchy
+		 */
+		WideBvh();
+
+	public:
+		/**
+		 * @brief Rebuilds this hierarchy by collapsing a binary one
+		 * @param binary Source hierarchy, leaves of every subtree must reference a contiguous range of indices
+		 *
+		 * Existing node and scratch storage is reused, so collapsing a binary
+		 * hierarchy of the same size every frame performs no reallocation.
+		 */
+		void Collapse(const LinearBvh& binary);
+
+		/**
+		 * @brief Aggregates per-primitive flags into every child slot
+		 * @param primitiveFlags Flags of each primitive, indexed by primitive id, or nullptr to drop the masks
+		 *
+		 * Collapsing again drops the masks; call this after every build.
+		 */
+		void BuildMasks(const uint32_t* primitiveFlags);
+
+		/**
+		 * @brief Finds the children of a node that may hold primitives with some of the given flags
+		 * @param node Index of the node
+		 * @param mask Flags looked for
+		 * @return Bit mask with bit i set unless child i holds none of the flags (every bit when masks is empty)
+		 */
+		int MatchingChildren(int node, uint32_t mask) const;
+
+		/**
+		 * @brief Removes all nodes and primitive references
+		 */
+		void Clear();
+
+		/**
+		 * @brief Frees the working storage kept for the next Collapse()
+		 */
+		void ReleaseScratch();
+
+		/**
+		 * @brief Tests whether the hierarchy contains any nodes
+		 * @return True if no hierarchy has been built
+		 */
+		bool IsEmpty() const;
+	};
+}
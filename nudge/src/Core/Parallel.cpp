@@ -0,0 +1,254 @@
+#include "Nudge/Core/Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::condition_variable;
+using std::exception_ptr;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+namespace Nudge
+{
+	/**
+	 * @brief One For() call shared between the caller and the pool's workers
+	 *
+	 * Lives on the calling thread's stack. The caller does not return before
+	 * every chunk has run and no worker still holds the batch.
+	 */
+	class ParallelBatch
+	{
+	public:
+		const function<void(int, int, int)>& body;
+		int count;
+		int chunks;
+		atomic<int> next;        ///< Next chunk to claim
+		atomic<bool> failed;     ///< A chunk threw; chunks claimed afterwards are skipped
+		int finished;            ///< Chunks run or skipped, guarded by the pool mutex
+		int users;               ///< Workers holding the batch, guarded by the pool mutex
+		exception_ptr error;     ///< First exception thrown by a chunk, guarded by the pool mutex
+		condition_variable done; ///< Signalled when the last chunk finishes or the last worker lets go
+
+	public:
+		ParallelBatch(const function<void(int, int, int)>& body, const int count, const int chunks)
+			: body{ body }, count{ count }, chunks{ chunks }, next{ 0 }, failed{ false }, finished{ 0 }, users{ 0 }
+		{
+		}
+
+		/**
+		 * @brief Claims and runs chunks until none are left
+		 * @param error Receives the first exception thrown, if any
+		 * @return Number of chunks claimed
+		 */
+		int Run(exception_ptr& error)
+		{
+			int claimed = 0;
+
+			for (int chunk = next++; chunk < chunks; chunk = next++)
+			{
+				++claimed;
+				if (failed)
+				{
+					continue;
+				}
+
+				// Chunk boundaries are computed in 64-bit to avoid overflow on large ranges
+				const int begin = static_cast<int>(static_cast<long long>(count) * chunk / chunks);
+				const int end = static_cast<int>(static_cast<long long>(count) * (chunk + 1) / chunks);
+
+				try
+				{
+					body(chunk, begin, end);
+				}
+				catch (...)
+				{
+					if (!error)
+					{
+						error = std::current_exception();
+					}
+
+					failed = true;
+				}
+			}
+
+			return claimed;
+		}
+	};
+
+	/**
+	 * @brief Worker threads started on the first parallel For() and kept for the process lifetime
+	 *
+	 * Workers sleep on a condition variable between batches, so a For() costs
+	 * a lock and a wake-up rather than creating and joining threads.
+	 */
+	class ParallelPool
+	{
+	public:
+		mutex lock;
+		condition_variable wake;
+		vector<ParallelBatch*> queue;  ///< Batches with chunks left to claim
+		vector<thread> workers;
+		bool stopping;
+
+	public:
+		explicit ParallelPool(const int count)
+			: stopping{ false }
+		{
+			workers.reserve(count);
+			for (int i = 0; i < count; ++i)
+			{
+				workers.emplace_back([this] { Work(); });
+			}
+		}
+
+		~ParallelPool()
+		{
+			{
+				const unique_lock<mutex> guard{ lock };
+				stopping = true;
+			}
+
+			wake.notify_all();
+			for (thread& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		/**
+		 * @brief Records chunks run on a batch and wakes its caller once it is complete
+		 * @param batch Batch the chunks belong to
+		 * @param claimed Chunks claimed by one thread
+		 * @param error Exception thrown by one of them, if any
+		 *
+		 * Must be called with the lock held. The batch is exhausted by then,
+		 * so it also leaves the queue.
+		 */
+		void Finish(ParallelBatch& batch, const int claimed, const exception_ptr& error)
+		{
+			batch.finished += claimed;
+			if (error && !batch.error)
+			{
+				batch.error = error;
+			}
+
+			const auto queued = std::find(queue.begin(), queue.end(), &batch);
+			if (queued != queue.end())
+			{
+				queue.erase(queued);
+			}
+
+			if (batch.finished == batch.chunks && batch.users == 0)
+			{
+				batch.done.notify_all();
+			}
+		}
+
+		void Work()
+		{
+			unique_lock<mutex> guard{ lock };
+
+			while (true)
+			{
+				wake.wait(guard, [this] { return stopping || !queue.empty(); });
+				if (queue.empty())
+				{
+					return;
+				}
+
+				ParallelBatch& batch = *queue.front();
+				++batch.users;
+				guard.unlock();
+
+				exception_ptr error;
+				const int claimed = batch.Run(error);
+
+				guard.lock();
+				--batch.users;
+				Finish(batch, claimed, error);
+			}
+		}
+	};
+
+	/**
+	 * @brief Number of hardware threads available for parallel work
+	 * @return Hardware concurrency, never less than 1
+	 */
+	int Parallel::WorkerCount()
+	{
+		static const int count = std::max(1, static_cast<int>(thread::hardware_concurrency()));
+
+		return count;
+	}
+
+	/**
+	 * @brief Number of chunks For() will split a range into
+	 * @param count Number of items in the range
+	 * @param minBatch Smallest number of items worth handing to a thread
+	 * @return Chunk count in [1, WorkerCount()]
+	 */
+	int Parallel::ChunkCount(const int count, const int minBatch)
+	{
+		const int batches = count / std::max(minBatch, 1);
+
+		return std::clamp(batches, 1, WorkerCount());
+	}
+
+	/**
+	 * @brief Runs a loop body over [0, count) split across worker threads
+	 * @param count Number of items in the range
+	 * @param minBatch Smallest number of items worth handing to a thread
+	 * @param body Callable receiving (chunk, begin, end) for each contiguous chunk
+	 *
+	 * Algorithm:
+	 * 1. Queue the batch and wake the pool's workers
+	 * 2. Claim chunks on the calling thread too, so a For() nested in a chunk
+	 *    always progresses even when every worker is busy
+	 * 3. Wait until every chunk has run and no worker holds the batch, then
+	 *    rethrow the first exception a chunk threw
+	 */
+	void Parallel::For(const int count, const int minBatch, const function<void(int, int, int)>& body)
+	{
+		if (count <= 0)
+		{
+			return;
+		}
+
+		const int chunks = ChunkCount(count, minBatch);
+		if (chunks == 1)
+		{
+			body(0, 0, count);
+			return;
+		}
+
+		static ParallelPool pool{ WorkerCount() - 1 };
+
+		ParallelBatch batch{ body, count, chunks };
+		{
+			const unique_lock<mutex> guard{ pool.lock };
+			pool.queue.push_back(&batch);
+		}
+
+		pool.wake.notify_all();
+
+		exception_ptr error;
+		const int claimed = batch.Run(error);
+
+		unique_lock<mutex> guard{ pool.lock };
+		pool.Finish(batch, claimed, error);
+		batch.done.wait(guard, [&batch] { return batch.finished == batch.chunks && batch.users == 0; });
+
+		if (batch.error)
+		{
+			std::rethrow_exception(batch.error);
+		}
+	}
+}
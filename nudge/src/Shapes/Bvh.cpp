@@ -0,0 +1,201 @@
+#include "Nudge/Shapes/Bvh.hpp"
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Line.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <algorithm>
+
+namespace Nudge
+{
+	/**
+	 * @brief Bounds of a box, with negative extents made positive
+	 * @param primitive Box
+	 * @return The box itself
+	 */
+	Aabb BvhTraits<Aabb>::Bounds(const Aabb& primitive)
+	{
+		return { primitive.origin, Vector3{ MathF::Abs(primitive.extents.x), MathF::Abs(primitive.extents.y), MathF::Abs(primitive.extents.z) } };
+	}
+
+	/**
+	 * @brief Centroid of a box
+	 * @param primitive Box
+	 * @return Center of the box
+	 */
+	Vector3 BvhTraits<Aabb>::Centroid(const Aabb& primitive)
+	{
+		return primitive.origin;
+	}
+
+	/**
+	 * @brief Bounds of a line segment
+	 * @param primitive Line segment
+	 * @return Box spanning both endpoints
+	 */
+	Aabb BvhTraits<Line>::Bounds(const Line& primitive)
+	{
+		const Vector3 min
+		{
+			MathF::Min(primitive.start.x, primitive.end.x),
+			MathF::Min(primitive.start.y, primitive.end.y),
+			MathF::Min(primitive.start.z, primitive.end.z)
+		};
+
+		const Vector3 max
+		{
+			MathF::Max(primitive.start.x, primitive.end.x),
+			MathF::Max(primitive.start.y, primitive.end.y),
+			MathF::Max(primitive.start.z, primitive.end.z)
+		};
+
+		return Aabb::FromMinMax(min, max);
+	}
+
+	/**
+	 * @brief Centroid of a line segment
+	 * @param primitive Line segment
+	 * @return Midpoint of the segment
+	 */
+	Vector3 BvhTraits<Line>::Centroid(const Line& primitive)
+	{
+		return (primitive.start + primitive.end) * .5f;
+	}
+
+	/**
+	 * @brief Bounds of an oriented box
+	 * @param primitive Oriented box
+	 * @return World-space box enclosing the oriented box
+	 */
+	Aabb BvhTraits<Obb>::Bounds(const Obb& primitive)
+	{
+		const Vector3 x = primitive.orientation.GetColumn(0) * primitive.extents.x;
+		const Vector3 y = primitive.orientation.GetColumn(1) * primitive.extents.y;
+		const Vector3 z = primitive.orientation.GetColumn(2) * primitive.extents.z;
+
+		const Vector3 extents
+		{
+			MathF::Abs(x.x) + MathF::Abs(y.x) + MathF::Abs(z.x),
+			MathF::Abs(x.y) + MathF::Abs(y.y) + MathF::Abs(z.y),
+			MathF::Abs(x.z) + MathF::Abs(y.z) + MathF::Abs(z.z)
+		};
+
+		return { primitive.origin, extents };
+	}
+
+	/**
+	 * @brief Centroid of an oriented box
+	 * @param primitive Oriented box
+	 * @return Center of the box
+	 */
+	Vector3 BvhTraits<Obb>::Centroid(const Obb& primitive)
+	{
+		return primitive.origin;
+	}
+
+	/**
+	 * @brief Bounds of a sphere
+	 * @param primitive Sphere
+	 * @return Box enclosing the sphere
+	 */
+	Aabb BvhTraits<Sphere>::Bounds(const Sphere& primitive)
+	{
+		return { primitive.origin, Vector3{ primitive.radius } };
+	}
+
+	/**
+	 * @brief Centroid of a sphere
+	 * @param primitive Sphere
+	 * @return Center of the sphere
+	 */
+	Vector3 BvhTraits<Sphere>::Centroid(const Sphere& primitive)
+	{
+		return primitive.origin;
+	}
+
+	/**
+	 * @brief Bounds of a triangle
+	 * @param primitive Triangle
+	 * @return Box enclosing the triangle
+	 */
+	Aabb BvhTraits<Triangle>::Bounds(const Triangle& primitive)
+	{
+		const auto& v = primitive.values;
+		Aabb box;
+
+		// Written per component: Mesh runs this over every triangle on every rebuild
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float min = std::min(v[axis], std::min(v[axis + 3], v[axis + 6]));
+			const float max = std::max(v[axis], std::max(v[axis + 3], v[axis + 6]));
+
+			box.origin[axis] = (min + max) * .5f;
+			box.extents[axis] = (max - min) * .5f;
+		}
+
+		return box;
+	}
+
+	/**
+	 * @brief Centroid of a triangle
+	 * @param primitive Triangle
+	 * @return Mean of the three vertices
+	 */
+	Vector3 BvhTraits<Triangle>::Centroid(const Triangle& primitive)
+	{
+		return (primitive.a + primitive.b + primitive.c) / 3.f;
+	}
+
+	/**
+	 * @brief Measures every triangle in parallel
+	 * @param primitives Triangles to measure
+	 * @param count Number of triangles
+	 * @param bounds Receives one box per triangle
+	 * @param centroids Receives one centroid per triangle, or nullptr to skip them
+	 */
+	void GatherBvhInputs(const Triangle* primitives, const int count, vector<Aabb>& bounds, vector<Vector3>* centroids)
+	{
+		bounds.resize(count);
+		if (centroids != nullptr)
+		{
+			centroids->resize(count);
+		}
+
+		Parallel::For(count, BVH_BOUNDS_BATCH, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				const auto& v = primitives[i].values;
+				float center[3];
+				float half[3];
+
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const float min = std::min(v[axis], std::min(v[axis + 3], v[axis + 6]));
+					const float max = std::max(v[axis], std::max(v[axis + 3], v[axis + 6]));
+
+					center[axis] = (min + max) * .5f;
+					half[axis] = (max - min) * .5f;
+				}
+
+				Aabb& box = bounds[i];
+				box.origin.x = center[0];
+				box.origin.y = center[1];
+				box.origin.z = center[2];
+				box.extents.x = half[0];
+				box.extents.y = half[1];
+				box.extents.z = half[2];
+
+				if (centroids != nullptr)
+				{
+					Vector3& centroid = (*centroids)[i];
+					centroid.x = (v[0] + v[3] + v[6]) / 3.f;
+					centroid.y = (v[1] + v[4] + v[7]) / 3.f;
+					centroid.z = (v[2] + v[5] + v[8]) / 3.f;
+				}
+			}
+		});
+	}
+}
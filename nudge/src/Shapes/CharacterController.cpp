@@ -0,0 +1,1041 @@
+#include "Nudge/Shapes/CharacterController.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+using std::uint32_t;
+using std::uint64_t;
+
+// Advancement steps per collider before a sweep settles for where it got to.
+// Flat faces converge in one step, edges and spheres in a handful
+constexpr int CHARACTER_SWEEP_ITERATIONS = 12;
+
+// A sweep stops once within this multiple of the skin width of a collider.
+// Advancement closes in on the skin distance from outside, and curved
+// features would otherwise take many steps over the last fraction
+constexpr float CHARACTER_SKIN_TOLERANCE = 1.5f;
+
+// Colliders approached slower than this fraction of the sweep length are
+// being slid along or left behind, and do not stop the sweep
+constexpr float CHARACTER_MIN_CLOSING = 1e-4f;
+
+// Moves shorter than this are dropped, which ends a slide
+constexpr float CHARACTER_MIN_MOVE = 1e-5f;
+
+// Push-out steps applied to a character that starts a move inside geometry
+constexpr int CHARACTER_DEPENETRATION_PASSES = 4;
+
+// Characters sharing one collider gather. Larger groups query less often
+// but hand each character more candidates to filter
+constexpr int CHARACTER_BATCH_SIZE = 16;
+
+// Groups handed to a parallel worker at a time
+constexpr int CHARACTER_PARALLEL_BATCH = 8;
+
+namespace Nudge
+{
+	/**
+	 * @brief Default constructor creating a unit sphere at the origin
+	 */
+	Character::Character()
+		: position{ 0.f }, displacement{ 0.f }, radius{ 1.f }, halfHeight{ 0.f }, groundNormal{ Vector3::UnitY() }, grounded{ false }
+	{
+	}
+
+	/**
+	 * @brief Creates a character at rest
+	 * @param position Center of the capsule
+	 * @param radius Radius of the capsule
+	 * @param halfHeight Half the length of the capsule's core segment, 0 for a sphere
+	 */
+	Character::Character(const Vector3& position, const float radius, const float halfHeight)
+		: position{ position }, displacement{ 0.f }, radius{ radius }, halfHeight{ halfHeight }, groundNormal{ Vector3::UnitY() }, grounded{ false }
+	{
+	}
+
+	/**
+	 * @brief Finds the closest points between two segments
+	 * @param p0 Start of the first segment
+	 * @param p1 End of the first segment
+	 * @param q0 Start of the second segment
+	 * @param q1 End of the second segment
+	 * @param onP Receives the closest point on the first segment
+	 * @param onQ Receives the closest point on the second segment
+	 *
+	 * Algorithm (Ericson, Real-Time Collision Detection, 5.1.9):
+	 * 1. Solve for the closest points of the two infinite lines
+	 * 2. Clamp the first parameter to the segment, recompute the second from
+	 *    it, and if that one needs clamping, recompute the first again
+	 */
+	static void ClosestSegmentPoints(const Vector3& p0, const Vector3& p1, const Vector3& q0, const Vector3& q1, Vector3& onP, Vector3& onQ)
+	{
+		const Vector3 d1 = p1 - p0;
+		const Vector3 d2 = q1 - q0;
+		const Vector3 r = p0 - q0;
+		const float a = Vector3::Dot(d1, d1);
+		const float e = Vector3::Dot(d2, d2);
+		const float f = Vector3::Dot(d2, r);
+
+		float s = 0.f;
+		float t = 0.f;
+
+		if (a <= MathF::epsilon)
+		{
+			t = e > MathF::epsilon ? MathF::Clamp01(f / e) : 0.f;
+		}
+		else
+		{
+			const float c = Vector3::Dot(d1, r);
+
+			if (e <= MathF::epsilon)
+			{
+				s = MathF::Clamp01(-c / a);
+			}
+			else
+			{
+				const float b = Vector3::Dot(d1, d2);
+				const float denominator = a * e - b * b;
+
+				s = denominator > 0.f ? MathF::Clamp01((b * f - c * e) / denominator) : 0.f;
+				t = (b * s + f) / e;
+
+				if (t < 0.f)
+				{
+					t = 0.f;
+					s = MathF::Clamp01(-c / a);
+				}
+				else if (t > 1.f)
+				{
+					t = 1.f;
+					s = MathF::Clamp01((b - c) / a);
+				}
+			}
+		}
+
+		onP = p0 + d1 * s;
+		onQ = q0 + d2 * t;
+	}
+
+	/**
+	 * @brief Measures the distance between a segment and a triangle
+	 * @param p0 Start of the segment
+	 * @param p1 End of the segment
+	 * @param triangle Triangle, collided from either side
+	 * @param normal Receives the unit direction from the triangle towards the segment
+	 * @return Distance between the two, 0 if the segment crosses the triangle
+	 *
+	 * Algorithm:
+	 * 1. If the segment crosses the triangle's plane inside the triangle, the
+	 *    distance is 0 and the normal is the face normal on the side of the
+	 *    segment's middle
+	 * 2. If it stays on one side and the endpoint nearest the plane projects
+	 *    inside the triangle, that projection is the closest point. This is
+	 *    the usual case of a character standing on or walking along a face
+	 * 3. Otherwise the segment passes over the triangle's boundary no higher
+	 *    than any endpoint whose projection falls inside, so the closest pair
+	 *    joins the segment to one of the three edges; keep the shortest
+	 */
+	static float SegmentTriangleDistance(const Vector3& p0, const Vector3& p1, const Triangle& triangle, Vector3& normal)
+	{
+		const Vector3& a = triangle.a;
+		const Vector3& b = triangle.b;
+		const Vector3& c = triangle.c;
+
+		const Vector3 winding = Vector3::Cross(b - a, c - a);
+		const float area = winding.Magnitude();
+
+		Vector3 face = Vector3::UnitY();
+		if (area > MathF::epsilon)
+		{
+			face = winding / area;
+			if (Vector3::Dot((p0 + p1) * .5f - a, face) < 0.f)
+			{
+				face = face * -1.f;
+			}
+
+			const float d0 = Vector3::Dot(p0 - a, face);
+			const float d1 = Vector3::Dot(p1 - a, face);
+
+			const auto inside = [&](const Vector3& point)
+			{
+				return Vector3::Dot(Vector3::Cross(b - a, point - a), winding) >= 0.f &&
+					Vector3::Dot(Vector3::Cross(c - b, point - b), winding) >= 0.f &&
+					Vector3::Dot(Vector3::Cross(a - c, point - c), winding) >= 0.f;
+			};
+
+			if ((d0 <= 0.f) != (d1 <= 0.f))
+			{
+				if (inside(p0 + (p1 - p0) * (d0 / (d0 - d1))))
+				{
+					normal = face;
+					return 0.f;
+				}
+			}
+			else
+			{
+				// The endpoint nearest the plane is nearest the triangle when it projects inside it
+				const float nearest = MathF::Min(d0, d1);
+				if (inside((d0 <= d1 ? p0 : p1) - face * nearest))
+				{
+					normal = face;
+					return nearest;
+				}
+			}
+		}
+
+		Vector3 onSegment;
+		Vector3 onTriangle;
+		float best = MathF::infinity;
+
+		for (int edge = 0; edge < 3; ++edge)
+		{
+			Vector3 s;
+			Vector3 q;
+			ClosestSegmentPoints(p0, p1, triangle.points[edge], triangle.points[(edge + 1) % 3], s, q);
+
+			const float distance = Vector3::DistanceSqr(s, q);
+			if (distance < best)
+			{
+				onSegment = s;
+				onTriangle = q;
+				best = distance;
+			}
+		}
+
+		const float distance = MathF::Sqrt(best);
+		normal = distance > MathF::epsilon ? (onSegment - onTriangle) / distance : face;
+
+		return distance;
+	}
+
+	/**
+	 * @brief Measures the distance between a segment and a sphere's surface
+	 * @param p0 Start of the segment
+	 * @param p1 End of the segment
+	 * @param sphere Sphere to measure against
+	 * @param normal Receives the unit direction from the sphere towards the segment
+	 * @return Distance from the segment to the sphere's surface, negative inside
+	 */
+	static float SegmentSphereDistance(const Vector3& p0, const Vector3& p1, const Sphere& sphere, Vector3& normal)
+	{
+		const Vector3 direction = p1 - p0;
+		const float length = Vector3::Dot(direction, direction);
+		const float t = length > MathF::epsilon ? MathF::Clamp01(Vector3::Dot(sphere.origin - p0, direction) / length) : 0.f;
+
+		const Vector3 offset = p0 + direction * t - sphere.origin;
+		const float distance = offset.Magnitude();
+		normal = distance > MathF::epsilon ? offset / distance : Vector3::UnitY();
+
+		return distance - sphere.radius;
+	}
+
+	/**
+	 * @brief Tests whether two boxes overlap, touching included
+	 * @param other Box to test against
+	 * @return True if the boxes share at least one point
+	 */
+	bool CharacterBox::Overlaps(const CharacterBox& other) const
+	{
+		return min.x <= other.max.x && max.x >= other.min.x &&
+			min.y <= other.max.y && max.y >= other.min.y &&
+			min.z <= other.max.z && max.z >= other.min.z;
+	}
+
+	/**
+	 * @brief Computes the bounds and normal a controller keeps for a triangle
+	 * @param triangle Triangle being added
+	 * @return Box around the triangle and its unit normal, zero if degenerate
+	 */
+	static CharacterTriangleData MakeTriangleData(const Triangle& triangle)
+	{
+		const Vector3 winding = Vector3::Cross(triangle.b - triangle.a, triangle.c - triangle.a);
+		const float area = winding.Magnitude();
+
+		return
+		{
+			{ Vector3::Min(Vector3::Min(triangle.a, triangle.b), triangle.c), Vector3::Max(Vector3::Max(triangle.a, triangle.b), triangle.c) },
+			area > MathF::epsilon ? winding / area : Vector3{ 0.f }
+		};
+	}
+
+	/**
+	 * @brief Tests whether a mesh's acceleration structure may reference a triangle from more than one leaf
+	 * @param mesh Mesh about to be queried
+	 * @return True for the octree and for spatial-split hierarchies that clipped triangles
+	 */
+	static bool SharesTriangles(const Mesh& mesh)
+	{
+		const LinearBvh* binary = AcquireStructure(mesh.hierarchy);
+
+		return AcquireStructure(mesh.accelerator) != nullptr ||
+			(binary != nullptr && binary->indices.size() > static_cast<size_t>(mesh.numTriangles));
+	}
+
+	/**
+	 * @brief Triangle gathered for a group, referenced where it is stored
+	 */
+	class GatheredTriangle
+	{
+	public:
+		const Triangle* triangle;            ///< Triangle in a mesh or in CharacterController::triangles
+		const CharacterTriangleData* data;   ///< Bounds and normal computed when the triangle was added
+	};
+
+	/**
+	 * @brief Colliders near a group of characters, and the subset near the one being moved
+	 */
+	class CharacterContacts
+	{
+	public:
+		vector<GatheredTriangle> triangles;  ///< Triangles near the group
+		vector<int> spheres;           ///< Controller spheres near the group
+		vector<int> stamps;            ///< Query that last gathered each triangle of a mesh whose leaves share triangles
+		int epoch = 0;                 ///< Last stamp handed out
+		vector<int> nearTriangles;     ///< Group triangles touching the moving character's swept bounds
+		vector<int> nearSpheres;       ///< Controller spheres touching the moving character's swept bounds
+	};
+
+	/**
+	 * @brief Collects the colliders overlapping a region
+	 * @param controller Controller owning the colliders
+	 * @param region Box around the swept bounds of a group of characters
+	 * @param contacts Receives the colliders, replacing the previous group's
+	 *
+	 * Triangles are kept as pointers into the arrays they live in. A mesh
+	 * whose leaves share triangles stamps each one on its first visit, so
+	 * later visits from other leaves are skipped without sorting.
+	 */
+	static void GatherContacts(const CharacterController& controller, const Aabb& region, CharacterContacts& contacts)
+	{
+		contacts.triangles.clear();
+		contacts.spheres.clear();
+
+		for (size_t m = 0; m < controller.meshes.size(); ++m)
+		{
+			const Mesh& mesh = *controller.meshes[m];
+			const CharacterTriangleData* data = controller.meshData[m].data();
+
+			int* stamps = nullptr;
+			if (SharesTriangles(mesh))
+			{
+				if (contacts.stamps.size() < static_cast<size_t>(mesh.numTriangles))
+				{
+					contacts.stamps.resize(mesh.numTriangles, 0);
+				}
+
+				stamps = contacts.stamps.data();
+			}
+
+			const int stamp = ++contacts.epoch;
+			mesh.Query(region, [&](const int triangle)
+			{
+				if (stamps != nullptr)
+				{
+					if (stamps[triangle] == stamp)
+					{
+						return false;
+					}
+
+					stamps[triangle] = stamp;
+				}
+
+				contacts.triangles.push_back({ mesh.triangles + triangle, data + triangle });
+				return false;
+			});
+		}
+
+		if (!controller.triangleTree.IsEmpty())
+		{
+			controller.triangleTree.Query(region, [&](const int triangle)
+			{
+				contacts.triangles.push_back({ &controller.triangles[triangle], &controller.triangleData[triangle] });
+				return false;
+			});
+		}
+
+		if (!controller.sphereTree.IsEmpty())
+		{
+			controller.sphereTree.Query(region, [&](const int sphere)
+			{
+				contacts.spheres.push_back(sphere);
+				return false;
+			});
+		}
+	}
+
+	/**
+	 * @brief Sweeps one character's capsule through the colliders gathered for it
+	 */
+	class CapsuleSweeper
+	{
+	public:
+		const CharacterController& controller;
+		const CharacterContacts& contacts;
+		Vector3 axis;    ///< Offset from the center to the top of the core segment
+		Vector3 reach;   ///< Half extents of the box around the capsule, skin included
+		float radius;
+
+	public:
+		/**
+		 * @brief Prepares sweeps for a character
+		 * @param controller Controller holding the settings
+		 * @param contacts Colliders, with the character's near lists filled
+		 * @param character Character whose shape is swept
+		 */
+		CapsuleSweeper(const CharacterController& controller, const CharacterContacts& contacts, const Character& character)
+			: controller{ controller }, contacts{ contacts }, axis{ controller.up * character.halfHeight }, radius{ character.radius }
+		{
+			const float margin = character.radius + controller.skinWidth * CHARACTER_SKIN_TOLERANCE;
+			reach = Vector3{ MathF::Abs(axis.x) + margin, MathF::Abs(axis.y) + margin, MathF::Abs(axis.z) + margin };
+		}
+
+		/**
+		 * @brief Box around the capsule moving between two positions
+		 */
+		CharacterBox Bounds(const Vector3& from, const Vector3& to) const
+		{
+			return { Vector3::Min(from, to) - reach, Vector3::Max(from, to) + reach };
+		}
+
+		/**
+		 * @brief Distance from the capsule's surface to a triangle, negative when overlapping
+		 */
+		float Gap(const Vector3& position, const Triangle& triangle, Vector3& normal) const
+		{
+			return SegmentTriangleDistance(position - axis, position + axis, triangle, normal) - radius;
+		}
+
+		/**
+		 * @brief Distance from the capsule's surface to a sphere, negative when overlapping
+		 */
+		float Gap(const Vector3& position, const Sphere& sphere, Vector3& normal) const
+		{
+			return SegmentSphereDistance(position - axis, position + axis, sphere, normal) - radius;
+		}
+
+		/**
+		 * @brief Distance from the capsule's surface to a triangle's plane, a lower bound of the distance to the triangle
+		 * @param triangle Index into the gathered triangles
+		 * @param position Center of the capsule
+		 * @param side Receives the plane normal flipped towards the capsule
+		 * @return Gap to the plane, negative if the capsule reaches across it
+		 */
+		float PlaneGap(const int triangle, const Vector3& position, Vector3& side) const
+		{
+			const GatheredTriangle& gathered = contacts.triangles[triangle];
+			const Vector3& normal = gathered.data->normal;
+			const float offset = Vector3::Dot(position - gathered.triangle->a, normal);
+
+			side = offset < 0.f ? normal * -1.f : normal;
+			return MathF::Abs(offset) - MathF::Abs(Vector3::Dot(axis, normal)) - radius;
+		}
+
+		/**
+		 * @brief Tests whether a sweep ends before the capsule gets within the skin of a triangle's plane
+		 * @param triangle Index into the gathered triangles
+		 * @param start Position at the start of the sweep
+		 * @param delta Full movement of the sweep
+		 * @param fraction Nearest hit so far as a fraction of delta
+		 * @return True if the triangle cannot stop the sweep before fraction
+		 *
+		 * The gap to a plane changes linearly along the sweep, so this is
+		 * exact for the plane and conservative for the triangle in it. It
+		 * spares the full distance test for the triangles a character stands
+		 * on or walks past, which make up most of the candidates.
+		 */
+		bool Unreachable(const int triangle, const Vector3& start, const Vector3& delta, const float fraction) const
+		{
+			Vector3 side;
+			const float gap = PlaneGap(triangle, start, side);
+			if (gap <= controller.skinWidth * CHARACTER_SKIN_TOLERANCE)
+			{
+				return false;
+			}
+
+			const float closing = -Vector3::Dot(delta, side);
+			return closing <= 0.f || gap - controller.skinWidth >= closing * fraction;
+		}
+
+		/**
+		 * @brief Tests whether a contact normal belongs to ground the character can stand on
+		 */
+		bool Walkable(const Vector3& normal) const
+		{
+			return Vector3::Dot(normal, controller.up) >= controller.maxSlopeCosine;
+		}
+
+		/**
+		 * @brief Advances the capsule towards one collider
+		 * @param collider Triangle or sphere
+		 * @param start Position at the start of the sweep
+		 * @param delta Full movement of the sweep
+		 * @param minClosing Approach speed below which the collider is ignored
+		 * @param fraction Nearest hit so far as a fraction of delta, lowered on an earlier hit
+		 * @param normal Receives the contact normal on an earlier hit
+		 * @return True if the collider is hit before fraction
+		 *
+		 * Algorithm (conservative advancement):
+		 * 1. Measure the gap and contact normal at the current fraction
+		 * 2. Stop if the capsule no longer closes in, or is within the skin
+		 * 3. Advance by the gap beyond the skin divided by the closing speed,
+		 *    which the convexity of the gap guarantees does not overshoot
+		 */
+		template <typename Collider>
+		bool Advance(const Collider& collider, const Vector3& start, const Vector3& delta, const float minClosing, float& fraction, Vector3& normal) const
+		{
+			float t = 0.f;
+			Vector3 contact;
+
+			for (int i = 0; i < CHARACTER_SWEEP_ITERATIONS; ++i)
+			{
+				const float gap = Gap(start + delta * t, collider, contact);
+				const float closing = -Vector3::Dot(delta, contact);
+
+				if (closing <= minClosing)
+				{
+					return false;
+				}
+
+				if (gap <= controller.skinWidth * CHARACTER_SKIN_TOLERANCE)
+				{
+					break;
+				}
+
+				t += (gap - controller.skinWidth) / closing;
+				if (t >= fraction)
+				{
+					return false;
+				}
+			}
+
+			fraction = t;
+			normal = contact;
+			return true;
+		}
+
+		/**
+		 * @brief Moves the capsule in a straight line until it reaches a collider
+		 * @param start Position at the start of the sweep
+		 * @param delta Full movement
+		 * @param fraction Receives the fraction of delta travelled, 1 without a hit
+		 * @param normal Receives the normal of the collider hit
+		 * @return True if a collider stopped the sweep
+		 */
+		bool Sweep(const Vector3& start, const Vector3& delta, float& fraction, Vector3& normal) const
+		{
+			const CharacterBox region = Bounds(start, start + delta);
+			const float minClosing = CHARACTER_MIN_CLOSING * delta.Magnitude();
+
+			fraction = 1.f;
+			bool hit = false;
+
+			for (const int i : contacts.nearTriangles)
+			{
+				if (contacts.triangles[i].data->bounds.Overlaps(region) && !Unreachable(i, start, delta, fraction))
+				{
+					hit |= Advance(*contacts.triangles[i].triangle, start, delta, minClosing, fraction, normal);
+				}
+			}
+
+			for (const int i : contacts.nearSpheres)
+			{
+				if (controller.sphereBounds[i].Overlaps(region))
+				{
+					hit |= Advance(controller.spheres[i], start, delta, minClosing, fraction, normal);
+				}
+			}
+
+			return hit;
+		}
+
+		/**
+		 * @brief Pushes the capsule out of the colliders it overlaps, deepest first
+		 * @param position Position to correct
+		 * @return Corrected position, skinWidth away from the deepest collider of the last pass
+		 */
+		Vector3 Depenetrate(Vector3 position) const
+		{
+			for (int pass = 0; pass < CHARACTER_DEPENETRATION_PASSES; ++pass)
+			{
+				const CharacterBox region = Bounds(position, position);
+
+				float deepest = 0.f;
+				Vector3 push;
+				Vector3 normal;
+
+				for (const int i : contacts.nearTriangles)
+				{
+					if (contacts.triangles[i].data->bounds.Overlaps(region) && PlaneGap(i, position, normal) < deepest)
+					{
+						const float gap = Gap(position, *contacts.triangles[i].triangle, normal);
+						if (gap < deepest)
+						{
+							deepest = gap;
+							push = normal;
+						}
+					}
+				}
+
+				for (const int i : contacts.nearSpheres)
+				{
+					if (controller.sphereBounds[i].Overlaps(region))
+					{
+						const float gap = Gap(position, controller.spheres[i], normal);
+						if (gap < deepest)
+						{
+							deepest = gap;
+							push = normal;
+						}
+					}
+				}
+
+				if (deepest >= 0.f)
+				{
+					break;
+				}
+
+				position += push * (controller.skinWidth - deepest);
+			}
+
+			return position;
+		}
+
+		/**
+		 * @brief Moves the capsule, sliding along the surfaces it hits
+		 * @param position Start position
+		 * @param displacement Movement wanted
+		 * @param stopOnWalkable Stop at the first walkable surface instead of sliding along it
+		 * @param touched Set to true if any collider was hit
+		 * @param walkable Set to true if a walkable surface was hit
+		 * @param ground Receives the normal of the last walkable surface hit
+		 * @return Final position
+		 *
+		 * Algorithm:
+		 * 1. Sweep the remaining displacement and move to the hit
+		 * 2. Remove the part of what is left that points into the surface
+		 * 3. If that now points into the previous surface, keep only its part
+		 *    along the crease between the two
+		 * 4. Repeat up to maxSlides times or until nothing is left
+		 */
+		Vector3 Slide(Vector3 position, Vector3 displacement, const bool stopOnWalkable, bool& touched, bool& walkable, Vector3& ground) const
+		{
+			Vector3 previous;
+
+			for (int i = 0; i < controller.maxSlides; ++i)
+			{
+				if (displacement.MagnitudeSqr() <= CHARACTER_MIN_MOVE * CHARACTER_MIN_MOVE)
+				{
+					break;
+				}
+
+				float fraction;
+				Vector3 normal;
+				const bool hit = Sweep(position, displacement, fraction, normal);
+
+				position += displacement * fraction;
+				if (!hit)
+				{
+					break;
+				}
+
+				touched = true;
+				if (Walkable(normal))
+				{
+					walkable = true;
+					ground = normal;
+
+					if (stopOnWalkable)
+					{
+						break;
+					}
+				}
+
+				Vector3 rest = displacement * (1.f - fraction);
+				rest -= normal * Vector3::Dot(rest, normal);
+
+				if (i > 0 && Vector3::Dot(rest, previous) < 0.f)
+				{
+					Vector3 crease = Vector3::Cross(previous, normal);
+					const float length = crease.Magnitude();
+					if (length <= MathF::epsilon)
+					{
+						break;
+					}
+
+					crease /= length;
+					rest = crease * Vector3::Dot(rest, crease);
+				}
+
+				previous = normal;
+				displacement = rest;
+			}
+
+			return position;
+		}
+	};
+
+	/**
+	 * @brief Box a character may reach during one move, colliders outside it are never tested
+	 * @param controller Controller holding the settings
+	 * @param character Character about to move
+	 * @return Box around the capsule grown by every distance the move can cover
+	 */
+	static Aabb MoveBounds(const CharacterController& controller, const Character& character)
+	{
+		const float travel = character.displacement.Magnitude() + controller.stepHeight + controller.snapDistance;
+		const float margin = travel + character.radius + controller.skinWidth * CHARACTER_SKIN_TOLERANCE;
+		const Vector3 axis = controller.up * character.halfHeight;
+
+		return Aabb{ character.position, Vector3{ MathF::Abs(axis.x) + margin, MathF::Abs(axis.y) + margin, MathF::Abs(axis.z) + margin } };
+	}
+
+	/**
+	 * @brief Volume of a box, the cost measure used to decide whether characters share a query
+	 * @param box Box to measure
+	 * @return Volume of the box
+	 */
+	static float Volume(const Aabb& box)
+	{
+		return box.extents.x * box.extents.y * box.extents.z * 8.f;
+	}
+
+	/**
+	 * @brief Moves one character through the colliders gathered for its group
+	 * @param controller Controller holding the settings
+	 * @param contacts Colliders near the group; the near lists are refilled
+	 * @param character Character to move
+	 * @param swept Box returned by MoveBounds() for the character
+	 *
+	 * Algorithm:
+	 * 1. Keep the gathered colliders touching the character's swept box
+	 * 2. Push the character out of anything it starts inside
+	 * 3. Up: sweep up by the step height (grounded and moving sideways)
+	 *    plus the upward part of the displacement
+	 * 4. Across: slide the sideways part of the displacement
+	 * 5. Down: slide down by the height stepped up, the downward part of the
+	 *    displacement and the snap distance (grounded and not moving up),
+	 *    stopping on walkable ground. Finding nothing to stand on takes the
+	 *    snap back, leaving the character airborne
+	 */
+	static void MoveCharacter(const CharacterController& controller, CharacterContacts& contacts, Character& character, const Aabb& swept)
+	{
+		const CharacterBox reach{ swept.Min(), swept.Max() };
+
+		contacts.nearTriangles.clear();
+		for (int i = 0; i < static_cast<int>(contacts.triangles.size()); ++i)
+		{
+			if (contacts.triangles[i].data->bounds.Overlaps(reach))
+			{
+				contacts.nearTriangles.push_back(i);
+			}
+		}
+
+		contacts.nearSpheres.clear();
+		for (const int i : contacts.spheres)
+		{
+			if (controller.sphereBounds[i].Overlaps(reach))
+			{
+				contacts.nearSpheres.push_back(i);
+			}
+		}
+
+		const CapsuleSweeper sweeper{ controller, contacts, character };
+		const Vector3& up = controller.up;
+
+		const float rise = Vector3::Dot(character.displacement, up);
+		const Vector3 across = character.displacement - up * rise;
+		const bool stepping = character.grounded && across.MagnitudeSqr() > CHARACTER_MIN_MOVE * CHARACTER_MIN_MOVE;
+		const float step = stepping ? controller.stepHeight : 0.f;
+
+		Vector3 position = sweeper.Depenetrate(character.position);
+
+		float lifted = 0.f;
+		const float lift = step + MathF::Max(rise, 0.f);
+		if (lift > 0.f)
+		{
+			float fraction;
+			Vector3 normal;
+			sweeper.Sweep(position, up * lift, fraction, normal);
+
+			lifted = lift * fraction;
+			position += up * lifted;
+		}
+
+		bool touched = false;
+		bool walkable = false;
+		Vector3 ground = up;
+		position = sweeper.Slide(position, across, false, touched, walkable, ground);
+
+		const float snap = character.grounded && rise <= 0.f ? controller.snapDistance : 0.f;
+		const float drop = MathF::Min(lifted, step) + MathF::Max(-rise, 0.f) + snap;
+
+		touched = false;
+		walkable = false;
+		if (drop > 0.f)
+		{
+			const Vector3 landed = sweeper.Slide(position, up * -drop, true, touched, walkable, ground);
+
+			// Nothing below: the path back up is the one just swept
+			position = touched ? landed : landed + up * snap;
+		}
+
+		character.position = position;
+		character.grounded = walkable;
+		character.groundNormal = walkable ? ground : up;
+	}
+
+	/**
+	 * @brief Adds the 12 face triangles of a box
+	 * @param controller Controller receiving the triangles
+	 * @param origin Center of the box
+	 * @param axes Unit axes of the box
+	 * @param extents Half size along each axis
+	 */
+	static void AddBox(CharacterController& controller, const Vector3& origin, const Vector3 axes[3], const Vector3& extents)
+	{
+		// Corner i lies on the positive side of axis k when bit k of i is set
+		Vector3 corners[8];
+		for (int i = 0; i < 8; ++i)
+		{
+			corners[i] = origin;
+			for (int k = 0; k < 3; ++k)
+			{
+				corners[i] += axes[k] * ((i >> k & 1) != 0 ? extents[k] : -extents[k]);
+			}
+		}
+
+		for (int k = 0; k < 3; ++k)
+		{
+			const int u = 1 << (k + 1) % 3;
+			const int v = 1 << (k + 2) % 3;
+
+			for (const int side : { 0, 1 << k })
+			{
+				controller.triangles.emplace_back(corners[side], corners[side | u], corners[side | u | v]);
+				controller.triangleData.push_back(MakeTriangleData(controller.triangles.back()));
+				controller.triangles.emplace_back(corners[side], corners[side | u | v], corners[side | v]);
+				controller.triangleData.push_back(MakeTriangleData(controller.triangles.back()));
+			}
+		}
+
+		controller.dirty = true;
+	}
+
+	/**
+	 * @brief Default constructor creating a controller without colliders, with +Y up and default settings
+	 */
+	CharacterController::CharacterController()
+		: up{ Vector3::UnitY() }, stepHeight{ CHARACTER_DEFAULT_STEP_HEIGHT }, snapDistance{ CHARACTER_DEFAULT_SNAP_DISTANCE },
+		maxSlopeCosine{ MathF::Cos(MathF::Radians(CHARACTER_DEFAULT_MAX_SLOPE)) }, skinWidth{ CHARACTER_DEFAULT_SKIN_WIDTH },
+		maxSlides{ CHARACTER_DEFAULT_MAX_SLIDES }, dirty{ false }
+	{
+	}
+
+	/**
+	 * @brief Sets the steepest walkable slope
+	 * @param degrees Angle from horizontal
+	 */
+	void CharacterController::SetMaxSlope(const float degrees)
+	{
+		maxSlopeCosine = MathF::Cos(MathF::Radians(degrees));
+	}
+
+	/**
+	 * @brief Adds a mesh to collide against
+	 * @param mesh Mesh to reference
+	 */
+	void CharacterController::Add(const Mesh& mesh)
+	{
+		meshes.push_back(&mesh);
+
+		vector<CharacterTriangleData>& data = meshData.emplace_back(mesh.numTriangles);
+		for (int i = 0; i < mesh.numTriangles; ++i)
+		{
+			data[i] = MakeTriangleData(mesh.triangles[i]);
+		}
+	}
+
+	/**
+	 * @brief Adds a triangle to collide against, from either side
+	 * @param triangle Triangle to copy
+	 */
+	void CharacterController::Add(const Triangle& triangle)
+	{
+		triangles.push_back(triangle);
+		triangleData.push_back(MakeTriangleData(triangle));
+		dirty = true;
+	}
+
+	/**
+	 * @brief Adds a sphere to collide against
+	 * @param sphere Sphere to copy
+	 */
+	void CharacterController::Add(const Sphere& sphere)
+	{
+		spheres.push_back(sphere);
+		sphereBounds.push_back({ sphere.origin - Vector3{ sphere.radius }, sphere.origin + Vector3{ sphere.radius } });
+		dirty = true;
+	}
+
+	/**
+	 * @brief Adds a box to collide against, as its 12 face triangles
+	 * @param box Box to copy
+	 */
+	void CharacterController::Add(const Aabb& box)
+	{
+		const Vector3 axes[3] = { Vector3::UnitX(), Vector3::UnitY(), Vector3::UnitZ() };
+
+		AddBox(*this, box.origin, axes, box.extents);
+	}
+
+	/**
+	 * @brief Adds an oriented box to collide against, as its 12 face triangles
+	 * @param box Box to copy
+	 */
+	void CharacterController::Add(const Obb& box)
+	{
+		const Vector3 axes[3] = { box.orientation.GetColumn(0), box.orientation.GetColumn(1), box.orientation.GetColumn(2) };
+
+		AddBox(*this, box.origin, axes, box.extents);
+	}
+
+	/**
+	 * @brief Removes every collider
+	 */
+	void CharacterController::Clear()
+	{
+		meshes.clear();
+		meshData.clear();
+		triangles.clear();
+		triangleData.clear();
+		spheres.clear();
+		sphereBounds.clear();
+		triangleTree.Clear();
+		sphereTree.Clear();
+		dirty = false;
+	}
+
+	/**
+	 * @brief Moves one character by its displacement
+	 * @param character Character to move
+	 */
+	void CharacterController::Move(Character& character)
+	{
+		Move(span<Character>{ &character, 1 });
+	}
+
+	/**
+	 * @brief Moves many characters by their displacements
+	 * @param characters Characters to move
+	 *
+	 * Algorithm:
+	 * 1. Rebuild the primitive trees if colliders were added (or the
+	 *    controller was copied, leaving them pointing at the source)
+	 * 2. Compute each character's swept box and sort the characters along a
+	 *    Morton curve through their positions
+	 * 3. Walk the sorted list, adding each box to the current group unless
+	 *    the group is full or the combined box would grow larger than the
+	 *    group's box and the new one taken apart (boxes that barely touch
+	 *    would chain into one large, mostly empty region)
+	 * 4. Per group, in parallel: gather the colliders in the combined box
+	 *    once, then move each member against them
+	 */
+	void CharacterController::Move(const span<Character> characters)
+	{
+		const int count = static_cast<int>(characters.size());
+		if (count == 0)
+		{
+			return;
+		}
+
+		if (dirty || triangleTree.primitives != triangles.data() || sphereTree.primitives != spheres.data())
+		{
+			triangleTree.Build(triangles);
+			sphereTree.Build(spheres);
+			dirty = false;
+		}
+
+		// Seeded from a real position: Vector3's assignment skips values that compare
+		// approximately equal, and infinity compares equal to every finite value
+		vector<Aabb> swept(count);
+		Vector3 min = characters[0].position;
+		Vector3 max = characters[0].position;
+
+		for (int i = 0; i < count; ++i)
+		{
+			swept[i] = MoveBounds(*this, characters[i]);
+			min = Vector3::Min(min, characters[i].position);
+			max = Vector3::Max(max, characters[i].position);
+		}
+
+		float scale[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			scale[axis] = max[axis] > min[axis] ? 1023.999f / (max[axis] - min[axis]) : 0.f;
+		}
+
+		// Morton code in the high half, character index in the low half, so one sort orders both
+		vector<uint64_t> keys(count);
+		for (int i = 0; i < count; ++i)
+		{
+			uint64_t code = 0;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const uint32_t cell = static_cast<uint32_t>(std::clamp((characters[i].position[axis] - min[axis]) * scale[axis], 0.f, 1023.f));
+				for (int bit = 0; bit < 10; ++bit)
+				{
+					code |= static_cast<uint64_t>(cell >> bit & 1u) << (bit * 3 + axis);
+				}
+			}
+
+			keys[i] = code << 32 | static_cast<uint32_t>(i);
+		}
+
+		std::sort(keys.begin(), keys.end());
+
+		vector<int> starts;
+		vector<Aabb> regions;
+		for (int k = 0; k < count; ++k)
+		{
+			const Aabb& box = swept[keys[k] & 0xFFFFFFFF];
+
+			if (!starts.empty() && k - starts.back() < CHARACTER_BATCH_SIZE)
+			{
+				const Aabb merged = Aabb::FromMinMax(Vector3::Min(regions.back().Min(), box.Min()), Vector3::Max(regions.back().Max(), box.Max()));
+
+				// Joining must not make the group query cover more than two separate ones would
+				if (Volume(merged) <= Volume(regions.back()) + Volume(box))
+				{
+					regions.back() = merged;
+					continue;
+				}
+			}
+
+			starts.push_back(k);
+			regions.push_back(box);
+		}
+
+		starts.push_back(count);
+
+		Parallel::For(static_cast<int>(regions.size()), CHARACTER_PARALLEL_BATCH, [&](const int, const int begin, const int end)
+		{
+			CharacterContacts contacts;
+
+			for (int group = begin; group < end; ++group)
+			{
+				GatherContacts(*this, regions[group], contacts);
+
+				for (int k = starts[group]; k < starts[group + 1]; ++k)
+				{
+					const int i = static_cast<int>(keys[k] & 0xFFFFFFFF);
+					MoveCharacter(*this, contacts, characters[i], swept[i]);
+				}
+			}
+		});
+	}
+}
@@ -0,0 +1,732 @@
+#include "Nudge/Shapes/Compound.hpp"
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Line.hpp"
+#include "Nudge/Shapes/Plane.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Shape.hpp"
+
+#include <utility>
+#include <variant>
+
+using std::pair;
+
+namespace Nudge
+{
+	/**
+	 * @brief Default constructor creating an empty sphere child
+	 */
+	CompoundChild::CompoundChild()
+		: shape{ CompoundShape::Sphere }, index{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Creates a child reference
+	 * @param shape Array the child lives in
+	 * @param index Index into that array
+	 */
+	CompoundChild::CompoundChild(const CompoundShape shape, const int index)
+		: shape{ shape }, index{ index }
+	{
+	}
+
+	/**
+	 * @brief Bounds of a compound child
+	 * @param primitive Child, measured when it was added
+	 * @return Local-space box enclosing the child
+	 */
+	Aabb BvhTraits<CompoundChild>::Bounds(const CompoundChild& primitive)
+	{
+		return primitive.bounds;
+	}
+
+	/**
+	 * @brief Centroid of a compound child
+	 * @param primitive Child, measured when it was added
+	 * @return Center of the child's bounds
+	 */
+	Vector3 BvhTraits<CompoundChild>::Centroid(const CompoundChild& primitive)
+	{
+		return primitive.bounds.origin;
+	}
+
+	/**
+	 * @brief Rigid placement of one frame in another
+	 *
+	 * Maps a point p to rotation * p + translation. Built for local-to-world
+	 * (a body's own transform), world-to-local (its inverse) and one body's
+	 * frame in another's.
+	 */
+	class CompoundPlacement
+	{
+	public:
+		Matrix3 rotation;
+		Vector3 translation;
+
+	public:
+		/**
+		 * @brief Placement taking world space into a body's frame
+		 * @param body Body whose frame is the target
+		 * @return Inverse of the body's transform
+		 */
+		static CompoundPlacement ToLocal(const Compound& body)
+		{
+			const Matrix3 inverse = body.orientation.Transposed();
+
+			return { inverse, -(inverse * body.position) };
+		}
+
+		/**
+		 * @brief Placement taking one body's frame into another's
+		 * @param from Body whose frame the input is in
+		 * @param to Body whose frame the output is in
+		 * @return to's inverse transform applied after from's transform
+		 */
+		static CompoundPlacement Between(const Compound& from, const Compound& to)
+		{
+			const Matrix3 inverse = to.orientation.Transposed();
+
+			return { inverse * from.orientation, inverse * (from.position - to.position) };
+		}
+
+	public:
+		Vector3 Point(const Vector3& point) const
+		{
+			return rotation * point + translation;
+		}
+
+		Sphere Place(const Sphere& sphere) const
+		{
+			return { Point(sphere.origin), sphere.radius };
+		}
+
+		Obb Place(const Obb& box) const
+		{
+			return { Point(box.origin), box.extents, rotation * box.orientation };
+		}
+
+		Obb Place(const Aabb& box) const
+		{
+			return { Point(box.origin), box.extents, rotation };
+		}
+
+		Triangle Place(const Triangle& triangle) const
+		{
+			return { Point(triangle.a), Point(triangle.b), Point(triangle.c) };
+		}
+
+		Line Place(const Line& line) const
+		{
+			return { Point(line.start), Point(line.end) };
+		}
+
+		Plane Place(const Plane& plane) const
+		{
+			const Vector3 normal = rotation * plane.normal;
+
+			return { normal, plane.distance + Vector3::Dot(normal, translation) };
+		}
+
+		Ray Place(const Ray& ray) const
+		{
+			return { Point(ray.origin), rotation * ray.direction };
+		}
+
+		/**
+		 * @brief Axis-aligned box enclosing a placed box
+		 * @param min Minimum corner of the box to place
+		 * @param max Maximum corner of the box to place
+		 * @return Box around the rotated corners, in the target frame
+		 */
+		Aabb Enclose(const Vector3& min, const Vector3& max) const
+		{
+			const Vector3 center = (min + max) * .5f;
+			const Vector3 half = (max - min) * .5f;
+			const Matrix3& r = rotation;
+
+			return { Point(center), Vector3{
+				MathF::Abs(r.m11) * half.x + MathF::Abs(r.m12) * half.y + MathF::Abs(r.m13) * half.z,
+				MathF::Abs(r.m21) * half.x + MathF::Abs(r.m22) * half.y + MathF::Abs(r.m23) * half.z,
+				MathF::Abs(r.m31) * half.x + MathF::Abs(r.m32) * half.y + MathF::Abs(r.m33) * half.z } };
+		}
+	};
+
+	/**
+	 * @brief Tests one child of a compound against a shape
+	 * @param compound Compound owning the child
+	 * @param child Child to test
+	 * @param other Shape to test, in the compound's frame
+	 * @return True if the child intersects the shape
+	 */
+	template <typename Shape>
+	static bool ChildIntersects(const Compound& compound, const CompoundChild& child, const Shape& other)
+	{
+		switch (child.shape)
+		{
+		case CompoundShape::Sphere:
+			return compound.spheres[child.index].Intersects(other);
+		case CompoundShape::Obb:
+			return compound.boxes[child.index].Intersects(other);
+		case CompoundShape::Triangle:
+			return compound.triangles[child.index].Intersects(other);
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Tests one child of a compound against a line segment
+	 * @param compound Compound owning the child
+	 * @param child Child to test
+	 * @param other Segment to test, in the compound's frame
+	 * @return True if the child intersects the segment
+	 */
+	static bool ChildIntersects(const Compound& compound, const CompoundChild& child, const Line& other)
+	{
+		switch (child.shape)
+		{
+		case CompoundShape::Sphere:
+			return other.Test(compound.spheres[child.index]);
+		case CompoundShape::Obb:
+			return other.Test(compound.boxes[child.index]);
+		case CompoundShape::Triangle:
+			return other.Test(compound.triangles[child.index]);
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Tests one child of a compound against one child of another
+	 * @param compound Compound owning the first child
+	 * @param child First child
+	 * @param other Compound owning the second child
+	 * @param otherChild Second child
+	 * @param placement Placement of the other compound's frame in the first's
+	 * @return True if the two children intersect
+	 */
+	static bool ChildrenIntersect(const Compound& compound, const CompoundChild& child, const Compound& other, const CompoundChild& otherChild, const CompoundPlacement& placement)
+	{
+		if (!child.bounds.Intersects(placement.Enclose(otherChild.bounds.Min(), otherChild.bounds.Max())))
+		{
+			return false;
+		}
+
+		switch (otherChild.shape)
+		{
+		case CompoundShape::Sphere:
+			return ChildIntersects(compound, child, placement.Place(other.spheres[otherChild.index]));
+		case CompoundShape::Obb:
+			return ChildIntersects(compound, child, placement.Place(other.boxes[otherChild.index]));
+		case CompoundShape::Triangle:
+			return ChildIntersects(compound, child, placement.Place(other.triangles[otherChild.index]));
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Tests whether two hierarchy nodes overlap
+	 * @param a First node
+	 * @param b Second node, from a tree in another frame
+	 * @param placement Placement of b's frame in a's
+	 * @return True if a's bounds touch the box enclosing b's placed bounds
+	 */
+	static bool NodesOverlap(const LinearBvhNode& a, const LinearBvhNode& b, const CompoundPlacement& placement)
+	{
+		const Aabb placed = placement.Enclose(b.min, b.max);
+		const Vector3 min = placed.Min();
+		const Vector3 max = placed.Max();
+
+		return a.min.x <= max.x && a.max.x >= min.x &&
+			a.min.y <= max.y && a.max.y >= min.y &&
+			a.min.z <= max.z && a.max.z >= min.z;
+	}
+
+	/**
+	 * @brief Volume of a hierarchy node's bounds
+	 * @param node Node to measure
+	 * @return Product of the node's side lengths
+	 */
+	static float NodeVolume(const LinearBvhNode& node)
+	{
+		const Vector3 size = node.max - node.min;
+
+		return size.x * size.y * size.z;
+	}
+
+	/**
+	 * @brief Visits every pair of primitives from two hierarchies whose leaves overlap
+	 * @param a First hierarchy
+	 * @param b Second hierarchy, in another frame
+	 * @param placement Placement of b's frame in a's
+	 * @param visit Called as visit(primitiveA, primitiveB); true stops the walk
+	 * @return True if visit stopped the walk
+	 *
+	 * Algorithm:
+	 * 1. Start from the pair of roots
+	 * 2. Drop any pair of nodes whose bounds do not overlap once b's node is
+	 *    placed in a's frame
+	 * 3. Split the larger node of an overlapping pair (or the internal one,
+	 *    if the other is a leaf) and push both of its children paired with
+	 *    the other node
+	 * 4. Pair up the primitives of two overlapping leaves
+	 *
+	 * Each step pops one pair and pushes two, so the stack never holds more
+	 * than the sum of both depths plus one.
+	 */
+	template <typename Visit>
+	static bool WalkPairs(const LinearBvh& a, const LinearBvh& b, const CompoundPlacement& placement, Visit&& visit)
+	{
+		if (a.IsEmpty() || b.IsEmpty())
+		{
+			return false;
+		}
+
+		const int* indicesA = a.indices.empty() ? nullptr : a.indices.data();
+		const int* indicesB = b.indices.empty() ? nullptr : b.indices.data();
+
+		pair<int, int> stack[BVH_QUERY_STACK_SIZE];
+		int top = 0;
+		stack[top++] = { 0, 0 };
+
+		while (top > 0)
+		{
+			const auto [indexA, indexB] = stack[--top];
+			const LinearBvhNode& nodeA = a.nodes[indexA];
+			const LinearBvhNode& nodeB = b.nodes[indexB];
+
+			if (!NodesOverlap(nodeA, nodeB, placement))
+			{
+				continue;
+			}
+
+			if (nodeA.IsLeaf() && nodeB.IsLeaf())
+			{
+				for (int i = nodeA.left; i < nodeA.left + nodeA.Count(); ++i)
+				{
+					const int primitiveA = indicesA != nullptr ? indicesA[i] : i;
+
+					for (int j = nodeB.left; j < nodeB.left + nodeB.Count(); ++j)
+					{
+						if (visit(primitiveA, indicesB != nullptr ? indicesB[j] : j))
+						{
+							return true;
+						}
+					}
+				}
+
+				continue;
+			}
+
+			if (nodeB.IsLeaf() || (!nodeA.IsLeaf() && NodeVolume(nodeA) >= NodeVolume(nodeB)))
+			{
+				stack[top++] = { nodeA.right, indexB };
+				stack[top++] = { nodeA.left, indexB };
+			}
+			else
+			{
+				stack[top++] = { indexA, nodeB.right };
+				stack[top++] = { indexA, nodeB.left };
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Default constructor creating an empty body at the origin
+	 */
+	Compound::Compound()
+		: position{ 0.f }, dirty{ false }
+	{
+	}
+
+	/**
+	 * @brief Creates an empty body
+	 * @param position World position of the local origin
+	 * @param orientation Rotation from local to world space
+	 */
+	Compound::Compound(const Vector3& position, const Matrix3& orientation)
+		: position{ position }, orientation{ orientation }, dirty{ false }
+	{
+	}
+
+	/**
+	 * @brief Copies a body, re-pointing the tree at the copied children
+	 * @param other Body to copy
+	 */
+	Compound::Compound(const Compound& other)
+		: position{ other.position }, orientation{ other.orientation },
+		spheres{ other.spheres }, boxes{ other.boxes }, triangles{ other.triangles },
+		children{ other.children }, tree{ other.tree }, dirty{ other.dirty }
+	{
+		tree.primitives = children.empty() ? nullptr : children.data();
+	}
+
+	/**
+	 * @brief Copies a body, re-pointing the tree at the copied children
+	 * @param other Body to copy
+	 * @return This body
+	 */
+	Compound& Compound::operator=(const Compound& other)
+	{
+		if (this != &other)
+		{
+			position = other.position;
+			orientation = other.orientation;
+			spheres = other.spheres;
+			boxes = other.boxes;
+			triangles = other.triangles;
+			children = other.children;
+			tree = other.tree;
+			dirty = other.dirty;
+			tree.primitives = children.empty() ? nullptr : children.data();
+		}
+
+		return *this;
+	}
+
+	/**
+	 * @brief Adds a sphere child
+	 * @param child Sphere in local space
+	 * @return Index of the new child
+	 */
+	int Compound::Add(const Sphere& child)
+	{
+		spheres.push_back(child);
+		children.emplace_back(CompoundShape::Sphere, static_cast<int>(spheres.size()) - 1);
+		children.back().bounds = BvhTraits<Sphere>::Bounds(child);
+		dirty = true;
+
+		return ChildCount() - 1;
+	}
+
+	/**
+	 * @brief Adds an axis-aligned box child
+	 * @param child Box in local space, stored as an unrotated Obb
+	 * @return Index of the new child
+	 */
+	int Compound::Add(const Aabb& child)
+	{
+		return Add(Obb{ child.origin, child.extents });
+	}
+
+	/**
+	 * @brief Adds an oriented box child
+	 * @param child Box in local space
+	 * @return Index of the new child
+	 */
+	int Compound::Add(const Obb& child)
+	{
+		boxes.push_back(child);
+		children.emplace_back(CompoundShape::Obb, static_cast<int>(boxes.size()) - 1);
+		children.back().bounds = BvhTraits<Obb>::Bounds(child);
+		dirty = true;
+
+		return ChildCount() - 1;
+	}
+
+	/**
+	 * @brief Adds a triangle child
+	 * @param child Triangle in local space
+	 * @return Index of the new child
+	 */
+	int Compound::Add(const Triangle& child)
+	{
+		triangles.push_back(child);
+		children.emplace_back(CompoundShape::Triangle, static_cast<int>(triangles.size()) - 1);
+		children.back().bounds = BvhTraits<Triangle>::Bounds(child);
+		dirty = true;
+
+		return ChildCount() - 1;
+	}
+
+	/**
+	 * @brief Moves the body
+	 * @param position World position of the local origin
+	 * @param orientation Rotation from local to world space
+	 *
+	 * Children and tree stay in local space, so this costs the same for
+	 * any number of children.
+	 */
+	void Compound::SetTransform(const Vector3& position, const Matrix3& orientation)
+	{
+		this->position = position;
+		this->orientation = orientation;
+	}
+
+	/**
+	 * @brief Places a local-space sphere in the world
+	 * @param local Sphere in the body's frame, such as an entry of spheres
+	 * @return The same sphere in world space
+	 */
+	Sphere Compound::ToWorld(const Sphere& local) const
+	{
+		return CompoundPlacement{ orientation, position }.Place(local);
+	}
+
+	/**
+	 * @brief Places a local-space oriented box in the world
+	 * @param local Box in the body's frame, such as an entry of boxes
+	 * @return The same box in world space
+	 */
+	Obb Compound::ToWorld(const Obb& local) const
+	{
+		return CompoundPlacement{ orientation, position }.Place(local);
+	}
+
+	/**
+	 * @brief Places a local-space triangle in the world
+	 * @param local Triangle in the body's frame, such as an entry of triangles
+	 * @return The same triangle in world space
+	 */
+	Triangle Compound::ToWorld(const Triangle& local) const
+	{
+		return CompoundPlacement{ orientation, position }.Place(local);
+	}
+
+	/**
+	 * @brief Builds the tree if children were added since the last build
+	 * @param body Body about to be queried
+	 * @return The body's tree
+	 */
+	static const Bvh<CompoundChild>& Prepare(const Compound& body)
+	{
+		if (body.dirty)
+		{
+			body.tree.Build(body.children);
+			body.dirty = false;
+		}
+
+		return body.tree;
+	}
+
+	/**
+	 * @brief Tests whether the body has any child
+	 * @return True if nothing has been added
+	 */
+	bool Compound::IsEmpty() const
+	{
+		return children.empty();
+	}
+
+	/**
+	 * @brief Number of children
+	 * @return Count over every shape kind
+	 */
+	int Compound::ChildCount() const
+	{
+		return static_cast<int>(children.size());
+	}
+
+	/**
+	 * @brief Box enclosing every child
+	 * @return World-space bounds, or a zero-size box at position if empty
+	 */
+	Aabb Compound::Bounds() const
+	{
+		const Bvh<CompoundChild>& local = Prepare(*this);
+		if (local.IsEmpty())
+		{
+			return { position, Vector3{ 0.f } };
+		}
+
+		const LinearBvhNode& root = local.hierarchy.nodes[0];
+
+		return CompoundPlacement{ orientation, position }.Enclose(root.min, root.max);
+	}
+
+	/**
+	 * @brief Tests a shape against the children it may touch
+	 * @param compound Compound to test
+	 * @param local Shape already placed in the compound's frame
+	 * @return True if any child intersects the shape
+	 */
+	template <typename Shape>
+	static bool LocalIntersects(const Compound& compound, const Shape& local)
+	{
+		return Prepare(compound).Query(BvhTraits<Shape>::Bounds(local), [&](const int index)
+		{
+			return ChildIntersects(compound, compound.children[index], local);
+		}) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether a box touches any child
+	 * @param other Box to test
+	 * @return True if any child intersects the box
+	 *
+	 * In the body's frame the box is oriented, so children are tested
+	 * against an Obb.
+	 */
+	bool Compound::Intersects(const Aabb& other) const
+	{
+		return LocalIntersects(*this, CompoundPlacement::ToLocal(*this).Place(other));
+	}
+
+	/**
+	 * @brief Tests whether an oriented box touches any child
+	 * @param other Oriented box to test
+	 * @return True if any child intersects the box
+	 */
+	bool Compound::Intersects(const Obb& other) const
+	{
+		return LocalIntersects(*this, CompoundPlacement::ToLocal(*this).Place(other));
+	}
+
+	/**
+	 * @brief Tests whether a sphere touches any child
+	 * @param other Sphere to test
+	 * @return True if any child intersects the sphere
+	 */
+	bool Compound::Intersects(const Sphere& other) const
+	{
+		return LocalIntersects(*this, CompoundPlacement::ToLocal(*this).Place(other));
+	}
+
+	/**
+	 * @brief Tests whether a triangle touches any child
+	 * @param other Triangle to test
+	 * @return True if any child intersects the triangle
+	 */
+	bool Compound::Intersects(const Triangle& other) const
+	{
+		return LocalIntersects(*this, CompoundPlacement::ToLocal(*this).Place(other));
+	}
+
+	/**
+	 * @brief Tests whether a plane touches any child
+	 * @param other Plane to test
+	 * @return True if any child intersects the plane
+	 *
+	 * A plane has no bounded box, so the walk enters the nodes the plane
+	 * passes through instead.
+	 */
+	bool Compound::Intersects(const Plane& other) const
+	{
+		const Plane local = CompoundPlacement::ToLocal(*this).Place(other);
+		const Vector3 reach{ MathF::Abs(local.normal.x), MathF::Abs(local.normal.y), MathF::Abs(local.normal.z) };
+
+		return WalkBvh(Prepare(*this).hierarchy, [&](const int, const Vector3& min, const Vector3& max)
+		{
+			const float center = Plane::PlaneEquation((min + max) * .5f, local);
+
+			return MathF::Abs(center) <= Vector3::Dot(reach, (max - min) * .5f);
+		}, [&](const int index)
+		{
+			return ChildIntersects(*this, children[index], local);
+		}) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether a line segment touches any child
+	 * @param other Segment to test
+	 * @return True if any child intersects the segment
+	 */
+	bool Compound::Intersects(const Line& other) const
+	{
+		return LocalIntersects(*this, CompoundPlacement::ToLocal(*this).Place(other));
+	}
+
+	/**
+	 * @brief Tests whether a shape of any kind touches any child
+	 * @param other Shape to test
+	 * @return True if any child intersects the shape
+	 */
+	bool Compound::Intersects(const Shape& other) const
+	{
+		return std::visit([this](const auto& primitive)
+		{
+			return Intersects(primitive);
+		}, other.value);
+	}
+
+	/**
+	 * @brief Tests whether two bodies touch
+	 * @param other Body to test
+	 * @return True if any child of this body intersects any child of the other
+	 *
+	 * Stops at the first touching pair.
+	 */
+	bool Compound::Intersects(const Compound& other) const
+	{
+		const CompoundPlacement placement = CompoundPlacement::Between(other, *this);
+
+		return WalkPairs(Prepare(*this).hierarchy, Prepare(other).hierarchy, placement, [&](const int first, const int second)
+		{
+			return ChildrenIntersect(*this, children[first], other, other.children[second], placement);
+		});
+	}
+
+	/**
+	 * @brief Finds every pair of touching children between two bodies
+	 * @param other Body to test
+	 * @param pairs Receives the touching pairs
+	 * @return Number of pairs written; stops early once pairs is full
+	 */
+	int Compound::Overlaps(const Compound& other, const span<CompoundPair> pairs) const
+	{
+		const int capacity = static_cast<int>(pairs.size());
+		int count = 0;
+
+		if (capacity == 0)
+		{
+			return 0;
+		}
+
+		const CompoundPlacement placement = CompoundPlacement::Between(other, *this);
+
+		WalkPairs(Prepare(*this).hierarchy, Prepare(other).hierarchy, placement, [&](const int first, const int second)
+		{
+			if (ChildrenIntersect(*this, children[first], other, other.children[second], placement))
+			{
+				pairs[count++] = { first, second };
+			}
+
+			return count == capacity;
+		});
+
+		return count;
+	}
+
+	/**
+	 * @brief Casts a ray against every child
+	 * @param ray Ray to cast
+	 * @param child Receives the index of the child hit, if not nullptr (unchanged on a miss)
+	 * @param maxDistance Hits beyond this distance are ignored
+	 * @return Distance along the ray to the first hit, or -1 if there is none
+	 *
+	 * The ray is cast in the body's frame; a rotation keeps distances, so
+	 * they need no conversion back.
+	 */
+	float Compound::CastRay(const Ray& ray, int* child, const float maxDistance) const
+	{
+		const Ray local = CompoundPlacement::ToLocal(*this).Place(ray);
+
+		float distance = -1.f;
+		const int nearest = Prepare(*this).CastRay(local, [&](const int index, float)
+		{
+			const CompoundChild& candidate = children[index];
+			switch (candidate.shape)
+			{
+			case CompoundShape::Sphere:
+				return local.CastAgainst(spheres[candidate.index]);
+			case CompoundShape::Obb:
+				return local.CastAgainst(boxes[candidate.index]);
+			case CompoundShape::Triangle:
+				return local.CastAgainst(triangles[candidate.index]);
+			}
+
+			return -1.f;
+		}, distance, maxDistance);
+
+		if (nearest >= 0 && child != nullptr)
+		{
+			*child = nearest;
+		}
+
+		return distance;
+	}
+}
@@ -0,0 +1,427 @@
+#include "Nudge/Shapes/ConvexDecomposition.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Shapes/Fitting.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/VoxelGrid.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+using std::int64_t;
+
+// Split planes tried along each axis of a part; parts thicker than this
+// many voxel layers are cut at evenly spaced layers only
+constexpr int DECOMPOSITION_SPLIT_CANDIDATES = 8;
+
+namespace Nudge
+{
+	/**
+	 * @brief Solid voxels of the mesh on a grid padded by one empty voxel on every side
+	 */
+	struct DecompositionVolume
+	{
+		int size[3];        ///< Padded voxels along each axis
+		vector<int> owner;  ///< Part index per voxel, -1 outside the solid
+	};
+
+	/**
+	 * @brief Set of solid voxels that will become one hull
+	 */
+	struct DecompositionPart
+	{
+		vector<int> voxels;  ///< Linear voxel indices, x fastest
+		int min[3];          ///< Lowest voxel coordinate along each axis
+		int max[3];          ///< Highest voxel coordinate along each axis
+		ConvexHull hull;     ///< Hull of the voxels, in voxel units of the padded grid
+		double concavity;    ///< Hull volume beyond the voxels, as a fraction of the whole solid
+	};
+
+	/**
+	 * @brief Coordinate of a voxel along one axis
+	 */
+	static int Coordinate(const DecompositionVolume& volume, const int voxel, const int axis)
+	{
+		switch (axis)
+		{
+		case 0: return voxel % volume.size[0];
+		case 1: return voxel / volume.size[0] % volume.size[1];
+		default: return voxel / (volume.size[0] * volume.size[1]);
+		}
+	}
+
+	/**
+	 * @brief Hull of the corners of the voxels on the border of a voxel set
+	 * @param volume Padded voxel grid
+	 * @param voxels Voxels of the set
+	 * @param inside Called with a voxel index, true if that voxel belongs to the set
+	 * @return Hull in voxel units; interior voxels cannot contribute hull vertices and are skipped
+	 */
+	template <typename Inside>
+	static ConvexHull HullOf(const DecompositionVolume& volume, const vector<int>& voxels, Inside&& inside)
+	{
+		const int sx = volume.size[0];
+		const int sxy = volume.size[0] * volume.size[1];
+		const int64_t cx = sx + 1;
+		const int64_t cxy = cx * (volume.size[1] + 1);
+		const int neighbours[6] = { -1, 1, -sx, sx, -sxy, sxy };
+
+		vector<int64_t> corners;
+		for (const int voxel : voxels)
+		{
+			bool border = false;
+			for (const int offset : neighbours)
+			{
+				if (!inside(voxel + offset))
+				{
+					border = true;
+					break;
+				}
+			}
+
+			if (!border)
+			{
+				continue;
+			}
+
+			const int64_t x = voxel % sx;
+			const int64_t y = voxel / sx % volume.size[1];
+			const int64_t z = voxel / sxy;
+
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				corners.push_back((x + (corner & 1)) + cx * (y + (corner >> 1 & 1)) + cxy * (z + (corner >> 2)));
+			}
+		}
+
+		std::sort(corners.begin(), corners.end());
+		corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+
+		vector<Vector3> points;
+		points.reserve(corners.size());
+
+		for (const int64_t corner : corners)
+		{
+			points.emplace_back(static_cast<float>(corner % cx), static_cast<float>(corner / cx % (volume.size[1] + 1)), static_cast<float>(corner / cxy));
+		}
+
+		return ConvexHull{ points };
+	}
+
+	/**
+	 * @brief Fills in a part's bounds, hull and concavity from its voxels
+	 * @param volume Padded voxel grid, with the part's voxels already owned by index
+	 * @param part Part to measure
+	 * @param index Owner index of the part
+	 * @param total Number of solid voxels in the whole grid
+	 */
+	static void Measure(const DecompositionVolume& volume, DecompositionPart& part, const int index, const int total)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			part.min[axis] = volume.size[axis];
+			part.max[axis] = -1;
+		}
+
+		for (const int voxel : part.voxels)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const int c = Coordinate(volume, voxel, axis);
+				part.min[axis] = std::min(part.min[axis], c);
+				part.max[axis] = std::max(part.max[axis], c);
+			}
+		}
+
+		part.hull = HullOf(volume, part.voxels, [&volume, index](const int voxel) { return volume.owner[voxel] == index; });
+		part.concavity = std::max(0.0, (static_cast<double>(part.hull.Volume()) - static_cast<double>(part.voxels.size())) / total);
+	}
+
+	/**
+	 * @brief Voxelizes a closed mesh and fills the space its surface encloses
+	 * @param mesh Mesh to voxelize
+	 * @param resolution Voxels along the longest side of the mesh bounds
+	 * @param volume Receives the padded grid, solid voxels owned by part 0
+	 * @param origin Receives the world position of padded voxel (1, 1, 1)
+	 * @param voxelSize Receives the edge length of a voxel
+	 * @return Number of solid voxels, 0 for an empty or flat mesh
+	 *
+	 * Empty voxels reachable from the padding through empty face neighbours
+	 * are outside; everything else is solid.
+	 */
+	static int Voxelize(const Mesh& mesh, const int resolution, DecompositionVolume& volume, Vector3& origin, float& voxelSize)
+	{
+		const Aabb bounds = Fitting::Bounds(span<const Vector3>{ mesh.vertices, static_cast<size_t>(mesh.numTriangles) * 3 });
+		const float longest = std::max({ bounds.extents.x, bounds.extents.y, bounds.extents.z }) * 2.f;
+
+		if (longest <= 0.f || resolution <= 0)
+		{
+			return 0;
+		}
+
+		voxelSize = longest / static_cast<float>(resolution);
+		const VoxelGrid grid{ mesh, voxelSize };
+
+		if (grid.IsEmpty())
+		{
+			return 0;
+		}
+
+		origin = grid.origin;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			volume.size[axis] = grid.size[axis] + 2;
+		}
+
+		const int sx = volume.size[0];
+		const int sxy = volume.size[0] * volume.size[1];
+		const int count = sxy * volume.size[2];
+
+		// 0 unknown, 1 surface, 2 outside
+		vector<char> state(count, 0);
+		for (int z = 0; z < grid.size[2]; ++z)
+		{
+			for (int y = 0; y < grid.size[1]; ++y)
+			{
+				for (int x = 0; x < grid.size[0]; ++x)
+				{
+					if (grid.IsOccupied(x, y, z))
+					{
+						state[(x + 1) + sx * (y + 1) + sxy * (z + 1)] = 1;
+					}
+				}
+			}
+		}
+
+		vector<int> stack{ 0 };
+		state[0] = 2;
+
+		while (!stack.empty())
+		{
+			const int voxel = stack.back();
+			stack.pop_back();
+
+			const int x = voxel % sx;
+			const int y = voxel / sx % volume.size[1];
+			const int z = voxel / sxy;
+
+			const int neighbours[6][2] =
+			{
+				{ x > 0, voxel - 1 }, { x < sx - 1, voxel + 1 },
+				{ y > 0, voxel - sx }, { y < volume.size[1] - 1, voxel + sx },
+				{ z > 0, voxel - sxy }, { z < volume.size[2] - 1, voxel + sxy }
+			};
+
+			for (const auto& [valid, neighbour] : neighbours)
+			{
+				if (valid && state[neighbour] == 0)
+				{
+					state[neighbour] = 2;
+					stack.push_back(neighbour);
+				}
+			}
+		}
+
+		volume.owner.assign(count, -1);
+		int solid = 0;
+
+		for (int voxel = 0; voxel < count; ++voxel)
+		{
+			if (state[voxel] != 2)
+			{
+				volume.owner[voxel] = 0;
+				++solid;
+			}
+		}
+
+		return solid;
+	}
+
+	/**
+	 * @brief Default constructor allowing 16 hulls at 2% concavity on a 32-voxel grid
+	 */
+	ConvexDecomposition::ConvexDecomposition()
+		: ConvexDecomposition{ 16 }
+	{
+	}
+
+	/**
+	 * @brief Creates a decomposition
+	 * @param maxHulls Largest number of hulls produced
+	 * @param maxConcavity Parts at or below this concavity are not split further
+	 * @param resolution Voxels along the longest side of the mesh bounds
+	 */
+	ConvexDecomposition::ConvexDecomposition(const int maxHulls, const float maxConcavity, const int resolution)
+		: maxHulls{ maxHulls }, maxConcavity{ maxConcavity }, resolution{ resolution }
+	{
+	}
+
+	/**
+	 * @brief Decomposes a mesh into convex hulls
+	 * @param mesh Mesh to decompose
+	 * @param hulls Receives the hulls, in world space
+	 * @return Largest concavity among the hulls
+	 *
+	 * Algorithm:
+	 * 1. Voxelize the surface and flood the outside from the padding; the
+	 *    rest is the solid, one part to start with
+	 * 2. Take the most concave part; for up to DECOMPOSITION_SPLIT_CANDIDATES
+	 *    layers per axis, hull both sides of the cut in parallel
+	 * 3. Replace the part with the two sides of the cut whose hull volumes
+	 *    sum lowest, and repeat until the hull budget or concavity is met
+	 * 4. Move each part's hull from voxel units to world space
+	 */
+	float ConvexDecomposition::Decompose(const Mesh& mesh, vector<ConvexHull>& hulls) const
+	{
+		hulls.clear();
+
+		if (mesh.numTriangles <= 0 || maxHulls <= 0)
+		{
+			return 0.f;
+		}
+
+		DecompositionVolume volume;
+		Vector3 origin;
+		float voxelSize = 0.f;
+
+		const int total = Voxelize(mesh, resolution, volume, origin, voxelSize);
+		if (total == 0)
+		{
+			return 0.f;
+		}
+
+		vector<DecompositionPart> parts(1);
+		for (int voxel = 0; voxel < static_cast<int>(volume.owner.size()); ++voxel)
+		{
+			if (volume.owner[voxel] == 0)
+			{
+				parts[0].voxels.push_back(voxel);
+			}
+		}
+
+		Measure(volume, parts[0], 0, total);
+
+		struct Candidate
+		{
+			int axis;
+			int cut;
+			double cost;
+		};
+
+		vector<Candidate> candidates;
+		while (static_cast<int>(parts.size()) < maxHulls)
+		{
+			int worst = -1;
+			for (int i = 0; i < static_cast<int>(parts.size()); ++i)
+			{
+				if (parts[i].voxels.size() > 1 && (worst < 0 || parts[i].concavity > parts[worst].concavity))
+				{
+					worst = i;
+				}
+			}
+
+			if (worst < 0 || parts[worst].concavity <= maxConcavity)
+			{
+				break;
+			}
+
+			DecompositionPart& part = parts[worst];
+
+			candidates.clear();
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				// Cuts at min + 1 .. max keep voxels on both sides; thick parts try evenly spaced ones
+				const int cuts = part.max[axis] - part.min[axis];
+				const int tried = std::min(cuts, DECOMPOSITION_SPLIT_CANDIDATES);
+
+				for (int i = 1; i <= tried; ++i)
+				{
+					candidates.push_back({ axis, part.min[axis] + (cuts <= tried ? i : i * (cuts + 1) / (tried + 1)), 0.0 });
+				}
+			}
+
+			Parallel::For(static_cast<int>(candidates.size()), 1, [&](int, const int begin, const int end)
+			{
+				vector<int> sides[2];
+
+				for (int c = begin; c < end; ++c)
+				{
+					Candidate& candidate = candidates[c];
+					sides[0].clear();
+					sides[1].clear();
+
+					for (const int voxel : part.voxels)
+					{
+						sides[Coordinate(volume, voxel, candidate.axis) < candidate.cut ? 0 : 1].push_back(voxel);
+					}
+
+					candidate.cost = 0.0;
+					for (int side = 0; side < 2; ++side)
+					{
+						const ConvexHull hull = HullOf(volume, sides[side], [&volume, &candidate, worst, side](const int voxel)
+						{
+							return volume.owner[voxel] == worst && (Coordinate(volume, voxel, candidate.axis) < candidate.cut ? 0 : 1) == side;
+						});
+
+						candidate.cost += hull.Volume();
+					}
+				}
+			});
+
+			const Candidate* best = &candidates[0];
+			for (const Candidate& candidate : candidates)
+			{
+				if (candidate.cost < best->cost)
+				{
+					best = &candidate;
+				}
+			}
+
+			DecompositionPart upper;
+			const int upperIndex = static_cast<int>(parts.size());
+			vector<int> lower;
+
+			for (const int voxel : part.voxels)
+			{
+				if (Coordinate(volume, voxel, best->axis) < best->cut)
+				{
+					lower.push_back(voxel);
+				}
+				else
+				{
+					upper.voxels.push_back(voxel);
+					volume.owner[voxel] = upperIndex;
+				}
+			}
+
+			part.voxels = std::move(lower);
+			Measure(volume, part, worst, total);
+			Measure(volume, upper, upperIndex, total);
+			parts.push_back(std::move(upper));
+		}
+
+		// Padded voxel coordinate c lies at origin + (c - 1) * voxelSize
+		hulls.resize(parts.size());
+		float concavity = 0.f;
+
+		for (size_t i = 0; i < parts.size(); ++i)
+		{
+			ConvexHull& hull = hulls[i];
+			hull = std::move(parts[i].hull);
+
+			for (Vector3& vertex : hull.vertices)
+			{
+				vertex = origin + (vertex - Vector3{ 1.f }) * voxelSize;
+			}
+
+			for (size_t face = 0; face < hull.planes.size(); ++face)
+			{
+				hull.planes[face].distance = Vector3::Dot(hull.planes[face].normal, hull.vertices[hull.indices[face * 3]]);
+			}
+
+			concavity = std::max(concavity, static_cast<float>(parts[i].concavity));
+		}
+
+		return concavity;
+	}
+}
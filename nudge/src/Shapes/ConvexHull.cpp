@@ -0,0 +1,452 @@
+#include "Nudge/Shapes/ConvexHull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using std::uint64_t;
+
+// Distance beyond a face, relative to the extent of the input, at which a
+// point counts as outside while building; closer points are merged away
+constexpr double CONVEX_HULL_EPSILON = 1e-7;
+
+// Distance beyond a face plane still accepted by Contains(), absorbing the
+// rounding of planes stored in single precision
+constexpr float CONVEX_HULL_TOLERANCE = 1e-5f;
+
+namespace Nudge
+{
+	/**
+	 * @brief Face of the hull while it is being built
+	 */
+	struct HullFace
+	{
+		int v[3];             ///< Vertex indices into the input, counter-clockwise from outside
+		double n[3];          ///< Unit outward normal
+		double d;             ///< Plane offset, dot(n, p) = d on the face
+		vector<int> outside;  ///< Input points above this face and no earlier one
+		bool alive;
+	};
+
+	/**
+	 * @brief Builds a face through three points with its plane
+	 * @param p Input points in double precision, three per point
+	 * @param a First vertex
+	 * @param b Second vertex
+	 * @param c Third vertex
+	 * @return Face with a unit normal, or a zero normal if the points are collinear
+	 */
+	static HullFace MakeFace(const vector<double>& p, const int a, const int b, const int c)
+	{
+		HullFace face{ { a, b, c }, { 0.0, 0.0, 0.0 }, 0.0, {}, true };
+
+		const double* pa = &p[a * 3];
+		const double* pb = &p[b * 3];
+		const double* pc = &p[c * 3];
+		const double e0[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+		const double e1[3] = { pc[0] - pa[0], pc[1] - pa[1], pc[2] - pa[2] };
+
+		double n[3] =
+		{
+			e0[1] * e1[2] - e0[2] * e1[1],
+			e0[2] * e1[0] - e0[0] * e1[2],
+			e0[0] * e1[1] - e0[1] * e1[0]
+		};
+
+		const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length > 0.0)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				face.n[i] = n[i] / length;
+			}
+		}
+
+		face.d = face.n[0] * pa[0] + face.n[1] * pa[1] + face.n[2] * pa[2];
+
+		return face;
+	}
+
+	/**
+	 * @brief Signed distance of an input point above a face
+	 */
+	static double Height(const HullFace& face, const vector<double>& p, const int point)
+	{
+		const double* q = &p[point * 3];
+
+		return face.n[0] * q[0] + face.n[1] * q[1] + face.n[2] * q[2] - face.d;
+	}
+
+	/**
+	 * @brief Squared distance between two input points
+	 */
+	static double DistanceSqr(const vector<double>& p, const int a, const int b)
+	{
+		double sum = 0.0;
+		for (int i = 0; i < 3; ++i)
+		{
+			const double delta = p[a * 3 + i] - p[b * 3 + i];
+			sum += delta * delta;
+		}
+
+		return sum;
+	}
+
+	/**
+	 * @brief Default constructor creating an empty hull
+	 */
+	ConvexHull::ConvexHull() = default;
+
+	/**
+	 * @brief Builds the convex hull of a point set
+	 * @param points Points to enclose
+	 *
+	 * Algorithm:
+	 * 1. Find an initial tetrahedron from extreme points, giving up if the
+	 *    input is degenerate
+	 * 2. Give every other point to the first face it lies above
+	 * 3. Repeatedly take the farthest point above a face, remove every face
+	 *    it sees, and connect it to the horizon (edges of removed faces whose
+	 *    other face survives); hand the removed faces' points to the new faces
+	 * 4. Compact the surviving faces and the vertices they use
+	 */
+	ConvexHull::ConvexHull(const span<const Vector3> points)
+	{
+		const int count = static_cast<int>(points.size());
+		if (count < 4)
+		{
+			return;
+		}
+
+		vector<double> p(static_cast<size_t>(count) * 3);
+		double min[3] = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+		double max[3] = { -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+
+		for (int i = 0; i < count; ++i)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				p[i * 3 + axis] = points[i][axis];
+				min[axis] = std::min(min[axis], p[i * 3 + axis]);
+				max[axis] = std::max(max[axis], p[i * 3 + axis]);
+			}
+		}
+
+		const double scale = std::max({ max[0] - min[0], max[1] - min[1], max[2] - min[2], std::abs(min[0]), std::abs(min[1]), std::abs(min[2]),
+			std::abs(max[0]), std::abs(max[1]), std::abs(max[2]) });
+		const double epsilon = CONVEX_HULL_EPSILON * scale;
+
+		// Initial tetrahedron: lowest x, the point farthest from it, the point
+		// farthest from their line, and the point farthest from their plane
+		int simplex[4] = { 0, 0, 0, 0 };
+		for (int i = 1; i < count; ++i)
+		{
+			if (p[i * 3] < p[simplex[0] * 3])
+			{
+				simplex[0] = i;
+			}
+		}
+
+		double best = 0.0;
+		for (int i = 0; i < count; ++i)
+		{
+			const double distance = DistanceSqr(p, simplex[0], i);
+			if (distance > best)
+			{
+				best = distance;
+				simplex[1] = i;
+			}
+		}
+
+		if (best <= epsilon * epsilon)
+		{
+			return;
+		}
+
+		best = 0.0;
+		for (int i = 0; i < count; ++i)
+		{
+			const double* a = &p[simplex[0] * 3];
+			const double* b = &p[simplex[1] * 3];
+			const double* c = &p[i * 3];
+			const double e0[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			const double e1[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			const double cross[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+			const double area = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+
+			if (area > best)
+			{
+				best = area;
+				simplex[2] = i;
+			}
+		}
+
+		if (std::sqrt(best) <= epsilon * scale)
+		{
+			return;
+		}
+
+		const HullFace base = MakeFace(p, simplex[0], simplex[1], simplex[2]);
+		best = 0.0;
+		for (int i = 0; i < count; ++i)
+		{
+			const double height = std::abs(Height(base, p, i));
+			if (height > best)
+			{
+				best = height;
+				simplex[3] = i;
+			}
+		}
+
+		if (best <= epsilon)
+		{
+			return;
+		}
+
+		// Wind the base away from the apex so every face points outward
+		vector<HullFace> faces;
+		if (Height(base, p, simplex[3]) > 0.0)
+		{
+			std::swap(simplex[1], simplex[2]);
+		}
+
+		faces.push_back(MakeFace(p, simplex[0], simplex[1], simplex[2]));
+		faces.push_back(MakeFace(p, simplex[0], simplex[3], simplex[1]));
+		faces.push_back(MakeFace(p, simplex[1], simplex[3], simplex[2]));
+		faces.push_back(MakeFace(p, simplex[2], simplex[3], simplex[0]));
+
+		for (int i = 0; i < count; ++i)
+		{
+			for (HullFace& face : faces)
+			{
+				if (Height(face, p, i) > epsilon)
+				{
+					face.outside.push_back(i);
+					break;
+				}
+			}
+		}
+
+		vector<int> live{ 0, 1, 2, 3 };
+		vector<uint64_t> edges;
+		vector<int> visible;
+		vector<int> orphans;
+
+		for (size_t current = 0; current < faces.size(); ++current)
+		{
+			if (!faces[current].alive || faces[current].outside.empty())
+			{
+				continue;
+			}
+
+			int apex = faces[current].outside[0];
+			double apexHeight = Height(faces[current], p, apex);
+			for (const int point : faces[current].outside)
+			{
+				const double height = Height(faces[current], p, point);
+				if (height > apexHeight)
+				{
+					apexHeight = height;
+					apex = point;
+				}
+			}
+
+			visible.clear();
+			edges.clear();
+			for (const int f : live)
+			{
+				if (Height(faces[f], p, apex) > epsilon)
+				{
+					visible.push_back(f);
+
+					for (int k = 0; k < 3; ++k)
+					{
+						const uint64_t from = static_cast<uint32_t>(faces[f].v[k]);
+						const uint64_t to = static_cast<uint32_t>(faces[f].v[(k + 1) % 3]);
+						edges.push_back(from << 32 | to);
+					}
+				}
+			}
+
+			std::sort(edges.begin(), edges.end());
+
+			orphans.clear();
+			for (const int f : visible)
+			{
+				faces[f].alive = false;
+				orphans.insert(orphans.end(), faces[f].outside.begin(), faces[f].outside.end());
+				faces[f].outside.clear();
+				faces[f].outside.shrink_to_fit();
+			}
+
+			// Horizon edges are those whose reverse is not on a removed face
+			const size_t firstNew = faces.size();
+			for (const uint64_t edge : edges)
+			{
+				const uint64_t reverse = (edge & 0xFFFFFFFFu) << 32 | edge >> 32;
+				if (std::binary_search(edges.begin(), edges.end(), reverse))
+				{
+					continue;
+				}
+
+				faces.push_back(MakeFace(p, static_cast<int>(edge >> 32), static_cast<int>(edge & 0xFFFFFFFFu), apex));
+			}
+
+			std::erase_if(live, [&faces](const int f) { return !faces[f].alive; });
+			for (size_t f = firstNew; f < faces.size(); ++f)
+			{
+				live.push_back(static_cast<int>(f));
+			}
+
+			for (const int point : orphans)
+			{
+				if (point == apex)
+				{
+					continue;
+				}
+
+				for (size_t f = firstNew; f < faces.size(); ++f)
+				{
+					if (Height(faces[f], p, point) > epsilon)
+					{
+						faces[f].outside.push_back(point);
+						break;
+					}
+				}
+			}
+		}
+
+		vector<int> remap(count, -1);
+		for (const HullFace& face : faces)
+		{
+			if (!face.alive)
+			{
+				continue;
+			}
+
+			for (const int v : face.v)
+			{
+				if (remap[v] < 0)
+				{
+					remap[v] = static_cast<int>(vertices.size());
+					vertices.push_back(points[v]);
+				}
+
+				indices.push_back(remap[v]);
+			}
+
+			const Vector3 normal{ static_cast<float>(face.n[0]), static_cast<float>(face.n[1]), static_cast<float>(face.n[2]) };
+			planes.emplace_back(normal, static_cast<float>(face.d));
+		}
+	}
+
+	/**
+	 * @brief Tests whether the hull has any volume
+	 * @return True if the hull was built from degenerate input
+	 */
+	bool ConvexHull::IsEmpty() const
+	{
+		return vertices.empty();
+	}
+
+	/**
+	 * @brief Tests whether a point lies inside or on the hull
+	 * @param point Point to classify
+	 * @return True if the point is behind every face plane
+	 */
+	bool ConvexHull::Contains(const Vector3& point) const
+	{
+		if (IsEmpty())
+		{
+			return false;
+		}
+
+		for (const Plane& plane : planes)
+		{
+			if (Plane::PlaneEquation(point, plane) > CONVEX_HULL_TOLERANCE)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Vertex farthest along a direction
+	 * @param direction Direction to search along
+	 * @return Hull vertex with the largest projection onto the direction
+	 */
+	Vector3 ConvexHull::Support(const Vector3& direction) const
+	{
+		if (IsEmpty())
+		{
+			return Vector3{ 0.f };
+		}
+
+		int best = 0;
+		float bestProjection = Vector3::Dot(vertices[0], direction);
+
+		for (int i = 1; i < static_cast<int>(vertices.size()); ++i)
+		{
+			const float projection = Vector3::Dot(vertices[i], direction);
+			if (projection > bestProjection)
+			{
+				bestProjection = projection;
+				best = i;
+			}
+		}
+
+		return vertices[best];
+	}
+
+	/**
+	 * @brief Volume enclosed by the hull
+	 * @return Sum of the signed tetrahedra between the first vertex and every face
+	 */
+	float ConvexHull::Volume() const
+	{
+		if (IsEmpty())
+		{
+			return 0.f;
+		}
+
+		const Vector3& apex = vertices[0];
+		double volume = 0.0;
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const Vector3 a = vertices[indices[i]] - apex;
+			const Vector3 b = vertices[indices[i + 1]] - apex;
+			const Vector3 c = vertices[indices[i + 2]] - apex;
+
+			volume += static_cast<double>(Vector3::Dot(a, Vector3::Cross(b, c)));
+		}
+
+		return static_cast<float>(volume / 6.0);
+	}
+
+	/**
+	 * @brief Box enclosing the hull
+	 * @return Bounds of the vertices
+	 */
+	Aabb ConvexHull::Bounds() const
+	{
+		if (IsEmpty())
+		{
+			return { Vector3{ 0.f }, Vector3{ 0.f } };
+		}
+
+		Vector3 min = vertices[0];
+		Vector3 max = vertices[0];
+
+		for (const Vector3& vertex : vertices)
+		{
+			min = Vector3::Min(min, vertex);
+			max = Vector3::Max(max, vertex);
+		}
+
+		return Aabb::FromMinMax(min, max);
+	}
+}
@@ -0,0 +1,848 @@
+#include "Nudge/Shapes/Fitting.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+// Smallest number of points worth handing to a thread in a reduction pass
+constexpr int FITTING_MIN_BATCH = 4096;
+
+// Directions whose extreme points span the DiTO-14 ditetrahedron: the world
+// axes and the four cube diagonals (left unnormalized, only the order matters)
+constexpr int FITTING_DIRECTIONS = 7;
+constexpr float FITTING_DIRECTION_VALUES[FITTING_DIRECTIONS][3] =
+{
+	{ 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f },
+	{ 1.f, 1.f, 1.f }, { 1.f, 1.f, -1.f }, { 1.f, -1.f, 1.f }, { 1.f, -1.f, -1.f }
+};
+
+// Relative slack on the squared radius when testing whether a ball already
+// encloses a point, so points on the boundary are not re-solved forever
+constexpr double FITTING_WELZL_TOLERANCE = 1e-9;
+
+// Relative size below which a cross product or determinant is treated as
+// zero, for collinear or coplanar support points
+constexpr double FITTING_DEGENERATE = 1e-12;
+
+// Jacobi rotations applied to the covariance matrix before giving up
+constexpr int FITTING_JACOBI_SWEEPS = 32;
+
+// Seed of the fixed permutation fed to Welzl's algorithm
+constexpr unsigned FITTING_SHUFFLE_SEED = 0x9E3779B9u;
+
+namespace Nudge
+{
+	/**
+	 * @brief Ball solved in double precision during Welzl's algorithm
+	 */
+	struct FittingBall
+	{
+		double center[3];
+		double radiusSquared;  ///< Negative for the empty ball
+	};
+
+	/**
+	 * @brief Extent of a point set along three axes
+	 */
+	struct FittingFrame
+	{
+		float min[3];
+		float max[3];
+	};
+
+	/**
+	 * @brief Extreme points of a point set along the DiTO directions
+	 */
+	struct FittingExtremes
+	{
+		float low[FITTING_DIRECTIONS];
+		float high[FITTING_DIRECTIONS];
+		int lowIndex[FITTING_DIRECTIONS];
+		int highIndex[FITTING_DIRECTIONS];
+	};
+
+	/**
+	 * @brief Sums of coordinates and coordinate products, relative to a reference point
+	 */
+	struct FittingMoments
+	{
+		double sum[3];
+		double products[6];  ///< xx, yy, zz, xy, xz, yz
+	};
+
+	/**
+	 * @brief Runs a reduction over a point range split across worker threads
+	 * @param count Number of points
+	 * @param measure Called as measure(begin, end), returns the partial result of a chunk
+	 * @param merge Called as merge(result, partial), folds one chunk into the result
+	 * @return Result of the first chunk merged with every other chunk in order
+	 */
+	template <typename Measure, typename Merge>
+	static auto Reduce(const int count, Measure&& measure, Merge&& merge)
+	{
+		using Result = decltype(measure(0, 0));
+
+		const int chunks = Parallel::ChunkCount(count, FITTING_MIN_BATCH);
+		vector<Result> partial(chunks);
+
+		Parallel::For(count, FITTING_MIN_BATCH, [&](const int chunk, const int begin, const int end)
+		{
+			partial[chunk] = measure(begin, end);
+		});
+
+		Result result = partial[0];
+		for (int chunk = 1; chunk < chunks; ++chunk)
+		{
+			merge(result, partial[chunk]);
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief Extent of a point set along three axes
+	 * @param points Points to measure (at least one)
+	 * @param axes Axes to project onto
+	 * @return Lowest and highest projection per axis
+	 */
+	static FittingFrame MeasureFrame(const span<const Vector3> points, const Vector3* axes)
+	{
+		const float a[3][3] = { { axes[0].x, axes[0].y, axes[0].z }, { axes[1].x, axes[1].y, axes[1].z }, { axes[2].x, axes[2].y, axes[2].z } };
+
+		return Reduce(static_cast<int>(points.size()), [&](const int begin, const int end)
+		{
+			FittingFrame frame;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				frame.min[axis] = std::numeric_limits<float>::infinity();
+				frame.max[axis] = -std::numeric_limits<float>::infinity();
+			}
+
+			for (int i = begin; i < end; ++i)
+			{
+				const Vector3& p = points[i];
+
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const float projection = p.x * a[axis][0] + p.y * a[axis][1] + p.z * a[axis][2];
+					frame.min[axis] = std::min(frame.min[axis], projection);
+					frame.max[axis] = std::max(frame.max[axis], projection);
+				}
+			}
+
+			return frame;
+		},
+		[](FittingFrame& result, const FittingFrame& other)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				result.min[axis] = std::min(result.min[axis], other.min[axis]);
+				result.max[axis] = std::max(result.max[axis], other.max[axis]);
+			}
+		});
+	}
+
+	/**
+	 * @brief Half the surface area of a box
+	 * @param frame Extent of the box along its axes
+	 * @return xy + yz + zx of the box's edge lengths
+	 */
+	static float HalfArea(const FittingFrame& frame)
+	{
+		const float x = frame.max[0] - frame.min[0];
+		const float y = frame.max[1] - frame.min[1];
+		const float z = frame.max[2] - frame.min[2];
+
+		return x * y + y * z + z * x;
+	}
+
+	/**
+	 * @brief Builds the oriented box spanning an extent along three axes
+	 * @param axes Orthonormal axes
+	 * @param frame Extent along each axis
+	 * @return Oriented box with the axes as orientation columns
+	 */
+	static Obb FrameBox(const Vector3* axes, const FittingFrame& frame)
+	{
+		Vector3 origin{ 0.f };
+		Vector3 extents;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			origin += axes[axis] * ((frame.min[axis] + frame.max[axis]) * .5f);
+			extents[axis] = (frame.max[axis] - frame.min[axis]) * .5f;
+		}
+
+		return { origin, extents, Matrix3{ axes[0], axes[1], axes[2] } };
+	}
+
+	/**
+	 * @brief Completes a right-handed orthonormal frame from one direction and a hint for the second
+	 * @param first Direction of the first axis (non-zero)
+	 * @param hint Direction the second axis should lie closest to; replaced when parallel to first
+	 * @param axes Receives the three axes
+	 */
+	static void CompleteFrame(const Vector3& first, const Vector3& hint, Vector3* axes)
+	{
+		axes[0] = first.Normalized();
+
+		Vector3 second = hint - axes[0] * Vector3::Dot(hint, axes[0]);
+		if (second.MagnitudeSqr() <= FITTING_DEGENERATE * hint.MagnitudeSqr() || second.MagnitudeSqr() == 0.f)
+		{
+			// Any direction not parallel to the first axis will do
+			const Vector3 fallback = MathF::Abs(axes[0].x) < .6f ? Vector3::UnitX() : Vector3::UnitY();
+			second = fallback - axes[0] * Vector3::Dot(fallback, axes[0]);
+		}
+
+		axes[1] = second.Normalized();
+		axes[2] = Vector3::Cross(axes[0], axes[1]);
+	}
+
+	/**
+	 * @brief Eigenvectors of a symmetric 3x3 matrix by cyclic Jacobi rotations
+	 * @param matrix Symmetric matrix; destroyed
+	 * @param axes Receives the eigenvectors as a right-handed orthonormal frame
+	 */
+	static void Eigenvectors(double matrix[3][3], Vector3* axes)
+	{
+		double vectors[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+		const int pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+		for (int sweep = 0; sweep < FITTING_JACOBI_SWEEPS; ++sweep)
+		{
+			const double off = matrix[0][1] * matrix[0][1] + matrix[0][2] * matrix[0][2] + matrix[1][2] * matrix[1][2];
+			const double diagonal = matrix[0][0] * matrix[0][0] + matrix[1][1] * matrix[1][1] + matrix[2][2] * matrix[2][2];
+			if (off <= FITTING_DEGENERATE * FITTING_DEGENERATE * diagonal)
+			{
+				break;
+			}
+
+			for (const auto& pair : pairs)
+			{
+				const int p = pair[0];
+				const int q = pair[1];
+				if (matrix[p][q] == 0.0)
+				{
+					continue;
+				}
+
+				// Rotation in the (p, q) plane zeroing matrix[p][q] (Numerical Recipes, jacobi)
+				const double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * matrix[p][q]);
+				const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+				const double c = 1.0 / std::sqrt(t * t + 1.0);
+				const double s = t * c;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					const double kp = matrix[k][p];
+					const double kq = matrix[k][q];
+					matrix[k][p] = c * kp - s * kq;
+					matrix[k][q] = s * kp + c * kq;
+				}
+
+				for (int k = 0; k < 3; ++k)
+				{
+					const double pk = matrix[p][k];
+					const double qk = matrix[q][k];
+					matrix[p][k] = c * pk - s * qk;
+					matrix[q][k] = s * pk + c * qk;
+				}
+
+				for (int k = 0; k < 3; ++k)
+				{
+					const double kp = vectors[k][p];
+					const double kq = vectors[k][q];
+					vectors[k][p] = c * kp - s * kq;
+					vectors[k][q] = s * kp + c * kq;
+				}
+			}
+		}
+
+		const Vector3 first{ static_cast<float>(vectors[0][0]), static_cast<float>(vectors[1][0]), static_cast<float>(vectors[2][0]) };
+		const Vector3 second{ static_cast<float>(vectors[0][1]), static_cast<float>(vectors[1][1]), static_cast<float>(vectors[2][1]) };
+		CompleteFrame(first, second, axes);
+	}
+
+	/**
+	 * @brief Squared distance from a ball's center to a point
+	 * @param ball Ball to measure from
+	 * @param point Point to measure to
+	 * @return Squared distance in double precision
+	 */
+	static double DistanceSquared(const FittingBall& ball, const Vector3& point)
+	{
+		const double dx = point.x - ball.center[0];
+		const double dy = point.y - ball.center[1];
+		const double dz = point.z - ball.center[2];
+
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	/**
+	 * @brief Tests whether a ball encloses a point, with FITTING_WELZL_TOLERANCE slack
+	 * @param ball Ball to test
+	 * @param point Point to test
+	 * @return True if the point is inside or on the ball
+	 */
+	static bool Encloses(const FittingBall& ball, const Vector3& point)
+	{
+		return ball.radiusSquared >= 0.0 && DistanceSquared(ball, point) <= ball.radiusSquared * (1.0 + FITTING_WELZL_TOLERANCE);
+	}
+
+	/**
+	 * @brief Ball with two points as a diameter
+	 * @param a First point
+	 * @param b Second point
+	 * @return Smallest ball through both points
+	 */
+	static FittingBall PairBall(const Vector3& a, const Vector3& b)
+	{
+		FittingBall ball;
+		const double ends[2][3] = { { a.x, a.y, a.z }, { b.x, b.y, b.z } };
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			ball.center[axis] = (ends[0][axis] + ends[1][axis]) * .5;
+		}
+
+		ball.radiusSquared = DistanceSquared(ball, a);
+
+		return ball;
+	}
+
+	/**
+	 * @brief Smallest ball with three points on its boundary
+	 * @param a First point
+	 * @param b Second point
+	 * @param c Third point
+	 * @param ball Receives the ball through all three points
+	 * @return False if the points are collinear
+	 */
+	static bool CircumBall(const Vector3& a, const Vector3& b, const Vector3& c, FittingBall& ball)
+	{
+		const double ab[3] = { double(b.x) - a.x, double(b.y) - a.y, double(b.z) - a.z };
+		const double ac[3] = { double(c.x) - a.x, double(c.y) - a.y, double(c.z) - a.z };
+		const double n[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+
+		const double abSquared = ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2];
+		const double acSquared = ac[0] * ac[0] + ac[1] * ac[1] + ac[2] * ac[2];
+		const double nSquared = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+
+		if (nSquared <= FITTING_DEGENERATE * abSquared * acSquared)
+		{
+			return false;
+		}
+
+		// a + (|ac|^2 (n x ab) + |ab|^2 (ac x n)) / (2 |n|^2)
+		const double nab[3] = { n[1] * ab[2] - n[2] * ab[1], n[2] * ab[0] - n[0] * ab[2], n[0] * ab[1] - n[1] * ab[0] };
+		const double acn[3] = { ac[1] * n[2] - ac[2] * n[1], ac[2] * n[0] - ac[0] * n[2], ac[0] * n[1] - ac[1] * n[0] };
+		const double origin[3] = { a.x, a.y, a.z };
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			ball.center[axis] = origin[axis] + (acSquared * nab[axis] + abSquared * acn[axis]) / (2.0 * nSquared);
+		}
+
+		ball.radiusSquared = DistanceSquared(ball, a);
+
+		return true;
+	}
+
+	/**
+	 * @brief Smallest ball whose boundary passes through every support point
+	 * @param support Support points
+	 * @param count Number of support points, at most 4
+	 * @return Ball through the support points; for collinear or coplanar
+	 *         points, the smallest lower-order ball enclosing them all
+	 */
+	static FittingBall SupportBall(const Vector3* support, const int count)
+	{
+		FittingBall ball{};
+
+		switch (count)
+		{
+		case 0:
+			ball.radiusSquared = -1.0;
+			return ball;
+
+		case 1:
+			ball.center[0] = support[0].x;
+			ball.center[1] = support[0].y;
+			ball.center[2] = support[0].z;
+			ball.radiusSquared = 0.0;
+			return ball;
+
+		case 2:
+			return PairBall(support[0], support[1]);
+
+		case 3:
+			if (CircumBall(support[0], support[1], support[2], ball))
+			{
+				return ball;
+			}
+			break;
+
+		default:
+		{
+			const Vector3& a = support[0];
+			const double rows[3][3] =
+			{
+				{ double(support[1].x) - a.x, double(support[1].y) - a.y, double(support[1].z) - a.z },
+				{ double(support[2].x) - a.x, double(support[2].y) - a.y, double(support[2].z) - a.z },
+				{ double(support[3].x) - a.x, double(support[3].y) - a.y, double(support[3].z) - a.z }
+			};
+			const double rhs[3] =
+			{
+				(rows[0][0] * rows[0][0] + rows[0][1] * rows[0][1] + rows[0][2] * rows[0][2]) * .5,
+				(rows[1][0] * rows[1][0] + rows[1][1] * rows[1][1] + rows[1][2] * rows[1][2]) * .5,
+				(rows[2][0] * rows[2][0] + rows[2][1] * rows[2][1] + rows[2][2] * rows[2][2]) * .5
+			};
+
+			const double determinant =
+				rows[0][0] * (rows[1][1] * rows[2][2] - rows[1][2] * rows[2][1]) -
+				rows[0][1] * (rows[1][0] * rows[2][2] - rows[1][2] * rows[2][0]) +
+				rows[0][2] * (rows[1][0] * rows[2][1] - rows[1][1] * rows[2][0]);
+			const double scale = std::sqrt(rhs[0] * rhs[1] * rhs[2]) * 8.0;
+
+			if (std::abs(determinant) > FITTING_DEGENERATE * scale)
+			{
+				// Cramer's rule for the center relative to a
+				double solution[3];
+				for (int column = 0; column < 3; ++column)
+				{
+					double m[3][3];
+					for (int row = 0; row < 3; ++row)
+					{
+						for (int k = 0; k < 3; ++k)
+						{
+							m[row][k] = k == column ? rhs[row] : rows[row][k];
+						}
+					}
+
+					solution[column] =
+						(m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+						 m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+						 m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) / determinant;
+				}
+
+				ball.center[0] = a.x + solution[0];
+				ball.center[1] = a.y + solution[1];
+				ball.center[2] = a.z + solution[2];
+				ball.radiusSquared = DistanceSquared(ball, a);
+				return ball;
+			}
+			break;
+		}
+		}
+
+		// Degenerate support: the smallest ball over any two or three of the points that encloses them all
+		FittingBall best{};
+		best.radiusSquared = std::numeric_limits<double>::infinity();
+
+		auto consider = [&](const FittingBall& candidate)
+		{
+			if (candidate.radiusSquared >= best.radiusSquared)
+			{
+				return;
+			}
+
+			for (int i = 0; i < count; ++i)
+			{
+				if (!Encloses(candidate, support[i]))
+				{
+					return;
+				}
+			}
+
+			best = candidate;
+		};
+
+		for (int i = 0; i < count; ++i)
+		{
+			for (int j = i + 1; j < count; ++j)
+			{
+				consider(PairBall(support[i], support[j]));
+
+				for (int k = j + 1; k < count && count > 3; ++k)
+				{
+					FittingBall candidate;
+					if (CircumBall(support[i], support[j], support[k], candidate))
+					{
+						consider(candidate);
+					}
+				}
+			}
+		}
+
+		return best;
+	}
+
+	/**
+	 * @brief Welzl's recursion: smallest ball enclosing the first points with a given support
+	 * @param points Points in random order
+	 * @param end Number of leading points to enclose
+	 * @param support Support points so far; room for 4
+	 * @param count Number of support points
+	 * @return Smallest ball enclosing points[0, end) with the support points on its boundary
+	 */
+	static FittingBall Welzl(const vector<Vector3>& points, const int end, Vector3* support, const int count)
+	{
+		FittingBall ball = SupportBall(support, count);
+		if (count == 4)
+		{
+			return ball;
+		}
+
+		for (int i = 0; i < end; ++i)
+		{
+			if (!Encloses(ball, points[i]))
+			{
+				support[count] = points[i];
+				ball = Welzl(points, i, support, count + 1);
+			}
+		}
+
+		return ball;
+	}
+
+	/**
+	 * @brief Axis-aligned box of a point set
+	 * @param points Points to enclose
+	 * @return Smallest enclosing box, or a zero box at the origin if there are no points
+	 */
+	Aabb Fitting::Bounds(const span<const Vector3> points)
+	{
+		if (points.empty())
+		{
+			return { Vector3{ 0.f }, Vector3{ 0.f } };
+		}
+
+		const Vector3 axes[3] = { Vector3::UnitX(), Vector3::UnitY(), Vector3::UnitZ() };
+		const FittingFrame frame = MeasureFrame(points, axes);
+
+		return Aabb::FromMinMax(Vector3{ frame.min[0], frame.min[1], frame.min[2] }, Vector3{ frame.max[0], frame.max[1], frame.max[2] });
+	}
+
+	/**
+	 * @brief Smallest sphere enclosing a point set
+	 * @param points Points to enclose
+	 * @return Minimal sphere, or a zero sphere at the origin if there are no points
+	 */
+	Sphere Fitting::MinimalSphere(const span<const Vector3> points)
+	{
+		if (points.empty())
+		{
+			return { Vector3{ 0.f }, 0.f };
+		}
+
+		// Welzl's expected linear time needs the points in random order
+		vector<Vector3> shuffled(points.begin(), points.end());
+		std::shuffle(shuffled.begin(), shuffled.end(), std::minstd_rand{ FITTING_SHUFFLE_SEED });
+
+		Vector3 support[4];
+		const FittingBall ball = Welzl(shuffled, static_cast<int>(shuffled.size()), support, 0);
+		const Vector3 center{ static_cast<float>(ball.center[0]), static_cast<float>(ball.center[1]), static_cast<float>(ball.center[2]) };
+
+		// Measure the float center against every point so none ends up outside
+		const float radiusSquared = Reduce(static_cast<int>(points.size()), [&](const int begin, const int end)
+		{
+			float farthest = 0.f;
+			for (int i = begin; i < end; ++i)
+			{
+				const float dx = points[i].x - center.x;
+				const float dy = points[i].y - center.y;
+				const float dz = points[i].z - center.z;
+				farthest = std::max(farthest, dx * dx + dy * dy + dz * dz);
+			}
+
+			return farthest;
+		},
+		[](float& result, const float other)
+		{
+			result = std::max(result, other);
+		});
+
+		return { center, std::nextafter(std::sqrt(radiusSquared), std::numeric_limits<float>::infinity()) };
+	}
+
+	/**
+	 * @brief Smallest sphere enclosing a mesh
+	 * @param mesh Mesh to enclose
+	 * @return Minimal sphere over the mesh's vertices
+	 */
+	Sphere Fitting::MinimalSphere(const Mesh& mesh)
+	{
+		return MinimalSphere(span<const Vector3>{ mesh.vertices, static_cast<size_t>(std::max(mesh.numTriangles, 0)) * 3 });
+	}
+
+	/**
+	 * @brief Tight oriented box enclosing a point set
+	 * @param points Points to enclose
+	 * @return Enclosing box with the smallest surface area among the candidate orientations,
+	 *         or a zero box at the origin if there are no points
+	 */
+	Obb Fitting::TightObb(const span<const Vector3> points)
+	{
+		if (points.empty())
+		{
+			return { Vector3{ 0.f }, Vector3{ 0.f } };
+		}
+
+		const int count = static_cast<int>(points.size());
+		const Vector3 reference = points[0];
+
+		// One pass gathers the DiTO extremes and the moments for PCA
+		struct Gathered
+		{
+			FittingExtremes extremes;
+			FittingMoments moments;
+		};
+
+		const Gathered gathered = Reduce(count, [&](const int begin, const int end)
+		{
+			Gathered partial{};
+			for (int d = 0; d < FITTING_DIRECTIONS; ++d)
+			{
+				partial.extremes.low[d] = std::numeric_limits<float>::infinity();
+				partial.extremes.high[d] = -std::numeric_limits<float>::infinity();
+			}
+
+			for (int i = begin; i < end; ++i)
+			{
+				const Vector3& p = points[i];
+
+				for (int d = 0; d < FITTING_DIRECTIONS; ++d)
+				{
+					const float projection = p.x * FITTING_DIRECTION_VALUES[d][0] + p.y * FITTING_DIRECTION_VALUES[d][1] + p.z * FITTING_DIRECTION_VALUES[d][2];
+
+					if (projection < partial.extremes.low[d])
+					{
+						partial.extremes.low[d] = projection;
+						partial.extremes.lowIndex[d] = i;
+					}
+
+					if (projection > partial.extremes.high[d])
+					{
+						partial.extremes.high[d] = projection;
+						partial.extremes.highIndex[d] = i;
+					}
+				}
+
+				const double x = double(p.x) - reference.x;
+				const double y = double(p.y) - reference.y;
+				const double z = double(p.z) - reference.z;
+
+				partial.moments.sum[0] += x;
+				partial.moments.sum[1] += y;
+				partial.moments.sum[2] += z;
+				partial.moments.products[0] += x * x;
+				partial.moments.products[1] += y * y;
+				partial.moments.products[2] += z * z;
+				partial.moments.products[3] += x * y;
+				partial.moments.products[4] += x * z;
+				partial.moments.products[5] += y * z;
+			}
+
+			return partial;
+		},
+		[](Gathered& result, const Gathered& other)
+		{
+			for (int d = 0; d < FITTING_DIRECTIONS; ++d)
+			{
+				if (other.extremes.low[d] < result.extremes.low[d])
+				{
+					result.extremes.low[d] = other.extremes.low[d];
+					result.extremes.lowIndex[d] = other.extremes.lowIndex[d];
+				}
+
+				if (other.extremes.high[d] > result.extremes.high[d])
+				{
+					result.extremes.high[d] = other.extremes.high[d];
+					result.extremes.highIndex[d] = other.extremes.highIndex[d];
+				}
+			}
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				result.moments.sum[axis] += other.moments.sum[axis];
+			}
+
+			for (int k = 0; k < 6; ++k)
+			{
+				result.moments.products[k] += other.moments.products[k];
+			}
+		});
+
+		// Candidate 1: world axes
+		Vector3 bestAxes[3] = { Vector3::UnitX(), Vector3::UnitY(), Vector3::UnitZ() };
+		FittingFrame bestFrame = MeasureFrame(points, bestAxes);
+		float bestArea = HalfArea(bestFrame);
+
+		auto consider = [&](const Vector3* axes, const FittingFrame& frame)
+		{
+			const float area = HalfArea(frame);
+			if (area < bestArea)
+			{
+				bestArea = area;
+				bestFrame = frame;
+				std::copy(axes, axes + 3, bestAxes);
+			}
+		};
+
+		// Candidate 2: principal axes of the covariance
+		{
+			const double n = count;
+			const double* sum = gathered.moments.sum;
+			const double* products = gathered.moments.products;
+
+			double covariance[3][3];
+			covariance[0][0] = products[0] / n - sum[0] * sum[0] / (n * n);
+			covariance[1][1] = products[1] / n - sum[1] * sum[1] / (n * n);
+			covariance[2][2] = products[2] / n - sum[2] * sum[2] / (n * n);
+			covariance[0][1] = covariance[1][0] = products[3] / n - sum[0] * sum[1] / (n * n);
+			covariance[0][2] = covariance[2][0] = products[4] / n - sum[0] * sum[2] / (n * n);
+			covariance[1][2] = covariance[2][1] = products[5] / n - sum[1] * sum[2] / (n * n);
+
+			Vector3 axes[3];
+			Eigenvectors(covariance, axes);
+			consider(axes, MeasureFrame(points, axes));
+		}
+
+		// Candidate 3: edges of the ditetrahedron over the 14 extreme points
+		Vector3 extremes[FITTING_DIRECTIONS * 2];
+		for (int d = 0; d < FITTING_DIRECTIONS; ++d)
+		{
+			extremes[d * 2] = points[gathered.extremes.lowIndex[d]];
+			extremes[d * 2 + 1] = points[gathered.extremes.highIndex[d]];
+		}
+
+		const span<const Vector3> extremeSpan{ extremes };
+
+		// Base edge: the farthest-apart extreme pair of any direction
+		int baseDirection = 0;
+		float baseLength = -1.f;
+		for (int d = 0; d < FITTING_DIRECTIONS; ++d)
+		{
+			const float length = (extremes[d * 2 + 1] - extremes[d * 2]).MagnitudeSqr();
+			if (length > baseLength)
+			{
+				baseLength = length;
+				baseDirection = d;
+			}
+		}
+
+		if (baseLength <= 0.f)
+		{
+			// Every point coincides
+			return FrameBox(bestAxes, bestFrame);
+		}
+
+		const Vector3 p0 = extremes[baseDirection * 2];
+		const Vector3 p1 = extremes[baseDirection * 2 + 1];
+		const Vector3 edge = p1 - p0;
+
+		// Third vertex: the extreme point farthest from the base edge's line
+		Vector3 p2 = p0;
+		float apex = 0.f;
+		for (const Vector3& point : extremes)
+		{
+			const float distance = Vector3::Cross(point - p0, edge).MagnitudeSqr();
+			if (distance > apex)
+			{
+				apex = distance;
+				p2 = point;
+			}
+		}
+
+		auto considerTriangle = [&](const Vector3& a, const Vector3& b, const Vector3& c)
+		{
+			const Vector3 normal = Vector3::Cross(b - a, c - a);
+			if (normal.MagnitudeSqr() <= 0.f)
+			{
+				return;
+			}
+
+			const Vector3 edges[3] = { b - a, c - b, a - c };
+			for (const Vector3& side : edges)
+			{
+				if (side.MagnitudeSqr() <= 0.f)
+				{
+					continue;
+				}
+
+				// Axes: the edge, the triangle normal and their cross product
+				Vector3 axes[3];
+				CompleteFrame(side, Vector3::Cross(normal, side), axes);
+
+				const FittingFrame frame = MeasureFrame(extremeSpan, axes);
+				if (HalfArea(frame) < bestArea)
+				{
+					// Ranked on the extremes; keep only if it holds up over every point
+					consider(axes, MeasureFrame(points, axes));
+				}
+			}
+		};
+
+		if (apex <= FITTING_DEGENERATE * baseLength * baseLength)
+		{
+			// Collinear extremes: only the base edge's direction is meaningful
+			Vector3 axes[3];
+			CompleteFrame(edge, Vector3::UnitY(), axes);
+			consider(axes, MeasureFrame(points, axes));
+
+			return FrameBox(bestAxes, bestFrame);
+		}
+
+		considerTriangle(p0, p1, p2);
+
+		// Apexes of the two tetrahedra: extremes farthest above and below the base triangle
+		const Vector3 normal = Vector3::Cross(edge, p2 - p0).Normalized();
+		Vector3 above = p0;
+		Vector3 below = p0;
+		float highest = 0.f;
+		float lowest = 0.f;
+
+		for (const Vector3& point : extremes)
+		{
+			const float height = Vector3::Dot(point - p0, normal);
+			if (height > highest)
+			{
+				highest = height;
+				above = point;
+			}
+
+			if (height < lowest)
+			{
+				lowest = height;
+				below = point;
+			}
+		}
+
+		for (const Vector3& q : { above, below })
+		{
+			considerTriangle(p0, p1, q);
+			considerTriangle(p1, p2, q);
+			considerTriangle(p2, p0, q);
+		}
+
+		return FrameBox(bestAxes, bestFrame);
+	}
+
+	/**
+	 * @brief Tight oriented box enclosing a mesh
+	 * @param mesh Mesh to enclose
+	 * @return Oriented box over the mesh's vertices
+	 */
+	Obb Fitting::TightObb(const Mesh& mesh)
+	{
+		return TightObb(span<const Vector3>{ mesh.vertices, static_cast<size_t>(std::max(mesh.numTriangles, 0)) * 3 });
+	}
+}
@@ -0,0 +1,781 @@
+#include "Nudge/Shapes/Heightfield.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Bvh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Stack capacity for pyramid walks: each level pops one entry and pushes at
+// most four, and a field of 2^31 cells per side has fewer than 32 levels
+constexpr int HEIGHTFIELD_STACK_SIZE = 4 * 32;
+
+// Largest 16-bit quantized height
+constexpr float HEIGHTFIELD_QUANTIZED_MAX = 65535.f;
+
+// Tile rows measured per parallel task when building the pyramid
+constexpr int HEIGHTFIELD_MIP_BATCH = 16;
+
+namespace Nudge
+{
+	/**
+	 * @brief Range of cells covered by one pyramid entry
+	 * @param field Field owning the pyramid
+	 * @param level Pyramid level
+	 * @param x Entry column at that level
+	 * @param z Entry row at that level
+	 * @param cells Receives the first and one-past-last cell column, then row
+	 */
+	static void EntryCells(const Heightfield& field, const int level, const int x, const int z, int* cells)
+	{
+		const int size = HEIGHTFIELD_TILE_SIZE << level;
+
+		cells[0] = x * size;
+		cells[1] = std::min(cells[0] + size, field.columns - 1);
+		cells[2] = z * size;
+		cells[3] = std::min(cells[2] + size, field.rows - 1);
+	}
+
+	/**
+	 * @brief Box enclosing one pyramid entry
+	 * @param field Field owning the pyramid
+	 * @param level Pyramid level
+	 * @param x Entry column at that level
+	 * @param z Entry row at that level
+	 * @param min Receives the minimum corner
+	 * @param max Receives the maximum corner
+	 */
+	static void EntryBounds(const Heightfield& field, const int level, const int x, const int z, Vector3& min, Vector3& max)
+	{
+		const HeightfieldMip& mip = field.mips[level];
+		const int entry = z * mip.columns + x;
+
+		int cells[4];
+		EntryCells(field, level, x, z, cells);
+
+		min = Vector3{ field.origin.x + cells[0] * field.spacingX, field.origin.y + mip.min[entry], field.origin.z + cells[2] * field.spacingZ };
+		max = Vector3{ field.origin.x + cells[1] * field.spacingX, field.origin.y + mip.max[entry], field.origin.z + cells[3] * field.spacingZ };
+	}
+
+	/**
+	 * @brief World position of a sample
+	 * @param field Field owning the sample
+	 * @param x Sample column
+	 * @param z Sample row
+	 * @return Position of the sample
+	 */
+	static Vector3 SamplePoint(const Heightfield& field, const int x, const int z)
+	{
+		return { field.origin.x + x * field.spacingX, field.origin.y + field.Height(x, z), field.origin.z + z * field.spacingZ };
+	}
+
+	/**
+	 * @brief Front-face ray-triangle test (Moller-Trumbore)
+	 * @param ray Prepared ray
+	 * @param a First vertex
+	 * @param b Second vertex
+	 * @param c Third vertex
+	 * @return Hit distance, or -1 if the ray misses or meets the back face
+	 *
+	 * Evaluated in double precision: the test is not watertight, and in float
+	 * a shallow ray crossing the edge two cells share can round to just
+	 * outside both triangles and fall through the surface.
+	 */
+	static float CastTriangle(const PreparedRay& ray, const Vector3& a, const Vector3& b, const Vector3& c)
+	{
+		const double e1[3] = { double(b.x) - a.x, double(b.y) - a.y, double(b.z) - a.z };
+		const double e2[3] = { double(c.x) - a.x, double(c.y) - a.y, double(c.z) - a.z };
+		const double d[3] = { ray.direction[0], ray.direction[1], ray.direction[2] };
+
+		const double p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+		const double determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+
+		if (!(determinant > 0.0))
+		{
+			return -1.f;
+		}
+
+		const double s[3] = { double(ray.origin[0]) - a.x, double(ray.origin[1]) - a.y, double(ray.origin[2]) - a.z };
+		const double u = s[0] * p[0] + s[1] * p[1] + s[2] * p[2];
+		if (u < 0.0 || u > determinant)
+		{
+			return -1.f;
+		}
+
+		const double q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+		const double v = d[0] * q[0] + d[1] * q[1] + d[2] * q[2];
+		if (v < 0.0 || u + v > determinant)
+		{
+			return -1.f;
+		}
+
+		const double t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / determinant;
+
+		return t >= 0.0 ? float(t) : -1.f;
+	}
+
+	/**
+	 * @brief Visits the cells whose bounds overlap a box, walking the pyramid
+	 * @param field Field to walk
+	 * @param min Minimum corner of the box
+	 * @param max Maximum corner of the box
+	 * @param visit Called as visit(x, z) for each cell; returns true to stop the walk
+	 * @return True if visit stopped the walk
+	 */
+	template <typename Visit>
+	static bool VisitCells(const Heightfield& field, const Vector3& min, const Vector3& max, Visit&& visit)
+	{
+		if (field.IsEmpty())
+		{
+			return false;
+		}
+
+		int levels[HEIGHTFIELD_STACK_SIZE];
+		int xs[HEIGHTFIELD_STACK_SIZE];
+		int zs[HEIGHTFIELD_STACK_SIZE];
+		int top = 0;
+
+		levels[top] = static_cast<int>(field.mips.size()) - 1;
+		xs[top] = 0;
+		zs[top++] = 0;
+
+		while (top > 0)
+		{
+			--top;
+			const int level = levels[top];
+			const int x = xs[top];
+			const int z = zs[top];
+
+			Vector3 entryMin;
+			Vector3 entryMax;
+			EntryBounds(field, level, x, z, entryMin, entryMax);
+
+			if (entryMin.x > max.x || entryMax.x < min.x ||
+				entryMin.y > max.y || entryMax.y < min.y ||
+				entryMin.z > max.z || entryMax.z < min.z)
+			{
+				continue;
+			}
+
+			if (level > 0)
+			{
+				const HeightfieldMip& below = field.mips[level - 1];
+
+				for (int child = 0; child < 4; ++child)
+				{
+					const int childX = x * 2 + (child & 1);
+					const int childZ = z * 2 + (child >> 1);
+
+					if (childX < below.columns && childZ < below.rows)
+					{
+						levels[top] = level - 1;
+						xs[top] = childX;
+						zs[top++] = childZ;
+					}
+				}
+
+				continue;
+			}
+
+			int cells[4];
+			EntryCells(field, 0, x, z, cells);
+
+			const int firstX = std::max(cells[0], static_cast<int>(std::floor((min.x - field.origin.x) / field.spacingX)));
+			const int lastX = std::min(cells[1] - 1, static_cast<int>(std::floor((max.x - field.origin.x) / field.spacingX)));
+			const int firstZ = std::max(cells[2], static_cast<int>(std::floor((min.z - field.origin.z) / field.spacingZ)));
+			const int lastZ = std::min(cells[3] - 1, static_cast<int>(std::floor((max.z - field.origin.z) / field.spacingZ)));
+
+			for (int cellZ = firstZ; cellZ <= lastZ; ++cellZ)
+			{
+				for (int cellX = firstX; cellX <= lastX; ++cellX)
+				{
+					const float h00 = field.Height(cellX, cellZ);
+					const float h10 = field.Height(cellX + 1, cellZ);
+					const float h01 = field.Height(cellX, cellZ + 1);
+					const float h11 = field.Height(cellX + 1, cellZ + 1);
+
+					const float low = field.origin.y + std::min(std::min(h00, h10), std::min(h01, h11));
+					const float high = field.origin.y + std::max(std::max(h00, h10), std::max(h01, h11));
+
+					if (low <= max.y && high >= min.y && visit(cellX, cellZ))
+					{
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Tests whether a shape touches the surface
+	 * @param field Field to test
+	 * @param shape Query shape, any type accepted by Triangle::Intersects()
+	 * @param bounds Box enclosing the shape, used to cull cells
+	 * @return True if any surface triangle intersects the shape
+	 */
+	template <typename Shape>
+	static bool Overlaps(const Heightfield& field, const Shape& shape, const Aabb& bounds)
+	{
+		return VisitCells(field, bounds.Min(), bounds.Max(), [&](const int x, const int z)
+		{
+			Triangle first;
+			Triangle second;
+			field.CellTriangles(x, z, first, second);
+
+			return first.Intersects(shape) || second.Intersects(shape);
+		});
+	}
+
+	/**
+	 * @brief Steps a ray through the cells of one tile in the order it crosses them
+	 * @param field Field owning the tile
+	 * @param ray Prepared ray; its maxDistance is lowered to the hit distance
+	 * @param cells Cell range of the tile, as from EntryCells()
+	 * @param entry Distance at which the ray enters the tile's box
+	 * @return True if a triangle was hit
+	 */
+	static bool CastTile(const Heightfield& field, PreparedRay& ray, const int* cells, const float entry)
+	{
+		const float start[2] =
+		{
+			ray.origin[0] + ray.direction[0] * entry - field.origin.x,
+			ray.origin[2] + ray.direction[2] * entry - field.origin.z
+		};
+		const float spacing[2] = { field.spacingX, field.spacingZ };
+		const float direction[2] = { ray.direction[0], ray.direction[2] };
+		const float origin[2] = { ray.origin[0] - field.origin.x, ray.origin[2] - field.origin.z };
+
+		int cell[2];
+		int step[2];
+		float next[2];
+		float delta[2];
+
+		for (int axis = 0; axis < 2; ++axis)
+		{
+			const int first = cells[axis * 2];
+			const int last = cells[axis * 2 + 1] - 1;
+			cell[axis] = std::clamp(static_cast<int>(std::floor(start[axis] / spacing[axis])), first, last);
+
+			if (direction[axis] == 0.f)
+			{
+				step[axis] = 0;
+				next[axis] = std::numeric_limits<float>::infinity();
+				delta[axis] = std::numeric_limits<float>::infinity();
+				continue;
+			}
+
+			step[axis] = direction[axis] > 0.f ? 1 : -1;
+			const float boundary = (cell[axis] + (step[axis] > 0 ? 1 : 0)) * spacing[axis];
+			next[axis] = (boundary - origin[axis]) / direction[axis];
+			delta[axis] = spacing[axis] / MathF::Abs(direction[axis]);
+		}
+
+		while (true)
+		{
+			const Vector3 p00 = SamplePoint(field, cell[0], cell[1]);
+			const Vector3 p10 = SamplePoint(field, cell[0] + 1, cell[1]);
+			const Vector3 p01 = SamplePoint(field, cell[0], cell[1] + 1);
+			const Vector3 p11 = SamplePoint(field, cell[0] + 1, cell[1] + 1);
+
+			const float first = CastTriangle(ray, p00, p01, p11);
+			const float second = CastTriangle(ray, p00, p11, p10);
+			const float hit = first >= 0.f && (second < 0.f || first < second) ? first : second;
+
+			// Cells are visited in ray order, so the first hit in range is the tile's nearest
+			if (hit >= 0.f && hit <= ray.maxDistance)
+			{
+				ray.maxDistance = hit;
+				return true;
+			}
+
+			// A vertical ray never leaves its cell (both crossings infinite)
+			const int axis = next[0] < next[1] ? 0 : 1;
+			if (!(next[axis] <= ray.maxDistance) || step[axis] == 0)
+			{
+				return false;
+			}
+
+			cell[axis] += step[axis];
+			next[axis] += delta[axis];
+
+			if (cell[axis] < cells[axis * 2] || cell[axis] >= cells[axis * 2 + 1])
+			{
+				return false;
+			}
+		}
+	}
+
+	/**
+	 * @brief Default constructor creating an empty level
+	 */
+	HeightfieldMip::HeightfieldMip()
+		: columns{ 0 }, rows{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Default constructor creating an empty contact
+	 */
+	HeightfieldContact::HeightfieldContact()
+		: depth{ 0.f }, triangle{ -1 }
+	{
+	}
+
+	/**
+	 * @brief Default constructor creating an empty field
+	 */
+	Heightfield::Heightfield()
+		: origin{ 0.f }, spacingX{ 1.f }, spacingZ{ 1.f }, columns{ 0 }, rows{ 0 }, quantizationBase{ 0.f }, quantizationStep{ 0.f }
+	{
+	}
+
+	/**
+	 * @brief Creates a field from a grid of heights
+	 * @param columns Samples along x (at least 2)
+	 * @param rows Samples along z (at least 2)
+	 * @param samples Heights relative to origin.y, row-major (columns * rows values)
+	 * @param origin World position of sample (0, 0) at height 0
+	 * @param spacingX Distance between samples along x
+	 * @param spacingZ Distance between samples along z
+	 * @param quantize Store heights as 16-bit values spanning the sample range
+	 */
+	Heightfield::Heightfield(const int columns, const int rows, const span<const float> samples, const Vector3& origin, const float spacingX, const float spacingZ, const bool quantize)
+		: Heightfield()
+	{
+		if (columns < 2 || rows < 2 || samples.size() != static_cast<size_t>(columns) * rows)
+		{
+			return;
+		}
+
+		this->origin = origin;
+		this->spacingX = spacingX;
+		this->spacingZ = spacingZ;
+		this->columns = columns;
+		this->rows = rows;
+
+		if (quantize)
+		{
+			const auto [low, high] = std::minmax_element(samples.begin(), samples.end());
+			quantizationBase = *low;
+			quantizationStep = (*high - *low) / HEIGHTFIELD_QUANTIZED_MAX;
+
+			quantized.resize(samples.size());
+			for (size_t i = 0; i < samples.size(); ++i)
+			{
+				const float level = quantizationStep > 0.f ? (samples[i] - quantizationBase) / quantizationStep : 0.f;
+				quantized[i] = static_cast<uint16_t>(std::clamp(std::round(level), 0.f, HEIGHTFIELD_QUANTIZED_MAX));
+			}
+		}
+		else
+		{
+			heights.assign(samples.begin(), samples.end());
+		}
+
+		// Level 0: height range of each tile, read from the (possibly quantized) samples
+		HeightfieldMip& tiles = mips.emplace_back();
+		tiles.columns = (columns - 1 + HEIGHTFIELD_TILE_SIZE - 1) / HEIGHTFIELD_TILE_SIZE;
+		tiles.rows = (rows - 1 + HEIGHTFIELD_TILE_SIZE - 1) / HEIGHTFIELD_TILE_SIZE;
+		tiles.min.resize(static_cast<size_t>(tiles.columns) * tiles.rows);
+		tiles.max.resize(tiles.min.size());
+
+		Parallel::For(tiles.rows, HEIGHTFIELD_MIP_BATCH, [&](const int, const int begin, const int end)
+		{
+			for (int tileZ = begin; tileZ < end; ++tileZ)
+			{
+				for (int tileX = 0; tileX < tiles.columns; ++tileX)
+				{
+					int cells[4];
+					EntryCells(*this, 0, tileX, tileZ, cells);
+
+					float low = Height(cells[0], cells[2]);
+					float high = low;
+
+					for (int z = cells[2]; z <= cells[3]; ++z)
+					{
+						for (int x = cells[0]; x <= cells[1]; ++x)
+						{
+							const float height = Height(x, z);
+							low = std::min(low, height);
+							high = std::max(high, height);
+						}
+					}
+
+					tiles.min[tileZ * tiles.columns + tileX] = low;
+					tiles.max[tileZ * tiles.columns + tileX] = high;
+				}
+			}
+		});
+
+		// Coarser levels merge 2x2 entries until one covers the whole field
+		while (mips.back().columns > 1 || mips.back().rows > 1)
+		{
+			HeightfieldMip level;
+			const HeightfieldMip& below = mips.back();
+			level.columns = (below.columns + 1) / 2;
+			level.rows = (below.rows + 1) / 2;
+			level.min.resize(static_cast<size_t>(level.columns) * level.rows);
+			level.max.resize(level.min.size());
+
+			for (int z = 0; z < level.rows; ++z)
+			{
+				for (int x = 0; x < level.columns; ++x)
+				{
+					float low = std::numeric_limits<float>::infinity();
+					float high = -std::numeric_limits<float>::infinity();
+
+					for (int child = 0; child < 4; ++child)
+					{
+						const int childX = x * 2 + (child & 1);
+						const int childZ = z * 2 + (child >> 1);
+
+						if (childX < below.columns && childZ < below.rows)
+						{
+							low = std::min(low, below.min[childZ * below.columns + childX]);
+							high = std::max(high, below.max[childZ * below.columns + childX]);
+						}
+					}
+
+					level.min[z * level.columns + x] = low;
+					level.max[z * level.columns + x] = high;
+				}
+			}
+
+			mips.push_back(std::move(level));
+		}
+	}
+
+	/**
+	 * @brief Tests whether the field has any cells
+	 * @return True if the field was not built from valid samples
+	 */
+	bool Heightfield::IsEmpty() const
+	{
+		return mips.empty();
+	}
+
+	/**
+	 * @brief Height of a sample
+	 * @param x Sample column
+	 * @param z Sample row
+	 * @return Height relative to origin.y
+	 */
+	float Heightfield::Height(const int x, const int z) const
+	{
+		const size_t index = static_cast<size_t>(z) * columns + x;
+
+		return quantized.empty() ? heights[index] : quantizationBase + quantized[index] * quantizationStep;
+	}
+
+	/**
+	 * @brief Height of the surface below or above a world position
+	 * @param x World x coordinate
+	 * @param z World z coordinate
+	 * @param height Receives the world height of the surface
+	 * @return True if the position lies over the field
+	 */
+	bool Heightfield::HeightAt(const float x, const float z, float& height) const
+	{
+		if (IsEmpty())
+		{
+			return false;
+		}
+
+		const float u = (x - origin.x) / spacingX;
+		const float v = (z - origin.z) / spacingZ;
+
+		if (!(u >= 0.f && u <= static_cast<float>(columns - 1) && v >= 0.f && v <= static_cast<float>(rows - 1)))
+		{
+			return false;
+		}
+
+		const int cellX = std::min(static_cast<int>(u), columns - 2);
+		const int cellZ = std::min(static_cast<int>(v), rows - 2);
+		const float fx = u - cellX;
+		const float fz = v - cellZ;
+
+		const float h00 = Height(cellX, cellZ);
+		const float h11 = Height(cellX + 1, cellZ + 1);
+
+		// The diagonal runs from (0, 0) to (1, 1); each side is one triangle's plane
+		height = origin.y + (fz >= fx
+			? h00 + fz * (Height(cellX, cellZ + 1) - h00) + fx * (h11 - Height(cellX, cellZ + 1))
+			: h00 + fx * (Height(cellX + 1, cellZ) - h00) + fz * (h11 - Height(cellX + 1, cellZ)));
+
+		return true;
+	}
+
+	/**
+	 * @brief Box enclosing the whole surface
+	 * @return World-space bounds
+	 */
+	Aabb Heightfield::Bounds() const
+	{
+		if (IsEmpty())
+		{
+			return { origin, Vector3{ 0.f } };
+		}
+
+		Vector3 min;
+		Vector3 max;
+		EntryBounds(*this, static_cast<int>(mips.size()) - 1, 0, 0, min, max);
+
+		return Aabb::FromMinMax(min, max);
+	}
+
+	/**
+	 * @brief Generates the two triangles of a cell
+	 * @param x Cell column, in [0, columns - 1)
+	 * @param z Cell row, in [0, rows - 1)
+	 * @param first Receives triangle 2 * (z * (columns - 1) + x)
+	 * @param second Receives the triangle after it
+	 */
+	void Heightfield::CellTriangles(const int x, const int z, Triangle& first, Triangle& second) const
+	{
+		const Vector3 p00 = SamplePoint(*this, x, z);
+		const Vector3 p10 = SamplePoint(*this, x + 1, z);
+		const Vector3 p01 = SamplePoint(*this, x, z + 1);
+		const Vector3 p11 = SamplePoint(*this, x + 1, z + 1);
+
+		first = Triangle{ p00, p01, p11 };
+		second = Triangle{ p00, p11, p10 };
+	}
+
+	/**
+	 * @brief Generates the triangles of the cells a box may touch
+	 * @param region World-space box
+	 * @param triangles Receives the triangles
+	 * @return Number of triangles written; stops early once triangles is full
+	 */
+	int Heightfield::CollectTriangles(const Aabb& region, const span<Triangle> triangles) const
+	{
+		const int capacity = static_cast<int>(triangles.size());
+		int count = 0;
+
+		VisitCells(*this, region.Min(), region.Max(), [&](const int x, const int z)
+		{
+			Triangle first;
+			Triangle second;
+			CellTriangles(x, z, first, second);
+
+			for (const Triangle* triangle : { &first, &second })
+			{
+				if (count == capacity)
+				{
+					return true;
+				}
+
+				triangles[count++] = *triangle;
+			}
+
+			return count == capacity;
+		});
+
+		return count;
+	}
+
+	/**
+	 * @brief Casts a ray against the upper side of the surface
+	 * @param ray Ray to cast
+	 * @param maxDistance Hits beyond this distance are ignored
+	 * @return Distance along the ray to the first hit, or -1 if there is none
+	 */
+	float Heightfield::CastRay(const Ray& ray, const float maxDistance) const
+	{
+		if (IsEmpty())
+		{
+			return -1.f;
+		}
+
+		PreparedRay prepared{ ray, maxDistance };
+		bool hit = false;
+
+		int levels[HEIGHTFIELD_STACK_SIZE];
+		int xs[HEIGHTFIELD_STACK_SIZE];
+		int zs[HEIGHTFIELD_STACK_SIZE];
+		float entries[HEIGHTFIELD_STACK_SIZE];
+		int top = 0;
+
+		Vector3 min;
+		Vector3 max;
+		const int root = static_cast<int>(mips.size()) - 1;
+		EntryBounds(*this, root, 0, 0, min, max);
+
+		const float rootEntry = prepared.Enter(min, max);
+		if (rootEntry < 0.f)
+		{
+			return -1.f;
+		}
+
+		levels[top] = root;
+		xs[top] = 0;
+		zs[top] = 0;
+		entries[top++] = rootEntry;
+
+		while (top > 0)
+		{
+			--top;
+			if (entries[top] > prepared.maxDistance)
+			{
+				continue;
+			}
+
+			const int level = levels[top];
+			const int x = xs[top];
+			const int z = zs[top];
+
+			if (level == 0)
+			{
+				int cells[4];
+				EntryCells(*this, 0, x, z, cells);
+				hit |= CastTile(*this, prepared, cells, entries[top]);
+				continue;
+			}
+
+			// Push entered children farthest first so the nearest is opened next
+			const HeightfieldMip& below = mips[level - 1];
+			int children[4][2];
+			float childEntries[4];
+			int entered = 0;
+
+			for (int child = 0; child < 4; ++child)
+			{
+				const int childX = x * 2 + (child & 1);
+				const int childZ = z * 2 + (child >> 1);
+
+				if (childX >= below.columns || childZ >= below.rows)
+				{
+					continue;
+				}
+
+				EntryBounds(*this, level - 1, childX, childZ, min, max);
+				const float entry = prepared.Enter(min, max);
+
+				if (entry < 0.f)
+				{
+					continue;
+				}
+
+				int slot = entered++;
+				for (; slot > 0 && childEntries[slot - 1] < entry; --slot)
+				{
+					children[slot][0] = children[slot - 1][0];
+					children[slot][1] = children[slot - 1][1];
+					childEntries[slot] = childEntries[slot - 1];
+				}
+
+				children[slot][0] = childX;
+				children[slot][1] = childZ;
+				childEntries[slot] = entry;
+			}
+
+			for (int i = 0; i < entered; ++i)
+			{
+				levels[top] = level - 1;
+				xs[top] = children[i][0];
+				zs[top] = children[i][1];
+				entries[top++] = childEntries[i];
+			}
+		}
+
+		return hit ? prepared.maxDistance : -1.f;
+	}
+
+	/**
+	 * @brief Tests whether a box touches the surface
+	 * @param other Box to test
+	 * @return True if any surface triangle intersects the box
+	 */
+	bool Heightfield::Intersects(const Aabb& other) const
+	{
+		return Overlaps(*this, other, other);
+	}
+
+	/**
+	 * @brief Tests whether an oriented box touches the surface
+	 * @param other Oriented box to test
+	 * @return True if any surface triangle intersects the box
+	 */
+	bool Heightfield::Intersects(const Obb& other) const
+	{
+		return Overlaps(*this, other, BvhTraits<Obb>::Bounds(other));
+	}
+
+	/**
+	 * @brief Tests whether a sphere touches the surface
+	 * @param other Sphere to test
+	 * @return True if any surface triangle intersects the sphere
+	 */
+	bool Heightfield::Intersects(const Sphere& other) const
+	{
+		return Overlaps(*this, other, BvhTraits<Sphere>::Bounds(other));
+	}
+
+	/**
+	 * @brief Generates contacts between a sphere and the surface
+	 * @param other Sphere to test
+	 * @param contacts Receives one contact per penetrated triangle
+	 * @return Number of contacts written; stops early once contacts is full
+	 */
+	int Heightfield::Contacts(const Sphere& other, const span<HeightfieldContact> contacts) const
+	{
+		const int capacity = static_cast<int>(contacts.size());
+		const Aabb bounds = BvhTraits<Sphere>::Bounds(other);
+		int count = 0;
+
+		VisitCells(*this, bounds.Min(), bounds.Max(), [&](const int x, const int z)
+		{
+			Triangle triangles[2];
+			CellTriangles(x, z, triangles[0], triangles[1]);
+
+			for (int i = 0; i < 2 && count < capacity; ++i)
+			{
+				const Vector3 closest = triangles[i].ClosestPoint(other.origin);
+				const Vector3 offset = other.origin - closest;
+				const float distance = offset.Magnitude();
+
+				if (distance >= other.radius)
+				{
+					continue;
+				}
+
+				HeightfieldContact& contact = contacts[count++];
+				contact.point = closest;
+				contact.depth = other.radius - distance;
+				contact.triangle = 2 * (z * (columns - 1) + x) + i;
+
+				// A center on the surface is pushed out along the triangle's normal
+				contact.normal = distance > 0.f
+					? offset / distance
+					: Vector3::Cross(triangles[i].b - triangles[i].a, triangles[i].c - triangles[i].a).Normalized();
+			}
+
+			return count == capacity;
+		});
+
+		return count;
+	}
+
+	/**
+	 * @brief Memory held by the heights and the pyramid
+	 * @return Size in bytes
+	 */
+	size_t Heightfield::ByteSize() const
+	{
+		size_t size = heights.size() * sizeof(float) + quantized.size() * sizeof(uint16_t);
+
+		for (const HeightfieldMip& mip : mips)
+		{
+			size += (mip.min.size() + mip.max.size()) * sizeof(float);
+		}
+
+		return size;
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "Nudge/Maths/MathF.hpp"
 #include "Nudge/Shapes/Plane.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
 #include "Nudge/Shapes/Ray.hpp"
 #include "Nudge/Shapes/Sphere.hpp"
 
@@ -91,12 +92,8 @@ namespace Nudge
 	 */
 	bool Line::Test(const Aabb& other) const
 	{
-		// Create ray from line start in line direction
-		const Ray ray = { start, (end - start).Normalized() };
-		const float t = ray.CastAgainst(other); // Get intersection distance
-		const float tSqr = MathF::Squared(t);
-
-		return t >= 0.f && tSqr <= LengthSqr(); // Check if intersection is within segment bounds
+		// Segment parameterized over [0, 1], so no normalization is needed
+		return PreparedRay::FromSegment(start, end).Enter(other) >= 0.f;
 	}
 
 	/**
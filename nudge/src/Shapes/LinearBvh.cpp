@@ -0,0 +1,1045 @@
+#include "Nudge/Shapes/LinearBvh.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using std::atomic_ref;
+using std::memory_order_acq_rel;
+using std::numeric_limits;
+using std::uint32_t;
+using std::uint64_t;
+
+// Smallest amount of work handed to a build thread; below this the cost of
+// spawning a worker outweighs the work it would do
+constexpr int BVH_MIN_BATCH = 4096;
+
+// Radix sort digit width (11 bits = 2048 buckets, so 30-bit codes sort in 3 passes)
+constexpr int BVH_RADIX_BITS = 11;
+constexpr int BVH_RADIX_BUCKETS = 1 << BVH_RADIX_BITS;
+
+// Spatial split build: bins per axis for both split searches, largest leaf,
+// depth limit (kept well inside the ray traversal stack) and the minimum
+// child overlap, relative to the root area, worth trying a spatial split for
+constexpr int SBVH_BINS = 32;
+constexpr int SBVH_LEAF_SIZE = 4;
+constexpr int SBVH_MAX_LEAF_SIZE = 16;
+constexpr int SBVH_MAX_DEPTH = 64;
+constexpr float SBVH_OVERLAP_THRESHOLD = 1e-5f;
+
+namespace Nudge
+{
+	/**
+	 * @brief Spreads the low 10 bits of a value so there are two zero bits between each
+	 * @param value Quantized coordinate in [0, 1023]
+	 * @return Value with bit i moved to bit 3 * i
+	 */
+	static uint64_t ExpandBits10(uint64_t value)
+	{
+		value &= 0x3ffu;
+		value = (value | value << 16) & 0x30000ffu;
+		value = (value | value << 8) & 0x300f00fu;
+		value = (value | value << 4) & 0x30c30c3u;
+		value = (value | value << 2) & 0x9249249u;
+
+		return value;
+	}
+
+	/**
+	 * @brief Spreads the low 21 bits of a value so there are two zero bits between each
+	 * @param value Quantized coordinate in [0, 2097151]
+	 * @return Value with bit i moved to bit 3 * i
+	 */
+	static uint64_t ExpandBits21(uint64_t value)
+	{
+		value &= 0x1fffffu;
+		value = (value | value << 32) & 0x1f00000000ffffu;
+		value = (value | value << 16) & 0x1f0000ff0000ffu;
+		value = (value | value << 8) & 0x100f00f00f00f00fu;
+		value = (value | value << 4) & 0x10c30c30c30c30c3u;
+		value = (value | value << 2) & 0x1249249249249249u;
+
+		return value;
+	}
+
+	/**
+	 * @brief Sorts keys (and optionally their paired values) with a stable parallel LSD radix sort
+	 * @param scratch Build storage: keys and order are sorted, the other buffers are reused as scratch
+	 * @param firstBit Lowest key bit considered
+	 * @param bits Number of significant key bits from firstBit
+	 * @param withOrder Whether order is permuted alongside the keys
+	 *
+	 * Each pass builds one histogram per chunk, turns them into scatter offsets
+	 * ordered digit-major then chunk-minor, and scatters every chunk
+	 * independently. Chunk boundaries are identical between the histogram and
+	 * scatter loops, which keeps the sort stable.
+	 */
+	static void RadixSort(LinearBvhScratch& scratch, const int firstBit, const int bits, const bool withOrder)
+	{
+		vector<uint64_t>& keys = scratch.keys;
+		vector<int>& values = scratch.order;
+		vector<uint64_t>& sortedKeys = scratch.sortedKeys;
+		vector<int>& sortedValues = scratch.sortedOrder;
+		vector<int>& offsets = scratch.offsets;
+
+		const int count = static_cast<int>(keys.size());
+		const int chunks = Parallel::ChunkCount(count, BVH_MIN_BATCH);
+
+		sortedKeys.resize(count);
+		sortedValues.resize(withOrder ? count : 0);
+		offsets.resize(static_cast<size_t>(chunks) * BVH_RADIX_BUCKETS);
+
+		for (int shift = firstBit; shift < firstBit + bits; shift += BVH_RADIX_BITS)
+		{
+			std::fill(offsets.begin(), offsets.end(), 0);
+
+			// Pass 1: per-chunk digit histograms
+			Parallel::For(count, BVH_MIN_BATCH, [&](const int chunk, const int begin, const int end)
+			{
+				int* histogram = &offsets[static_cast<size_t>(chunk) * BVH_RADIX_BUCKETS];
+
+				for (int i = begin; i < end; ++i)
+				{
+					histogram[(keys[i] >> shift) & (BVH_RADIX_BUCKETS - 1)]++;
+				}
+			});
+
+			// Exclusive prefix sum, digit-major so lower chunks land first within a digit
+			int sum = 0;
+			for (int digit = 0; digit < BVH_RADIX_BUCKETS; ++digit)
+			{
+				for (int chunk = 0; chunk < chunks; ++chunk)
+				{
+					int& slot = offsets[static_cast<size_t>(chunk) * BVH_RADIX_BUCKETS + digit];
+					const int bucket = slot;
+
+					slot = sum;
+					sum += bucket;
+				}
+			}
+
+			// Pass 2: scatter into the destination buffers
+			Parallel::For(count, BVH_MIN_BATCH, [&](const int chunk, const int begin, const int end)
+			{
+				int* offset = &offsets[static_cast<size_t>(chunk) * BVH_RADIX_BUCKETS];
+
+				for (int i = begin; i < end; ++i)
+				{
+					const int destination = offset[(keys[i] >> shift) & (BVH_RADIX_BUCKETS - 1)]++;
+
+					sortedKeys[destination] = keys[i];
+					if (withOrder)
+					{
+						sortedValues[destination] = values[i];
+					}
+				}
+			});
+
+			keys.swap(sortedKeys);
+			if (withOrder)
+			{
+				values.swap(sortedValues);
+			}
+		}
+	}
+
+	/**
+	 * @brief Writes the component-wise union of two nodes' bounds into a parent
+	 *
+	 * Components are written directly: this runs once per node during every
+	 * rebuild and must stay free of temporaries.
+	 */
+	static void Merge(LinearBvhNode& parent, const LinearBvhNode& a, const LinearBvhNode& b)
+	{
+		parent.min.x = std::min(a.min.x, b.min.x);
+		parent.min.y = std::min(a.min.y, b.min.y);
+		parent.min.z = std::min(a.min.z, b.min.z);
+		parent.max.x = std::max(a.max.x, b.max.x);
+		parent.max.y = std::max(a.max.y, b.max.y);
+		parent.max.z = std::max(a.max.z, b.max.z);
+	}
+
+	/**
+	 * @brief Box stored as min/max float arrays, used while building spatial splits
+	 *
+	 * Starts inverted so the first Grow() sets both corners.
+	 */
+	class BuildBox
+	{
+	public:
+		float min[3] = { numeric_limits<float>::max(), numeric_limits<float>::max(), numeric_limits<float>::max() };
+		float max[3] = { -numeric_limits<float>::max(), -numeric_limits<float>::max(), -numeric_limits<float>::max() };
+
+	public:
+		void Grow(const float* point)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				min[axis] = std::min(min[axis], point[axis]);
+				max[axis] = std::max(max[axis], point[axis]);
+			}
+		}
+
+		void Grow(const BuildBox& other)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				min[axis] = std::min(min[axis], other.min[axis]);
+				max[axis] = std::max(max[axis], other.max[axis]);
+			}
+		}
+
+		void Clip(const BuildBox& other)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				min[axis] = std::max(min[axis], other.min[axis]);
+				max[axis] = std::min(max[axis], other.max[axis]);
+			}
+		}
+
+		bool IsValid() const
+		{
+			return min[0] <= max[0] && min[1] <= max[1] && min[2] <= max[2];
+		}
+
+		float Area() const
+		{
+			if (!IsValid())
+			{
+				return 0.f;
+			}
+
+			const float x = max[0] - min[0];
+			const float y = max[1] - min[1];
+			const float z = max[2] - min[2];
+
+			return x * y + y * z + z * x;
+		}
+
+		float Centroid(const int axis) const
+		{
+			return (min[axis] + max[axis]) * .5f;
+		}
+	};
+
+	/**
+	 * @brief Part of a primitive assigned to a node during a spatial split build
+	 *
+	 * A triangle clipped by a spatial split keeps one reference per side, each
+	 * bounding only the part of the triangle on that side.
+	 */
+	class BuildReference
+	{
+	public:
+		BuildBox bounds;
+		int primitive = 0;
+	};
+
+	/**
+	 * @brief Best split found for a node by one of the binned searches
+	 */
+	class BuildSplit
+	{
+	public:
+		float cost = numeric_limits<float>::max();
+		int axis = -1;
+		int bin = 0;          ///< Children are bins [0, bin) and [bin, SBVH_BINS)
+		int duplicates = 0;   ///< References added by clipping (spatial splits only)
+		BuildBox left;
+		BuildBox right;
+	};
+
+	/**
+	 * @brief Shared state of one spatial split build
+	 */
+	class SpatialBuild
+	{
+	public:
+		LinearBvh& bvh;
+		const Triangle* triangles;
+		float rootArea;
+		int budget;   ///< References that may still be added by clipping
+	};
+
+	/**
+	 * @brief Bin of a coordinate along an axis, clamped to the valid range
+	 */
+	static int BinOf(const float value, const float origin, const float scale)
+	{
+		return std::clamp(static_cast<int>((value - origin) * scale), 0, SBVH_BINS - 1);
+	}
+
+	/**
+	 * @brief Splits a triangle reference by an axis-aligned plane
+	 * @param triangle Triangle the reference belongs to
+	 * @param reference Reference to split
+	 * @param axis Axis the plane is perpendicular to
+	 * @param position Position of the plane along the axis
+	 * @param left Receives the bounds of the part below the plane
+	 * @param right Receives the bounds of the part above the plane
+	 *
+	 * Each side is the box of the triangle's vertices and edge crossings on
+	 * that side, clipped to the incoming reference so repeated splits only
+	 * ever shrink it.
+	 */
+	static void SplitReference(const Triangle& triangle, const BuildReference& reference, const int axis, const float position, BuildBox& left, BuildBox& right)
+	{
+		left = BuildBox{};
+		right = BuildBox{};
+
+		for (int i = 0; i < 3; ++i)
+		{
+			const float* from = &triangle.values[i * 3];
+			const float* to = &triangle.values[(i + 1) % 3 * 3];
+
+			if (from[axis] <= position)
+			{
+				left.Grow(from);
+			}
+
+			if (from[axis] >= position)
+			{
+				right.Grow(from);
+			}
+
+			if ((from[axis] < position && to[axis] > position) || (from[axis] > position && to[axis] < position))
+			{
+				const float t = (position - from[axis]) / (to[axis] - from[axis]);
+				float crossing[3];
+
+				for (int k = 0; k < 3; ++k)
+				{
+					crossing[k] = from[k] + (to[k] - from[k]) * t;
+				}
+
+				crossing[axis] = position;
+				left.Grow(crossing);
+				right.Grow(crossing);
+			}
+		}
+
+		left.max[axis] = std::min(left.max[axis], position);
+		right.min[axis] = std::max(right.min[axis], position);
+		left.Clip(reference.bounds);
+		right.Clip(reference.bounds);
+	}
+
+	/**
+	 * @brief Finds the cheapest SAH split of references by their centroids
+	 * @param references References in the node
+	 * @param centroids Bounds of the reference centroids
+	 * @return Best object split, with axis -1 if every centroid coincides
+	 */
+	static BuildSplit FindObjectSplit(const vector<BuildReference>& references, const BuildBox& centroids)
+	{
+		BuildSplit best;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float extent = centroids.max[axis] - centroids.min[axis];
+			if (extent <= 0.f)
+			{
+				continue;
+			}
+
+			const float scale = SBVH_BINS / extent;
+			BuildBox bins[SBVH_BINS];
+			int counts[SBVH_BINS] = {};
+
+			for (const BuildReference& reference : references)
+			{
+				const int bin = BinOf(reference.bounds.Centroid(axis), centroids.min[axis], scale);
+				bins[bin].Grow(reference.bounds);
+				counts[bin]++;
+			}
+
+			// Sweep from the right, recording the box and count of every suffix
+			BuildBox suffix[SBVH_BINS];
+			int suffixCount[SBVH_BINS];
+			BuildBox accumulated;
+			int total = 0;
+
+			for (int i = SBVH_BINS - 1; i > 0; --i)
+			{
+				accumulated.Grow(bins[i]);
+				total += counts[i];
+				suffix[i] = accumulated;
+				suffixCount[i] = total;
+			}
+
+			BuildBox prefix;
+			int prefixCount = 0;
+
+			for (int i = 1; i < SBVH_BINS; ++i)
+			{
+				prefix.Grow(bins[i - 1]);
+				prefixCount += counts[i - 1];
+
+				if (prefixCount == 0 || suffixCount[i] == 0)
+				{
+					continue;
+				}
+
+				const float cost = prefix.Area() * prefixCount + suffix[i].Area() * suffixCount[i];
+				if (cost < best.cost)
+				{
+					best.cost = cost;
+					best.axis = axis;
+					best.bin = i;
+					best.left = prefix;
+					best.right = suffix[i];
+				}
+			}
+		}
+
+		return best;
+	}
+
+	/**
+	 * @brief Finds the cheapest SAH split of a node by axis-aligned planes, clipping straddling references
+	 * @param build Build state providing the triangles
+	 * @param references References in the node
+	 * @param bounds Bounds of the node
+	 * @return Best spatial split, with axis -1 if none separates the references
+	 */
+	static BuildSplit FindSpatialSplit(const SpatialBuild& build, const vector<BuildReference>& references, const BuildBox& bounds)
+	{
+		BuildSplit best;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float extent = bounds.max[axis] - bounds.min[axis];
+			if (extent <= 0.f)
+			{
+				continue;
+			}
+
+			const float width = extent / SBVH_BINS;
+			const float scale = SBVH_BINS / extent;
+			BuildBox bins[SBVH_BINS];
+			int entries[SBVH_BINS] = {};
+			int exits[SBVH_BINS] = {};
+
+			// Chop every reference into the bins it spans
+			for (const BuildReference& reference : references)
+			{
+				const int first = BinOf(reference.bounds.min[axis], bounds.min[axis], scale);
+				const int last = BinOf(reference.bounds.max[axis], bounds.min[axis], scale);
+
+				BuildReference remainder = reference;
+
+				for (int bin = first; bin < last; ++bin)
+				{
+					BuildBox left;
+					BuildBox right;
+					SplitReference(build.triangles[reference.primitive], remainder, axis, bounds.min[axis] + width * (bin + 1), left, right);
+
+					bins[bin].Grow(left);
+					remainder.bounds = right;
+				}
+
+				bins[last].Grow(remainder.bounds);
+				entries[first]++;
+				exits[last]++;
+			}
+
+			BuildBox suffix[SBVH_BINS];
+			int suffixCount[SBVH_BINS];
+			BuildBox accumulated;
+			int total = 0;
+
+			for (int i = SBVH_BINS - 1; i > 0; --i)
+			{
+				accumulated.Grow(bins[i]);
+				total += exits[i];
+				suffix[i] = accumulated;
+				suffixCount[i] = total;
+			}
+
+			BuildBox prefix;
+			int prefixCount = 0;
+
+			for (int i = 1; i < SBVH_BINS; ++i)
+			{
+				prefix.Grow(bins[i - 1]);
+				prefixCount += entries[i - 1];
+
+				if (prefixCount == 0 || suffixCount[i] == 0)
+				{
+					continue;
+				}
+
+				const float cost = prefix.Area() * prefixCount + suffix[i].Area() * suffixCount[i];
+				if (cost < best.cost)
+				{
+					best.cost = cost;
+					best.axis = axis;
+					best.bin = i;
+					best.duplicates = prefixCount + suffixCount[i] - static_cast<int>(references.size());
+					best.left = prefix;
+					best.right = suffix[i];
+				}
+			}
+		}
+
+		return best;
+	}
+
+	/**
+	 * @brief Builds the subtree for a set of references and returns its node index
+	 * @param build Shared build state
+	 * @param references References in the subtree, consumed by the call
+	 * @param bounds Bounds of every reference
+	 * @param depth Depth of the node
+	 *
+	 * Nodes and leaf indices are emitted depth-first, so every subtree
+	 * references a contiguous range of indices.
+	 */
+	static int BuildSpatialNode(SpatialBuild& build, vector<BuildReference>& references, const BuildBox& bounds, const int depth)
+	{
+		LinearBvh& bvh = build.bvh;
+		const int index = static_cast<int>(bvh.nodes.size());
+		const int count = static_cast<int>(references.size());
+
+		bvh.nodes.emplace_back();
+		bvh.nodes[index].min = Vector3{ bounds.min[0], bounds.min[1], bounds.min[2] };
+		bvh.nodes[index].max = Vector3{ bounds.max[0], bounds.max[1], bounds.max[2] };
+
+		auto makeLeaf = [&]()
+		{
+			LinearBvhNode& leaf = bvh.nodes[index];
+			leaf.left = static_cast<int>(bvh.indices.size());
+			leaf.right = -count;
+
+			for (const BuildReference& reference : references)
+			{
+				bvh.indices.push_back(reference.primitive);
+			}
+
+			return index;
+		};
+
+		if (count <= SBVH_LEAF_SIZE || depth >= SBVH_MAX_DEPTH)
+		{
+			return makeLeaf();
+		}
+
+		BuildBox centroids;
+		for (const BuildReference& reference : references)
+		{
+			const float centroid[3] = { reference.bounds.Centroid(0), reference.bounds.Centroid(1), reference.bounds.Centroid(2) };
+			centroids.Grow(centroid);
+		}
+
+		BuildSplit split = FindObjectSplit(references, centroids);
+		bool spatial = false;
+
+		// Only look for a spatial split where the object split leaves the
+		// children overlapping noticeably and the duplication budget allows it
+		BuildBox overlap = split.left;
+		overlap.Clip(split.right);
+
+		if (build.budget > 0 && (split.axis < 0 || overlap.Area() > SBVH_OVERLAP_THRESHOLD * build.rootArea))
+		{
+			const BuildSplit candidate = FindSpatialSplit(build, references, bounds);
+
+			if (candidate.axis >= 0 && candidate.cost < split.cost && candidate.duplicates <= build.budget)
+			{
+				split = candidate;
+				spatial = true;
+			}
+		}
+
+		// SAH termination: traversal costs one box test, each primitive one triangle test
+		const float area = std::max(bounds.Area(), numeric_limits<float>::min());
+		const float splitCost = 1.f + split.cost / area;
+
+		if (split.axis < 0 || (count <= SBVH_MAX_LEAF_SIZE && static_cast<float>(count) <= splitCost))
+		{
+			return makeLeaf();
+		}
+
+		vector<BuildReference> left;
+		vector<BuildReference> right;
+		left.reserve(count);
+		right.reserve(count);
+
+		const int axis = split.axis;
+
+		if (spatial)
+		{
+			const float scale = SBVH_BINS / (bounds.max[axis] - bounds.min[axis]);
+			const float position = bounds.min[axis] + (bounds.max[axis] - bounds.min[axis]) / SBVH_BINS * split.bin;
+
+			for (const BuildReference& reference : references)
+			{
+				// Classified with the same bins the search used so the counts match
+				if (BinOf(reference.bounds.max[axis], bounds.min[axis], scale) < split.bin)
+				{
+					left.push_back(reference);
+				}
+				else if (BinOf(reference.bounds.min[axis], bounds.min[axis], scale) >= split.bin)
+				{
+					right.push_back(reference);
+				}
+				else
+				{
+					BuildReference lower = reference;
+					BuildReference upper = reference;
+					SplitReference(build.triangles[reference.primitive], reference, axis, position, lower.bounds, upper.bounds);
+
+					// Numerical slivers can leave one side empty; keep the reference whole on the other
+					if (lower.bounds.IsValid() && upper.bounds.IsValid())
+					{
+						left.push_back(lower);
+						right.push_back(upper);
+						build.budget--;
+					}
+					else
+					{
+						(lower.bounds.IsValid() ? left : right).push_back(reference);
+					}
+				}
+			}
+		}
+		else
+		{
+			const float scale = SBVH_BINS / (centroids.max[axis] - centroids.min[axis]);
+
+			for (const BuildReference& reference : references)
+			{
+				const bool isLeft = BinOf(reference.bounds.Centroid(axis), centroids.min[axis], scale) < split.bin;
+				(isLeft ? left : right).push_back(reference);
+			}
+		}
+
+		if (left.empty() || right.empty())
+		{
+			return makeLeaf();
+		}
+
+		// References are no longer needed at this level, release them before recursing
+		vector<BuildReference>().swap(references);
+
+		BuildBox leftBounds;
+		BuildBox rightBounds;
+
+		for (const BuildReference& reference : left)
+		{
+			leftBounds.Grow(reference.bounds);
+		}
+
+		for (const BuildReference& reference : right)
+		{
+			rightBounds.Grow(reference.bounds);
+		}
+
+		const int leftChild = BuildSpatialNode(build, left, leftBounds, depth + 1);
+		const int rightChild = BuildSpatialNode(build, right, rightBounds, depth + 1);
+
+		bvh.nodes[index].left = leftChild;
+		bvh.nodes[index].right = rightChild;
+
+		return index;
+	}
+
+	/**
+	 * @brief Computes the aggregated flags of a subtree and stores them for every node in it
+	 * @param bvh Hierarchy whose masks are filled, already sized to its nodes
+	 * @param flags Flags of each primitive
+	 * @param index Root of the subtree
+	 * @return Bitwise OR of the flags of every primitive in the subtree
+	 */
+	static uint32_t GatherMask(LinearBvh& bvh, const uint32_t* flags, const int index)
+	{
+		const LinearBvhNode& node = bvh.nodes[index];
+		uint32_t mask = 0;
+
+		if (node.IsLeaf())
+		{
+			for (int i = node.left; i < node.left + node.Count(); ++i)
+			{
+				mask |= flags[bvh.indices.empty() ? i : bvh.indices[i]];
+			}
+		}
+		else
+		{
+			mask = GatherMask(bvh, flags, node.left) | GatherMask(bvh, flags, node.right);
+		}
+
+		bvh.masks[index] = mask;
+		return mask;
+	}
+
+	/**
+	 * @brief Default constructor creating an empty leaf
+	 */
+	LinearBvhNode::LinearBvhNode()
+		: left{ 0 }, right{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Tests whether this node is a leaf
+	 * @return True if the node references primitives instead of children
+	 */
+	bool LinearBvhNode::IsLeaf() const
+	{
+		return right < 0;
+	}
+
+	/**
+	 * @brief Number of primitives referenced by a leaf
+	 * @return Primitive count for leaves, 0 for internal nodes
+	 */
+	int LinearBvhNode::Count() const
+	{
+		return right < 0 ? -right : 0;
+	}
+
+	/**
+	 * @brief Bounds of this node as an axis-aligned box
+	 * @return Aabb spanning min to max
+	 */
+	Aabb LinearBvhNode::Bounds() const
+	{
+		return Aabb::FromMinMax(min, max);
+	}
+
+	/**
+	 * @brief Default constructor creating an empty hierarchy
+	 */
+	LinearBvh::LinearBvh() = default;
+
+	/**
+	 * @brief Rebuilds the hierarchy using Morton-ordered linear construction
+	 * @param primitiveBounds Bounds of each primitive, indexed by primitive id
+	 * @param count Number of primitives
+	 * @param mortonBits Code precision: 30 (10 bits per axis) or 63 (21 bits per axis)
+	 * @param centroids Point of each primitive to sort by, or nullptr to use the bounds' centers
+	 *
+	 * Node layout follows Karras: internal nodes occupy [0, count - 1) and the
+	 * leaf for sorted slot k lives at (count - 1) + k. Internal node i is the
+	 * split between sorted slots i and i + 1 until the root is swapped into
+	 * index 0.
+	 */
+	void LinearBvh::BuildMorton(const Aabb* primitiveBounds, const int count, const int mortonBits, const Vector3* centroids)
+	{
+		if (count <= 0)
+		{
+			Clear();
+			return;
+		}
+
+		masks.clear();
+
+		const bool precise = mortonBits > 30;
+		const int axisBits = precise ? 21 : 10;
+		const int keyBits = axisBits * 3;
+
+		// Step 1: bounds of all primitive centroids, reduced per chunk
+		const int chunks = Parallel::ChunkCount(count, BVH_MIN_BATCH);
+		vector<float>& chunkBounds = scratch.chunkBounds;
+		chunkBounds.resize(static_cast<size_t>(chunks) * 6);
+
+		Parallel::For(count, BVH_MIN_BATCH, [&](const int chunk, const int begin, const int end)
+		{
+			float* bounds = &chunkBounds[static_cast<size_t>(chunk) * 6];
+			const Vector3& seed = centroids != nullptr ? centroids[begin] : primitiveBounds[begin].origin;
+
+			float min[3] = { seed.x, seed.y, seed.z };
+			float max[3] = { seed.x, seed.y, seed.z };
+
+			for (int i = begin + 1; i < end; ++i)
+			{
+				const Vector3& centroid = centroids != nullptr ? centroids[i] : primitiveBounds[i].origin;
+
+				min[0] = std::min(min[0], centroid.x);
+				min[1] = std::min(min[1], centroid.y);
+				min[2] = std::min(min[2], centroid.z);
+				max[0] = std::max(max[0], centroid.x);
+				max[1] = std::max(max[1], centroid.y);
+				max[2] = std::max(max[2], centroid.z);
+			}
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				bounds[axis] = min[axis];
+				bounds[axis + 3] = max[axis];
+			}
+		});
+
+		float centroidMin[3] = { chunkBounds[0], chunkBounds[1], chunkBounds[2] };
+		float centroidMax[3] = { chunkBounds[3], chunkBounds[4], chunkBounds[5] };
+
+		for (int chunk = 1; chunk < chunks; ++chunk)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				centroidMin[axis] = std::min(centroidMin[axis], chunkBounds[chunk * 6 + axis]);
+				centroidMax[axis] = std::max(centroidMax[axis], chunkBounds[chunk * 6 + axis + 3]);
+			}
+		}
+
+		// Step 2: quantize centroids into Morton codes. Flat axes map to cell 0.
+		const float cells = static_cast<float>(1 << axisBits);
+		float scale[3];
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float size = centroidMax[axis] - centroidMin[axis];
+			scale[axis] = size > 0.f ? cells / size : 0.f;
+		}
+
+		vector<uint64_t>& keys = scratch.keys;
+		vector<int>& order = scratch.order;
+		keys.resize(count);
+		order.resize(precise ? count : 0);
+
+		Parallel::For(count, BVH_MIN_BATCH, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				const Vector3& centroid = centroids != nullptr ? centroids[i] : primitiveBounds[i].origin;
+				const float position[3] = { centroid.x, centroid.y, centroid.z };
+				uint64_t cell[3];
+
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					const float scaled = (position[axis] - centroidMin[axis]) * scale[axis];
+					cell[axis] = static_cast<uint64_t>(std::clamp(scaled, 0.f, cells - 1.f));
+				}
+
+				// 30-bit codes carry the primitive index in their low half, so only
+				// one array is sorted and equal codes still compare as distinct keys
+				if (precise)
+				{
+					keys[i] = ExpandBits21(cell[0]) << 2 | ExpandBits21(cell[1]) << 1 | ExpandBits21(cell[2]);
+					order[i] = i;
+				}
+				else
+				{
+					keys[i] = (ExpandBits10(cell[0]) << 2 | ExpandBits10(cell[1]) << 1 | ExpandBits10(cell[2])) << 32 | static_cast<uint32_t>(i);
+				}
+			}
+		});
+
+		// Step 3: sort primitives along the Z-order curve
+		RadixSort(scratch, precise ? 0 : 32, keyBits, precise);
+
+		const int internalCount = count - 1;
+		nodes.resize(static_cast<size_t>(count) * 2 - 1);
+		indices.resize(count);
+
+		// Leaves: one per sorted primitive
+		Parallel::For(count, BVH_MIN_BATCH, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				const int primitive = precise ? order[i] : static_cast<int>(keys[i] & 0xffffffffu);
+				const Aabb& bounds = primitiveBounds[primitive];
+				const Vector3& origin = bounds.origin;
+				const Vector3& extents = bounds.extents;
+
+				LinearBvhNode& leaf = nodes[internalCount + i];
+				leaf.min.x = origin.x - std::abs(extents.x);
+				leaf.min.y = origin.y - std::abs(extents.y);
+				leaf.min.z = origin.z - std::abs(extents.z);
+				leaf.max.x = origin.x + std::abs(extents.x);
+				leaf.max.y = origin.y + std::abs(extents.y);
+				leaf.max.z = origin.z + std::abs(extents.z);
+				leaf.left = i;
+				leaf.right = -1;
+				indices[i] = primitive;
+			}
+		});
+
+		if (internalCount == 0)
+		{
+			return;
+		}
+
+		// Internal node i splits sorted slots i and i + 1. True if the keys
+		// either side of split a are closer than those either side of split b;
+		// equal codes (precise mode) fall back to their slots, which halves
+		// runs of duplicates like Karras's tie-break. Strict, so every range
+		// has exactly one parent.
+		auto closer = [&](const int a, const int b)
+		{
+			const uint64_t first = keys[a] ^ keys[a + 1];
+			const uint64_t second = keys[b] ^ keys[b + 1];
+
+			if (first != second)
+			{
+				return first < second;
+			}
+
+			const uint32_t firstSlots = static_cast<uint32_t>(a ^ (a + 1));
+			const uint32_t secondSlots = static_cast<uint32_t>(b ^ (b + 1));
+
+			return firstSlots != secondSlots ? firstSlots < secondSlots : a < b;
+		};
+
+		// Step 4: emit internal nodes and their bounds bottom-up in one pass.
+		// Each subtree joins the neighbour whose boundary key is closer; the
+		// first child to reach a parent leaves its far end there and stops,
+		// the second one knows both children are final and merges them.
+		vector<int>& pending = scratch.pending;
+		pending.assign(internalCount, -1);
+
+		int root = 0;
+		int zeroParent = -1;
+
+		Parallel::For(count, BVH_MIN_BATCH, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				int node = internalCount + i;
+				int first = i;
+				int last = i;
+
+				while (true)
+				{
+					const bool isLeft = first == 0 || (last != internalCount && closer(last, first - 1));
+					const int parent = isLeft ? last : first - 1;
+
+					(isLeft ? nodes[parent].left : nodes[parent].right) = node;
+					if (node == 0)
+					{
+						zeroParent = parent;
+					}
+
+					const int other = atomic_ref<int>(pending[parent]).exchange(isLeft ? first : last, memory_order_acq_rel);
+					if (other < 0)
+					{
+						break;
+					}
+
+					(isLeft ? last : first) = other;
+					Merge(nodes[parent], nodes[nodes[parent].left], nodes[nodes[parent].right]);
+					node = parent;
+
+					if (first == 0 && last == internalCount)
+					{
+						root = node;
+						break;
+					}
+				}
+			}
+		});
+
+		// Step 5: move the root to index 0 and repoint the parent of the node it displaced
+		if (root != 0)
+		{
+			std::swap(nodes[0], nodes[root]);
+
+			LinearBvhNode& parent = nodes[zeroParent == root ? 0 : zeroParent];
+			(parent.left == 0 ? parent.left : parent.right) = root;
+		}
+	}
+
+	/**
+	 * @brief Rebuilds the hierarchy top-down with SAH object and spatial splits
+	 * @param triangles Triangles to organize
+	 * @param count Number of triangles
+	 * @param duplicationBudget Extra references allowed, as a fraction of count
+	 *
+	 * Algorithm (Stich et al. 2009):
+	 * 1. Find the best binned SAH object split of the node's references
+	 * 2. If its children overlap, also bin the node spatially, clipping each
+	 *    reference into the bins it crosses, and find the best plane
+	 * 3. Take the cheaper split, or make a leaf if splitting costs more than
+	 *    intersecting every reference
+	 * 4. Recurse depth-first, emitting nodes and leaf indices in order
+	 */
+	void LinearBvh::BuildSpatial(const Triangle* triangles, const int count, const float duplicationBudget)
+	{
+		Clear();
+
+		if (count <= 0)
+		{
+			return;
+		}
+
+		vector<BuildReference> references(count);
+		BuildBox bounds;
+
+		for (int i = 0; i < count; ++i)
+		{
+			BuildReference& reference = references[i];
+			reference.primitive = i;
+
+			for (int vertex = 0; vertex < 3; ++vertex)
+			{
+				reference.bounds.Grow(&triangles[i].values[vertex * 3]);
+			}
+
+			bounds.Grow(reference.bounds);
+		}
+
+		SpatialBuild build
+		{
+			*this,
+			triangles,
+			bounds.Area(),
+			static_cast<int>(static_cast<float>(count) * std::max(duplicationBudget, 0.f))
+		};
+
+		indices.reserve(count + build.budget);
+		BuildSpatialNode(build, references, bounds, 0);
+	}
+
+	/**
+	 * @brief Aggregates per-primitive flags into every node
+	 * @param primitiveFlags Flags of each primitive, or nullptr to drop the masks
+	 *
+	 * Internal nodes are not stored in any particular order relative to their
+	 * children (Karras places leaves last), so the masks are gathered
+	 * bottom-up by a depth-first walk from the root.
+	 */
+	void LinearBvh::BuildMasks(const uint32_t* primitiveFlags)
+	{
+		if (primitiveFlags == nullptr || nodes.empty())
+		{
+			masks.clear();
+			return;
+		}
+
+		masks.assign(nodes.size(), 0);
+		GatherMask(*this, primitiveFlags, 0);
+	}
+
+	/**
+	 * @brief Removes all nodes and primitive references
+	 */
+	void LinearBvh::Clear()
+	{
+		nodes.clear();
+		indices.clear();
+		masks.clear();
+	}
+
+	/**
+	 * @brief Frees the working storage kept for the next BuildMorton()
+	 */
+	void LinearBvh::ReleaseScratch()
+	{
+		scratch = LinearBvhScratch{};
+	}
+
+	/**
+	 * @brief Tests whether the hierarchy contains any nodes
+	 * @return True if no hierarchy has been built
+	 */
+	bool LinearBvh::IsEmpty() const
+	{
+		return nodes.empty();
+	}
+}
@@ -0,0 +1,597 @@
+#include "Nudge/Shapes/LooseOctree.hpp"
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Bvh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Stack capacity for traversals: each level pops one node and pushes at most eight
+constexpr int LOOSE_OCTREE_STACK_SIZE = 8 * LOOSE_OCTREE_MAX_DEPTH + 1;
+
+namespace Nudge
+{
+	/**
+	 * @brief Chooses the node an object belongs to
+	 * @param tree Tree the object is stored in
+	 * @param bounds Box enclosing the object
+	 * @param depth Receives the depth of the node
+	 * @param cell Receives the cell coordinates of the node at that depth
+	 *
+	 * A cell of half size h at depth d holds objects up to (looseness - 1) * h
+	 * in extent, so its loose bounds contain every object centered in it.
+	 */
+	static void Place(const LooseOctree& tree, const Aabb& bounds, int& depth, int* cell)
+	{
+		const LooseOctreeNode& root = tree.nodes[0];
+		const float center[3] = { bounds.origin.x, bounds.origin.y, bounds.origin.z };
+		const float rootCenter[3] = { root.center.x, root.center.y, root.center.z };
+
+		depth = 0;
+		cell[0] = cell[1] = cell[2] = 0;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (!(MathF::Abs(center[axis] - rootCenter[axis]) <= root.halfSize))
+			{
+				return;
+			}
+		}
+
+		const float extent = std::max(MathF::Abs(bounds.extents.x), std::max(MathF::Abs(bounds.extents.y), MathF::Abs(bounds.extents.z)));
+		const float slack = tree.looseness - 1.f;
+
+		if (extent <= 0.f)
+		{
+			depth = tree.maxDepth;
+		}
+		else if (slack > 0.f)
+		{
+			const float levels = std::floor(std::log2(slack * root.halfSize / extent));
+			depth = static_cast<int>(std::clamp(levels, 0.f, static_cast<float>(tree.maxDepth)));
+
+			// Guard against log2 rounding up past the level that actually fits
+			while (depth > 0 && extent > slack * std::ldexp(root.halfSize, -depth))
+			{
+				--depth;
+			}
+		}
+
+		const int cells = 1 << depth;
+		const float cellSize = std::ldexp(root.halfSize * 2.f, -depth);
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float offset = center[axis] - (rootCenter[axis] - root.halfSize);
+			cell[axis] = std::clamp(static_cast<int>(offset / cellSize), 0, cells - 1);
+		}
+	}
+
+	/**
+	 * @brief Takes a node from the pool
+	 * @param tree Tree owning the pool
+	 * @param parent Parent node index
+	 * @param octant Octant of the parent the node covers
+	 * @return Index of the new node
+	 */
+	static int AcquireNode(LooseOctree& tree, const int parent, const int octant)
+	{
+		int index;
+		if (!tree.freeNodes.empty())
+		{
+			index = tree.freeNodes.back();
+			tree.freeNodes.pop_back();
+		}
+		else
+		{
+			index = static_cast<int>(tree.nodes.size());
+			tree.nodes.emplace_back();
+		}
+
+		const LooseOctreeNode& owner = tree.nodes[parent];
+		const float quarter = owner.halfSize * .5f;
+
+		LooseOctreeNode& node = tree.nodes[index];
+		node = LooseOctreeNode{};
+		node.center = owner.center + Vector3
+		{
+			(octant & 1) != 0 ? quarter : -quarter,
+			(octant & 2) != 0 ? quarter : -quarter,
+			(octant & 4) != 0 ? quarter : -quarter
+		};
+		node.halfSize = quarter;
+		node.parent = parent;
+
+		tree.nodes[parent].children[octant] = index;
+
+		return index;
+	}
+
+	/**
+	 * @brief Stores a proxy in the node given by its depth and cell, creating nodes along the way
+	 * @param tree Tree to link into
+	 * @param id Proxy whose depth and cell are set
+	 */
+	static void Link(LooseOctree& tree, const int id)
+	{
+		LooseOctreeProxy& proxy = tree.proxies[id];
+
+		int node = 0;
+		++tree.nodes[node].population;
+
+		for (int level = 1; level <= proxy.depth; ++level)
+		{
+			const int shift = proxy.depth - level;
+			const int octant = ((proxy.cell[0] >> shift) & 1) | ((proxy.cell[1] >> shift) & 1) << 1 | ((proxy.cell[2] >> shift) & 1) << 2;
+
+			int child = tree.nodes[node].children[octant];
+			if (child < 0)
+			{
+				child = AcquireNode(tree, node, octant);
+			}
+
+			node = child;
+			++tree.nodes[node].population;
+		}
+
+		LooseOctreeNode& owner = tree.nodes[node];
+		proxy.node = node;
+		proxy.previous = -1;
+		proxy.next = owner.first;
+
+		if (owner.first >= 0)
+		{
+			tree.proxies[owner.first].previous = id;
+		}
+
+		owner.first = id;
+	}
+
+	/**
+	 * @brief Takes a proxy out of its node, returning nodes whose subtree empties to the pool
+	 * @param tree Tree to unlink from
+	 * @param id Linked proxy
+	 */
+	static void Unlink(LooseOctree& tree, const int id)
+	{
+		LooseOctreeProxy& proxy = tree.proxies[id];
+
+		if (proxy.previous >= 0)
+		{
+			tree.proxies[proxy.previous].next = proxy.next;
+		}
+		else
+		{
+			tree.nodes[proxy.node].first = proxy.next;
+		}
+
+		if (proxy.next >= 0)
+		{
+			tree.proxies[proxy.next].previous = proxy.previous;
+		}
+
+		for (int node = proxy.node; node >= 0;)
+		{
+			LooseOctreeNode& current = tree.nodes[node];
+			const int parent = current.parent;
+
+			if (--current.population == 0 && parent >= 0)
+			{
+				int* slots = tree.nodes[parent].children;
+				*std::find(slots, slots + 8, node) = -1;
+
+				current = LooseOctreeNode{};
+				tree.freeNodes.push_back(node);
+			}
+
+			node = parent;
+		}
+
+		proxy.node = -1;
+		proxy.previous = -1;
+		proxy.next = -1;
+	}
+
+	/**
+	 * @brief Tests whether a node's loose bounds overlap a box
+	 * @param tree Tree owning the node
+	 * @param node Node to test
+	 * @param min Minimum corner of the box
+	 * @param max Maximum corner of the box
+	 * @return True if the node may hold an overlapping object
+	 */
+	static bool LooseOverlaps(const LooseOctree& tree, const LooseOctreeNode& node, const Vector3& min, const Vector3& max)
+	{
+		const float reach = node.halfSize * tree.looseness;
+
+		return node.center.x - reach <= max.x && node.center.x + reach >= min.x &&
+			node.center.y - reach <= max.y && node.center.y + reach >= min.y &&
+			node.center.z - reach <= max.z && node.center.z + reach >= min.z;
+	}
+
+	/**
+	 * @brief Visits the objects whose bounds overlap a shape
+	 * @param tree Tree to query
+	 * @param shape Query shape, any type accepted by Aabb::Intersects()
+	 * @param cull Box enclosing the shape, used to cull nodes
+	 * @param visit Called with each proxy id; returns true to stop the query
+	 * @return Proxy the query stopped at, or -1 if every object was visited
+	 *
+	 * The root is always entered, since it also holds objects centered outside its cell.
+	 */
+	template <typename Shape>
+	static int QueryNodes(const LooseOctree& tree, const Shape& shape, const Aabb& cull, const function<bool(int)>& visit)
+	{
+		const Vector3 min = cull.Min();
+		const Vector3 max = cull.Max();
+
+		int stack[LOOSE_OCTREE_STACK_SIZE];
+		int top = 0;
+		stack[top++] = 0;
+
+		while (top > 0)
+		{
+			const LooseOctreeNode& node = tree.nodes[stack[--top]];
+
+			for (int id = node.first; id >= 0; id = tree.proxies[id].next)
+			{
+				if (tree.proxies[id].bounds.Intersects(shape) && visit(id))
+				{
+					return id;
+				}
+			}
+
+			for (const int child : node.children)
+			{
+				if (child >= 0 && LooseOverlaps(tree, tree.nodes[child], min, max))
+				{
+					stack[top++] = child;
+				}
+			}
+		}
+
+		return -1;
+	}
+
+	/**
+	 * @brief Finds the nearest object along a ray, visiting nodes front to back
+	 * @param tree Tree to query
+	 * @param ray Ray to cast
+	 * @param maxDistance Hits beyond this distance are ignored
+	 * @param cast Called as cast(proxy, entry, maxDistance) for objects whose bounds are
+	 *             entered; returns the hit distance, or a negative value on a miss
+	 * @param distance Receives the distance to the nearest hit (unchanged on a miss)
+	 * @return Nearest proxy hit, or -1 if there is none
+	 */
+	template <typename Cast>
+	static int CastNodes(const LooseOctree& tree, const Ray& ray, const float maxDistance, const Cast& cast, float& distance)
+	{
+		PreparedRay bounded{ ray, maxDistance };
+		int nearest = -1;
+
+		int stack[LOOSE_OCTREE_STACK_SIZE];
+		float entries[LOOSE_OCTREE_STACK_SIZE];
+		int top = 0;
+		stack[top] = 0;
+		entries[top++] = 0.f;
+
+		while (top > 0)
+		{
+			--top;
+			if (entries[top] > bounded.maxDistance)
+			{
+				continue;
+			}
+
+			const LooseOctreeNode& node = tree.nodes[stack[top]];
+
+			for (int id = node.first; id >= 0; id = tree.proxies[id].next)
+			{
+				const float entry = bounded.Enter(tree.proxies[id].bounds);
+				if (entry < 0.f)
+				{
+					continue;
+				}
+
+				const float hit = cast(id, entry, bounded.maxDistance);
+				if (hit >= 0.f && hit <= bounded.maxDistance)
+				{
+					bounded.maxDistance = hit;
+					nearest = id;
+				}
+			}
+
+			// Push entered children farthest first so the nearest is opened next
+			int children[8];
+			float childEntries[8];
+			int entered = 0;
+
+			for (const int child : node.children)
+			{
+				if (child < 0)
+				{
+					continue;
+				}
+
+				const LooseOctreeNode& next = tree.nodes[child];
+				const Vector3 reach{ next.halfSize * tree.looseness };
+				const float entry = bounded.Enter(next.center - reach, next.center + reach);
+
+				if (entry < 0.f)
+				{
+					continue;
+				}
+
+				int slot = entered++;
+				for (; slot > 0 && childEntries[slot - 1] < entry; --slot)
+				{
+					children[slot] = children[slot - 1];
+					childEntries[slot] = childEntries[slot - 1];
+				}
+
+				children[slot] = child;
+				childEntries[slot] = entry;
+			}
+
+			for (int i = 0; i < entered; ++i)
+			{
+				stack[top] = children[i];
+				entries[top++] = childEntries[i];
+			}
+		}
+
+		if (nearest >= 0)
+		{
+			distance = bounded.maxDistance;
+		}
+
+		return nearest;
+	}
+
+	/**
+	 * @brief Default constructor creating an empty, unlinked node
+	 */
+	LooseOctreeNode::LooseOctreeNode()
+		: center{ 0.f }, halfSize{ 0.f }, parent{ -1 }, children{ -1, -1, -1, -1, -1, -1, -1, -1 }, first{ -1 }, population{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Default constructor creating a free proxy slot
+	 */
+	LooseOctreeProxy::LooseOctreeProxy()
+		: node{ -1 }, previous{ -1 }, next{ -1 }, depth{ 0 }, cell{ 0, 0, 0 }
+	{
+	}
+
+	/**
+	 * @brief Default constructor covering a cube of LOOSE_OCTREE_DEFAULT_HALF_SIZE around the origin
+	 */
+	LooseOctree::LooseOctree()
+		: LooseOctree(Vector3{ 0.f }, LOOSE_OCTREE_DEFAULT_HALF_SIZE)
+	{
+	}
+
+	/**
+	 * @brief Creates an empty tree over a cubic region
+	 * @param center Center of the root cell
+	 * @param halfSize Half the edge length of the root cell
+	 * @param maxDepth Subdivision levels below the root, clamped to [0, LOOSE_OCTREE_MAX_DEPTH]
+	 * @param looseness Ratio of a node's loose bounds to its cell, at least 1
+	 */
+	LooseOctree::LooseOctree(const Vector3& center, const float halfSize, const int maxDepth, const float looseness)
+		: looseness{ std::max(looseness, 1.f) }, maxDepth{ std::clamp(maxDepth, 0, LOOSE_OCTREE_MAX_DEPTH) }, count{ 0 }
+	{
+		LooseOctreeNode& root = nodes.emplace_back();
+		root.center = center;
+		root.halfSize = halfSize;
+	}
+
+	/**
+	 * @brief Adds an object
+	 * @param bounds Box enclosing the object
+	 * @return Id of the new proxy
+	 */
+	int LooseOctree::Insert(const Aabb& bounds)
+	{
+		int id;
+		if (!freeProxies.empty())
+		{
+			id = freeProxies.back();
+			freeProxies.pop_back();
+		}
+		else
+		{
+			id = static_cast<int>(proxies.size());
+			proxies.emplace_back();
+		}
+
+		LooseOctreeProxy& proxy = proxies[id];
+		proxy.bounds = bounds;
+		Place(*this, bounds, proxy.depth, proxy.cell);
+		Link(*this, id);
+
+		++count;
+		return id;
+	}
+
+	/**
+	 * @brief Adds an oriented box, stored by its world-space bounds
+	 * @param shape Oriented box
+	 * @return Id of the new proxy
+	 */
+	int LooseOctree::Insert(const Obb& shape)
+	{
+		return Insert(BvhTraits<Obb>::Bounds(shape));
+	}
+
+	/**
+	 * @brief Adds a sphere, stored by its bounds
+	 * @param shape Sphere
+	 * @return Id of the new proxy
+	 */
+	int LooseOctree::Insert(const Sphere& shape)
+	{
+		return Insert(BvhTraits<Sphere>::Bounds(shape));
+	}
+
+	/**
+	 * @brief Removes an object
+	 * @param proxy Id returned by Insert(); unknown or removed ids are ignored
+	 */
+	void LooseOctree::Remove(const int proxy)
+	{
+		if (proxy < 0 || proxy >= static_cast<int>(proxies.size()) || proxies[proxy].node < 0)
+		{
+			return;
+		}
+
+		Unlink(*this, proxy);
+		freeProxies.push_back(proxy);
+		--count;
+	}
+
+	/**
+	 * @brief Updates the bounds of an object
+	 * @param proxy Id returned by Insert(); unknown or removed ids are ignored
+	 * @param bounds New box enclosing the object
+	 */
+	void LooseOctree::Move(const int proxy, const Aabb& bounds)
+	{
+		if (proxy < 0 || proxy >= static_cast<int>(proxies.size()) || proxies[proxy].node < 0)
+		{
+			return;
+		}
+
+		LooseOctreeProxy& moved = proxies[proxy];
+		moved.bounds = bounds;
+
+		int depth;
+		int cell[3];
+		Place(*this, bounds, depth, cell);
+
+		if (depth == moved.depth && cell[0] == moved.cell[0] && cell[1] == moved.cell[1] && cell[2] == moved.cell[2])
+		{
+			return;
+		}
+
+		Unlink(*this, proxy);
+		moved.depth = depth;
+		std::copy(cell, cell + 3, moved.cell);
+		Link(*this, proxy);
+	}
+
+	/**
+	 * @brief Updates an object stored as an oriented box
+	 * @param proxy Id returned by Insert()
+	 * @param shape New oriented box
+	 */
+	void LooseOctree::Move(const int proxy, const Obb& shape)
+	{
+		Move(proxy, BvhTraits<Obb>::Bounds(shape));
+	}
+
+	/**
+	 * @brief Updates an object stored as a sphere
+	 * @param proxy Id returned by Insert()
+	 * @param shape New sphere
+	 */
+	void LooseOctree::Move(const int proxy, const Sphere& shape)
+	{
+		Move(proxy, BvhTraits<Sphere>::Bounds(shape));
+	}
+
+	/**
+	 * @brief Removes every object and node, keeping the pooled storage
+	 */
+	void LooseOctree::Clear()
+	{
+		LooseOctreeNode root;
+		root.center = nodes[0].center;
+		root.halfSize = nodes[0].halfSize;
+
+		nodes.clear();
+		nodes.push_back(root);
+		proxies.clear();
+		freeNodes.clear();
+		freeProxies.clear();
+		count = 0;
+	}
+
+	/**
+	 * @brief Number of nodes in use, including the root
+	 * @return Live node count
+	 */
+	int LooseOctree::NodeCount() const
+	{
+		return static_cast<int>(nodes.size() - freeNodes.size());
+	}
+
+	/**
+	 * @brief Visits the objects whose bounds overlap a box
+	 * @param region Box to query
+	 * @param visit Called with each proxy id; returns true to stop the query
+	 * @return Proxy the query stopped at, or -1 if every object was visited
+	 */
+	int LooseOctree::Query(const Aabb& region, const function<bool(int)>& visit) const
+	{
+		return QueryNodes(*this, region, region, visit);
+	}
+
+	/**
+	 * @brief Visits the objects whose bounds overlap an oriented box
+	 * @param region Oriented box to query
+	 * @param visit Called with each proxy id; returns true to stop the query
+	 * @return Proxy the query stopped at, or -1 if every object was visited
+	 */
+	int LooseOctree::Query(const Obb& region, const function<bool(int)>& visit) const
+	{
+		return QueryNodes(*this, region, BvhTraits<Obb>::Bounds(region), visit);
+	}
+
+	/**
+	 * @brief Visits the objects whose bounds overlap a sphere
+	 * @param region Sphere to query
+	 * @param visit Called with each proxy id; returns true to stop the query
+	 * @return Proxy the query stopped at, or -1 if every object was visited
+	 */
+	int LooseOctree::Query(const Sphere& region, const function<bool(int)>& visit) const
+	{
+		return QueryNodes(*this, region, BvhTraits<Sphere>::Bounds(region), visit);
+	}
+
+	/**
+	 * @brief Finds the nearest object bounds hit by a ray
+	 * @param ray Ray to cast
+	 * @param distance Receives the distance to the nearest box (unchanged on a miss)
+	 * @param maxDistance Boxes entered beyond this distance are ignored
+	 * @return Proxy whose bounds are entered first, or -1 if none is hit
+	 */
+	int LooseOctree::CastRay(const Ray& ray, float& distance, const float maxDistance) const
+	{
+		return CastNodes(*this, ray, maxDistance, [](int, const float entry, float)
+		{
+			return entry;
+		}, distance);
+	}
+
+	/**
+	 * @brief Finds the nearest object hit by a ray, with an exact test per object
+	 * @param ray Ray to cast
+	 * @param cast Called as cast(proxy, maxDistance) for objects whose bounds the ray enters
+	 * @param distance Receives the distance to the nearest hit (unchanged on a miss)
+	 * @param maxDistance Hits beyond this distance are ignored
+	 * @return Nearest proxy hit, or -1 if there is none
+	 */
+	int LooseOctree::CastRay(const Ray& ray, const function<float(int, float)>& cast, float& distance, const float maxDistance) const
+	{
+		return CastNodes(*this, ray, maxDistance, [&](const int proxy, float, const float limit)
+		{
+			return cast(proxy, limit);
+		}, distance);
+	}
+}
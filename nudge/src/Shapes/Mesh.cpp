@@ -1,22 +1,482 @@
 #include "Nudge/Shapes/Mesh.hpp"
 
+#include "Nudge/Core/Parallel.hpp"
 #include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Bvh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/QueryCoherence.hpp"
+#include "Nudge/Shapes/QueryFilter.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
 #include "Nudge/Shapes/Triangle.hpp"
+#include "Nudge/Shapes/TriangleCache.hpp"
 
-// Configuration: Use octree subdivision (8 children per node)
-// Could be adjusted for different tree structures (binary = 2, quadtree = 4, etc.)
-constexpr int BVH_CHILD_COUNT = 8;
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+using std::atomic;
+using std::vector;
+
+// Barycentric margin within which a containment ray counts as grazing an edge
+// or vertex. Such rays could be counted by both neighbouring triangles or by
+// neither, so the test is retried along another direction.
+constexpr float MESH_CONTAINS_EDGE_TOLERANCE = 1e-5f;
+
+// Distance to a triangle, relative to its longest edge, within which a point
+// counts as lying on the surface
+constexpr float MESH_CONTAINS_SURFACE_TOLERANCE = 1e-6f;
+
+// Unit directions tried in turn by Mesh::Contains(). Chosen off the axes and
+// diagonals so grid-aligned meshes rarely put an edge in their way.
+constexpr float MESH_CONTAINS_DIRECTIONS[][3] =
+{
+	{ 0.5318143f, 0.7153192f, 0.4533122f },
+	{ -0.6137614f, 0.3219322f, 0.7208721f },
+	{ 0.2740971f, -0.8865906f, 0.3725961f },
+	{ -0.4417330f, -0.5183387f, -0.7322547f }
+};
+
+// Pseudo-random directions Mesh::Contains() tries once every fixed direction
+// has grazed an edge or vertex, before falling back to the winding number
+constexpr int MESH_CONTAINS_RANDOM_DIRECTIONS = 16;
+
+// Crossings remembered without allocating; more spill to the heap
+constexpr int MESH_CONTAINS_INLINE_CROSSINGS = 32;
+
+// Points handed to a batch worker at a time
+constexpr int MESH_CONTAINS_BATCH_BLOCK = 256;
 
 namespace Nudge
 {
+	/**
+	 * @brief Tests whether one triangle of a mesh overlaps a shape
+	 * @param mesh Mesh owning the triangle
+	 * @param index Triangle index
+	 * @param shape Query shape, any type accepted by Triangle::Intersects()
+	 * @return True if the triangle intersects the shape
+	 */
+	template <typename Shape>
+	static bool TriangleIntersects(const Mesh& mesh, const int index, const Shape& shape)
+	{
+		return mesh.triangles[index].Intersects(shape);
+	}
+
+	/**
+	 * @brief Tests whether one triangle of a mesh overlaps a box, using the triangle cache if built
+	 * @param mesh Mesh owning the triangle
+	 * @param index Triangle index
+	 * @param shape Box to test
+	 * @return True if the triangle intersects the box
+	 */
+	static bool TriangleIntersects(const Mesh& mesh, const int index, const Aabb& shape)
+	{
+		if (mesh.cache != nullptr)
+		{
+			return mesh.cache->IntersectsAabb(index, shape.origin, shape.extents);
+		}
+
+		return mesh.triangles[index].Intersects(shape);
+	}
+
+	/**
+	 * @brief Tests whether one triangle of a mesh overlaps a sphere, using the triangle cache if built
+	 * @param mesh Mesh owning the triangle
+	 * @param index Triangle index
+	 * @param shape Sphere to test
+	 * @return True if the triangle intersects the sphere
+	 */
+	static bool TriangleIntersects(const Mesh& mesh, const int index, const Sphere& shape)
+	{
+		if (mesh.cache != nullptr)
+		{
+			return mesh.cache->IntersectsSphere(index, shape.origin, shape.radius);
+		}
+
+		return mesh.triangles[index].Intersects(shape);
+	}
+
+	/**
+	 * @brief Overlap query for VisitTriangles(): stops at the first triangle overlapping a shape
+	 */
+	template <typename Shape>
+	class OverlapQuery
+	{
+	public:
+		const Mesh& mesh;
+		const Shape& shape;
+		const Aabb& bounds;
+		Vector3 min;
+		Vector3 max;
+
+	public:
+		/**
+		 * @brief Prepares the query
+		 * @param mesh Mesh whose triangles are tested
+		 * @param shape Query shape, any type accepted by Triangle::Intersects()
+		 * @param bounds Box enclosing the shape, used to cull hierarchy nodes
+		 */
+		OverlapQuery(const Mesh& mesh, const Shape& shape, const Aabb& bounds)
+			: mesh{ mesh }, shape{ shape }, bounds{ bounds }, min{ bounds.Min() }, max{ bounds.Max() }
+		{
+		}
+
+		int Children(const WideBvhNode& node) const
+		{
+			return node.OverlapChildren(min, max);
+		}
+
+		bool Enters(const Vector3& nodeMin, const Vector3& nodeMax) const
+		{
+			return nodeMin.x <= max.x && nodeMax.x >= min.x &&
+				nodeMin.y <= max.y && nodeMax.y >= min.y &&
+				nodeMin.z <= max.z && nodeMax.z >= min.z;
+		}
+
+		bool Enters(const Aabb& box) const
+		{
+			return box.Intersects(bounds);
+		}
+
+		bool Visit(const int triangle) const
+		{
+			return TriangleIntersects(mesh, triangle, shape);
+		}
+	};
+
+	/**
+	 * @brief Finds a triangle that overlaps a shape, with a box of the shape for culling
+	 * @param mesh Mesh whose triangles are tested
+	 * @param shape Query shape, any type accepted by Triangle::Intersects()
+	 * @param bounds Box enclosing the shape, used to cull hierarchy nodes
+	 * @param filter Selects the triangles that count, or nullptr for all
+	 * @return Index of the first overlapping triangle found, or -1 if there is none
+	 */
+	template <typename Shape>
+	static int Overlaps(const Mesh& mesh, const Shape& shape, const Aabb& bounds, const QueryFilter* filter = nullptr)
+	{
+		OverlapQuery<Shape> query{ mesh, shape, bounds };
+
+		return VisitTriangles(mesh, query, filter);
+	}
+
+	/**
+	 * @brief Containment query for VisitTriangles(): counts the triangles a ray from the point crosses
+	 *
+	 * Crossings are counted from both sides and each triangle once, even when
+	 * the structure references it from several leaves. The walk stops early
+	 * when the point lies on a triangle or the ray grazes an edge, vertex or
+	 * the plane of a triangle, where the count would be unreliable.
+	 */
+	class CrossingQuery
+	{
+	public:
+		const Mesh& mesh;
+		PreparedRay ray;
+		int count;                                          ///< Distinct triangles crossed so far
+		int crossed[MESH_CONTAINS_INLINE_CROSSINGS];       ///< First crossed triangles
+		vector<int> spill;                                  ///< Further crossed triangles
+		bool surface;                                       ///< The point lies on a triangle
+		bool ambiguous;                                     ///< The ray grazed an edge, vertex or plane
+
+	public:
+		/**
+		 * @brief Prepares the query
+		 * @param mesh Mesh whose triangles are crossed
+		 * @param point Start of the ray
+		 * @param direction Unit direction of the ray
+		 */
+		CrossingQuery(const Mesh& mesh, const Vector3& point, const float* direction)
+			: mesh{ mesh }, ray{ Ray{ point, Vector3{ direction[0], direction[1], direction[2] } } },
+			  count{ 0 }, crossed{}, surface{ false }, ambiguous{ false }
+		{
+		}
+
+		int Children(const WideBvhNode& node) const
+		{
+			float entries[WIDE_BVH_WIDTH];
+
+			return node.IntersectChildren(ray, ray.maxDistance, entries);
+		}
+
+		bool Enters(const Vector3& nodeMin, const Vector3& nodeMax) const
+		{
+			return ray.Enter(nodeMin, nodeMax) >= 0.f;
+		}
+
+		bool Enters(const Aabb& box) const
+		{
+			return ray.Enter(box) >= 0.f;
+		}
+
+		/**
+		 * @brief Classifies one triangle against the ray
+		 * @param triangle Triangle index
+		 * @return True to stop the walk (point on the surface, or ambiguous ray)
+		 *
+		 * Double-sided Moller-Trumbore with tolerances on the barycentric
+		 * coordinates and the hit distance.
+		 */
+		bool Visit(const int triangle)
+		{
+			const auto& v = mesh.triangles[triangle].values;
+
+			const float e1[3] = { v[3] - v[0], v[4] - v[1], v[5] - v[2] };
+			const float e2[3] = { v[6] - v[0], v[7] - v[1], v[8] - v[2] };
+			const float* d = ray.direction;
+
+			const float p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+			const float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+
+			const float length1 = e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2];
+			const float length2 = e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2];
+			const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			const float area = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+			const float offset[3] = { ray.origin[0] - v[0], ray.origin[1] - v[1], ray.origin[2] - v[2] };
+
+			// Degenerate triangles enclose nothing
+			if (area <= MESH_CONTAINS_SURFACE_TOLERANCE * MESH_CONTAINS_SURFACE_TOLERANCE * length1 * length2)
+			{
+				return false;
+			}
+
+			// The determinant is -dot(direction, n): near zero the ray runs along the plane,
+			// which only matters if it lies in it
+			if (determinant * determinant <= MESH_CONTAINS_EDGE_TOLERANCE * MESH_CONTAINS_EDGE_TOLERANCE * area)
+			{
+				const float distance = n[0] * offset[0] + n[1] * offset[1] + n[2] * offset[2];
+
+				ambiguous = distance * distance <= MESH_CONTAINS_EDGE_TOLERANCE * MESH_CONTAINS_EDGE_TOLERANCE * area * std::max(length1, length2);
+				return ambiguous;
+			}
+
+			const float inverse = 1.f / determinant;
+			const float u = (offset[0] * p[0] + offset[1] * p[1] + offset[2] * p[2]) * inverse;
+			if (u < -MESH_CONTAINS_EDGE_TOLERANCE || u > 1.f + MESH_CONTAINS_EDGE_TOLERANCE)
+			{
+				return false;
+			}
+
+			const float q[3] = { offset[1] * e1[2] - offset[2] * e1[1], offset[2] * e1[0] - offset[0] * e1[2], offset[0] * e1[1] - offset[1] * e1[0] };
+			const float w = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse;
+			if (w < -MESH_CONTAINS_EDGE_TOLERANCE || u + w > 1.f + MESH_CONTAINS_EDGE_TOLERANCE)
+			{
+				return false;
+			}
+
+			const float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+			const float reach = MESH_CONTAINS_SURFACE_TOLERANCE * MESH_CONTAINS_SURFACE_TOLERANCE * std::max(length1, length2);
+
+			if (t * t <= reach)
+			{
+				surface = true;
+				return true;
+			}
+
+			if (t < 0.f)
+			{
+				return false;
+			}
+
+			if (u < MESH_CONTAINS_EDGE_TOLERANCE || w < MESH_CONTAINS_EDGE_TOLERANCE || u + w > 1.f - MESH_CONTAINS_EDGE_TOLERANCE)
+			{
+				ambiguous = true;
+				return true;
+			}
+
+			Add(triangle);
+			return false;
+		}
+
+		/**
+		 * @brief Records a crossed triangle unless it was already counted
+		 * @param triangle Triangle index
+		 */
+		void Add(const int triangle)
+		{
+			const int kept = std::min(count, MESH_CONTAINS_INLINE_CROSSINGS);
+
+			if (std::find(crossed, crossed + kept, triangle) != crossed + kept ||
+				std::find(spill.begin(), spill.end(), triangle) != spill.end())
+			{
+				return;
+			}
+
+			if (count < MESH_CONTAINS_INLINE_CROSSINGS)
+			{
+				crossed[count] = triangle;
+			}
+			else
+			{
+				spill.push_back(triangle);
+			}
+
+			++count;
+		}
+	};
+
+	/**
+	 * @brief Derives a direction for a containment retry from a point and an attempt number
+	 * @param point Point being classified
+	 * @param attempt Retry number
+	 * @param direction Receives a unit direction, uniform over the sphere
+	 *
+	 * Hashing the point's bits means neighbouring lattice points never share
+	 * the same sequence, so a regular mesh cannot line up an edge with every
+	 * retry of a whole row of points.
+	 */
+	static void ScatterDirection(const Vector3& point, const int attempt, float* direction)
+	{
+		uint32_t hash = std::bit_cast<uint32_t>(point.x) * 73856093u;
+		hash ^= std::bit_cast<uint32_t>(point.y) * 19349663u;
+		hash ^= std::bit_cast<uint32_t>(point.z) * 83492791u;
+		hash ^= static_cast<uint32_t>(attempt + 1) * 2654435761u;
+
+		hash ^= hash >> 16;
+		hash *= 0x7feb352du;
+		hash ^= hash >> 15;
+		hash *= 0x846ca68bu;
+		hash ^= hash >> 16;
+
+		const float z = 1.f - 2.f * static_cast<float>(hash & 0xffffu) / 65535.f;
+		const float angle = 6.28318531f * static_cast<float>(hash >> 16) / 65536.f;
+		const float radius = std::sqrt(std::max(1.f - z * z, 0.f));
+
+		direction[0] = radius * std::cos(angle);
+		direction[1] = radius * std::sin(angle);
+		direction[2] = z;
+	}
+
+	/**
+	 * @brief Generalized winding number of a mesh around a point
+	 * @param mesh Mesh whose triangles are summed
+	 * @param point Point to measure around
+	 * @return Sum of the signed solid angles of every triangle over 4 pi
+	 *
+	 * Uses the solid angle formula of Van Oosterom and Strackee. Exact for
+	 * points off the surface whatever the ray geometry, but only meaningful
+	 * for consistently wound meshes: the result is +-1 inside, 0 outside.
+	 */
+	static float WindingNumber(const Mesh& mesh, const Vector3& point)
+	{
+		double total = 0.;
+
+		for (int i = 0; i < mesh.numTriangles; ++i)
+		{
+			const auto& v = mesh.triangles[i].values;
+			const float a[3] = { v[0] - point.x, v[1] - point.y, v[2] - point.z };
+			const float b[3] = { v[3] - point.x, v[4] - point.y, v[5] - point.z };
+			const float c[3] = { v[6] - point.x, v[7] - point.y, v[8] - point.z };
+
+			const float la = std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+			const float lb = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+			const float lc = std::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+
+			const float triple =
+				a[0] * (b[1] * c[2] - b[2] * c[1]) +
+				a[1] * (b[2] * c[0] - b[0] * c[2]) +
+				a[2] * (b[0] * c[1] - b[1] * c[0]);
+
+			const float denominator = la * lb * lc +
+				(a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) * lc +
+				(a[0] * c[0] + a[1] * c[1] + a[2] * c[2]) * lb +
+				(b[0] * c[0] + b[1] * c[1] + b[2] * c[2]) * la;
+
+			total += 2. * std::atan2(static_cast<double>(triple), static_cast<double>(denominator));
+		}
+
+		return static_cast<float>(total / (4. * 3.14159265358979));
+	}
+
+	/**
+	 * @brief Tests whether a mesh overlaps a shape, trying the triangle found last time first
+	 * @param mesh Mesh whose triangles are tested
+	 * @param shape Query shape, any type accepted by Triangle::Intersects()
+	 * @param bounds Box enclosing the shape, used to cull hierarchy nodes
+	 * @param coherence Hint to test first and update
+	 * @return True if any triangle intersects the shape
+	 */
+	template <typename Shape>
+	static bool CoherentOverlaps(const Mesh& mesh, const Shape& shape, const Aabb& bounds, QueryCoherence& coherence)
+	{
+		const int hint = coherence.triangle;
+		if (hint >= 0 && hint < mesh.numTriangles && TriangleIntersects(mesh, hint, shape))
+		{
+			++coherence.hits;
+			return true;
+		}
+
+		++coherence.misses;
+
+		const int triangle = Overlaps(mesh, shape, bounds);
+		if (triangle >= 0)
+		{
+			coherence.triangle = triangle;
+		}
+
+		return triangle >= 0;
+	}
+
+	/**
+	 * @brief Sets the flag mask of every node in an octree subtree
+	 * @param node Root of the subtree
+	 * @param flags Flags of each triangle, or nullptr to make every node match any filter
+	 * @return Bitwise OR of the flags of every triangle referenced in the subtree
+	 */
+	static uint32_t GatherOctreeMask(BvhNode& node, const uint32_t* flags)
+	{
+		uint32_t mask = 0;
+
+		for (int i = 0; i < node.numTriangles; ++i)
+		{
+			mask |= flags != nullptr ? flags[node.triangles[i]] : QUERY_FILTER_ALL;
+		}
+
+		if (node.children != nullptr)
+		{
+			for (int i = 0; i < BVH_CHILD_COUNT; ++i)
+			{
+				mask |= GatherOctreeMask(node.children[i], flags);
+			}
+		}
+
+		node.mask = flags != nullptr ? mask : QUERY_FILTER_ALL;
+		return node.mask;
+	}
+
+	/**
+	 * @brief Frees the working storage the mesh's structures keep between builds
+	 * @param mesh Mesh whose structures keep their nodes
+	 */
+	static void ReleaseStructureScratch(Mesh& mesh)
+	{
+		if (mesh.hierarchy != nullptr)
+		{
+			mesh.hierarchy->ReleaseScratch();
+		}
+
+		if (mesh.wideHierarchy != nullptr)
+		{
+			mesh.wideHierarchy->ReleaseScratch();
+		}
+	}
+
 	/**
 	 * @brief Default constructor for BVH node
 	 *
 	 * Initializes node as a leaf with no children or triangles.
-	 * All pointers are set to nullptr and counts to zero.
+	 * All pointers are set to nullptr and counts to zero. The flag mask
+	 * starts with every bit set, so filtered queries never skip the node
+	 * before Mesh::RefreshFlags() has run.
 	 */
 	BvhNode::BvhNode()
-		: children{ nullptr }, numTriangles{ 0 }, triangles{ nullptr }
+		: children{ nullptr }, numTriangles{ 0 }, triangles{ nullptr }, mask{ QUERY_FILTER_ALL }
 	{
 	}
 
@@ -152,37 +612,119 @@ namespace Nudge
 		}
 	}
 
+	/**
+	 * @brief Default constructor creating an idle state with no storage
+	 */
+	MeshBuildState::MeshBuildState()
+		: collapseSource{ nullptr }
+	{
+	}
+
+	/**
+	 * @brief Starts an idle state with no storage, whatever the source holds
+	 * @param other State of the mesh being copied, which must have no build running
+	 *
+	 * The collapse source is owned, and the pending handle belongs to the
+	 * mesh whose address the worker captured, so neither is shared.
+	 */
+	MeshBuildState::MeshBuildState(const MeshBuildState& other)
+		: collapseSource{ nullptr }
+	{
+		assert(!other.IsRunning() && "a mesh must not be copied or moved while AccelerateAsync() is running");
+	}
+
+	/**
+	 * @brief Frees the collapse source
+	 */
+	MeshBuildState::~MeshBuildState()
+	{
+		delete collapseSource;
+	}
+
+	/**
+	 * @brief Keeps this state, checking the source has no build running
+	 * @param other State of the mesh being copied, which must have no build running
+	 * @return This state
+	 */
+	MeshBuildState& MeshBuildState::operator=(const MeshBuildState& other)
+	{
+		assert(!IsRunning() && !other.IsRunning() && "a mesh must not be copied or moved while AccelerateAsync() is running");
+
+		return *this;
+	}
+
+	/**
+	 * @brief Tests whether a build started by AccelerateAsync() has not been waited for
+	 * @return True while the handle is valid
+	 */
+	bool MeshBuildState::IsPending() const
+	{
+		return pending.valid();
+	}
+
+	/**
+	 * @brief Tests whether the worker of a build started by AccelerateAsync() may still write to the mesh
+	 * @return True while the pending build has not finished
+	 */
+	bool MeshBuildState::IsRunning() const
+	{
+		return pending.valid() && pending.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready;
+	}
+
+	/**
+	 * @brief Frees the working storage, keeping any pending build
+	 */
+	void MeshBuildState::Release()
+	{
+		delete collapseSource;
+		collapseSource = nullptr;
+
+		vector<Aabb>().swap(triangleBounds);
+	}
+
 	/**
 	 * @brief Default constructor for mesh
 	 *
 	 * Initializes empty mesh with no triangles or acceleration structure.
 	 */
 	Mesh::Mesh()
-		: numTriangles{ 0 }, values{ nullptr }, accelerator{ nullptr }
+		: numTriangles{ 0 }, values{ nullptr }, accelerator{ nullptr }, hierarchy{ nullptr }, wideHierarchy{ nullptr }, cache{ nullptr }, flags{ nullptr }
 	{
 	}
 
 	/**
 	 * @brief Builds BVH acceleration structure for the mesh
+	 * @param mode Construction strategy
 	 *
-	 * Creates an octree-based BVH to accelerate spatial queries on the mesh.
-	 * The structure enables fast ray-mesh intersection, collision detection,
-	 * and spatial queries by hierarchically organizing triangles.
+	 * Creates either the octree BVH or a linear BVH to accelerate spatial queries
+	 * on the mesh. The structure enables fast ray-mesh intersection, collision
+	 * detection, and spatial queries by hierarchically organizing triangles.
 	 *
-	 * Algorithm:
+	 * Octree algorithm:
 	 * 1. Calculate tight bounding box around all mesh vertices
 	 * 2. Create root BVH node encompassing entire mesh
 	 * 3. Initialize with all triangle indices
 	 * 4. Recursively subdivide to depth of 3 levels
 	 */
-	void Mesh::Accelerate()
+	void Mesh::Accelerate(const BvhBuildMode mode)
 	{
+		WaitForBuild();
+
 		// Avoid rebuilding existing acceleration structure
-		if (accelerator != nullptr)
+		if (accelerator != nullptr || hierarchy != nullptr || wideHierarchy != nullptr || numTriangles <= 0)
 		{
 			return;
 		}
 
+		// A structure built once has no use for the storage kept for rebuilds
+		if (mode != BvhBuildMode::Octree)
+		{
+			Rebuild(mode);
+			build.Release();
+			ReleaseStructureScratch(*this);
+			return;
+		}
+
 		// Calculate mesh bounding box by examining all vertices
 		// ASSUMPTION: vertices array contains numTriangles * 3 elements
 		Vector3 min = vertices[0];
@@ -214,5 +756,529 @@ namespace Nudge
 		// Begin recursive subdivision with maximum depth of 3
 		// Depth 3 = up to 8^3 = 512 potential leaf nodes
 		accelerator->Split(this, 3);
+
+		RefreshFlags();
+	}
+
+	/**
+	 * @brief Builds the acceleration structure on a worker thread
+	 * @param mode Construction strategy
+	 * @return Handle that becomes ready once the structure is in place
+	 *
+	 * Algorithm:
+	 * 1. Build into a staging mesh that shares the triangle data, so nothing
+	 *    queries can see is touched while the build runs
+	 * 2. Release-store each of the staging mesh's three structure pointers,
+	 *    pairing with the acquire loads in the query code. Only the structure
+	 *    built is non-null; the other two stores write nullptr over nullptr
+	 */
+	shared_future<void> Mesh::AccelerateAsync(const BvhBuildMode mode)
+	{
+		if (build.IsPending())
+		{
+			return build.pending;
+		}
+
+		if (accelerator != nullptr || hierarchy != nullptr || wideHierarchy != nullptr || numTriangles <= 0)
+		{
+			std::promise<void> done;
+			done.set_value();
+			return done.get_future().share();
+		}
+
+		build.pending = std::async(std::launch::async, [this, mode]
+		{
+			Mesh staging;
+			staging.numTriangles = numTriangles;
+			staging.triangles = triangles;
+			staging.flags = flags;
+			staging.Accelerate(mode);
+
+			std::atomic_ref<BvhNode*>(accelerator).store(staging.accelerator, std::memory_order_release);
+			std::atomic_ref<LinearBvh*>(hierarchy).store(staging.hierarchy, std::memory_order_release);
+			std::atomic_ref<WideBvh*>(wideHierarchy).store(staging.wideHierarchy, std::memory_order_release);
+		}).share();
+
+		return build.pending;
+	}
+
+	/**
+	 * @brief Build handle and working storage kept by the mesh
+	 * @return Read-only view of the build state
+	 */
+	const MeshBuildState& Mesh::BuildState() const
+	{
+		return build;
+	}
+
+	/**
+	 * @brief Blocks until a build started by AccelerateAsync() has been published
+	 */
+	void Mesh::WaitForBuild()
+	{
+		if (build.IsPending())
+		{
+			build.pending.wait();
+			build.pending = shared_future<void>();
+		}
+	}
+
+	/**
+	 * @brief Rebuilds the acceleration structure from the current triangle data
+	 * @param mode Construction strategy for the new structure
+	 *
+	 * Algorithm (Morton and wide modes):
+	 * 1. Compute the bounds of every triangle in parallel
+	 * 2. Hand them to LinearBvh::BuildMorton(), reusing the existing hierarchy if present
+	 * 3. Wide mode only: collapse the binary hierarchy into the WideBvh
+	 *
+	 * Spatial mode hands the triangles straight to LinearBvh::BuildSpatial().
+	 * The triangle cache, if present, is refreshed first, and the flags are
+	 * aggregated into the new nodes last.
+	 */
+	void Mesh::Rebuild(const BvhBuildMode mode)
+	{
+		WaitForBuild();
+
+		if (cache != nullptr)
+		{
+			cache->Build(triangles, numTriangles);
+		}
+
+		if (mode == BvhBuildMode::Octree || accelerator != nullptr || numTriangles <= 0)
+		{
+			ReleaseAccelerator();
+			Accelerate(mode);
+			return;
+		}
+
+		if (mode == BvhBuildMode::Wide)
+		{
+			delete hierarchy;
+			hierarchy = nullptr;
+
+			if (wideHierarchy == nullptr)
+			{
+				wideHierarchy = new WideBvh;
+			}
+
+			if (build.collapseSource == nullptr)
+			{
+				build.collapseSource = new LinearBvh;
+			}
+
+			GatherBvhInputs(triangles, numTriangles, build.triangleBounds, nullptr);
+
+			build.collapseSource->BuildMorton(build.triangleBounds.data(), numTriangles);
+			wideHierarchy->Collapse(*build.collapseSource);
+			wideHierarchy->BuildMasks(flags);
+			return;
+		}
+
+		delete wideHierarchy;
+		wideHierarchy = nullptr;
+
+		delete build.collapseSource;
+		build.collapseSource = nullptr;
+
+		if (hierarchy == nullptr)
+		{
+			hierarchy = new LinearBvh;
+		}
+
+		// Spatial splits clip the triangles themselves rather than their bounds
+		if (mode == BvhBuildMode::Spatial)
+		{
+			hierarchy->BuildSpatial(triangles, numTriangles);
+			hierarchy->BuildMasks(flags);
+			return;
+		}
+
+		GatherBvhInputs(triangles, numTriangles, build.triangleBounds, nullptr);
+
+		hierarchy->BuildMorton(build.triangleBounds.data(), numTriangles, mode == BvhBuildMode::MortonPrecise ? 63 : 30);
+		hierarchy->BuildMasks(flags);
+	}
+
+	/**
+	 * @brief Frees any acceleration structure owned by the mesh
+	 */
+	void Mesh::ReleaseAccelerator()
+	{
+		WaitForBuild();
+
+		if (accelerator != nullptr)
+		{
+			accelerator->Free();
+			delete accelerator;
+			accelerator = nullptr;
+		}
+
+		delete hierarchy;
+		hierarchy = nullptr;
+
+		delete wideHierarchy;
+		wideHierarchy = nullptr;
+
+		build.Release();
+		ReleaseStructureScratch(*this);
+	}
+
+	/**
+	 * @brief Reorders triangle storage so every BVH leaf covers a contiguous run of triangles
+	 * @param ids Optional per-triangle values permuted alongside the triangles
+	 * @return True if the triangles were reordered (or already were in leaf order)
+	 *
+	 * Algorithm:
+	 * 1. Check the hierarchy's index array is a permutation of the triangles
+	 *    (every triangle is referenced at least once, so a size match suffices)
+	 * 2. Gather triangles (and ids, and flags) into leaf order in scratch storage
+	 * 3. Copy them back over the caller's arrays and drop the index array
+	 *
+	 * Node flag masks stay valid: every leaf still covers the same triangles.
+	 */
+	bool Mesh::ReorderTriangles(int* ids)
+	{
+		WaitForBuild();
+
+		vector<int>* order = nullptr;
+
+		if (wideHierarchy != nullptr && !wideHierarchy->IsEmpty())
+		{
+			order = &wideHierarchy->indices;
+		}
+		else if (hierarchy != nullptr && !hierarchy->IsEmpty())
+		{
+			order = &hierarchy->indices;
+		}
+
+		if (order == nullptr)
+		{
+			return false;
+		}
+
+		if (order->empty())
+		{
+			return true;
+		}
+
+		if (static_cast<int>(order->size()) != numTriangles)
+		{
+			return false;
+		}
+
+		vector<float> sorted(static_cast<size_t>(numTriangles) * 9);
+		vector<int> sortedIds(ids != nullptr ? numTriangles : 0);
+		vector<uint32_t> sortedFlags(flags != nullptr ? numTriangles : 0);
+
+		Parallel::For(numTriangles, 4096, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				const int source = (*order)[i];
+				std::copy_n(&values[static_cast<size_t>(source) * 9], 9, &sorted[static_cast<size_t>(i) * 9]);
+
+				if (ids != nullptr)
+				{
+					sortedIds[i] = ids[source];
+				}
+
+				if (flags != nullptr)
+				{
+					sortedFlags[i] = flags[source];
+				}
+			}
+		});
+
+		std::copy(sorted.begin(), sorted.end(), values);
+
+		if (ids != nullptr)
+		{
+			std::copy(sortedIds.begin(), sortedIds.end(), ids);
+		}
+
+		if (flags != nullptr)
+		{
+			std::copy(sortedFlags.begin(), sortedFlags.end(), flags);
+		}
+
+		vector<int>().swap(*order);
+
+		if (cache != nullptr)
+		{
+			cache->Build(triangles, numTriangles);
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Aggregates the triangle flags into the nodes of the acceleration structure
+	 *
+	 * The binary and wide hierarchies store their masks alongside the nodes;
+	 * octree nodes hold their own, computed depth-first. Without flags every
+	 * octree node goes back to matching any filter.
+	 */
+	void Mesh::RefreshFlags()
+	{
+		WaitForBuild();
+
+		if (accelerator != nullptr)
+		{
+			GatherOctreeMask(*accelerator, flags);
+		}
+
+		if (hierarchy != nullptr)
+		{
+			hierarchy->BuildMasks(flags);
+		}
+
+		if (wideHierarchy != nullptr)
+		{
+			wideHierarchy->BuildMasks(flags);
+		}
+	}
+
+	/**
+	 * @brief Precomputes per-triangle query data used by ray casts and overlap queries
+	 */
+	void Mesh::BuildCache()
+	{
+		if (cache == nullptr)
+		{
+			cache = new TriangleCache;
+		}
+
+		cache->Build(triangles, numTriangles);
+	}
+
+	/**
+	 * @brief Frees the precomputed triangle data
+	 */
+	void Mesh::ReleaseCache()
+	{
+		delete cache;
+		cache = nullptr;
+	}
+
+	/**
+	 * @brief Tests whether a point lies inside the volume a closed mesh encloses
+	 * @param point Point to classify
+	 * @return True if the point is inside or on the surface
+	 *
+	 * Algorithm:
+	 * 1. Cast a ray from the point and count the distinct triangles it crosses,
+	 *    from either side, culling with the acceleration structure
+	 * 2. An odd count means inside
+	 * 3. If the ray grazes an edge, vertex or triangle plane, retry along the
+	 *    next of MESH_CONTAINS_DIRECTIONS, then along up to
+	 *    MESH_CONTAINS_RANDOM_DIRECTIONS directions hashed from the point
+	 * 4. If every ray grazed, classify by the generalized winding number,
+	 *    an O(n) pass over all triangles
+	 *
+	 * @warning The mesh must be closed and consistently wound
+	 */
+	bool Mesh::Contains(const Vector3& point) const
+	{
+		constexpr int fixed = static_cast<int>(std::size(MESH_CONTAINS_DIRECTIONS));
+
+		for (int attempt = 0; attempt < fixed + MESH_CONTAINS_RANDOM_DIRECTIONS; ++attempt)
+		{
+			float scattered[3];
+			if (attempt >= fixed)
+			{
+				ScatterDirection(point, attempt - fixed, scattered);
+			}
+
+			CrossingQuery query{ *this, point, attempt < fixed ? MESH_CONTAINS_DIRECTIONS[attempt] : scattered };
+			VisitTriangles(*this, query);
+
+			if (query.surface)
+			{
+				return true;
+			}
+
+			if (!query.ambiguous)
+			{
+				return query.count % 2 == 1;
+			}
+		}
+
+		return std::abs(WindingNumber(*this, point)) > .5f;
+	}
+
+	/**
+	 * @brief Classifies many points against a closed mesh in parallel
+	 * @param points Points to classify
+	 * @param inside Receives 1 for each point inside or on the surface, 0 otherwise, at the point's index
+	 * @return Number of points inside
+	 *
+	 * Workers claim blocks of MESH_CONTAINS_BATCH_BLOCK points from a shared
+	 * counter, as in Ray::CastBatch().
+	 *
+	 * @warning The mesh must be closed and consistently wound
+	 */
+	int Mesh::ContainsBatch(span<const Vector3> points, span<uint8_t> inside) const
+	{
+		const int count = static_cast<int>(std::min(points.size(), inside.size()));
+		if (count <= 0)
+		{
+			return 0;
+		}
+
+		const int workers = std::min(Parallel::WorkerCount(), (count + MESH_CONTAINS_BATCH_BLOCK - 1) / MESH_CONTAINS_BATCH_BLOCK);
+
+		atomic<int> next{ 0 };
+		atomic<int> total{ 0 };
+
+		Parallel::For(workers, 1, [&](const int, const int, const int)
+		{
+			int found = 0;
+
+			for (int begin = next.fetch_add(MESH_CONTAINS_BATCH_BLOCK); begin < count; begin = next.fetch_add(MESH_CONTAINS_BATCH_BLOCK))
+			{
+				const int end = std::min(begin + MESH_CONTAINS_BATCH_BLOCK, count);
+
+				for (int i = begin; i < end; ++i)
+				{
+					inside[i] = Contains(points[i]) ? 1 : 0;
+					found += inside[i];
+				}
+			}
+
+			total += found;
+		});
+
+		return total;
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps a box
+	 * @param other Axis-aligned box to test
+	 * @return True if at least one triangle intersects the box
+	 */
+	bool Mesh::Intersects(const Aabb& other) const
+	{
+		return Overlaps(*this, other, other) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps an oriented box
+	 * @param other Oriented box to test
+	 * @return True if at least one triangle intersects the box
+	 *
+	 * Nodes are culled against the world-space box enclosing the OBB.
+	 */
+	bool Mesh::Intersects(const Obb& other) const
+	{
+		return Overlaps(*this, other, BvhTraits<Obb>::Bounds(other)) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps a sphere
+	 * @param other Sphere to test
+	 * @return True if at least one triangle intersects the sphere
+	 */
+	bool Mesh::Intersects(const Sphere& other) const
+	{
+		return Overlaps(*this, other, BvhTraits<Sphere>::Bounds(other)) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps a triangle
+	 * @param other Triangle to test
+	 * @return True if at least one triangle intersects the given one
+	 */
+	bool Mesh::Intersects(const Triangle& other) const
+	{
+		return Overlaps(*this, other, BvhTraits<Triangle>::Bounds(other)) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps a box, trying the triangle found last time first
+	 * @param other Axis-aligned box to test
+	 * @param coherence Hint updated with the overlapping triangle and the hint's hit or miss
+	 * @return True if at least one triangle intersects the box
+	 */
+	bool Mesh::Intersects(const Aabb& other, QueryCoherence& coherence) const
+	{
+		return CoherentOverlaps(*this, other, other, coherence);
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps an oriented box, trying the triangle found last time first
+	 * @param other Oriented box to test
+	 * @param coherence Hint updated with the overlapping triangle and the hint's hit or miss
+	 * @return True if at least one triangle intersects the box
+	 */
+	bool Mesh::Intersects(const Obb& other, QueryCoherence& coherence) const
+	{
+		return CoherentOverlaps(*this, other, BvhTraits<Obb>::Bounds(other), coherence);
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps a sphere, trying the triangle found last time first
+	 * @param other Sphere to test
+	 * @param coherence Hint updated with the overlapping triangle and the hint's hit or miss
+	 * @return True if at least one triangle intersects the sphere
+	 */
+	bool Mesh::Intersects(const Sphere& other, QueryCoherence& coherence) const
+	{
+		return CoherentOverlaps(*this, other, BvhTraits<Sphere>::Bounds(other), coherence);
+	}
+
+	/**
+	 * @brief Tests whether any triangle of the mesh overlaps a triangle, trying the triangle found last time first
+	 * @param other Triangle to test
+	 * @param coherence Hint updated with the overlapping triangle and the hint's hit or miss
+	 * @return True if at least one triangle intersects the given one
+	 */
+	bool Mesh::Intersects(const Triangle& other, QueryCoherence& coherence) const
+	{
+		return CoherentOverlaps(*this, other, BvhTraits<Triangle>::Bounds(other), coherence);
+	}
+
+	/**
+	 * @brief Tests whether any triangle passing a filter overlaps a box
+	 * @param other Axis-aligned box to test
+	 * @param filter Selects the triangles that count
+	 * @return True if at least one accepted triangle intersects the box
+	 */
+	bool Mesh::Intersects(const Aabb& other, const QueryFilter& filter) const
+	{
+		return Overlaps(*this, other, other, &filter) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether any triangle passing a filter overlaps an oriented box
+	 * @param other Oriented box to test
+	 * @param filter Selects the triangles that count
+	 * @return True if at least one accepted triangle intersects the box
+	 */
+	bool Mesh::Intersects(const Obb& other, const QueryFilter& filter) const
+	{
+		return Overlaps(*this, other, BvhTraits<Obb>::Bounds(other), &filter) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether any triangle passing a filter overlaps a sphere
+	 * @param other Sphere to test
+	 * @param filter Selects the triangles that count
+	 * @return True if at least one accepted triangle intersects the sphere
+	 */
+	bool Mesh::Intersects(const Sphere& other, const QueryFilter& filter) const
+	{
+		return Overlaps(*this, other, BvhTraits<Sphere>::Bounds(other), &filter) >= 0;
+	}
+
+	/**
+	 * @brief Tests whether any triangle passing a filter overlaps a triangle
+	 * @param other Triangle to test
+	 * @param filter Selects the triangles that count
+	 * @return True if at least one accepted triangle intersects the given one
+	 */
+	bool Mesh::Intersects(const Triangle& other, const QueryFilter& filter) const
+	{
+		return Overlaps(*this, other, BvhTraits<Triangle>::Bounds(other), &filter) >= 0;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,639 @@
+#include "Nudge/Shapes/MeshSimplifier.hpp"
+
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+
+// Weight of the constraint plane added along every open edge when boundaries
+// are preserved, relative to the unit weight of a triangle's own plane
+constexpr double SIMPLIFIER_BOUNDARY_WEIGHT = 1000.0;
+
+// Relative size below which a quadric's 3x3 system is treated as singular
+// and the collapse position is chosen among the edge's endpoints instead
+constexpr double SIMPLIFIER_SINGULAR = 1e-10;
+
+// Smallest cosine between a triangle's normal before and after a collapse;
+// anything below rotates the triangle too far and is treated as a flip
+constexpr double SIMPLIFIER_FLIP_COSINE = 1e-3;
+
+namespace Nudge
+{
+	/**
+	 * @brief Symmetric 4x4 quadric of summed squared plane distances
+	 *
+	 * Stored as its ten distinct coefficients: aa, ab, ac, ad, bb, bc, bd, cc, cd, dd
+	 * for planes ax + by + cz + d = 0.
+	 */
+	struct SimplifierQuadric
+	{
+		double q[10];
+	};
+
+	/**
+	 * @brief Candidate collapse of the edge between two welded vertices
+	 */
+	struct SimplifierCollapse
+	{
+		double error;       ///< Quadric error of the collapsed vertex
+		int from;           ///< Vertex removed by the collapse
+		int to;             ///< Vertex kept, moved to the collapse position
+		int fromVersion;    ///< Version of from when the candidate was measured
+		int toVersion;      ///< Version of to when the candidate was measured
+		double position[3]; ///< Position of the kept vertex after the collapse
+
+		bool operator>(const SimplifierCollapse& rhs) const
+		{
+			return error > rhs.error;
+		}
+	};
+
+	/**
+	 * @brief Welded, indexed working copy of the mesh being simplified
+	 */
+	struct SimplifierState
+	{
+		vector<double> positions;            ///< Three coordinates per vertex
+		vector<SimplifierQuadric> quadrics;  ///< One quadric per vertex
+		vector<int> versions;                ///< Bumped whenever a vertex moves or dies
+		vector<vector<int>> adjacency;       ///< Live triangles around each vertex
+		vector<int> corners;                 ///< Three vertex indices per triangle
+		vector<char> alive;                  ///< Per triangle, 0 once collapsed away
+	};
+
+	/**
+	 * @brief Adds the quadric of a plane, scaled by a weight
+	 * @param quadric Quadric to accumulate into
+	 * @param n Unit plane normal
+	 * @param d Plane offset, so that dot(n, p) + d = 0 on the plane
+	 * @param weight Scale of the plane's contribution
+	 */
+	static void AddPlane(SimplifierQuadric& quadric, const double* n, const double d, const double weight)
+	{
+		const double a = n[0];
+		const double b = n[1];
+		const double c = n[2];
+
+		quadric.q[0] += weight * a * a;
+		quadric.q[1] += weight * a * b;
+		quadric.q[2] += weight * a * c;
+		quadric.q[3] += weight * a * d;
+		quadric.q[4] += weight * b * b;
+		quadric.q[5] += weight * b * c;
+		quadric.q[6] += weight * b * d;
+		quadric.q[7] += weight * c * c;
+		quadric.q[8] += weight * c * d;
+		quadric.q[9] += weight * d * d;
+	}
+
+	/**
+	 * @brief Evaluates a quadric at a point
+	 * @param quadric Quadric to evaluate
+	 * @param p Point as three coordinates
+	 * @return Summed weighted squared distance of the point to the quadric's planes, never negative
+	 */
+	static double Evaluate(const SimplifierQuadric& quadric, const double* p)
+	{
+		const double* q = quadric.q;
+		const double x = p[0];
+		const double y = p[1];
+		const double z = p[2];
+
+		const double error = q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+			+ q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+			+ q[7] * z * z + 2.0 * q[8] * z
+			+ q[9];
+
+		return std::max(error, 0.0);
+	}
+
+	/**
+	 * @brief Cross product of b - a and c - a
+	 * @param a First corner
+	 * @param b Second corner
+	 * @param c Third corner
+	 * @param n Receives the unnormalized normal
+	 */
+	static void FaceNormal(const double* a, const double* b, const double* c, double* n)
+	{
+		const double e0[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		const double e1[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+		n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+		n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+		n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+	}
+
+	/**
+	 * @brief Welds triangle corners sharing an exact position into indexed vertices
+	 * @param source Mesh to weld
+	 * @param state Receives positions, corners and live flags; degenerate triangles are left out
+	 */
+	static void Weld(const Mesh& source, SimplifierState& state)
+	{
+		const int cornerCount = source.numTriangles * 3;
+
+		vector<int> order(cornerCount);
+		std::iota(order.begin(), order.end(), 0);
+
+		const auto less = [&source](const int lhs, const int rhs)
+		{
+			const Vector3& l = source.vertices[lhs];
+			const Vector3& r = source.vertices[rhs];
+
+			if (l.x != r.x) return l.x < r.x;
+			if (l.y != r.y) return l.y < r.y;
+			return l.z < r.z;
+		};
+		std::sort(order.begin(), order.end(), less);
+
+		vector<int> vertexOf(cornerCount);
+		for (int i = 0; i < cornerCount; ++i)
+		{
+			if (i == 0 || less(order[i - 1], order[i]))
+			{
+				const Vector3& p = source.vertices[order[i]];
+				state.positions.push_back(p.x);
+				state.positions.push_back(p.y);
+				state.positions.push_back(p.z);
+			}
+
+			vertexOf[order[i]] = static_cast<int>(state.positions.size() / 3) - 1;
+		}
+
+		for (int t = 0; t < source.numTriangles; ++t)
+		{
+			const int a = vertexOf[t * 3];
+			const int b = vertexOf[t * 3 + 1];
+			const int c = vertexOf[t * 3 + 2];
+
+			double n[3];
+			FaceNormal(&state.positions[a * 3], &state.positions[b * 3], &state.positions[c * 3], n);
+
+			if (a == b || b == c || c == a || (n[0] == 0.0 && n[1] == 0.0 && n[2] == 0.0))
+			{
+				continue;
+			}
+
+			state.corners.push_back(a);
+			state.corners.push_back(b);
+			state.corners.push_back(c);
+		}
+
+		const int vertexCount = static_cast<int>(state.positions.size() / 3);
+		const int triangleCount = static_cast<int>(state.corners.size() / 3);
+
+		state.quadrics.assign(vertexCount, SimplifierQuadric{});
+		state.versions.assign(vertexCount, 0);
+		state.adjacency.assign(vertexCount, {});
+		state.alive.assign(triangleCount, 1);
+
+		for (int t = 0; t < triangleCount; ++t)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				state.adjacency[state.corners[t * 3 + k]].push_back(t);
+			}
+		}
+	}
+
+	/**
+	 * @brief Accumulates every triangle's plane, and optionally every open edge's constraint plane, into the vertex quadrics
+	 * @param state Welded mesh
+	 * @param preserveBoundaries Whether open edges get weighted constraint planes
+	 */
+	static void BuildQuadrics(SimplifierState& state, const bool preserveBoundaries)
+	{
+		const int triangleCount = static_cast<int>(state.alive.size());
+
+		for (int t = 0; t < triangleCount; ++t)
+		{
+			const int* v = &state.corners[t * 3];
+			const double* p[3] = { &state.positions[v[0] * 3], &state.positions[v[1] * 3], &state.positions[v[2] * 3] };
+
+			double n[3];
+			FaceNormal(p[0], p[1], p[2], n);
+
+			const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			n[0] /= length;
+			n[1] /= length;
+			n[2] /= length;
+
+			const double d = -(n[0] * p[0][0] + n[1] * p[0][1] + n[2] * p[0][2]);
+			for (int k = 0; k < 3; ++k)
+			{
+				AddPlane(state.quadrics[v[k]], n, d, 1.0);
+			}
+
+			if (!preserveBoundaries)
+			{
+				continue;
+			}
+
+			for (int k = 0; k < 3; ++k)
+			{
+				const int from = v[k];
+				const int to = v[(k + 1) % 3];
+
+				// An edge is open when no other triangle uses both of its vertices
+				bool shared = false;
+				for (const int other : state.adjacency[from])
+				{
+					if (other == t)
+					{
+						continue;
+					}
+
+					const int* o = &state.corners[other * 3];
+					if (o[0] == to || o[1] == to || o[2] == to)
+					{
+						shared = true;
+						break;
+					}
+				}
+
+				if (shared)
+				{
+					continue;
+				}
+
+				// Plane through the edge, perpendicular to the triangle
+				const double* a = &state.positions[from * 3];
+				const double* b = &state.positions[to * 3];
+				const double edge[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+
+				double m[3] =
+				{
+					edge[1] * n[2] - edge[2] * n[1],
+					edge[2] * n[0] - edge[0] * n[2],
+					edge[0] * n[1] - edge[1] * n[0]
+				};
+
+				const double mLength = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+				m[0] /= mLength;
+				m[1] /= mLength;
+				m[2] /= mLength;
+
+				const double md = -(m[0] * a[0] + m[1] * a[1] + m[2] * a[2]);
+				AddPlane(state.quadrics[from], m, md, SIMPLIFIER_BOUNDARY_WEIGHT);
+				AddPlane(state.quadrics[to], m, md, SIMPLIFIER_BOUNDARY_WEIGHT);
+			}
+		}
+	}
+
+	/**
+	 * @brief Measures the collapse of an edge, placing the kept vertex where the combined quadric is smallest
+	 * @param state Welded mesh
+	 * @param from Vertex to remove
+	 * @param to Vertex to keep
+	 * @return Candidate collapse stamped with both vertices' current versions
+	 *
+	 * Solves the quadric's 3x3 system by Cramer's rule; when it is singular
+	 * (flat or straight neighbourhoods) the best of the two endpoints and
+	 * their midpoint is used instead.
+	 */
+	static SimplifierCollapse Measure(const SimplifierState& state, const int from, const int to)
+	{
+		SimplifierQuadric quadric;
+		for (int i = 0; i < 10; ++i)
+		{
+			quadric.q[i] = state.quadrics[from].q[i] + state.quadrics[to].q[i];
+		}
+
+		SimplifierCollapse collapse{ 0.0, from, to, state.versions[from], state.versions[to], { 0.0, 0.0, 0.0 } };
+
+		const double* q = quadric.q;
+		const double det = q[0] * (q[4] * q[7] - q[5] * q[5])
+			- q[1] * (q[1] * q[7] - q[5] * q[2])
+			+ q[2] * (q[1] * q[5] - q[4] * q[2]);
+
+		const double scale = q[0] + q[4] + q[7];
+		if (std::abs(det) > SIMPLIFIER_SINGULAR * scale * scale * scale)
+		{
+			const double bx = -q[3];
+			const double by = -q[6];
+			const double bz = -q[8];
+
+			collapse.position[0] = (bx * (q[4] * q[7] - q[5] * q[5]) - q[1] * (by * q[7] - q[5] * bz) + q[2] * (by * q[5] - q[4] * bz)) / det;
+			collapse.position[1] = (q[0] * (by * q[7] - bz * q[5]) - bx * (q[1] * q[7] - q[5] * q[2]) + q[2] * (q[1] * bz - by * q[2])) / det;
+			collapse.position[2] = (q[0] * (q[4] * bz - q[5] * by) - q[1] * (q[1] * bz - by * q[2]) + bx * (q[1] * q[5] - q[4] * q[2])) / det;
+			collapse.error = Evaluate(quadric, collapse.position);
+
+			return collapse;
+		}
+
+		const double* a = &state.positions[from * 3];
+		const double* b = &state.positions[to * 3];
+		const double mid[3] = { (a[0] + b[0]) * .5, (a[1] + b[1]) * .5, (a[2] + b[2]) * .5 };
+		const double* candidates[3] = { b, a, mid };
+
+		collapse.error = std::numeric_limits<double>::infinity();
+		for (const double* candidate : candidates)
+		{
+			const double error = Evaluate(quadric, candidate);
+			if (error < collapse.error)
+			{
+				collapse.error = error;
+				std::copy(candidate, candidate + 3, collapse.position);
+			}
+		}
+
+		return collapse;
+	}
+
+	/**
+	 * @brief Pushes a candidate collapse for every edge around a vertex
+	 * @param state Welded mesh
+	 * @param vertex Vertex whose edges changed
+	 * @param heap Queue of candidates, cheapest first
+	 */
+	static void PushEdges(const SimplifierState& state, const int vertex,
+		std::priority_queue<SimplifierCollapse, vector<SimplifierCollapse>, std::greater<>>& heap)
+	{
+		for (const int t : state.adjacency[vertex])
+		{
+			const int* v = &state.corners[t * 3];
+
+			for (int k = 0; k < 3; ++k)
+			{
+				// Each edge is met from both of its triangles; take it once per triangle in winding order
+				const int a = v[k];
+				const int b = v[(k + 1) % 3];
+
+				if (a == vertex || b == vertex)
+				{
+					heap.push(Measure(state, a == vertex ? b : a, vertex));
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Tests whether a collapse keeps the surface valid
+	 * @param state Welded mesh
+	 * @param collapse Candidate collapse
+	 * @return True if the collapse neither joins two sheets, duplicates a triangle nor flips one
+	 */
+	static bool CanCollapse(const SimplifierState& state, const SimplifierCollapse& collapse)
+	{
+		const int from = collapse.from;
+		const int to = collapse.to;
+
+		// Link condition: the endpoints may share at most the two vertices opposite the edge
+		vector<int> fromNeighbours;
+		for (const int t : state.adjacency[from])
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				const int v = state.corners[t * 3 + k];
+				if (v != from)
+				{
+					fromNeighbours.push_back(v);
+				}
+			}
+		}
+
+		std::sort(fromNeighbours.begin(), fromNeighbours.end());
+		fromNeighbours.erase(std::unique(fromNeighbours.begin(), fromNeighbours.end()), fromNeighbours.end());
+
+		vector<int> shared;
+		for (const int t : state.adjacency[to])
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				const int v = state.corners[t * 3 + k];
+				if (v != to && v != from && std::binary_search(fromNeighbours.begin(), fromNeighbours.end(), v))
+				{
+					shared.push_back(v);
+				}
+			}
+		}
+
+		std::sort(shared.begin(), shared.end());
+		if (std::unique(shared.begin(), shared.end()) - shared.begin() > 2)
+		{
+			return false;
+		}
+
+		for (const int t : state.adjacency[from])
+		{
+			const int* v = &state.corners[t * 3];
+			if (v[0] == to || v[1] == to || v[2] == to)
+			{
+				continue;
+			}
+
+			// The moved triangle must not coincide with one already around the kept vertex
+			for (const int other : state.adjacency[to])
+			{
+				const int* o = &state.corners[other * 3];
+				int matches = 0;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					matches += (v[k] != from && (o[0] == v[k] || o[1] == v[k] || o[2] == v[k])) ? 1 : 0;
+				}
+
+				if (matches == 2)
+				{
+					return false;
+				}
+			}
+		}
+
+		// Every triangle that survives must keep facing the way it did
+		for (const int vertex : { from, to })
+		{
+			for (const int t : state.adjacency[vertex])
+			{
+				const int* v = &state.corners[t * 3];
+				if ((v[0] == from || v[1] == from || v[2] == from) && (v[0] == to || v[1] == to || v[2] == to))
+				{
+					continue;
+				}
+
+				const double* before[3];
+				const double* after[3];
+				for (int k = 0; k < 3; ++k)
+				{
+					before[k] = &state.positions[v[k] * 3];
+					after[k] = v[k] == vertex ? collapse.position : before[k];
+				}
+
+				double n0[3];
+				double n1[3];
+				FaceNormal(before[0], before[1], before[2], n0);
+				FaceNormal(after[0], after[1], after[2], n1);
+
+				const double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+				const double length0 = std::sqrt(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+				const double length1 = std::sqrt(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+
+				if (length1 == 0.0 || dot < SIMPLIFIER_FLIP_COSINE * length0 * length1)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Applies a collapse, removing the triangles on the edge and moving the rest onto the kept vertex
+	 * @param state Welded mesh
+	 * @param collapse Collapse accepted by CanCollapse()
+	 * @return Number of triangles removed
+	 */
+	static int Collapse(SimplifierState& state, const SimplifierCollapse& collapse)
+	{
+		const int from = collapse.from;
+		const int to = collapse.to;
+		int removed = 0;
+
+		for (const int t : state.adjacency[from])
+		{
+			int* v = &state.corners[t * 3];
+
+			if (v[0] == to || v[1] == to || v[2] == to)
+			{
+				state.alive[t] = 0;
+				++removed;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					if (v[k] != from)
+					{
+						vector<int>& around = state.adjacency[v[k]];
+						around.erase(std::find(around.begin(), around.end(), t));
+					}
+				}
+
+				continue;
+			}
+
+			for (int k = 0; k < 3; ++k)
+			{
+				if (v[k] == from)
+				{
+					v[k] = to;
+				}
+			}
+
+			state.adjacency[to].push_back(t);
+		}
+
+		state.adjacency[from].clear();
+		std::copy(collapse.position, collapse.position + 3, &state.positions[to * 3]);
+
+		for (int i = 0; i < 10; ++i)
+		{
+			state.quadrics[to].q[i] += state.quadrics[from].q[i];
+		}
+
+		++state.versions[from];
+		++state.versions[to];
+
+		return removed;
+	}
+
+	/**
+	 * @brief Default constructor halving the triangle count with no error limit
+	 */
+	MeshSimplifier::MeshSimplifier()
+		: targetTriangles{ -1 }, maxError{ std::numeric_limits<float>::infinity() }, preserveBoundaries{ true }
+	{
+	}
+
+	/**
+	 * @brief Creates a simplifier
+	 * @param targetTriangles Stop once at most this many triangles remain (0 to rely on maxError only)
+	 * @param maxError Largest distance error accepted
+	 * @param preserveBoundaries Constrain vertices on open edges to stay on the boundary
+	 */
+	MeshSimplifier::MeshSimplifier(const int targetTriangles, const float maxError, const bool preserveBoundaries)
+		: targetTriangles{ targetTriangles }, maxError{ maxError }, preserveBoundaries{ preserveBoundaries }
+	{
+	}
+
+	/**
+	 * @brief Simplifies a mesh into new triangle storage
+	 * @param source Mesh to simplify; left untouched
+	 * @param triangles Receives the simplified triangles, which the returned mesh points into
+	 * @param mode Acceleration structure built for the returned mesh
+	 * @return Accelerated mesh over triangles
+	 *
+	 * Algorithm:
+	 * 1. Weld corners by exact position and drop degenerate triangles
+	 * 2. Accumulate plane quadrics per vertex (plus boundary constraint planes)
+	 * 3. Queue every edge's collapse by quadric error, cheapest first
+	 * 4. Pop collapses, skipping stale ones (either vertex changed since it was
+	 *    measured) and invalid ones, re-queueing the kept vertex's edges after each
+	 * 5. Write the surviving triangles out in their original winding and accelerate
+	 */
+	Mesh MeshSimplifier::Simplify(const Mesh& source, vector<Triangle>& triangles, const BvhBuildMode mode) const
+	{
+		SimplifierState state;
+		Weld(source, state);
+		BuildQuadrics(state, preserveBoundaries);
+
+		int remaining = static_cast<int>(state.alive.size());
+		const int target = targetTriangles < 0 ? source.numTriangles / 2 : targetTriangles;
+		const double errorLimit = static_cast<double>(maxError) * static_cast<double>(maxError);
+
+		std::priority_queue<SimplifierCollapse, vector<SimplifierCollapse>, std::greater<>> heap;
+		for (int v = 0; v < static_cast<int>(state.versions.size()); ++v)
+		{
+			PushEdges(state, v, heap);
+		}
+
+		while (remaining > target && !heap.empty())
+		{
+			const SimplifierCollapse collapse = heap.top();
+			heap.pop();
+
+			if (collapse.error > errorLimit)
+			{
+				break;
+			}
+
+			if (collapse.fromVersion != state.versions[collapse.from] || collapse.toVersion != state.versions[collapse.to]
+				|| state.adjacency[collapse.from].empty() || !CanCollapse(state, collapse))
+			{
+				continue;
+			}
+
+			remaining -= Collapse(state, collapse);
+			PushEdges(state, collapse.to, heap);
+		}
+
+		triangles.clear();
+		triangles.reserve(remaining);
+
+		for (int t = 0; t < static_cast<int>(state.alive.size()); ++t)
+		{
+			if (!state.alive[t])
+			{
+				continue;
+			}
+
+			Vector3 corners[3];
+			for (int k = 0; k < 3; ++k)
+			{
+				const double* p = &state.positions[state.corners[t * 3 + k] * 3];
+				corners[k] = { static_cast<float>(p[0]), static_cast<float>(p[1]), static_cast<float>(p[2]) };
+			}
+
+			triangles.emplace_back(corners[0], corners[1], corners[2]);
+		}
+
+		Mesh mesh;
+		mesh.numTriangles = static_cast<int>(triangles.size());
+		mesh.triangles = triangles.data();
+		mesh.Accelerate(mode);
+
+		return mesh;
+	}
+}
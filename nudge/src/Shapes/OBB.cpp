@@ -80,7 +80,7 @@ namespace Nudge
 
 		const float dist = Vector3::Dot(other.normal, origin);
 
-		return MathF::Abs(dist) <= pLen;
+		return MathF::Abs(dist - other.distance) <= pLen;
 	}
 
 	bool Obb::Intersects(const Sphere& other) const
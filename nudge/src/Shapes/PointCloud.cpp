@@ -0,0 +1,632 @@
+#include "Nudge/Shapes/PointCloud.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+
+using std::atomic;
+
+// Stack capacity for tree walks: a depth-first walk holds at most one
+// pending sibling per level, and a tree over 2^31 points has fewer than 32
+constexpr int POINT_CLOUD_STACK_SIZE = 64;
+
+// Queries handed to a batch worker at a time
+constexpr int POINT_CLOUD_BATCH_BLOCK = 64;
+
+// Nodes of one tree level split per parallel task during a build
+constexpr int POINT_CLOUD_BUILD_BATCH = 4;
+
+namespace Nudge
+{
+	/**
+	 * @brief Squared distance from a position to a node's bounds
+	 * @param node Node to measure
+	 * @param point Query position
+	 * @return Zero inside the bounds, infinity for a node with no points
+	 */
+	static float DistanceSquared(const PointCloudNode& node, const Vector3& point)
+	{
+		if (node.begin >= node.end)
+		{
+			return std::numeric_limits<float>::infinity();
+		}
+
+		const float dx = std::max(std::max(node.min.x - point.x, point.x - node.max.x), 0.f);
+		const float dy = std::max(std::max(node.min.y - point.y, point.y - node.max.y), 0.f);
+		const float dz = std::max(std::max(node.min.z - point.z, point.z - node.max.z), 0.f);
+
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	/**
+	 * @brief Squared distance from a position to the closest point of a segment
+	 * @param ray Prepared ray giving the segment's start and direction
+	 * @param x Position x
+	 * @param y Position y
+	 * @param z Position z
+	 * @return Squared distance
+	 */
+	static float DistanceSquared(const PreparedRay& ray, const float x, const float y, const float z)
+	{
+		const float* d = ray.direction;
+		const float ox = x - ray.origin[0];
+		const float oy = y - ray.origin[1];
+		const float oz = z - ray.origin[2];
+
+		const float length = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+		const float along = length > 0.f ? std::clamp((ox * d[0] + oy * d[1] + oz * d[2]) / length, 0.f, ray.maxDistance) : 0.f;
+
+		const float ex = ox - d[0] * along;
+		const float ey = oy - d[1] * along;
+		const float ez = oz - d[2] * along;
+
+		return ex * ex + ey * ey + ez * ez;
+	}
+
+	/**
+	 * @brief Restores the max-heap order of a neighbour list after its root was replaced
+	 * @param neighbours Input indices, heap-ordered on distances
+	 * @param distances Squared distances, largest at the root
+	 * @param count Number of entries in the heap
+	 */
+	static void SiftDown(const span<int> neighbours, const span<float> distances, const int count)
+	{
+		int parent = 0;
+
+		while (true)
+		{
+			const int left = parent * 2 + 1;
+			if (left >= count)
+			{
+				return;
+			}
+
+			const int right = left + 1;
+			const int child = right < count && distances[right] > distances[left] ? right : left;
+			if (distances[child] <= distances[parent])
+			{
+				return;
+			}
+
+			std::swap(distances[child], distances[parent]);
+			std::swap(neighbours[child], neighbours[parent]);
+			parent = child;
+		}
+	}
+
+	/**
+	 * @brief Restores the max-heap order of a neighbour list after an entry was appended
+	 * @param neighbours Input indices, heap-ordered on distances
+	 * @param distances Squared distances, largest at the root
+	 * @param last Slot of the appended entry
+	 */
+	static void SiftUp(const span<int> neighbours, const span<float> distances, int last)
+	{
+		while (last > 0)
+		{
+			const int parent = (last - 1) / 2;
+			if (distances[parent] >= distances[last])
+			{
+				return;
+			}
+
+			std::swap(distances[parent], distances[last]);
+			std::swap(neighbours[parent], neighbours[last]);
+			last = parent;
+		}
+	}
+
+	/**
+	 * @brief Walks the tree depth first, skipping the subtrees a query rejects
+	 * @param cloud Cloud to walk
+	 * @param enters Called with a node; returns false to skip its subtree
+	 * @param visit Called with each slot of the leaves reached; returns true to stop the walk
+	 * @return Input index of the slot the walk stopped at, or -1 if it ran to completion
+	 */
+	template <typename Enters, typename Visit>
+	static int WalkPoints(const PointCloud& cloud, Enters&& enters, Visit&& visit)
+	{
+		if (cloud.IsEmpty())
+		{
+			return -1;
+		}
+
+		const int count = static_cast<int>(cloud.nodes.size());
+		int stack[POINT_CLOUD_STACK_SIZE];
+		int top = 0;
+		stack[top++] = 0;
+
+		while (top > 0)
+		{
+			const int index = stack[--top];
+			const PointCloudNode& node = cloud.nodes[index];
+
+			if (node.begin >= node.end || !enters(node))
+			{
+				continue;
+			}
+
+			if (index * 2 + 1 < count)
+			{
+				stack[top++] = index * 2 + 2;
+				stack[top++] = index * 2 + 1;
+				continue;
+			}
+
+			for (int slot = node.begin; slot < node.end; ++slot)
+			{
+				if (visit(slot))
+				{
+					return cloud.indices[slot];
+				}
+			}
+		}
+
+		return -1;
+	}
+
+	/**
+	 * @brief Default constructor creating a node with no points
+	 */
+	PointCloudNode::PointCloudNode()
+		: min{ 0.f }, max{ 0.f }, begin{ 0 }, end{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Default constructor creating an empty cloud
+	 */
+	PointCloud::PointCloud() = default;
+
+	/**
+	 * @brief Creates a cloud over a set of points
+	 * @param points Points to index
+	 */
+	PointCloud::PointCloud(const span<const Vector3> points)
+	{
+		Build(points);
+	}
+
+	/**
+	 * @brief Rebuilds the tree over a set of points
+	 * @param points Points to index
+	 */
+	void PointCloud::Build(const span<const Vector3> points)
+	{
+		const int count = static_cast<int>(points.size());
+
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+		indices.resize(count);
+		nodes.clear();
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		// Shallowest complete tree whose leaves hold at most POINT_CLOUD_LEAF_SIZE points each
+		int depth = 0;
+		while ((static_cast<long long>(POINT_CLOUD_LEAF_SIZE) << depth) < count)
+		{
+			++depth;
+		}
+
+		nodes.resize((static_cast<size_t>(2) << depth) - 1);
+		nodes[0].begin = 0;
+		nodes[0].end = count;
+
+		// Slots hold input indices until the final gather
+		std::iota(indices.begin(), indices.end(), 0);
+
+		for (int level = 0; level <= depth; ++level)
+		{
+			const int levelStart = (1 << level) - 1;
+
+			Parallel::For(1 << level, POINT_CLOUD_BUILD_BATCH, [&](const int, const int begin, const int end)
+			{
+				for (int index = levelStart + begin; index < levelStart + end; ++index)
+				{
+					PointCloudNode& node = nodes[index];
+
+					if (node.begin < node.end)
+					{
+						Vector3 low = points[indices[node.begin]];
+						Vector3 high = low;
+
+						for (int slot = node.begin + 1; slot < node.end; ++slot)
+						{
+							const Vector3& point = points[indices[slot]];
+							low.x = std::min(low.x, point.x);
+							low.y = std::min(low.y, point.y);
+							low.z = std::min(low.z, point.z);
+							high.x = std::max(high.x, point.x);
+							high.y = std::max(high.y, point.y);
+							high.z = std::max(high.z, point.z);
+						}
+
+						node.min = low;
+						node.max = high;
+					}
+
+					if (level == depth)
+					{
+						continue;
+					}
+
+					const Vector3 size = node.max - node.min;
+					const auto first = indices.begin() + node.begin;
+					const auto middle = indices.begin() + node.begin + (node.end - node.begin + 1) / 2;
+					const auto last = indices.begin() + node.end;
+
+					if (size.x >= size.y && size.x >= size.z)
+					{
+						std::nth_element(first, middle, last, [&](const int lhs, const int rhs) { return points[lhs].x < points[rhs].x; });
+					}
+					else if (size.y >= size.z)
+					{
+						std::nth_element(first, middle, last, [&](const int lhs, const int rhs) { return points[lhs].y < points[rhs].y; });
+					}
+					else
+					{
+						std::nth_element(first, middle, last, [&](const int lhs, const int rhs) { return points[lhs].z < points[rhs].z; });
+					}
+
+					const int split = static_cast<int>(middle - indices.begin());
+					nodes[index * 2 + 1].begin = node.begin;
+					nodes[index * 2 + 1].end = split;
+					nodes[index * 2 + 2].begin = split;
+					nodes[index * 2 + 2].end = node.end;
+				}
+			});
+		}
+
+		for (int slot = 0; slot < count; ++slot)
+		{
+			const Vector3& point = points[indices[slot]];
+			x[slot] = point.x;
+			y[slot] = point.y;
+			z[slot] = point.z;
+		}
+	}
+
+	/**
+	 * @brief Number of points in the cloud
+	 * @return Point count
+	 */
+	int PointCloud::Count() const
+	{
+		return static_cast<int>(indices.size());
+	}
+
+	/**
+	 * @brief Tests whether the cloud has any points
+	 * @return True if the cloud is empty
+	 */
+	bool PointCloud::IsEmpty() const
+	{
+		return nodes.empty();
+	}
+
+	/**
+	 * @brief Finds the points closest to a position
+	 * @param point Query position
+	 * @param neighbours Receives input indices, nearest first; its size is the number of neighbours wanted
+	 * @param distances Receives the distance to each neighbour (at least as large as neighbours)
+	 * @param maxDistance Points farther than this are ignored
+	 * @return Number of neighbours written, less than requested only if the cloud runs out of points in range
+	 */
+	int PointCloud::Nearest(const Vector3& point, const span<int> neighbours, const span<float> distances, const float maxDistance) const
+	{
+		const int wanted = static_cast<int>(std::min(neighbours.size(), distances.size()));
+		if (wanted <= 0 || IsEmpty())
+		{
+			return 0;
+		}
+
+		// The outputs double as a max-heap of squared distances while searching
+		const float limit = maxDistance * maxDistance;
+		int found = 0;
+
+		struct Pending
+		{
+			int node;
+			float distance;
+		};
+
+		Pending stack[POINT_CLOUD_STACK_SIZE];
+		int top = 0;
+		stack[top++] = { 0, DistanceSquared(nodes[0], point) };
+
+		const int count = static_cast<int>(nodes.size());
+
+		while (top > 0)
+		{
+			const Pending pending = stack[--top];
+			const float worst = found == wanted ? distances[0] : limit;
+
+			if (!(pending.distance <= worst) || (found == wanted && pending.distance == worst))
+			{
+				continue;
+			}
+
+			const PointCloudNode& node = nodes[pending.node];
+
+			if (pending.node * 2 + 1 < count)
+			{
+				const int left = pending.node * 2 + 1;
+				const float leftDistance = DistanceSquared(nodes[left], point);
+				const float rightDistance = DistanceSquared(nodes[left + 1], point);
+
+				// Push the farther child first so the nearer one is searched first
+				if (leftDistance <= rightDistance)
+				{
+					stack[top++] = { left + 1, rightDistance };
+					stack[top++] = { left, leftDistance };
+				}
+				else
+				{
+					stack[top++] = { left, leftDistance };
+					stack[top++] = { left + 1, rightDistance };
+				}
+
+				continue;
+			}
+
+			for (int slot = node.begin; slot < node.end; ++slot)
+			{
+				const float dx = x[slot] - point.x;
+				const float dy = y[slot] - point.y;
+				const float dz = z[slot] - point.z;
+				const float distance = dx * dx + dy * dy + dz * dz;
+
+				if (found < wanted)
+				{
+					if (distance <= limit)
+					{
+						neighbours[found] = indices[slot];
+						distances[found] = distance;
+						SiftUp(neighbours, distances, found++);
+					}
+				}
+				else if (distance < distances[0])
+				{
+					neighbours[0] = indices[slot];
+					distances[0] = distance;
+					SiftDown(neighbours, distances, found);
+				}
+			}
+		}
+
+		// Unwind the heap into ascending order, converting to distances
+		for (int last = found - 1; last > 0; --last)
+		{
+			std::swap(distances[0], distances[last]);
+			std::swap(neighbours[0], neighbours[last]);
+			SiftDown(neighbours, distances, last);
+		}
+
+		for (int i = 0; i < found; ++i)
+		{
+			distances[i] = std::sqrt(distances[i]);
+		}
+
+		return found;
+	}
+
+	/**
+	 * @brief Finds the k nearest points of many positions in parallel
+	 * @param points Query positions
+	 * @param k Neighbours per position
+	 * @param neighbours Receives k input indices per position, nearest first, -1 past the last found
+	 * @param distances Receives k distances per position, -1 past the last found
+	 * @return Total number of neighbours found
+	 */
+	int PointCloud::NearestBatch(const span<const Vector3> points, const int k, const span<int> neighbours, const span<float> distances) const
+	{
+		if (k <= 0)
+		{
+			return 0;
+		}
+
+		const int count = static_cast<int>(std::min(points.size(), std::min(neighbours.size(), distances.size()) / k));
+		if (count <= 0)
+		{
+			return 0;
+		}
+
+		const int workers = std::min(Parallel::WorkerCount(), (count + POINT_CLOUD_BATCH_BLOCK - 1) / POINT_CLOUD_BATCH_BLOCK);
+
+		atomic<int> next{ 0 };
+		atomic<int> total{ 0 };
+
+		Parallel::For(workers, 1, [&](const int, const int, const int)
+		{
+			int found = 0;
+
+			for (int begin = next.fetch_add(POINT_CLOUD_BATCH_BLOCK); begin < count; begin = next.fetch_add(POINT_CLOUD_BATCH_BLOCK))
+			{
+				const int end = std::min(begin + POINT_CLOUD_BATCH_BLOCK, count);
+
+				for (int i = begin; i < end; ++i)
+				{
+					const span<int> row = neighbours.subspan(static_cast<size_t>(i) * k, k);
+					const span<float> rowDistances = distances.subspan(static_cast<size_t>(i) * k, k);
+					const int written = Nearest(points[i], row, rowDistances);
+
+					std::fill(row.begin() + written, row.end(), -1);
+					std::fill(rowDistances.begin() + written, rowDistances.end(), -1.f);
+					found += written;
+				}
+			}
+
+			total += found;
+		});
+
+		return total;
+	}
+
+	/**
+	 * @brief Visits the points inside a sphere
+	 * @param region Sphere to query
+	 * @param visit Called with each input index; returns true to stop the query
+	 * @return Input index the query stopped at, or -1 if every point was visited
+	 */
+	int PointCloud::Query(const Sphere& region, const function<bool(int)>& visit) const
+	{
+		const Vector3 center = region.origin;
+		const float limit = region.radius * region.radius;
+
+		return WalkPoints(*this, [&](const PointCloudNode& node)
+		{
+			return DistanceSquared(node, center) <= limit;
+		},
+		[&](const int slot)
+		{
+			const float dx = x[slot] - center.x;
+			const float dy = y[slot] - center.y;
+			const float dz = z[slot] - center.z;
+
+			return dx * dx + dy * dy + dz * dz <= limit && visit(indices[slot]);
+		});
+	}
+
+	/**
+	 * @brief Visits the points inside a box
+	 * @param region Box to query
+	 * @param visit Called with each input index; returns true to stop the query
+	 * @return Input index the query stopped at, or -1 if every point was visited
+	 */
+	int PointCloud::Query(const Aabb& region, const function<bool(int)>& visit) const
+	{
+		const Vector3 min = region.Min();
+		const Vector3 max = region.Max();
+
+		return WalkPoints(*this, [&](const PointCloudNode& node)
+		{
+			return node.min.x <= max.x && node.max.x >= min.x
+				&& node.min.y <= max.y && node.max.y >= min.y
+				&& node.min.z <= max.z && node.max.z >= min.z;
+		},
+		[&](const int slot)
+		{
+			return x[slot] >= min.x && x[slot] <= max.x
+				&& y[slot] >= min.y && y[slot] <= max.y
+				&& z[slot] >= min.z && z[slot] <= max.z
+				&& visit(indices[slot]);
+		});
+	}
+
+	/**
+	 * @brief Finds the point closest to a ray
+	 * @param ray Ray to test
+	 * @param distance Receives the distance from the point to the ray (unchanged if the cloud is empty)
+	 * @param maxDistance Length of the ray; points are measured against the segment it spans
+	 * @return Input index of the closest point, or -1 if the cloud is empty
+	 */
+	int PointCloud::NearestToRay(const Ray& ray, float& distance, const float maxDistance) const
+	{
+		if (IsEmpty())
+		{
+			return -1;
+		}
+
+		const PreparedRay prepared{ ray, maxDistance };
+		const int count = static_cast<int>(nodes.size());
+		float best = std::numeric_limits<float>::infinity();
+		float bestSquared = best;
+		int nearest = -1;
+
+		int stack[POINT_CLOUD_STACK_SIZE];
+		int top = 0;
+		stack[top++] = 0;
+
+		while (top > 0)
+		{
+			const int index = stack[--top];
+			const PointCloudNode& node = nodes[index];
+
+			// A point within best of the segment lies in the bounds grown by best
+			const Vector3 grow{ best };
+			if (node.begin >= node.end || (nearest >= 0 && prepared.Enter(node.min - grow, node.max + grow) < 0.f))
+			{
+				continue;
+			}
+
+			if (index * 2 + 1 < count)
+			{
+				// Search first the child whose center lies closer to the ray
+				const PointCloudNode& left = nodes[index * 2 + 1];
+				const PointCloudNode& right = nodes[index * 2 + 2];
+				const Vector3 leftCenter = (left.min + left.max) * .5f;
+				const Vector3 rightCenter = (right.min + right.max) * .5f;
+				const bool leftFirst = right.begin >= right.end
+					|| DistanceSquared(prepared, leftCenter.x, leftCenter.y, leftCenter.z) <= DistanceSquared(prepared, rightCenter.x, rightCenter.y, rightCenter.z);
+
+				stack[top++] = leftFirst ? index * 2 + 2 : index * 2 + 1;
+				stack[top++] = leftFirst ? index * 2 + 1 : index * 2 + 2;
+				continue;
+			}
+
+			for (int slot = node.begin; slot < node.end; ++slot)
+			{
+				const float squared = DistanceSquared(prepared, x[slot], y[slot], z[slot]);
+				if (squared < bestSquared)
+				{
+					bestSquared = squared;
+					nearest = indices[slot];
+				}
+			}
+
+			best = std::sqrt(bestSquared);
+		}
+
+		distance = best;
+
+		return nearest;
+	}
+
+	/**
+	 * @brief Finds the point closest to each of many rays in parallel
+	 * @param rays Rays to test
+	 * @param nearest Receives the input index of the closest point per ray, -1 if the cloud is empty
+	 * @param distances Receives the distance from that point to the ray
+	 * @param maxDistance Length of every ray
+	 * @return Number of rays processed, min(rays.size(), nearest.size(), distances.size())
+	 */
+	int PointCloud::NearestToRayBatch(const span<const Ray> rays, const span<int> nearest, const span<float> distances, const float maxDistance) const
+	{
+		const int count = static_cast<int>(std::min(rays.size(), std::min(nearest.size(), distances.size())));
+		if (count <= 0)
+		{
+			return 0;
+		}
+
+		const int workers = std::min(Parallel::WorkerCount(), (count + POINT_CLOUD_BATCH_BLOCK - 1) / POINT_CLOUD_BATCH_BLOCK);
+		atomic<int> next{ 0 };
+
+		Parallel::For(workers, 1, [&](const int, const int, const int)
+		{
+			for (int begin = next.fetch_add(POINT_CLOUD_BATCH_BLOCK); begin < count; begin = next.fetch_add(POINT_CLOUD_BATCH_BLOCK))
+			{
+				const int end = std::min(begin + POINT_CLOUD_BATCH_BLOCK, count);
+
+				for (int i = begin; i < end; ++i)
+				{
+					distances[i] = -1.f;
+					nearest[i] = NearestToRay(rays[i], distances[i], maxDistance);
+				}
+			}
+		});
+
+		return count;
+	}
+}
@@ -0,0 +1,179 @@
+#include "Nudge/Shapes/PreparedRay.hpp"
+
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/LinearBvh.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+
+#include <cmath>
+
+namespace Nudge
+{
+	/**
+	 * @brief Fills the reciprocal direction and sign bits from the direction
+	 * @param ray Prepared ray whose direction is set
+	 */
+	static void PrepareDirection(PreparedRay& ray)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			ray.inverseDirection[axis] = 1.f / ray.direction[axis];
+			ray.sign[axis] = std::signbit(ray.inverseDirection[axis]) ? 1 : 0;
+		}
+	}
+
+	/**
+	 * @brief Prepares a segment from start to end
+	 * @param start First endpoint
+	 * @param end Second endpoint
+	 * @return Prepared ray with direction end - start and a maximum distance of 1
+	 */
+	PreparedRay PreparedRay::FromSegment(const Vector3& start, const Vector3& end)
+	{
+		PreparedRay result;
+		result.origin[0] = start.x;
+		result.origin[1] = start.y;
+		result.origin[2] = start.z;
+		result.direction[0] = end.x - start.x;
+		result.direction[1] = end.y - start.y;
+		result.direction[2] = end.z - start.z;
+		result.maxDistance = 1.f;
+		PrepareDirection(result);
+
+		return result;
+	}
+
+	/**
+	 * @brief Default constructor creating a ray at the origin along positive Z
+	 */
+	PreparedRay::PreparedRay()
+		: origin{ 0.f, 0.f, 0.f }, direction{ 0.f, 0.f, 1.f }, inverseDirection{}, sign{}, maxDistance{ std::numeric_limits<float>::infinity() }
+	{
+		PrepareDirection(*this);
+	}
+
+	/**
+	 * @brief Prepares a ray
+	 * @param ray Ray to prepare
+	 * @param maxDistance Boxes entered beyond this distance are missed
+	 */
+	PreparedRay::PreparedRay(const Ray& ray, const float maxDistance)
+		: origin{ ray.origin.x, ray.origin.y, ray.origin.z }, direction{ ray.direction.x, ray.direction.y, ray.direction.z },
+		  inverseDirection{}, sign{}, maxDistance{ maxDistance }
+	{
+		PrepareDirection(*this);
+	}
+
+	/**
+	 * @brief Computes where the ray's line enters and leaves a box
+	 * @param min Minimum corner of the box
+	 * @param max Maximum corner of the box
+	 * @param enter Receives the distance at which the line enters the box
+	 * @param exit Receives the distance at which the line leaves the box
+	 * @return True if the line passes through the box
+	 *
+	 * Algorithm (Williams et al., "An Efficient and Robust Ray-Box Intersection Algorithm"):
+	 * 1. For each axis, the sign bit selects the slab plane crossed first
+	 * 2. The line is inside the box between the latest entry and the earliest exit
+	 *
+	 * A zero direction component with the origin on a slab plane gives
+	 * 0 * infinity = NaN; the comparisons are ordered so NaN never replaces
+	 * the running interval, leaving that axis unconstrained.
+	 */
+	bool PreparedRay::Clip(const Vector3& min, const Vector3& max, float& enter, float& exit) const
+	{
+		const float bounds[2][3] = { { min.x, min.y, min.z }, { max.x, max.y, max.z } };
+
+		enter = -std::numeric_limits<float>::infinity();
+		exit = std::numeric_limits<float>::infinity();
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float near = (bounds[sign[axis]][axis] - origin[axis]) * inverseDirection[axis];
+			const float far = (bounds[1 - sign[axis]][axis] - origin[axis]) * inverseDirection[axis];
+
+			enter = near > enter ? near : enter;
+			exit = far < exit ? far : exit;
+		}
+
+		return enter <= exit;
+	}
+
+	/**
+	 * @brief Slab test against a box given by its corners
+	 * @param min Minimum corner of the box
+	 * @param max Maximum corner of the box
+	 * @return Distance at which the ray enters the box (0 if it starts inside), or -1 if it misses
+	 */
+	float PreparedRay::Enter(const Vector3& min, const Vector3& max) const
+	{
+		const float bounds[2][3] = { { min.x, min.y, min.z }, { max.x, max.y, max.z } };
+
+		float enter = 0.f;
+		float exit = maxDistance;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float near = (bounds[sign[axis]][axis] - origin[axis]) * inverseDirection[axis];
+			const float far = (bounds[1 - sign[axis]][axis] - origin[axis]) * inverseDirection[axis];
+
+			enter = near > enter ? near : enter;
+			exit = far < exit ? far : exit;
+		}
+
+		return enter <= exit * BVH_SLAB_TOLERANCE ? enter : -1.f;
+	}
+
+	/**
+	 * @brief Slab test against an axis-aligned box
+	 * @param box Box to test
+	 * @return Distance at which the ray enters the box (0 if it starts inside), or -1 if it misses
+	 */
+	float PreparedRay::Enter(const Aabb& box) const
+	{
+		float entry;
+		Enter(&box, 1, &entry);
+
+		return entry;
+	}
+
+	/**
+	 * @brief Slab test against many boxes
+	 * @param boxes Boxes to test
+	 * @param count Number of boxes
+	 * @param entries Receives each box's entry distance, or -1 where it is missed
+	 * @return Number of boxes hit
+	 *
+	 * Same test as Enter(min, max), with the corners selected arithmetically
+	 * so the loop over boxes has no branches.
+	 */
+	int PreparedRay::Enter(const Aabb* boxes, const int count, float* entries) const
+	{
+		int hits = 0;
+
+		for (int i = 0; i < count; ++i)
+		{
+			const float center[3] = { boxes[i].origin.x, boxes[i].origin.y, boxes[i].origin.z };
+			const float extents[3] = { boxes[i].extents.x, boxes[i].extents.y, boxes[i].extents.z };
+
+			float enter = 0.f;
+			float exit = maxDistance;
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				// A negative direction enters through the upper plane
+				const float half = sign[axis] != 0 ? -extents[axis] : extents[axis];
+				const float near = (center[axis] - half - origin[axis]) * inverseDirection[axis];
+				const float far = (center[axis] + half - origin[axis]) * inverseDirection[axis];
+
+				enter = near > enter ? near : enter;
+				exit = far < exit ? far : exit;
+			}
+
+			const bool hit = enter <= exit * BVH_SLAB_TOLERANCE;
+			entries[i] = hit ? enter : -1.f;
+			hits += hit;
+		}
+
+		return hits;
+	}
+}
@@ -0,0 +1,33 @@
+#include "Nudge/Shapes/QueryCoherence.hpp"
+
+namespace Nudge
+{
+	/**
+	 * @brief Default constructor creating an empty hint with zeroed counters
+	 */
+	QueryCoherence::QueryCoherence()
+		: triangle{ -1 }, hits{ 0 }, misses{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Fraction of queries answered or bounded by the remembered triangle
+	 * @return hits / (hits + misses), or 0 before the first query
+	 */
+	float QueryCoherence::HitRate() const
+	{
+		const uint64_t total = hits + misses;
+
+		return total > 0 ? static_cast<float>(static_cast<double>(hits) / static_cast<double>(total)) : 0.f;
+	}
+
+	/**
+	 * @brief Forgets the remembered triangle and zeroes the counters
+	 */
+	void QueryCoherence::Reset()
+	{
+		triangle = -1;
+		hits = 0;
+		misses = 0;
+	}
+}
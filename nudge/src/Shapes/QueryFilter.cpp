@@ -0,0 +1,52 @@
+#include "Nudge/Shapes/QueryFilter.hpp"
+
+#include "Nudge/Shapes/Mesh.hpp"
+
+#include <utility>
+
+namespace Nudge
+{
+	/**
+	 * @brief Default constructor creating a filter that passes every triangle
+	 */
+	QueryFilter::QueryFilter()
+		: mask{ QUERY_FILTER_ALL }
+	{
+	}
+
+	/**
+	 * @brief Creates a filter from a mask and an optional callback
+	 * @param mask Flags a triangle needs at least one of
+	 * @param accept Called with each triangle index passing the mask; false skips the triangle
+	 */
+	QueryFilter::QueryFilter(const uint32_t mask, function<bool(int)> accept)
+		: mask{ mask }, accept{ std::move(accept) }
+	{
+	}
+
+	/**
+	 * @brief Tests whether a subtree with the given aggregated flags may hold a passing triangle
+	 * @param flags Bitwise OR of the flags of every triangle in the subtree
+	 * @return True if the subtree must be visited
+	 */
+	bool QueryFilter::Matches(const uint32_t flags) const
+	{
+		return (flags & mask) != 0;
+	}
+
+	/**
+	 * @brief Tests whether one triangle of a mesh passes the filter
+	 * @param mesh Mesh owning the triangle
+	 * @param triangle Triangle index
+	 * @return True if queries may report the triangle
+	 */
+	bool QueryFilter::Accepts(const Mesh& mesh, const int triangle) const
+	{
+		if (mesh.flags != nullptr && !Matches(mesh.flags[triangle]))
+		{
+			return false;
+		}
+
+		return !accept || accept(triangle);
+	}
+}
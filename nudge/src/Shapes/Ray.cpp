@@ -1,20 +1,151 @@
 #include "Nudge/Shapes/Ray.hpp"
 
+#include "Nudge/Core/Parallel.hpp"
 #include "Nudge/Maths/MathF.hpp"
 #include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Compound.hpp"
+#include "Nudge/Shapes/Heightfield.hpp"
 #include "Nudge/Shapes/Mesh.hpp"
 #include "Nudge/Shapes/OBB.hpp"
 #include "Nudge/Shapes/Plane.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/QueryCoherence.hpp"
+#include "Nudge/Shapes/QueryFilter.hpp"
+#include "Nudge/Shapes/Shape.hpp"
 #include "Nudge/Shapes/Sphere.hpp"
 #include "Nudge/Shapes/Triangle.hpp"
+#include "Nudge/Shapes/TriangleCache.hpp"
 
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
-using std::list;
+using std::atomic;
 using std::numeric_limits;
+using std::vector;
+
+// Traversal stack capacity. A Morton-built hierarchy is at most key bits plus
+// 32 duplicate-disambiguation bits deep, and each level pushes one extra entry.
+constexpr int BVH_STACK_SIZE = 128;
+
+// A wide hierarchy is never deeper than its binary source, and each level
+// pushes up to WIDE_BVH_WIDTH - 1 extra entries.
+constexpr int WIDE_BVH_STACK_SIZE = BVH_STACK_SIZE * (WIDE_BVH_WIDTH - 1);
+
+// Rays handed to a batch worker at a time. Small enough to balance load when
+// ray costs vary widely, large enough to keep the shared counter uncontended.
+constexpr int RAY_BATCH_BLOCK = 256;
 
 namespace Nudge
 {
+	/**
+	 * @brief Casts a ray against one triangle of a mesh
+	 * @param ray Ray to test
+	 * @param mesh Mesh owning the triangle
+	 * @param index Triangle index
+	 * @return Distance to the hit, or -1 if no intersection
+	 *
+	 * Reads the mesh's precomputed triangle data when it has been built.
+	 */
+	static float CastTriangle(const Ray& ray, const Mesh& mesh, const int index)
+	{
+		if (mesh.cache != nullptr)
+		{
+			return mesh.cache->CastRay(index, ray.origin, ray.direction);
+		}
+
+		return ray.CastAgainst(mesh.triangles[index]);
+	}
+
+	/**
+	 * @brief Spreads the low 10 bits of a value so there are two zero bits between each
+	 * @param value Value to expand
+	 * @return Expanded value, ready to be interleaved into a 3D Morton code
+	 */
+	static uint32_t ExpandBits10(uint32_t value)
+	{
+		value &= 0x3FF;
+		value = (value | (value << 16)) & 0x030000FF;
+		value = (value | (value << 8)) & 0x0300F00F;
+		value = (value | (value << 4)) & 0x030C30C3;
+		value = (value | (value << 2)) & 0x09249249;
+
+		return value;
+	}
+
+	/**
+	 * @brief Computes an order for tracing rays that keeps similar rays together
+	 * @param rays Rays to order
+	 * @param count Number of rays
+	 * @param order Receives ray indices in tracing order
+	 *
+	 * Rays are keyed by direction octant, then by the Morton code of their origin
+	 * within the batch's bounds (5 bits per axis), then by the Morton code of their
+	 * direction (4 bits per axis). Rays with equal keys keep their input order.
+	 */
+	static void CoherentOrder(const Ray* rays, const int count, vector<int>& order)
+	{
+		float min[3] = { rays[0].origin.x, rays[0].origin.y, rays[0].origin.z };
+		float max[3] = { min[0], min[1], min[2] };
+
+		for (int i = 1; i < count; ++i)
+		{
+			const float origin[3] = { rays[i].origin.x, rays[i].origin.y, rays[i].origin.z };
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				min[axis] = std::min(min[axis], origin[axis]);
+				max[axis] = std::max(max[axis], origin[axis]);
+			}
+		}
+
+		float scale[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			scale[axis] = max[axis] > min[axis] ? 31.999f / (max[axis] - min[axis]) : 0.f;
+		}
+
+		// Key in the high half, ray index in the low half, so one sort orders both
+		vector<uint64_t> keys(count);
+
+		Parallel::For(count, 4096, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				const float origin[3] = { rays[i].origin.x, rays[i].origin.y, rays[i].origin.z };
+				const float direction[3] = { rays[i].direction.x, rays[i].direction.y, rays[i].direction.z };
+
+				uint32_t octant = 0;
+				uint32_t cell[3];
+				uint32_t heading[3];
+
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					octant |= (direction[axis] < 0.f ? 1u : 0u) << axis;
+					cell[axis] = static_cast<uint32_t>(std::clamp((origin[axis] - min[axis]) * scale[axis], 0.f, 31.f));
+					heading[axis] = static_cast<uint32_t>(std::clamp((direction[axis] + 1.f) * 7.999f, 0.f, 15.f));
+				}
+
+				const uint32_t cellCode = ExpandBits10(cell[0]) | ExpandBits10(cell[1]) << 1 | ExpandBits10(cell[2]) << 2;
+				const uint32_t headingCode = ExpandBits10(heading[0]) | ExpandBits10(heading[1]) << 1 | ExpandBits10(heading[2]) << 2;
+				const uint32_t key = octant << 27 | cellCode << 12 | headingCode;
+
+				keys[i] = static_cast<uint64_t>(key) << 32 | static_cast<uint32_t>(i);
+			}
+		});
+
+		std::sort(keys.begin(), keys.end());
+
+		order.resize(count);
+		for (int i = 0; i < count; ++i)
+		{
+			order[i] = static_cast<int>(keys[i] & 0xFFFFFFFF);
+		}
+	}
+
 	/**
 	 * @brief Creates a ray from two points
 	 * @param from Starting point of the ray
@@ -86,112 +217,498 @@ namespace Nudge
 	/**
 	 * @brief Performs ray-AABB intersection using the slab method
 	 * @param other AABB to test intersection against
-	 * @return Distance to intersection point, or -1 if no intersection
+	 * @return Distance to intersection point (0 if the origin is inside), or -1 if no intersection
+	 *
+	 * Prepares the ray for this one test; code testing many boxes against the
+	 * same ray should keep a PreparedRay instead.
 	 */
 	float Ray::CastAgainst(const Aabb& other) const
 	{
-		// Get AABB bounds
-		const Vector3 min = other.Min();
-		const Vector3 max = other.Max();
+		return PreparedRay(*this).Enter(other);
+	}
+
+	/**
+	 * @brief Collects the nearest hit of a mesh traversal
+	 */
+	class NearestHit
+	{
+	public:
+		float distance = numeric_limits<float>::infinity();
+		int triangle = -1;
+
+	public:
+		/**
+		 * @brief Distance beyond which nodes and hits can be skipped
+		 * @return Nearest hit distance so far
+		 */
+		float Bound() const
+		{
+			return distance;
+		}
 
-		// Initialize intersection parameter range
-		float tMin = 0.f;                               // Near intersection distance
-		float tMax = numeric_limits<float>::infinity(); // Far intersection distance
+		/**
+		 * @brief Records a triangle test result
+		 * @param index Index of the tested triangle
+		 * @param t Hit distance, negative for a miss
+		 */
+		void Add(const int index, const float t)
+		{
+			if (t >= 0.f && t < distance)
+			{
+				distance = t;
+				triangle = index;
+			}
+		}
+	};
 
-		// Test intersection with each pair of parallel planes (slabs)
-		for (int i = 0; i < 3; ++i)
+	/**
+	 * @brief Collects up to a fixed number of hits of a mesh traversal, sorted by distance
+	 *
+	 * Keeps the nearest hits in the caller's buffer. Once the buffer is full the
+	 * farthest kept hit bounds the traversal, like the nearest hit does for a
+	 * single cast.
+	 */
+	class SortedHits
+	{
+	public:
+		RayHit* hits;
+		int capacity;
+		int count;
+		float maxDistance;
+
+	public:
+		/**
+		 * @brief Distance beyond which nodes and hits can be skipped
+		 * @return Farthest kept hit when the buffer is full, the distance limit otherwise
+		 */
+		float Bound() const
+		{
+			return count == capacity ? hits[count - 1].distance : maxDistance;
+		}
+
+		/**
+		 * @brief Inserts a triangle test result in distance order
+		 * @param triangle Index of the tested triangle
+		 * @param t Hit distance, negative for a miss
+		 *
+		 * Triangles referenced from several leaves (octree, spatial splits) are
+		 * reported once.
+		 */
+		void Add(const int triangle, const float t)
 		{
-			if (MathF::IsNearZero(direction[i]))
+			if (t < 0.f || t > maxDistance || (count == capacity && t >= hits[count - 1].distance))
+			{
+				return;
+			}
+
+			for (int i = 0; i < count; ++i)
 			{
-				// Ray is parallel to this slab - check if origin is within slab bounds
-				if (origin[i] < min[i] || origin[i] > max[i])
+				if (hits[i].triangle == triangle)
 				{
-					return -1.f; // Ray misses the AABB entirely
+					return;
 				}
 			}
-			else
+
+			int i = count < capacity ? count++ : count - 1;
+			for (; i > 0 && hits[i - 1].distance > t; --i)
 			{
-				// Calculate intersection distances with both planes of this slab
-				float t1 = (min[i] - origin[i]) / direction[i]; // Distance to min plane
-				float t2 = (max[i] - origin[i]) / direction[i]; // Distance to max plane
+				hits[i] = hits[i - 1];
+			}
 
-				// Ensure t1 is the near plane and t2 is the far plane
-				if (t1 > t2)
+			hits[i] = { t, triangle };
+		}
+	};
+
+	/**
+	 * @brief Walks the triangles of a mesh a ray may hit, using whichever acceleration structure it holds
+	 * @param ray Ray to cast
+	 * @param mesh Mesh to traverse
+	 * @param collector Receives every triangle test through Add(triangle, t); its Bound() culls nodes
+	 * @param filter Skips nodes whose aggregated flags miss the filter's mask and
+	 *               triangles it rejects, without testing them; nullptr for none
+	 *
+	 * - WideBvh: tests all children of a node at once, visits leaves immediately
+	 *   and the internal children nearest first
+	 * - LinearBvh: the front-to-back CastBvh() walk shared with Bvh, narrowed
+	 *   to the collector's bound after every triangle
+	 * - Octree: depth-first traversal of every child the ray enters
+	 * - None: brute-force test against every triangle
+	 *
+	 * Rejected triangles never reach the collector, so they neither stop the
+	 * ray nor tighten its bound.
+	 */
+	template <typename Collector>
+	static void TraverseMesh(const Ray& ray, const Mesh& mesh, Collector& collector, const QueryFilter* filter = nullptr)
+	{
+		const WideBvh* wide = AcquireStructure(mesh.wideHierarchy);
+		const LinearBvh* binary = AcquireStructure(mesh.hierarchy);
+		const BvhNode* octree = AcquireStructure(mesh.accelerator);
+
+		const PreparedRay prepared(ray);
+
+		if (wide != nullptr && !wide->IsEmpty())
+		{
+			const WideBvh& bvh = *wide;
+			const int* indices = bvh.indices.empty() ? nullptr : bvh.indices.data();
+
+			// Nodes are stacked with their entry distance so they can be culled
+			// once a closer hit has been found
+			int stack[WIDE_BVH_STACK_SIZE];
+			float stackEntries[WIDE_BVH_STACK_SIZE];
+			int top = 0;
+			stack[top] = 0;
+			stackEntries[top++] = 0.f;
+
+			while (top > 0)
+			{
+				--top;
+				if (stackEntries[top] > collector.Bound())
 				{
-					std::swap(t1, t2);
+					continue;
 				}
 
-				// Update the intersection parameter range
-				tMin = MathF::Max(tMin, t1); // Latest entry point
-				tMax = MathF::Min(tMax, t2); // Earliest exit point
+				const int index = stack[top];
+				const WideBvhNode& node = bvh.nodes[index];
 
-				// No intersection if entry point is after exit point
-				if (tMin > tMax)
+				float entries[WIDE_BVH_WIDTH];
+				int order[WIDE_BVH_WIDTH];
+				int internal = 0;
+
+				int children = node.IntersectChildren(prepared, collector.Bound(), entries);
+				if (filter != nullptr)
 				{
-					return -1.f;
+					children &= bvh.MatchingChildren(index, filter->mask);
 				}
-			}
-		}
 
-		// No intersection if the AABB is entirely behind the ray origin
-		if (tMax < 0.f)
-		{
-			return -1.f;
-		}
+				// Leaves are tested first so their hits tighten the bound for the internal children
+				for (int mask = children; mask != 0; mask &= mask - 1)
+				{
+					const int slot = std::countr_zero(static_cast<unsigned>(mask));
 
-		// Return the closest intersection point in front of the ray origin
-		return tMin < 0.f ? tMax : tMin;
-	}
+					if (!node.IsLeaf(slot))
+					{
+						order[internal++] = slot;
+						continue;
+					}
 
-	float Ray::CastAgainst(const Mesh& other) const
-	{
-		if (other.accelerator == nullptr)
+					for (int i = node.child[slot]; i < node.child[slot] + node.count[slot]; ++i)
+					{
+						const int triangle = indices != nullptr ? indices[i] : i;
+						if (filter == nullptr || filter->Accepts(mesh, triangle))
+						{
+							collector.Add(triangle, CastTriangle(ray, mesh, triangle));
+						}
+					}
+				}
+
+				// Sort internal children far to near so the nearest is popped first
+				for (int i = 1; i < internal; ++i)
+				{
+					for (int j = i; j > 0 && entries[order[j - 1]] < entries[order[j]]; --j)
+					{
+						std::swap(order[j - 1], order[j]);
+					}
+				}
+
+				for (int i = 0; i < internal; ++i)
+				{
+					if (entries[order[i]] <= collector.Bound())
+					{
+						stack[top] = node.child[order[i]];
+						stackEntries[top++] = entries[order[i]];
+					}
+				}
+			}
+		}
+		else if (binary != nullptr && !binary->IsEmpty())
 		{
-			for (int i = 0; i < other.numTriangles; ++i)
+			const uint32_t* masks = filter != nullptr && !binary->masks.empty() ? binary->masks.data() : nullptr;
+
+			// The collector narrows the ray to its own bound, which for multiple hits
+			// is the farthest one kept rather than the nearest
+			CastBvh(*binary, PreparedRay{ ray, collector.Bound() }, [&](const int index)
+			{
+				return masks == nullptr || filter->Matches(masks[index]);
+			}, [&](const int triangle, const float)
 			{
-				float result = CastAgainst(other.triangles[i]);
-				if (result >= 0)
+				if (filter == nullptr || filter->Accepts(mesh, triangle))
 				{
-					return result;
+					collector.Add(triangle, CastTriangle(ray, mesh, triangle));
 				}
-			}
+
+				return collector.Bound();
+			});
 		}
-		else
+		else if (octree != nullptr)
 		{
-			list<BvhNode*> toProcess;
-			toProcess.emplace_front(other.accelerator);
+			// Node masks only mean something when the mesh has flags
+			const QueryFilter* culling = mesh.flags != nullptr ? filter : nullptr;
+
+			const BvhNode* stack[BVH_STACK_SIZE];
+			int top = 0;
+
+			if (culling == nullptr || culling->Matches(octree->mask))
+			{
+				stack[top++] = octree;
+			}
 
-			while (!toProcess.empty())
+			while (top > 0)
 			{
-				BvhNode* iterator = *toProcess.begin();
-				toProcess.erase(toProcess.begin());
+				const BvhNode* node = stack[--top];
 
-				if (iterator->numTriangles >= 0)
+				for (int i = 0; i < node->numTriangles; ++i)
 				{
-					for (int i = 0; i < iterator->numTriangles; ++i)
+					const int triangle = node->triangles[i];
+					if (filter == nullptr || filter->Accepts(mesh, triangle))
 					{
-						float r = CastAgainst(other.triangles[iterator->triangles[i]]);
-						if (r >= 0)
-						{
-							return r;
-						}
+						collector.Add(triangle, CastTriangle(ray, mesh, triangle));
 					}
 				}
 
-				if (iterator->children != nullptr)
+				if (node->children != nullptr)
 				{
-					for (int i = 8 - 1; i >= 0; --i)
+					for (int i = BVH_CHILD_COUNT - 1; i >= 0; --i)
 					{
-						if (CastAgainst(iterator->children[i].bounds) >= 0.f)
+						if (culling != nullptr && !culling->Matches(node->children[i].mask))
+						{
+							continue;
+						}
+
+						const float entry = prepared.Enter(node->children[i].bounds);
+						if (entry >= 0.f && entry <= collector.Bound())
 						{
-							toProcess.emplace_front(iterator->children);
+							stack[top++] = &node->children[i];
 						}
 					}
 				}
 			}
 		}
+		else
+		{
+			for (int i = 0; i < mesh.numTriangles; ++i)
+			{
+				if (filter == nullptr || filter->Accepts(mesh, i))
+				{
+					collector.Add(i, CastTriangle(ray, mesh, i));
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Finds the nearest triangle a ray hits, optionally seeded with a coherence hint
+	 * @param ray Ray to cast
+	 * @param mesh Mesh to traverse
+	 * @param coherence Hint to test first and update, or nullptr
+	 * @param filter Selects the triangles that may be hit, or nullptr for all
+	 * @return Nearest hit (triangle -1 if none)
+	 */
+	static NearestHit CastNearest(const Ray& ray, const Mesh& mesh, QueryCoherence* coherence, const QueryFilter* filter = nullptr)
+	{
+		NearestHit nearest;
+
+		if (coherence != nullptr)
+		{
+			const int hint = coherence->triangle;
+			if (hint >= 0 && hint < mesh.numTriangles && (filter == nullptr || filter->Accepts(mesh, hint)))
+			{
+				nearest.Add(hint, CastTriangle(ray, mesh, hint));
+			}
+
+			if (nearest.triangle >= 0)
+			{
+				++coherence->hits;
+			}
+			else
+			{
+				++coherence->misses;
+			}
+		}
+
+		TraverseMesh(ray, mesh, nearest, filter);
+
+		if (coherence != nullptr && nearest.triangle >= 0)
+		{
+			coherence->triangle = nearest.triangle;
+		}
+
+		return nearest;
+	}
+
+	/**
+	 * @brief Performs ray-mesh intersection, returning the nearest triangle hit
+	 * @param other Mesh to test intersection against
+	 * @return Distance to the nearest intersection point, or -1 if no intersection
+	 */
+	float Ray::CastAgainst(const Mesh& other) const
+	{
+		const NearestHit nearest = CastNearest(*this, other, nullptr);
 
-		return -1.f;
+		return nearest.triangle >= 0 ? nearest.distance : -1.f;
+	}
+
+	/**
+	 * @brief Performs ray-mesh intersection, starting from the triangle hit last time
+	 * @param other Mesh to test intersection against
+	 * @param coherence Hint updated with the triangle hit and the hint's hit or miss
+	 * @return Distance to the nearest intersection point, or -1 if no intersection
+	 */
+	float Ray::CastAgainst(const Mesh& other, QueryCoherence& coherence) const
+	{
+		const NearestHit nearest = CastNearest(*this, other, &coherence);
+
+		return nearest.triangle >= 0 ? nearest.distance : -1.f;
+	}
+
+	/**
+	 * @brief Performs ray-mesh intersection against the triangles passing a filter
+	 * @param other Mesh to test intersection against
+	 * @param filter Selects the triangles that may be hit; the ray passes through the others
+	 * @return Distance to the nearest accepted intersection point, or -1 if no intersection
+	 *
+	 * Subtrees whose aggregated flags miss the filter's mask are skipped
+	 * without a bounds test, and rejected triangles are never intersected.
+	 */
+	float Ray::CastAgainst(const Mesh& other, const QueryFilter& filter) const
+	{
+		const NearestHit nearest = CastNearest(*this, other, nullptr, &filter);
+
+		return nearest.triangle >= 0 ? nearest.distance : -1.f;
+	}
+
+	/**
+	 * @brief Finds every triangle of a mesh the ray hits, nearest first
+	 * @param other Mesh to test intersection against
+	 * @param hits Caller-provided buffer receiving the hits sorted by distance
+	 * @param capacity Size of the buffer; only the nearest capacity hits are kept
+	 * @param maxDistance Hits farther than this are ignored
+	 * @return Number of hits written to the buffer
+	 *
+	 * Runs a single traversal: hits are insertion-sorted into the buffer as
+	 * they are found, and once it is full, nodes beyond the farthest kept hit
+	 * are skipped.
+	 */
+	int Ray::CastAgainst(const Mesh& other, RayHit* hits, const int capacity, const float maxDistance) const
+	{
+		if (hits == nullptr || capacity <= 0)
+		{
+			return 0;
+		}
+
+		SortedHits collector{ hits, capacity, 0, maxDistance };
+		TraverseMesh(*this, other, collector);
+
+		return collector.count;
+	}
+
+	/**
+	 * @brief Finds every triangle passing a filter the ray hits, nearest first
+	 * @param other Mesh to test intersection against
+	 * @param filter Selects the triangles that may be hit
+	 * @param hits Caller-provided buffer receiving the hits sorted by distance
+	 * @param capacity Size of the buffer; only the nearest capacity hits are kept
+	 * @param maxDistance Hits farther than this are ignored
+	 * @return Number of hits written to the buffer
+	 */
+	int Ray::CastAgainst(const Mesh& other, const QueryFilter& filter, RayHit* hits, const int capacity, const float maxDistance) const
+	{
+		if (hits == nullptr || capacity <= 0)
+		{
+			return 0;
+		}
+
+		SortedHits collector{ hits, capacity, 0, maxDistance };
+		TraverseMesh(*this, other, collector, &filter);
+
+		return collector.count;
+	}
+
+	/**
+	 * @brief Casts many rays against a mesh in parallel
+	 * @param mesh Mesh to test intersection against
+	 * @param rays Rays to cast
+	 * @param results Receives the nearest hit of each ray, at the ray's index
+	 * @param sortForCoherence Trace rays in an order that groups similar rays
+	 * @param coherence Optional per-ray hints, at the ray's index
+	 * @return Number of rays that hit the mesh
+	 *
+	 * Algorithm:
+	 * 1. Optionally compute a coherent tracing order (see CoherentOrder())
+	 * 2. Start one worker per hardware thread; each repeatedly claims the next
+	 *    block of RAY_BATCH_BLOCK rays from a shared counter and traces it
+	 *    with the traversal stack on its own thread stack
+	 */
+	int Ray::CastBatch(const Mesh& mesh, span<const Ray> rays, span<RayHit> results, const bool sortForCoherence, span<QueryCoherence> coherence)
+	{
+		const int count = static_cast<int>(std::min(rays.size(), results.size()));
+		if (count <= 0)
+		{
+			return 0;
+		}
+
+		vector<int> order;
+		if (sortForCoherence && count > RAY_BATCH_BLOCK)
+		{
+			CoherentOrder(rays.data(), count, order);
+		}
+
+		const int* sequence = order.empty() ? nullptr : order.data();
+		const int workers = std::min(Parallel::WorkerCount(), (count + RAY_BATCH_BLOCK - 1) / RAY_BATCH_BLOCK);
+
+		atomic<int> next{ 0 };
+		atomic<int> hits{ 0 };
+
+		Parallel::For(workers, 1, [&](const int, const int, const int)
+		{
+			int found = 0;
+
+			for (int begin = next.fetch_add(RAY_BATCH_BLOCK); begin < count; begin = next.fetch_add(RAY_BATCH_BLOCK))
+			{
+				const int end = std::min(begin + RAY_BATCH_BLOCK, count);
+
+				for (int i = begin; i < end; ++i)
+				{
+					const int index = sequence != nullptr ? sequence[i] : i;
+
+					QueryCoherence* hint = static_cast<size_t>(index) < coherence.size() ? &coherence[index] : nullptr;
+					const NearestHit nearest = CastNearest(rays[index], mesh, hint);
+
+					if (nearest.triangle >= 0)
+					{
+						results[index] = { nearest.distance, nearest.triangle };
+						++found;
+					}
+					else
+					{
+						results[index] = { -1.f, -1 };
+					}
+				}
+			}
+
+			hits += found;
+		});
+
+		return hits;
+	}
+
+	/**
+	 * @brief Casts the ray against every child of a compound body
+	 * @param other Compound to test intersection against
+	 * @return Distance along ray to the nearest child hit, or -1 if no intersection
+	 */
+	float Ray::CastAgainst(const Compound& other) const
+	{
+		return other.CastRay(*this);
+	}
+
+	/**
+	 * @brief Casts the ray against the upper side of a heightfield
+	 * @param other Heightfield to test intersection against
+	 * @return Distance along ray to intersection point, or -1 if no intersection
+	 */
+	float Ray::CastAgainst(const Heightfield& other) const
+	{
+		return other.CastRay(*this);
 	}
 
 	/**
@@ -300,6 +817,16 @@ namespace Nudge
 		return t >= 0.f ? t : -1.f;
 	}
 
+	/**
+	 * @brief Casts the ray against whichever primitive a shape holds
+	 * @param other Shape to test intersection against
+	 * @return Distance along ray to intersection point, or -1 if no intersection
+	 */
+	float Ray::CastAgainst(const Shape& other) const
+	{
+		return other.CastRay(*this);
+	}
+
 	/**
 	 * @brief Performs ray-sphere intersection using quadratic equation
 	 * @param other Sphere to test intersection against
@@ -0,0 +1,809 @@
+#include "Nudge/Shapes/Shape.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using std::array;
+using std::atomic;
+using std::index_sequence;
+using std::make_index_sequence;
+using std::size_t;
+using std::vector;
+
+// Iteration cap for GJK; well-shaped pairs converge in under ten
+constexpr int SHAPE_GJK_MAX_ITERATIONS = 64;
+
+// Relative improvement of the closest point below which GJK stops refining it;
+// tighter than this, float round-off in flat simplices starts to dominate
+constexpr float SHAPE_GJK_TOLERANCE = 1e-5f;
+
+// Squared length below which the closest point is taken as the origin, i.e. overlap
+constexpr float SHAPE_GJK_CONTACT_SQR = 1e-12f;
+
+// Separation at or below which two segments count as touching
+constexpr float SHAPE_TOUCH_DISTANCE = 1e-5f;
+
+// Pairs processed per parallel task in the batch queries
+constexpr int SHAPE_BATCH_SIZE = 256;
+
+namespace Nudge
+{
+	static_assert(std::variant_size_v<Shape::Storage> == SHAPE_TYPE_COUNT, "ShapeType must list every Shape alternative");
+
+	/**
+	 * @brief Farthest point of a sphere's core along a direction
+	 * @param shape Sphere, whose core is its center
+	 * @return Center of the sphere
+	 */
+	static Vector3 Support(const Sphere& shape, const Vector3&)
+	{
+		return shape.origin;
+	}
+
+	/**
+	 * @brief Farthest point of a box along a direction
+	 * @param shape Box
+	 * @param direction Direction to search along
+	 * @return Corner of the box farthest along direction
+	 */
+	static Vector3 Support(const Aabb& shape, const Vector3& direction)
+	{
+		return
+		{
+			shape.origin.x + (direction.x >= 0.f ? shape.extents.x : -shape.extents.x),
+			shape.origin.y + (direction.y >= 0.f ? shape.extents.y : -shape.extents.y),
+			shape.origin.z + (direction.z >= 0.f ? shape.extents.z : -shape.extents.z)
+		};
+	}
+
+	/**
+	 * @brief Farthest point of an oriented box along a direction
+	 * @param shape Oriented box
+	 * @param direction Direction to search along
+	 * @return Corner of the box farthest along direction
+	 */
+	static Vector3 Support(const Obb& shape, const Vector3& direction)
+	{
+		Vector3 point = shape.origin;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const Vector3 column = shape.orientation.GetColumn(axis);
+			point += column * (Vector3::Dot(column, direction) >= 0.f ? shape.extents[axis] : -shape.extents[axis]);
+		}
+
+		return point;
+	}
+
+	/**
+	 * @brief Farthest vertex of a triangle along a direction
+	 * @param shape Triangle
+	 * @param direction Direction to search along
+	 * @return Vertex farthest along direction
+	 */
+	static Vector3 Support(const Triangle& shape, const Vector3& direction)
+	{
+		const float a = Vector3::Dot(shape.a, direction);
+		const float b = Vector3::Dot(shape.b, direction);
+		const float c = Vector3::Dot(shape.c, direction);
+
+		if (a >= b && a >= c)
+		{
+			return shape.a;
+		}
+
+		return b >= c ? shape.b : shape.c;
+	}
+
+	/**
+	 * @brief Farthest endpoint of a segment along a direction
+	 * @param shape Segment
+	 * @param direction Direction to search along
+	 * @return Endpoint farthest along direction
+	 */
+	static Vector3 Support(const Line& shape, const Vector3& direction)
+	{
+		return Vector3::Dot(shape.end - shape.start, direction) > 0.f ? shape.end : shape.start;
+	}
+
+	/**
+	 * @brief Thickness added around a shape's core
+	 * @return 0 for every shape but spheres
+	 */
+	template <typename Primitive>
+	static float Margin(const Primitive&)
+	{
+		return 0.f;
+	}
+
+	/**
+	 * @brief Thickness added around a sphere's core point
+	 * @param shape Sphere
+	 * @return Radius of the sphere
+	 */
+	static float Margin(const Sphere& shape)
+	{
+		return shape.radius;
+	}
+
+	/**
+	 * @brief Closest point to the origin on a segment simplex
+	 * @param points Simplex vertices; reduced to those spanning the closest feature
+	 * @param count Number of vertices (2); updated with the reduced count
+	 * @return Closest point to the origin
+	 */
+	static Vector3 ClosestOnSegment(Vector3* points, int& count)
+	{
+		const Vector3 a = points[0];
+		const Vector3 ab = points[1] - a;
+		const float lengthSqr = Vector3::Dot(ab, ab);
+		const float t = lengthSqr > 0.f ? -Vector3::Dot(a, ab) / lengthSqr : 0.f;
+
+		if (t <= 0.f)
+		{
+			count = 1;
+			return a;
+		}
+
+		if (t >= 1.f)
+		{
+			points[0] = points[1];
+			count = 1;
+			return points[0];
+		}
+
+		return a + ab * t;
+	}
+
+	/**
+	 * @brief Closest point to the origin on a triangle simplex
+	 * @param points Simplex vertices; reduced to those spanning the closest feature
+	 * @param count Number of vertices (3); updated with the reduced count
+	 * @return Closest point to the origin
+	 *
+	 * Classifies the origin against the Voronoi regions of the triangle's
+	 * vertices, edges and face (Ericson, Real-Time Collision Detection 5.1.5).
+	 */
+	static Vector3 ClosestOnTriangle(Vector3* points, int& count)
+	{
+		const Vector3 a = points[0];
+		const Vector3 b = points[1];
+		const Vector3 c = points[2];
+		const Vector3 ab = b - a;
+		const Vector3 ac = c - a;
+
+		const float d1 = -Vector3::Dot(ab, a);
+		const float d2 = -Vector3::Dot(ac, a);
+		if (d1 <= 0.f && d2 <= 0.f)
+		{
+			count = 1;
+			return a;
+		}
+
+		const float d3 = -Vector3::Dot(ab, b);
+		const float d4 = -Vector3::Dot(ac, b);
+		if (d3 >= 0.f && d4 <= d3)
+		{
+			points[0] = b;
+			count = 1;
+			return b;
+		}
+
+		const float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+		{
+			count = 2;
+			return a + ab * (d1 / (d1 - d3));
+		}
+
+		const float d5 = -Vector3::Dot(ab, c);
+		const float d6 = -Vector3::Dot(ac, c);
+		if (d6 >= 0.f && d5 <= d6)
+		{
+			points[0] = c;
+			count = 1;
+			return c;
+		}
+
+		const float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+		{
+			points[1] = c;
+			count = 2;
+			return a + ac * (d2 / (d2 - d6));
+		}
+
+		const float va = d3 * d6 - d5 * d4;
+		if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f)
+		{
+			points[0] = b;
+			points[1] = c;
+			count = 2;
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+		}
+
+		const float sum = va + vb + vc;
+		if (sum <= 0.f)
+		{
+			// Collinear vertices: the closest point lies on the longest edge
+			const float lengthAb = ab.MagnitudeSqr();
+			const float lengthAc = ac.MagnitudeSqr();
+			const float lengthBc = (c - b).MagnitudeSqr();
+
+			if (lengthAc >= lengthAb && lengthAc >= lengthBc)
+			{
+				points[1] = c;
+			}
+			else if (lengthBc >= lengthAb)
+			{
+				points[0] = c;
+			}
+
+			count = 2;
+			return ClosestOnSegment(points, count);
+		}
+
+		return a + ab * (vb / sum) + ac * (vc / sum);
+	}
+
+	/**
+	 * @brief Closest point to the origin on a tetrahedron simplex
+	 * @param points Simplex vertices; reduced to those spanning the closest feature
+	 * @param count Number of vertices (4); left at 4 if the origin is enclosed
+	 * @return Closest point to the origin, the origin itself if enclosed
+	 *
+	 * Only faces with the origin on their outer side can hold the closest
+	 * point; if there is none, the origin is inside. A flat tetrahedron has
+	 * every face treated as outer.
+	 */
+	static Vector3 ClosestOnTetrahedron(Vector3* points, int& count)
+	{
+		constexpr int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 1, 3, 2 }, { 0, 2, 3, 1 }, { 1, 2, 3, 0 } };
+
+		Vector3 closest{ 0.f };
+		Vector3 best[3];
+		int bestCount = 0;
+		float bestSqr = std::numeric_limits<float>::infinity();
+
+		for (const auto& face : faces)
+		{
+			const Vector3& a = points[face[0]];
+			const Vector3 normal = Vector3::Cross(points[face[1]] - a, points[face[2]] - a);
+			const float origin = -Vector3::Dot(normal, a);
+			const float opposite = Vector3::Dot(normal, points[face[3]] - a);
+
+			if (origin * opposite > 0.f)
+			{
+				continue;
+			}
+
+			Vector3 candidate[3] = { a, points[face[1]], points[face[2]] };
+			int candidateCount = 3;
+			const Vector3 point = ClosestOnTriangle(candidate, candidateCount);
+
+			if (const float sqr = point.MagnitudeSqr(); sqr < bestSqr)
+			{
+				bestSqr = sqr;
+				closest = point;
+				bestCount = candidateCount;
+				for (int i = 0; i < candidateCount; ++i)
+				{
+					best[i] = candidate[i];
+				}
+			}
+		}
+
+		if (bestCount == 0)
+		{
+			return closest;
+		}
+
+		for (int i = 0; i < bestCount; ++i)
+		{
+			points[i] = best[i];
+		}
+
+		count = bestCount;
+		return closest;
+	}
+
+	/**
+	 * @brief Distance between the cores of two convex shapes
+	 * @param a First shape
+	 * @param b Second shape
+	 * @return Distance between the cores, 0 if they overlap
+	 *
+	 * Algorithm (GJK):
+	 * 1. Start from one support point of the Minkowski difference a - b
+	 * 2. Take the closest point v to the origin on the current simplex,
+	 *    keeping only the vertices of the feature it lies on
+	 * 3. Add the support point w farthest along -v; stop once w brings v no
+	 *    meaningfully closer, or the simplex encloses the origin
+	 *
+	 * An iteration that fails to shrink v (round-off in a nearly flat
+	 * simplex) ends the search with the previous, closer point.
+	 */
+	template <typename A, typename B>
+	static float CoreDistance(const A& a, const B& b)
+	{
+		Vector3 points[4];
+		int count = 1;
+
+		const Vector3 start = Vector3::UnitX();
+		points[0] = Support(a, start) - Support(b, start * -1.f);
+		Vector3 v = points[0];
+
+		for (int iteration = 0; iteration < SHAPE_GJK_MAX_ITERATIONS; ++iteration)
+		{
+			const float vSqr = Vector3::Dot(v, v);
+			if (vSqr <= SHAPE_GJK_CONTACT_SQR)
+			{
+				return 0.f;
+			}
+
+			const Vector3 w = Support(a, v * -1.f) - Support(b, v);
+			if (vSqr - Vector3::Dot(v, w) <= SHAPE_GJK_TOLERANCE * vSqr)
+			{
+				break;
+			}
+
+			points[count++] = w;
+
+			Vector3 closer;
+			switch (count)
+			{
+			case 2:
+				closer = ClosestOnSegment(points, count);
+				break;
+			case 3:
+				closer = ClosestOnTriangle(points, count);
+				break;
+			default:
+				closer = ClosestOnTetrahedron(points, count);
+				break;
+			}
+
+			if (count == 4)
+			{
+				return 0.f;
+			}
+
+			if (Vector3::Dot(closer, closer) >= vSqr)
+			{
+				break;
+			}
+
+			v = closer;
+		}
+
+		return MathF::Sqrt(Vector3::Dot(v, v));
+	}
+
+	/**
+	 * @brief Distance between a plane and a convex shape
+	 * @param plane Plane, with a unit normal
+	 * @param other Shape to measure
+	 * @return Gap between the plane and the nearer side of the shape, 0 if it straddles the plane
+	 */
+	template <typename Primitive>
+	static float PlaneDistance(const Plane& plane, const Primitive& other)
+	{
+		const float margin = Margin(other);
+		const float low = Plane::PlaneEquation(Support(other, plane.normal * -1.f), plane) - margin;
+		const float high = Plane::PlaneEquation(Support(other, plane.normal), plane) + margin;
+
+		if (low > 0.f)
+		{
+			return low;
+		}
+
+		return high < 0.f ? -high : 0.f;
+	}
+
+	/**
+	 * @brief Distance between two planes
+	 * @param a First plane, with a unit normal
+	 * @param b Second plane, with a unit normal
+	 * @return Gap between parallel planes, 0 for planes that cross
+	 */
+	static float PlanesDistance(const Plane& a, const Plane& b)
+	{
+		const Vector3 cross = Vector3::Cross(a.normal, b.normal);
+		if (!MathF::IsNearZero(Vector3::Dot(cross, cross)))
+		{
+			return 0.f;
+		}
+
+		const float facing = Vector3::Dot(a.normal, b.normal) >= 0.f ? 1.f : -1.f;
+
+		return MathF::Abs(a.distance - facing * b.distance);
+	}
+
+	/**
+	 * @brief Separation between two primitives of known type
+	 * @param a First primitive
+	 * @param b Second primitive
+	 * @return Smallest distance between the primitives, 0 if they overlap
+	 */
+	template <typename A, typename B>
+	static float DistancePair(const A& a, const B& b)
+	{
+		if constexpr (std::is_same_v<A, Plane> && std::is_same_v<B, Plane>)
+		{
+			return PlanesDistance(a, b);
+		}
+		else if constexpr (std::is_same_v<A, Plane>)
+		{
+			return PlaneDistance(a, b);
+		}
+		else if constexpr (std::is_same_v<B, Plane>)
+		{
+			return PlaneDistance(b, a);
+		}
+		else
+		{
+			return MathF::Max(0.f, CoreDistance(a, b) - Margin(a) - Margin(b));
+		}
+	}
+
+	/**
+	 * @brief Overlap test between two primitives of known type
+	 * @param a First primitive
+	 * @param b Second primitive
+	 * @return True if the primitives intersect
+	 *
+	 * Prefers a's own Intersects() overload, then the segment tests of
+	 * Line::Test(), and falls back to the distance for pairs with neither.
+	 */
+	template <typename A, typename B>
+	static bool IntersectsPair(const A& a, const B& b)
+	{
+		if constexpr (requires { a.Intersects(b); })
+		{
+			return a.Intersects(b);
+		}
+		else if constexpr (requires { a.Test(b); })
+		{
+			return a.Test(b);
+		}
+		else if constexpr (requires { b.Test(a); })
+		{
+			return b.Test(a);
+		}
+		else
+		{
+			return DistancePair(a, b) <= SHAPE_TOUCH_DISTANCE;
+		}
+	}
+
+	/**
+	 * @brief Ray cast against a primitive of known type
+	 * @param ray Ray to cast
+	 * @param shape Primitive to cast against
+	 * @return Distance along the ray to the hit, or -1 if there is none
+	 *
+	 * Segments have no Ray::CastAgainst() overload of their own (a Line
+	 * would convert to a Shape and land back here), and are never hit.
+	 */
+	template <typename Primitive>
+	static float CastPair(const Ray& ray, const Primitive& shape)
+	{
+		if constexpr (std::is_same_v<Primitive, Line>)
+		{
+			return -1.f;
+		}
+		else
+		{
+			return ray.CastAgainst(shape);
+		}
+	}
+
+	/**
+	 * @brief Entry points for one pair of shape types
+	 *
+	 * The run functions process a bucket of pairs already known to hold
+	 * these two types, so the loop body calls the exact test directly.
+	 */
+	class ShapeDispatch
+	{
+	public:
+		bool (*intersects)(const Shape& a, const Shape& b);
+		float (*distance)(const Shape& a, const Shape& b);
+		int (*intersectsRun)(const Shape* shapes, const ShapePair* pairs, const int* order, int count, uint8_t* overlaps);
+		void (*distanceRun)(const Shape* shapes, const ShapePair* pairs, const int* order, int count, float* distances);
+	};
+
+	template <size_t A, size_t B>
+	static bool IntersectsEntry(const Shape& a, const Shape& b)
+	{
+		return IntersectsPair(*std::get_if<A>(&a.value), *std::get_if<B>(&b.value));
+	}
+
+	template <size_t A, size_t B>
+	static float DistanceEntry(const Shape& a, const Shape& b)
+	{
+		return DistancePair(*std::get_if<A>(&a.value), *std::get_if<B>(&b.value));
+	}
+
+	template <size_t A, size_t B>
+	static int IntersectsRun(const Shape* shapes, const ShapePair* pairs, const int* order, const int count, uint8_t* overlaps)
+	{
+		int found = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			const ShapePair& pair = pairs[order[i]];
+			const bool hit = IntersectsPair(*std::get_if<A>(&shapes[pair.first].value), *std::get_if<B>(&shapes[pair.second].value));
+
+			overlaps[order[i]] = hit ? 1 : 0;
+			found += hit ? 1 : 0;
+		}
+
+		return found;
+	}
+
+	template <size_t A, size_t B>
+	static void DistanceRun(const Shape* shapes, const ShapePair* pairs, const int* order, const int count, float* distances)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			const ShapePair& pair = pairs[order[i]];
+			distances[order[i]] = DistancePair(*std::get_if<A>(&shapes[pair.first].value), *std::get_if<B>(&shapes[pair.second].value));
+		}
+	}
+
+	template <size_t... Entries>
+	static constexpr array<ShapeDispatch, sizeof...(Entries)> MakeDispatchTable(index_sequence<Entries...>)
+	{
+		constexpr size_t types = SHAPE_TYPE_COUNT;
+
+		return { ShapeDispatch
+		{
+			&IntersectsEntry<Entries / types, Entries % types>,
+			&DistanceEntry<Entries / types, Entries % types>,
+			&IntersectsRun<Entries / types, Entries % types>,
+			&DistanceRun<Entries / types, Entries % types>
+		}... };
+	}
+
+	template <size_t Type>
+	static float CastEntry(const Ray& ray, const Shape& shape)
+	{
+		return CastPair(ray, *std::get_if<Type>(&shape.value));
+	}
+
+	template <size_t... Types>
+	static constexpr array<float (*)(const Ray&, const Shape&), sizeof...(Types)> MakeCastTable(index_sequence<Types...>)
+	{
+		return { &CastEntry<Types>... };
+	}
+
+	// Row-major by (first type, second type)
+	static constexpr auto SHAPE_DISPATCH = MakeDispatchTable(make_index_sequence<SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT>{});
+
+	static constexpr auto SHAPE_CAST_DISPATCH = MakeCastTable(make_index_sequence<SHAPE_TYPE_COUNT>{});
+
+	/**
+	 * @brief Dispatch table slot of a pair
+	 * @param a First shape
+	 * @param b Second shape
+	 * @return Row-major index by (a's type, b's type)
+	 */
+	static int DispatchSlot(const Shape& a, const Shape& b)
+	{
+		return static_cast<int>(a.value.index()) * SHAPE_TYPE_COUNT + static_cast<int>(b.value.index());
+	}
+
+	/**
+	 * @brief Buckets a batch of pairs by their dispatch slot and runs each bucket
+	 * @param shapes Shapes the pairs index into
+	 * @param pairs Pairs to process
+	 * @param count Number of pairs to process
+	 * @param run Called as run(slot, order, bucketCount) for each contiguous run of one slot; returns a count to add up
+	 * @return Sum of the run results
+	 *
+	 * Algorithm:
+	 * 1. Compute the slot of every pair
+	 * 2. Counting-sort the pair indices by slot, keeping the input order
+	 *    within a slot
+	 * 3. Split the sorted order across threads; each thread hands every run
+	 *    of equal slots in its range to the run callback in one call
+	 */
+	template <typename Run>
+	static int RunBuckets(span<const Shape> shapes, span<const ShapePair> pairs, const int count, Run&& run)
+	{
+		vector<uint8_t> slots(count);
+		array<int, SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT + 1> starts{};
+
+		for (int i = 0; i < count; ++i)
+		{
+			slots[i] = static_cast<uint8_t>(DispatchSlot(shapes[pairs[i].first], shapes[pairs[i].second]));
+			++starts[slots[i] + 1];
+		}
+
+		for (size_t slot = 1; slot < starts.size(); ++slot)
+		{
+			starts[slot] += starts[slot - 1];
+		}
+
+		vector<int> order(count);
+		for (int i = 0; i < count; ++i)
+		{
+			order[starts[slots[i]]++] = i;
+		}
+
+		atomic<int> total{ 0 };
+
+		Parallel::For(count, SHAPE_BATCH_SIZE, [&](const int, const int begin, const int end)
+		{
+			int sum = 0;
+
+			for (int first = begin; first < end;)
+			{
+				const uint8_t slot = slots[order[first]];
+
+				int last = first + 1;
+				while (last < end && slots[order[last]] == slot)
+				{
+					++last;
+				}
+
+				sum += run(slot, order.data() + first, last - first);
+				first = last;
+			}
+
+			total += sum;
+		});
+
+		return total;
+	}
+
+	/**
+	 * @brief Default constructor holding a default sphere
+	 */
+	Shape::Shape() = default;
+
+	/**
+	 * @brief Creates a shape holding a sphere
+	 * @param sphere Sphere to hold
+	 */
+	Shape::Shape(const Sphere& sphere)
+		: value{ sphere }
+	{
+	}
+
+	/**
+	 * @brief Creates a shape holding an axis-aligned box
+	 * @param box Box to hold
+	 */
+	Shape::Shape(const Aabb& box)
+		: value{ box }
+	{
+	}
+
+	/**
+	 * @brief Creates a shape holding an oriented box
+	 * @param box Box to hold
+	 */
+	Shape::Shape(const Obb& box)
+		: value{ box }
+	{
+	}
+
+	/**
+	 * @brief Creates a shape holding a triangle
+	 * @param triangle Triangle to hold
+	 */
+	Shape::Shape(const Triangle& triangle)
+		: value{ triangle }
+	{
+	}
+
+	/**
+	 * @brief Creates a shape holding a plane
+	 * @param plane Plane to hold
+	 */
+	Shape::Shape(const Plane& plane)
+		: value{ plane }
+	{
+	}
+
+	/**
+	 * @brief Creates a shape holding a line segment
+	 * @param line Segment to hold
+	 */
+	Shape::Shape(const Line& line)
+		: value{ line }
+	{
+	}
+
+	/**
+	 * @brief Tests a batch of pairs, bucketed by type
+	 * @param shapes Shapes the pairs index into
+	 * @param pairs Pairs to test
+	 * @param overlaps Receives 1 for each pair that intersects, 0 otherwise, at the pair's index
+	 * @return Number of pairs that intersect
+	 */
+	int Shape::IntersectsBatch(span<const Shape> shapes, span<const ShapePair> pairs, span<uint8_t> overlaps)
+	{
+		const int count = static_cast<int>(std::min(pairs.size(), overlaps.size()));
+		if (count <= 0)
+		{
+			return 0;
+		}
+
+		return RunBuckets(shapes, pairs, count, [&](const int slot, const int* order, const int bucket)
+		{
+			return SHAPE_DISPATCH[slot].intersectsRun(shapes.data(), pairs.data(), order, bucket, overlaps.data());
+		});
+	}
+
+	/**
+	 * @brief Measures a batch of pairs, bucketed by type
+	 * @param shapes Shapes the pairs index into
+	 * @param pairs Pairs to measure
+	 * @param distances Receives the distance of each pair, at the pair's index
+	 * @return Number of pairs measured, min(pairs.size(), distances.size())
+	 */
+	int Shape::DistanceBatch(span<const Shape> shapes, span<const ShapePair> pairs, span<float> distances)
+	{
+		const int count = static_cast<int>(std::min(pairs.size(), distances.size()));
+		if (count <= 0)
+		{
+			return 0;
+		}
+
+		return RunBuckets(shapes, pairs, count, [&](const int slot, const int* order, const int bucket)
+		{
+			SHAPE_DISPATCH[slot].distanceRun(shapes.data(), pairs.data(), order, bucket, distances.data());
+			return bucket;
+		});
+	}
+
+	/**
+	 * @brief Kind of primitive held
+	 * @return Type matching the active alternative of value
+	 */
+	ShapeType Shape::Type() const
+	{
+		return static_cast<ShapeType>(value.index());
+	}
+
+	/**
+	 * @brief Tests whether two shapes touch
+	 * @param other Shape to test
+	 * @return True if the shapes intersect
+	 */
+	bool Shape::Intersects(const Shape& other) const
+	{
+		return SHAPE_DISPATCH[DispatchSlot(*this, other)].intersects(*this, other);
+	}
+
+	/**
+	 * @brief Separation between two shapes
+	 * @param other Shape to measure against
+	 * @return Smallest distance between any two points of the shapes, 0 if they overlap
+	 */
+	float Shape::Distance(const Shape& other) const
+	{
+		return SHAPE_DISPATCH[DispatchSlot(*this, other)].distance(*this, other);
+	}
+
+	/**
+	 * @brief Casts a ray against the shape
+	 * @param ray Ray to cast
+	 * @return Distance along the ray to the hit, or -1 if there is none
+	 */
+	float Shape::CastRay(const Ray& ray) const
+	{
+		return SHAPE_CAST_DISPATCH[value.index()](ray, *this);
+	}
+}
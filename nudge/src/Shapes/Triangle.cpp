@@ -6,8 +6,358 @@
 #include "Nudge/Shapes/Plane.hpp"
 #include "Nudge/Shapes/Sphere.hpp"
 
+#include <cmath>
+
+// Distances to a triangle's plane below this fraction of the triangle's longest
+// edge count as lying on the plane. The same fraction of the squared longest
+// edge bounds the normal length of triangles treated as degenerate.
+constexpr float TRIANGLE_PLANE_TOLERANCE = 1e-6f;
+
 namespace Nudge
 {
+	/**
+	 * @brief Plane of a triangle, prepared for repeated triangle-triangle tests
+	 */
+	class TrianglePlane
+	{
+	public:
+		float vertices[9];  ///< Triangle vertices [ax,ay,az, bx,by,bz, cx,cy,cz]
+		float normal[3];    ///< Unit face normal
+		float tolerance;    ///< Distances within this count as on the plane
+		bool degenerate;    ///< True if the triangle has (almost) no area
+
+	public:
+		/**
+		 * @brief Computes the plane of a triangle
+		 * @param triangle Triangle to prepare
+		 */
+		explicit TrianglePlane(const Triangle& triangle)
+			: vertices{}, normal{}, tolerance{ 0.f }, degenerate{ true }
+		{
+			for (int i = 0; i < 9; ++i)
+			{
+				vertices[i] = triangle.values[i];
+			}
+
+			const float* v = vertices;
+			const float e0[3] = { v[3] - v[0], v[4] - v[1], v[5] - v[2] };
+			const float e1[3] = { v[6] - v[0], v[7] - v[1], v[8] - v[2] };
+			const float e2[3] = { v[6] - v[3], v[7] - v[4], v[8] - v[5] };
+
+			const float n[3] =
+			{
+				e0[1] * e1[2] - e0[2] * e1[1],
+				e0[2] * e1[0] - e0[0] * e1[2],
+				e0[0] * e1[1] - e0[1] * e1[0]
+			};
+
+			const float longestSqr = std::fmax(e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2],
+				std::fmax(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2], e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2]));
+			const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			if (length <= TRIANGLE_PLANE_TOLERANCE * longestSqr || length == 0.f)
+			{
+				return;
+			}
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				normal[axis] = n[axis] / length;
+			}
+
+			tolerance = TRIANGLE_PLANE_TOLERANCE * std::sqrt(longestSqr);
+			degenerate = false;
+		}
+
+	public:
+		/**
+		 * @brief Signed distances of three vertices to the plane, snapped to 0 within the tolerance
+		 * @param points Vertices [ax,ay,az, bx,by,bz, cx,cy,cz]
+		 * @param distances Receives one distance per vertex
+		 * @return -1 or 1 if all vertices lie strictly on that side, 0 otherwise
+		 */
+		int Distances(const float* points, float* distances) const
+		{
+			int above = 0;
+			int below = 0;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				// Relative to a vertex of the plane's triangle, which keeps precision far from the origin
+				const float d = normal[0] * (points[i * 3] - vertices[0])
+					+ normal[1] * (points[i * 3 + 1] - vertices[1])
+					+ normal[2] * (points[i * 3 + 2] - vertices[2]);
+
+				distances[i] = std::abs(d) <= tolerance ? 0.f : d;
+				above += distances[i] > 0.f;
+				below += distances[i] < 0.f;
+			}
+
+			return above == 3 ? 1 : below == 3 ? -1 : 0;
+		}
+	};
+
+	/**
+	 * @brief Finds where a triangle meets a plane it straddles or touches
+	 * @param vertices Triangle vertices
+	 * @param distances Signed distances of the vertices to the plane, not all zero
+	 * @param points Receives the two ends of the triangle's cut (equal if it only touches)
+	 */
+	static void PlaneCut(const float* vertices, const float* distances, float points[2][3])
+	{
+		int count = 0;
+
+		for (int i = 0; i < 3; ++i)
+		{
+			if (distances[i] == 0.f)
+			{
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					points[count][axis] = vertices[i * 3 + axis];
+				}
+
+				++count;
+			}
+		}
+
+		for (int i = 0; i < 3 && count < 2; ++i)
+		{
+			const int j = (i + 1) % 3;
+			if ((distances[i] > 0.f && distances[j] < 0.f) || (distances[i] < 0.f && distances[j] > 0.f))
+			{
+				const float s = distances[i] / (distances[i] - distances[j]);
+
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					points[count][axis] = vertices[i * 3 + axis] + s * (vertices[j * 3 + axis] - vertices[i * 3 + axis]);
+				}
+
+				++count;
+			}
+		}
+
+		if (count == 1)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				points[1][axis] = points[0][axis];
+			}
+		}
+	}
+
+	/**
+	 * @brief Twice the signed area of a 2D triangle
+	 */
+	static float Orient2D(const float* a, const float* b, const float* c)
+	{
+		return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+	}
+
+	/**
+	 * @brief Tests coplanar triangles for overlap in the plane they share
+	 * @param p First triangle
+	 * @param q Second triangle
+	 * @param point Receives a point of the overlap (3D)
+	 * @return True if the triangles overlap or touch
+	 *
+	 * Projects both triangles onto the coordinate plane most parallel to
+	 * them, then looks for an edge crossing or a vertex of one inside the other.
+	 */
+	static bool CoplanarOverlap(const TrianglePlane& p, const float* q, float* point)
+	{
+		// Drop the axis along which the normal is largest
+		const float n[3] = { std::abs(p.normal[0]), std::abs(p.normal[1]), std::abs(p.normal[2]) };
+		const int drop = n[0] > n[1] ? (n[0] > n[2] ? 0 : 2) : (n[1] > n[2] ? 1 : 2);
+		const int u = drop == 0 ? 1 : 0;
+		const int v = drop == 2 ? 1 : 2;
+
+		const float* triangles[2] = { p.vertices, q };
+		float flat[2][3][2];
+
+		for (int t = 0; t < 2; ++t)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				flat[t][i][0] = triangles[t][i * 3 + u];
+				flat[t][i][1] = triangles[t][i * 3 + v];
+			}
+		}
+
+		// Edge crossings
+		for (int i = 0; i < 3; ++i)
+		{
+			const float* a = flat[0][i];
+			const float* b = flat[0][(i + 1) % 3];
+
+			for (int j = 0; j < 3; ++j)
+			{
+				const float* c = flat[1][j];
+				const float* d = flat[1][(j + 1) % 3];
+
+				const float d1 = Orient2D(c, d, a);
+				const float d2 = Orient2D(c, d, b);
+				const float d3 = Orient2D(a, b, c);
+				const float d4 = Orient2D(a, b, d);
+
+				// Collinear overlapping edges put a vertex on the other triangle, found below
+				if (d1 == d2 || d1 * d2 > 0.f || d3 * d4 > 0.f)
+				{
+					continue;
+				}
+
+				const float s = d1 / (d1 - d2);
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					point[axis] = p.vertices[i * 3 + axis] + s * (p.vertices[((i + 1) % 3) * 3 + axis] - p.vertices[i * 3 + axis]);
+				}
+
+				return true;
+			}
+		}
+
+		// Containment of a vertex, either way round
+		for (int t = 0; t < 2; ++t)
+		{
+			const float (*outer)[2] = flat[1 - t];
+
+			for (int i = 0; i < 3; ++i)
+			{
+				const float o1 = Orient2D(outer[0], outer[1], flat[t][i]);
+				const float o2 = Orient2D(outer[1], outer[2], flat[t][i]);
+				const float o3 = Orient2D(outer[2], outer[0], flat[t][i]);
+
+				if ((o1 >= 0.f && o2 >= 0.f && o3 >= 0.f) || (o1 <= 0.f && o2 <= 0.f && o3 <= 0.f))
+				{
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						point[axis] = triangles[t][i * 3 + axis];
+					}
+
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Tests a prepared triangle against another triangle
+	 * @param p Prepared first triangle
+	 * @param other Second triangle
+	 * @param segment Receives the shared segment if not nullptr (untouched for degenerate triangles)
+	 * @return True if the triangles intersect or touch
+	 *
+	 * Algorithm (Moller, "A Fast Triangle-Triangle Intersection Test"):
+	 * 1. Reject if the second triangle lies strictly on one side of the first's plane
+	 * 2. Reject if the first lies strictly on one side of the second's plane
+	 * 3. Both triangles cut the line where the planes meet; they intersect if
+	 *    their cuts overlap along it
+	 */
+	static bool IntersectTriangles(const TrianglePlane& p, const Triangle& other, Line* segment)
+	{
+		float q[9];
+		for (int i = 0; i < 9; ++i)
+		{
+			q[i] = other.values[i];
+		}
+
+		float qDistances[3];
+		if (p.Distances(q, qDistances) != 0)
+		{
+			return false;
+		}
+
+		const TrianglePlane plane(other);
+		if (p.degenerate || plane.degenerate)
+		{
+			const float* v = p.vertices;
+			return Interval::TriangleTriangle(Triangle{ Vector3{ v[0], v[1], v[2] }, Vector3{ v[3], v[4], v[5] }, Vector3{ v[6], v[7], v[8] } }, other);
+		}
+
+		float pDistances[3];
+		if (plane.Distances(p.vertices, pDistances) != 0)
+		{
+			return false;
+		}
+
+		if ((qDistances[0] == 0.f && qDistances[1] == 0.f && qDistances[2] == 0.f) ||
+			(pDistances[0] == 0.f && pDistances[1] == 0.f && pDistances[2] == 0.f))
+		{
+			float point[3];
+			if (!CoplanarOverlap(p, q, point))
+			{
+				return false;
+			}
+
+			if (segment != nullptr)
+			{
+				segment->start = segment->end = Vector3{ point[0], point[1], point[2] };
+			}
+
+			return true;
+		}
+
+		// Direction of the line both planes share
+		const float direction[3] =
+		{
+			p.normal[1] * plane.normal[2] - p.normal[2] * plane.normal[1],
+			p.normal[2] * plane.normal[0] - p.normal[0] * plane.normal[2],
+			p.normal[0] * plane.normal[1] - p.normal[1] * plane.normal[0]
+		};
+
+		float pCut[2][3];
+		float qCut[2][3];
+		PlaneCut(p.vertices, pDistances, pCut);
+		PlaneCut(q, qDistances, qCut);
+
+		auto along = [&](const float* point)
+		{
+			return direction[0] * (point[0] - p.vertices[0]) + direction[1] * (point[1] - p.vertices[1]) + direction[2] * (point[2] - p.vertices[2]);
+		};
+
+		float pt[2] = { along(pCut[0]), along(pCut[1]) };
+		float qt[2] = { along(qCut[0]), along(qCut[1]) };
+
+		// Order each cut along the line
+		const int pLow = pt[0] <= pt[1] ? 0 : 1;
+		const int qLow = qt[0] <= qt[1] ? 0 : 1;
+
+		if (pt[1 - pLow] < qt[qLow] || qt[1 - qLow] < pt[pLow])
+		{
+			return false;
+		}
+
+		if (segment != nullptr)
+		{
+			const float* start = pt[pLow] >= qt[qLow] ? pCut[pLow] : qCut[qLow];
+			const float* end = pt[1 - pLow] <= qt[1 - qLow] ? pCut[1 - pLow] : qCut[1 - qLow];
+
+			segment->start = Vector3{ start[0], start[1], start[2] };
+			segment->end = Vector3{ end[0], end[1], end[2] };
+		}
+
+		return true;
+	}
+
+	int Triangle::IntersectsBatch(const Triangle& triangle, span<const Triangle> others, span<int> hits)
+	{
+		const TrianglePlane plane(triangle);
+		const int count = static_cast<int>(others.size());
+		const int capacity = static_cast<int>(hits.size());
+
+		int found = 0;
+		for (int i = 0; i < count && found < capacity; ++i)
+		{
+			if (IntersectTriangles(plane, others[i], nullptr))
+			{
+				hits[found++] = i;
+			}
+		}
+
+		return found;
+	}
+
 	Triangle::Triangle()
 		: Triangle{ Vector3{ -1.f, 0.f, 0.f }, Vector3{ 0.f, 1.f, 0.f }, Vector3{ 1.f, 0.f, 0.f } }
 	{
@@ -53,19 +403,20 @@ namespace Nudge
 		const float magSqr2 = (point - c2).MagnitudeSqr();
 		const float magSqr3 = (point - c3).MagnitudeSqr();
 
-		if (magSqr1 < magSqr2 && magSqr1 < magSqr3)
+		// Ties occur when the nearest feature is a vertex shared by two edges
+		if (magSqr1 <= magSqr2 && magSqr1 <= magSqr3)
 		{
 			return c1;
 		}
 
-		return magSqr2 < magSqr1 && magSqr2 < magSqr3 ? c2 : c3;
+		return magSqr2 <= magSqr3 ? c2 : c3;
 	}
 
 	Vector3 Triangle::Barycentric(const Vector3& point) const
 	{
 		const Vector3 ap = point - a;
-		const Vector3 bp = point - a;
-		const Vector3 cp = point - a;
+		const Vector3 bp = point - b;
+		const Vector3 cp = point - c;
 
 		const Vector3 ab = b - a;
 		const Vector3 ac = c - a;
@@ -73,7 +424,7 @@ namespace Nudge
 		const Vector3 cb = b - c;
 		const Vector3 ca = a - c;
 
-		Vector3 v = ab - Vector3::Project(ab, ac);
+		Vector3 v = ab - Vector3::Project(ab, cb);
 		const float av = 1.f - Vector3::Dot(v, ap) / Vector3::Dot(v, ab);
 
 		v = bc - Vector3::Project(bc, ac);
@@ -124,6 +475,11 @@ namespace Nudge
 
 	bool Triangle::Intersects(const Triangle& other) const
 	{
-		return Interval::TriangleTriangle(*this, other);
+		return IntersectTriangles(TrianglePlane{ *this }, other, nullptr);
+	}
+
+	bool Triangle::Intersects(const Triangle& other, Line& segment) const
+	{
+		return IntersectTriangles(TrianglePlane{ *this }, other, &segment);
 	}
 }
@@ -0,0 +1,294 @@
+#include "Nudge/Shapes/TriangleCache.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Nudge
+{
+	/**
+	 * @brief Default constructor creating an empty cache
+	 */
+	TriangleCache::TriangleCache() = default;
+
+	/**
+	 * @brief Recomputes the cache from triangle data
+	 * @param triangles Triangles to precompute
+	 * @param count Number of triangles
+	 */
+	void TriangleCache::Build(const Triangle* triangles, const int count)
+	{
+		for (vector<float>* column : { &ax, &ay, &az, &e0x, &e0y, &e0z, &e1x, &e1y, &e1z, &nx, &ny, &nz, &distance, &d00, &d01, &d11, &inverseDenominator })
+		{
+			column->resize(std::max(count, 0));
+		}
+
+		Parallel::For(count, 4096, [&](const int, const int begin, const int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				const auto& v = triangles[i].values;
+
+				const float edge0[3] = { v[3] - v[0], v[4] - v[1], v[5] - v[2] };
+				const float edge1[3] = { v[6] - v[0], v[7] - v[1], v[8] - v[2] };
+				const float normal[3] =
+				{
+					edge0[1] * edge1[2] - edge0[2] * edge1[1],
+					edge0[2] * edge1[0] - edge0[0] * edge1[2],
+					edge0[0] * edge1[1] - edge0[1] * edge1[0]
+				};
+
+				ax[i] = v[0];
+				ay[i] = v[1];
+				az[i] = v[2];
+				e0x[i] = edge0[0];
+				e0y[i] = edge0[1];
+				e0z[i] = edge0[2];
+				e1x[i] = edge1[0];
+				e1y[i] = edge1[1];
+				e1z[i] = edge1[2];
+				nx[i] = normal[0];
+				ny[i] = normal[1];
+				nz[i] = normal[2];
+				distance[i] = normal[0] * v[0] + normal[1] * v[1] + normal[2] * v[2];
+
+				d00[i] = edge0[0] * edge0[0] + edge0[1] * edge0[1] + edge0[2] * edge0[2];
+				d01[i] = edge0[0] * edge1[0] + edge0[1] * edge1[1] + edge0[2] * edge1[2];
+				d11[i] = edge1[0] * edge1[0] + edge1[1] * edge1[1] + edge1[2] * edge1[2];
+
+				const float denominator = d00[i] * d11[i] - d01[i] * d01[i];
+				inverseDenominator[i] = denominator != 0.f ? 1.f / denominator : 0.f;
+			}
+		});
+	}
+
+	/**
+	 * @brief Removes all cached data
+	 */
+	void TriangleCache::Clear()
+	{
+		for (vector<float>* column : { &ax, &ay, &az, &e0x, &e0y, &e0z, &e1x, &e1y, &e1z, &nx, &ny, &nz, &distance, &d00, &d01, &d11, &inverseDenominator })
+		{
+			column->clear();
+		}
+	}
+
+	/**
+	 * @brief Number of triangles in the cache
+	 * @return Cached triangle count
+	 */
+	int TriangleCache::Count() const
+	{
+		return static_cast<int>(ax.size());
+	}
+
+	/**
+	 * @brief Casts a ray against one cached triangle
+	 * @param index Triangle index
+	 * @param origin Ray origin
+	 * @param direction Ray direction
+	 * @return Distance along the ray to the hit, or -1 if no intersection
+	 *
+	 * Algorithm:
+	 * 1. Intersect the supporting plane, rejecting back faces and hits behind the origin
+	 * 2. Solve for the hit's barycentric coordinates with the precomputed dot products
+	 */
+	float TriangleCache::CastRay(const int index, const Vector3& origin, const Vector3& direction) const
+	{
+		const float nd = direction.x * nx[index] + direction.y * ny[index] + direction.z * nz[index];
+		if (!(nd < 0.f))
+		{
+			return -1.f;
+		}
+
+		const float pn = origin.x * nx[index] + origin.y * ny[index] + origin.z * nz[index];
+		const float t = (distance[index] - pn) / nd;
+		if (t < 0.f)
+		{
+			return -1.f;
+		}
+
+		// Hit point relative to vertex a
+		const float px = origin.x + direction.x * t - ax[index];
+		const float py = origin.y + direction.y * t - ay[index];
+		const float pz = origin.z + direction.z * t - az[index];
+
+		const float d20 = px * e0x[index] + py * e0y[index] + pz * e0z[index];
+		const float d21 = px * e1x[index] + py * e1y[index] + pz * e1z[index];
+
+		const float v = (d11[index] * d20 - d01[index] * d21) * inverseDenominator[index];
+		const float w = (d00[index] * d21 - d01[index] * d20) * inverseDenominator[index];
+
+		if (v < 0.f || w < 0.f || v + w > 1.f || inverseDenominator[index] == 0.f)
+		{
+			return -1.f;
+		}
+
+		return t;
+	}
+
+	/**
+	 * @brief Tests one cached triangle against an axis-aligned box
+	 * @param index Triangle index
+	 * @param center Center of the box
+	 * @param extents Half-extents of the box
+	 * @return True if the triangle and box overlap
+	 *
+	 * Separating axis test of Akenine-Moller: the three box axes, the nine
+	 * cross products of box axes with triangle edges, then the triangle plane.
+	 * Touching counts as overlapping, as in Interval::TriangleAabb().
+	 */
+	bool TriangleCache::IntersectsAabb(const int index, const Vector3& center, const Vector3& extents) const
+	{
+		const float hx = std::abs(extents.x);
+		const float hy = std::abs(extents.y);
+		const float hz = std::abs(extents.z);
+
+		// Vertices relative to the box center
+		const float v0[3] = { ax[index] - center.x, ay[index] - center.y, az[index] - center.z };
+		const float v1[3] = { v0[0] + e0x[index], v0[1] + e0y[index], v0[2] + e0z[index] };
+		const float v2[3] = { v0[0] + e1x[index], v0[1] + e1y[index], v0[2] + e1z[index] };
+
+		// Box face normals
+		const float* vertices[3] = { v0, v1, v2 };
+		const float half[3] = { hx, hy, hz };
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float min = std::min(v0[axis], std::min(v1[axis], v2[axis]));
+			const float max = std::max(v0[axis], std::max(v1[axis], v2[axis]));
+
+			if (min > half[axis] || max < -half[axis])
+			{
+				return false;
+			}
+		}
+
+		// Box axes crossed with the triangle edges
+		const float edges[3][3] =
+		{
+			{ e0x[index], e0y[index], e0z[index] },
+			{ e1x[index] - e0x[index], e1y[index] - e0y[index], e1z[index] - e0z[index] },
+			{ e1x[index], e1y[index], e1z[index] }
+		};
+
+		auto separated = [&](const float p0, const float p1, const float p2, const float radius)
+		{
+			return std::min(p0, std::min(p1, p2)) > radius || std::max(p0, std::max(p1, p2)) < -radius;
+		};
+
+		for (const float* f : edges)
+		{
+			// X cross f = (0, -f.z, f.y)
+			if (separated(-f[2] * vertices[0][1] + f[1] * vertices[0][2],
+			              -f[2] * vertices[1][1] + f[1] * vertices[1][2],
+			              -f[2] * vertices[2][1] + f[1] * vertices[2][2],
+			              hy * std::abs(f[2]) + hz * std::abs(f[1])))
+			{
+				return false;
+			}
+
+			// Y cross f = (f.z, 0, -f.x)
+			if (separated(f[2] * vertices[0][0] - f[0] * vertices[0][2],
+			              f[2] * vertices[1][0] - f[0] * vertices[1][2],
+			              f[2] * vertices[2][0] - f[0] * vertices[2][2],
+			              hx * std::abs(f[2]) + hz * std::abs(f[0])))
+			{
+				return false;
+			}
+
+			// Z cross f = (-f.y, f.x, 0)
+			if (separated(-f[1] * vertices[0][0] + f[0] * vertices[0][1],
+			              -f[1] * vertices[1][0] + f[0] * vertices[1][1],
+			              -f[1] * vertices[2][0] + f[0] * vertices[2][1],
+			              hx * std::abs(f[1]) + hy * std::abs(f[0])))
+			{
+				return false;
+			}
+		}
+
+		// Triangle plane against the box
+		const float radius = hx * std::abs(nx[index]) + hy * std::abs(ny[index]) + hz * std::abs(nz[index]);
+		const float offset = nx[index] * v0[0] + ny[index] * v0[1] + nz[index] * v0[2];
+
+		return std::abs(offset) <= radius;
+	}
+
+	/**
+	 * @brief Tests one cached triangle against a sphere
+	 * @param index Triangle index
+	 * @param center Center of the sphere
+	 * @param radius Radius of the sphere
+	 * @return True if the closest point of the triangle lies strictly inside the sphere
+	 *
+	 * Finds the closest point by Voronoi region (Ericson, Real-Time Collision
+	 * Detection 5.1.5), expressed as a + s * e0 + t * e1.
+	 */
+	bool TriangleCache::IntersectsSphere(const int index, const Vector3& center, const float radius) const
+	{
+		const float ab[3] = { e0x[index], e0y[index], e0z[index] };
+		const float ac[3] = { e1x[index], e1y[index], e1z[index] };
+		const float ap[3] = { center.x - ax[index], center.y - ay[index], center.z - az[index] };
+
+		auto dot = [](const float* u, const float* v)
+		{
+			return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+		};
+
+		const float d1 = dot(ab, ap);
+		const float d2 = dot(ac, ap);
+
+		// Edge dot products are cached: dot(ab, bp) = d1 - d00 and so on
+		const float d3 = d1 - d00[index];
+		const float d4 = d2 - d01[index];
+		const float d5 = d1 - d01[index];
+		const float d6 = d2 - d11[index];
+
+		float s = 0.f;
+		float t = 0.f;
+
+		const float vc = d1 * d4 - d3 * d2;
+		const float vb = d5 * d2 - d1 * d6;
+		const float va = d3 * d6 - d5 * d4;
+
+		if (d1 <= 0.f && d2 <= 0.f)
+		{
+			// Vertex a
+		}
+		else if (d3 >= 0.f && d4 <= d3)
+		{
+			s = 1.f;
+		}
+		else if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+		{
+			s = d1 / (d1 - d3);
+		}
+		else if (d6 >= 0.f && d5 <= d6)
+		{
+			t = 1.f;
+		}
+		else if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+		{
+			t = d2 / (d2 - d6);
+		}
+		else if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f)
+		{
+			t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			s = 1.f - t;
+		}
+		else
+		{
+			const float denominator = 1.f / (va + vb + vc);
+			s = vb * denominator;
+			t = vc * denominator;
+		}
+
+		const float dx = ap[0] - ab[0] * s - ac[0] * t;
+		const float dy = ap[1] - ab[1] * s - ac[1] * t;
+		const float dz = ap[2] - ab[2] * s - ac[2] * t;
+
+		return dx * dx + dy * dy + dz * dz < radius * radius;
+	}
+}
@@ -0,0 +1,362 @@
+#include "Nudge/Shapes/TriggerSystem.hpp"
+
+#include "Nudge/Shapes/Bvh.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+
+namespace Nudge
+{
+	/**
+	 * @brief Computes the box enclosing a shape
+	 * @param shape Shape to bound
+	 * @param bounds Receives the box
+	 * @return False for planes, which have no finite bounds
+	 */
+	static bool ShapeBounds(const Shape& shape, Aabb& bounds)
+	{
+		return std::visit([&](const auto& primitive)
+		{
+			using Primitive = std::decay_t<decltype(primitive)>;
+
+			if constexpr (std::is_same_v<Primitive, Plane>)
+			{
+				return false;
+			}
+			else
+			{
+				bounds = BvhTraits<Primitive>::Bounds(primitive);
+				return true;
+			}
+		}, shape.value);
+	}
+
+	/**
+	 * @brief Removes one id from an overlap list
+	 * @param overlaps List to edit
+	 * @param id Id to remove; the list order is not kept
+	 */
+	static void Unlink(vector<int>& overlaps, const int id)
+	{
+		const auto found = std::find(overlaps.begin(), overlaps.end(), id);
+		if (found != overlaps.end())
+		{
+			*found = overlaps.back();
+			overlaps.pop_back();
+		}
+	}
+
+	/**
+	 * @brief Default constructor creating a free slot
+	 */
+	TriggerVolume::TriggerVolume()
+		: proxy{ -1 }, stamp{ 0 }, isTrigger{ false }, live{ false }, dirty{ false }
+	{
+	}
+
+	/**
+	 * @brief Default constructor creating an empty system over the default LooseOctree region
+	 */
+	TriggerSystem::TriggerSystem()
+		: epoch{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Creates an empty system whose trees cover a cubic region
+	 * @param center Center of the region
+	 * @param halfSize Half the edge length of the region
+	 */
+	TriggerSystem::TriggerSystem(const Vector3& center, const float halfSize)
+		: triggerTree{ center, halfSize }, bodyTree{ center, halfSize }, epoch{ 0 }
+	{
+	}
+
+	/**
+	 * @brief Adds a volume of either kind
+	 * @param system System to add to
+	 * @param shape Shape of the volume
+	 * @param isTrigger Kind of the volume
+	 * @return Id of the volume, or -1 if the shape is unbounded
+	 */
+	static int AddVolume(TriggerSystem& system, const Shape& shape, const bool isTrigger)
+	{
+		Aabb bounds;
+		if (!ShapeBounds(shape, bounds))
+		{
+			return -1;
+		}
+
+		int id;
+		if (!system.freeVolumes.empty())
+		{
+			id = system.freeVolumes.back();
+			system.freeVolumes.pop_back();
+		}
+		else
+		{
+			id = static_cast<int>(system.volumes.size());
+			system.volumes.emplace_back();
+			system.shapes.emplace_back();
+		}
+
+		LooseOctree& tree = isTrigger ? system.triggerTree : system.bodyTree;
+		vector<int>& owners = isTrigger ? system.triggerOwners : system.bodyOwners;
+
+		TriggerVolume& volume = system.volumes[id];
+		volume.bounds = bounds;
+		volume.proxy = tree.Insert(bounds);
+		volume.isTrigger = isTrigger;
+		volume.live = true;
+		volume.dirty = true;
+		volume.overlaps.clear();
+		system.shapes[id] = shape;
+		system.changed.push_back(id);
+
+		if (volume.proxy >= static_cast<int>(owners.size()))
+		{
+			owners.resize(volume.proxy + 1, -1);
+		}
+
+		owners[volume.proxy] = id;
+		return id;
+	}
+
+	/**
+	 * @brief Adds a trigger volume
+	 * @param shape Region of the trigger
+	 * @return Id of the trigger, or -1 if the shape is unbounded
+	 */
+	int TriggerSystem::AddTrigger(const Shape& shape)
+	{
+		return AddVolume(*this, shape, true);
+	}
+
+	/**
+	 * @brief Adds a body that can enter triggers
+	 * @param shape Shape of the body
+	 * @return Id of the body, or -1 if the shape is unbounded
+	 */
+	int TriggerSystem::AddBody(const Shape& shape)
+	{
+		return AddVolume(*this, shape, false);
+	}
+
+	/**
+	 * @brief Changes the shape of a trigger or body
+	 * @param id Id returned by AddTrigger() or AddBody()
+	 * @param shape New shape
+	 */
+	void TriggerSystem::Move(const int id, const Shape& shape)
+	{
+		Aabb bounds;
+		if (id < 0 || id >= static_cast<int>(volumes.size()) || !volumes[id].live || !ShapeBounds(shape, bounds))
+		{
+			return;
+		}
+
+		TriggerVolume& volume = volumes[id];
+		volume.bounds = bounds;
+		shapes[id] = shape;
+		(volume.isTrigger ? triggerTree : bodyTree).Move(volume.proxy, bounds);
+
+		if (!volume.dirty)
+		{
+			volume.dirty = true;
+			changed.push_back(id);
+		}
+	}
+
+	/**
+	 * @brief Removes a trigger or body
+	 * @param id Id returned by AddTrigger() or AddBody()
+	 */
+	void TriggerSystem::Remove(const int id)
+	{
+		if (id < 0 || id >= static_cast<int>(volumes.size()) || !volumes[id].live)
+		{
+			return;
+		}
+
+		TriggerVolume& volume = volumes[id];
+		(volume.isTrigger ? triggerTree : bodyTree).Remove(volume.proxy);
+		(volume.isTrigger ? triggerOwners : bodyOwners)[volume.proxy] = -1;
+		volume.proxy = -1;
+		volume.live = false;
+
+		if (!volume.dirty)
+		{
+			volume.dirty = true;
+			changed.push_back(id);
+		}
+	}
+
+	/**
+	 * @brief Re-tests the pairs of every volume changed since the last call and reports the differences
+	 * @param events Receives one event per pair that entered or exited, appended
+	 * @return Number of events appended
+	 *
+	 * Algorithm:
+	 * 1. Removed volumes report an exit for each stored pair and leave their
+	 *    partners' lists, before anything else can pair with them
+	 * 2. For each changed volume, stamp its stored partners, then query the
+	 *    other kind's tree: every volume found becomes a candidate, flagged as
+	 *    previously overlapping if stamped. Partners left stamped no longer
+	 *    share bounds and exit without an exact test. A pair in which both
+	 *    volumes changed is handled from the trigger's side only
+	 * 3. Test all candidates in one Shape::IntersectsBatch() call
+	 * 4. Enter or exit the candidates whose result differs from before
+	 * 5. Clear the change marks and free the ids of removed volumes
+	 */
+	int TriggerSystem::Update(vector<TriggerEvent>& events)
+	{
+		const size_t start = events.size();
+
+		for (const int id : changed)
+		{
+			TriggerVolume& volume = volumes[id];
+			if (volume.live)
+			{
+				continue;
+			}
+
+			for (const int partner : volume.overlaps)
+			{
+				Unlink(volumes[partner].overlaps, id);
+				events.push_back(volume.isTrigger ? TriggerEvent{ id, partner, TriggerEventType::Exit } : TriggerEvent{ partner, id, TriggerEventType::Exit });
+			}
+
+			volume.overlaps.clear();
+		}
+
+		candidates.clear();
+		previous.clear();
+
+		for (const int id : changed)
+		{
+			if (!volumes[id].live)
+			{
+				continue;
+			}
+
+			const bool isTrigger = volumes[id].isTrigger;
+			const int stamp = ++epoch;
+
+			// Bodies leave pairs with changed triggers to the trigger's pass
+			const auto handles = [&](const int partner)
+			{
+				return isTrigger || !volumes[partner].dirty;
+			};
+
+			for (const int partner : volumes[id].overlaps)
+			{
+				if (handles(partner))
+				{
+					volumes[partner].stamp = stamp;
+				}
+			}
+
+			const vector<int>& owners = isTrigger ? bodyOwners : triggerOwners;
+			(isTrigger ? bodyTree : triggerTree).Query(volumes[id].bounds, [&](const int proxy)
+			{
+				const int partner = owners[proxy];
+				if (!handles(partner))
+				{
+					return false;
+				}
+
+				TriggerVolume& other = volumes[partner];
+				previous.push_back(other.stamp == stamp ? 1 : 0);
+				candidates.push_back(isTrigger ? ShapePair{ id, partner } : ShapePair{ partner, id });
+				other.stamp = 0;
+				return false;
+			});
+
+			vector<int>& overlaps = volumes[id].overlaps;
+			for (size_t i = 0; i < overlaps.size();)
+			{
+				const int partner = overlaps[i];
+				if (volumes[partner].stamp != stamp)
+				{
+					++i;
+					continue;
+				}
+
+				volumes[partner].stamp = 0;
+				Unlink(volumes[partner].overlaps, id);
+				overlaps[i] = overlaps.back();
+				overlaps.pop_back();
+				events.push_back(isTrigger ? TriggerEvent{ id, partner, TriggerEventType::Exit } : TriggerEvent{ partner, id, TriggerEventType::Exit });
+			}
+		}
+
+		results.resize(candidates.size());
+		Shape::IntersectsBatch(shapes, candidates, results);
+
+		for (size_t i = 0; i < candidates.size(); ++i)
+		{
+			if (results[i] == previous[i])
+			{
+				continue;
+			}
+
+			const int trigger = candidates[i].first;
+			const int body = candidates[i].second;
+
+			if (results[i] != 0)
+			{
+				volumes[trigger].overlaps.push_back(body);
+				volumes[body].overlaps.push_back(trigger);
+				events.push_back({ trigger, body, TriggerEventType::Enter });
+			}
+			else
+			{
+				Unlink(volumes[trigger].overlaps, body);
+				Unlink(volumes[body].overlaps, trigger);
+				events.push_back({ trigger, body, TriggerEventType::Exit });
+			}
+		}
+
+		for (const int id : changed)
+		{
+			volumes[id].dirty = false;
+			if (!volumes[id].live)
+			{
+				freeVolumes.push_back(id);
+			}
+		}
+
+		changed.clear();
+
+		return static_cast<int>(events.size() - start);
+	}
+
+	/**
+	 * @brief Tests whether a body overlapped a trigger at the last Update()
+	 * @param trigger Trigger id
+	 * @param body Body id
+	 * @return True if the pair is in the overlapping state
+	 */
+	bool TriggerSystem::Overlaps(const int trigger, const int body) const
+	{
+		const span<const int> bodies = Overlapping(trigger);
+
+		return std::find(bodies.begin(), bodies.end(), body) != bodies.end() && volumes[trigger].isTrigger;
+	}
+
+	/**
+	 * @brief Volumes of the other kind a volume overlapped at the last Update()
+	 * @param id Trigger or body id
+	 * @return Ids of the overlapped volumes (empty for unknown ids)
+	 */
+	span<const int> TriggerSystem::Overlapping(const int id) const
+	{
+		if (id < 0 || id >= static_cast<int>(volumes.size()))
+		{
+			return {};
+		}
+
+		return volumes[id].overlaps;
+	}
+}
@@ -0,0 +1,542 @@
+#include "Nudge/Shapes/VoxelGrid.hpp"
+
+#include "Nudge/Core/Parallel.hpp"
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Bvh.hpp"
+#include "Nudge/Shapes/Interval.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+using std::pair;
+
+// Fraction of a voxel each voxel box is enlarged by when testing triangles,
+// so rounding never leaves a point of a triangle in an empty voxel
+constexpr float VOXEL_GRID_MARGIN = 1e-3f;
+
+// Mask bits per voxel step along each axis, and the brick-wide pattern that
+// repeats a one-row, one-layer or one-brick selection across the brick
+constexpr int VOXEL_GRID_AXIS_BITS[3] = { 1, VOXEL_GRID_BRICK_SIZE, VOXEL_GRID_BRICK_SIZE * VOXEL_GRID_BRICK_SIZE };
+constexpr uint64_t VOXEL_GRID_AXIS_REPEAT[3] = { 0x1111111111111111ull, 0x0001000100010001ull, 1ull };
+
+namespace Nudge
+{
+	/**
+	 * @brief Voxel coordinate containing a grid-relative position along one axis
+	 * @param grid Grid to index
+	 * @param offset Position relative to grid.origin
+	 * @return Voxel index, unclamped
+	 */
+	static int VoxelIndex(const VoxelGrid& grid, const float offset)
+	{
+		return static_cast<int>(std::floor(offset / grid.voxelSize));
+	}
+
+	/**
+	 * @brief Bit of a voxel within its brick's mask
+	 * @param x Voxel column
+	 * @param y Voxel row
+	 * @param z Voxel layer
+	 * @return Single-bit mask
+	 */
+	static uint64_t VoxelBit(const int x, const int y, const int z)
+	{
+		constexpr int local = VOXEL_GRID_BRICK_SIZE - 1;
+
+		return 1ull << ((x & local) + VOXEL_GRID_BRICK_SIZE * ((y & local) + VOXEL_GRID_BRICK_SIZE * (z & local)));
+	}
+
+	/**
+	 * @brief Mask selecting the voxels of a brick within a coordinate range along one axis
+	 * @param axis Axis of the range
+	 * @param first First selected coordinate inside the brick, in [0, VOXEL_GRID_BRICK_SIZE)
+	 * @param last Last selected coordinate inside the brick, in [first, VOXEL_GRID_BRICK_SIZE)
+	 * @return Mask of every voxel whose coordinate along the axis lies in [first, last]
+	 */
+	static uint64_t AxisMask(const int axis, const int first, const int last)
+	{
+		const int bits = VOXEL_GRID_AXIS_BITS[axis];
+		const int width = (last - first + 1) * bits;
+		const uint64_t run = width >= 64 ? ~0ull : ((1ull << width) - 1) << (first * bits);
+
+		return run * VOXEL_GRID_AXIS_REPEAT[axis];
+	}
+
+	/**
+	 * @brief Steps a ray through a block of cubic cells in the order it crosses them
+	 * @param origin Ray origin relative to the cell grid's corner
+	 * @param direction Ray direction
+	 * @param start Distance at which the ray enters the block
+	 * @param end Distance beyond which cells are not visited
+	 * @param cellSize Edge length of a cell
+	 * @param first First cell of the block along each axis
+	 * @param last One past the last cell of the block along each axis
+	 * @param visit Called as visit(cell, distance) with the cell coordinates and the
+	 *              distance at which the ray enters it; returns true to stop
+	 * @return True if visit stopped the walk
+	 */
+	template <typename Visit>
+	static bool March(const float* origin, const float* direction, const float start, const float end, const float cellSize, const int* first, const int* last, Visit&& visit)
+	{
+		int cell[3];
+		int step[3];
+		float next[3];
+		float delta[3];
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float position = origin[axis] + direction[axis] * start;
+			cell[axis] = std::clamp(static_cast<int>(std::floor(position / cellSize)), first[axis], last[axis] - 1);
+
+			if (direction[axis] == 0.f)
+			{
+				step[axis] = 0;
+				next[axis] = std::numeric_limits<float>::infinity();
+				delta[axis] = std::numeric_limits<float>::infinity();
+				continue;
+			}
+
+			step[axis] = direction[axis] > 0.f ? 1 : -1;
+			const float boundary = (cell[axis] + (step[axis] > 0 ? 1 : 0)) * cellSize;
+			next[axis] = (boundary - origin[axis]) / direction[axis];
+			delta[axis] = cellSize / MathF::Abs(direction[axis]);
+		}
+
+		float distance = start;
+
+		while (true)
+		{
+			if (visit(cell, distance))
+			{
+				return true;
+			}
+
+			const int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+			if (!(next[axis] <= end))
+			{
+				return false;
+			}
+
+			distance = std::max(distance, next[axis]);
+			cell[axis] += step[axis];
+			next[axis] += delta[axis];
+
+			if (cell[axis] < first[axis] || cell[axis] >= last[axis])
+			{
+				return false;
+			}
+		}
+	}
+
+	/**
+	 * @brief Visits the occupied voxels of each non-empty brick a box touches
+	 * @param grid Grid to query
+	 * @param region World-space box
+	 * @param visit Called with the occupied voxels of one brick inside the region
+	 *              (possibly none); returns true to stop
+	 * @return True if visit stopped the walk
+	 */
+	template <typename Visit>
+	static bool VisitRegion(const VoxelGrid& grid, const Aabb& region, Visit&& visit)
+	{
+		if (grid.IsEmpty())
+		{
+			return false;
+		}
+
+		const Vector3 min = region.Min() - grid.origin;
+		const Vector3 max = region.Max() - grid.origin;
+		const float low[3] = { min.x, min.y, min.z };
+		const float high[3] = { max.x, max.y, max.z };
+
+		int first[3];
+		int last[3];
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			first[axis] = VoxelIndex(grid, low[axis]);
+			last[axis] = VoxelIndex(grid, high[axis]);
+
+			if (last[axis] < 0 || first[axis] >= grid.size[axis])
+			{
+				return false;
+			}
+
+			first[axis] = std::max(first[axis], 0);
+			last[axis] = std::min(last[axis], grid.size[axis] - 1);
+		}
+
+		for (int bz = first[2] / VOXEL_GRID_BRICK_SIZE; bz <= last[2] / VOXEL_GRID_BRICK_SIZE; ++bz)
+		{
+			for (int by = first[1] / VOXEL_GRID_BRICK_SIZE; by <= last[1] / VOXEL_GRID_BRICK_SIZE; ++by)
+			{
+				for (int bx = first[0] / VOXEL_GRID_BRICK_SIZE; bx <= last[0] / VOXEL_GRID_BRICK_SIZE; ++bx)
+				{
+					const int index = grid.brickIndices[(static_cast<size_t>(bz) * grid.bricks[1] + by) * grid.bricks[0] + bx];
+					if (index < 0)
+					{
+						continue;
+					}
+
+					// Intersect the per-axis slices of the region inside this brick
+					const int brick[3] = { bx, by, bz };
+					uint64_t selection = ~0ull;
+
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						const int base = brick[axis] * VOXEL_GRID_BRICK_SIZE;
+						const int from = std::max(first[axis] - base, 0);
+						const int to = std::min(last[axis] - base, VOXEL_GRID_BRICK_SIZE - 1);
+						selection &= AxisMask(axis, from, to);
+					}
+
+					if (visit(grid.masks[index] & selection))
+					{
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Default constructor creating an empty grid
+	 */
+	VoxelGrid::VoxelGrid()
+		: origin{ 0.f }, voxelSize{ 1.f }, size{ 0, 0, 0 }, bricks{ 0, 0, 0 }
+	{
+	}
+
+	/**
+	 * @brief Voxelizes triangles
+	 * @param triangles Triangles to voxelize
+	 * @param voxelSize Edge length of a voxel
+	 */
+	VoxelGrid::VoxelGrid(const span<const Triangle> triangles, const float voxelSize)
+		: VoxelGrid()
+	{
+		if (triangles.empty() || !(voxelSize > 0.f))
+		{
+			return;
+		}
+
+		const int count = static_cast<int>(triangles.size());
+		vector<Aabb> bounds;
+		GatherBvhInputs(triangles.data(), count, bounds, nullptr);
+
+		Vector3 min = bounds[0].Min();
+		Vector3 max = bounds[0].Max();
+
+		for (const Aabb& box : bounds)
+		{
+			min = Vector3::Min(min, box.Min());
+			max = Vector3::Max(max, box.Max());
+		}
+
+		const float margin = voxelSize * VOXEL_GRID_MARGIN;
+		this->voxelSize = voxelSize;
+		origin = min - Vector3{ margin };
+
+		const Vector3 extent = max - origin;
+		const float extents[3] = { extent.x, extent.y, extent.z };
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			bricks[axis] = VoxelIndex(*this, extents[axis] + margin) / VOXEL_GRID_BRICK_SIZE + 1;
+			size[axis] = bricks[axis] * VOXEL_GRID_BRICK_SIZE;
+		}
+
+		// Sort triangles into every layer of bricks along z their bounds reach
+		vector<int> layerStarts(static_cast<size_t>(bricks[2]) + 1, 0);
+		vector<pair<int, int>> layerRanges(count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			const int low = VoxelIndex(*this, bounds[i].Min().z - origin.z - margin) / VOXEL_GRID_BRICK_SIZE;
+			const int high = VoxelIndex(*this, bounds[i].Max().z - origin.z + margin) / VOXEL_GRID_BRICK_SIZE;
+			layerRanges[i] = { std::clamp(low, 0, bricks[2] - 1), std::clamp(high, 0, bricks[2] - 1) };
+
+			for (int layer = layerRanges[i].first; layer <= layerRanges[i].second; ++layer)
+			{
+				++layerStarts[layer + 1];
+			}
+		}
+
+		for (int layer = 0; layer < bricks[2]; ++layer)
+		{
+			layerStarts[layer + 1] += layerStarts[layer];
+		}
+
+		vector<int> layerTriangles(layerStarts.back());
+		vector<int> cursor(layerStarts.begin(), layerStarts.end() - 1);
+
+		for (int i = 0; i < count; ++i)
+		{
+			for (int layer = layerRanges[i].first; layer <= layerRanges[i].second; ++layer)
+			{
+				layerTriangles[cursor[layer]++] = i;
+			}
+		}
+
+		// Each layer writes only its own bricks, so layers fill in parallel
+		const int layerBricks = bricks[0] * bricks[1];
+		vector<vector<pair<int, uint64_t>>> layerMasks(bricks[2]);
+		const Vector3 halfVoxel{ voxelSize * .5f + margin };
+
+		Parallel::For(bricks[2], 1, [&](const int, const int begin, const int end)
+		{
+			vector<uint64_t> dense(layerBricks);
+
+			for (int layer = begin; layer < end; ++layer)
+			{
+				std::fill(dense.begin(), dense.end(), 0ull);
+
+				const int layerFirst = layer * VOXEL_GRID_BRICK_SIZE;
+				const int layerLast = layerFirst + VOXEL_GRID_BRICK_SIZE - 1;
+
+				for (int slot = layerStarts[layer]; slot < layerStarts[layer + 1]; ++slot)
+				{
+					const int i = layerTriangles[slot];
+					const Vector3 low = bounds[i].Min() - origin - Vector3{ margin };
+					const Vector3 high = bounds[i].Max() - origin + Vector3{ margin };
+
+					const int x0 = std::max(VoxelIndex(*this, low.x), 0);
+					const int x1 = std::min(VoxelIndex(*this, high.x), size[0] - 1);
+					const int y0 = std::max(VoxelIndex(*this, low.y), 0);
+					const int y1 = std::min(VoxelIndex(*this, high.y), size[1] - 1);
+					const int z0 = std::max(VoxelIndex(*this, low.z), layerFirst);
+					const int z1 = std::min(VoxelIndex(*this, high.z), layerLast);
+
+					for (int z = z0; z <= z1; ++z)
+					{
+						for (int y = y0; y <= y1; ++y)
+						{
+							for (int x = x0; x <= x1; ++x)
+							{
+								uint64_t& mask = dense[(y / VOXEL_GRID_BRICK_SIZE) * bricks[0] + x / VOXEL_GRID_BRICK_SIZE];
+								const uint64_t bit = VoxelBit(x, y, z);
+
+								if ((mask & bit) != 0)
+								{
+									continue;
+								}
+
+								const Vector3 center = origin + Vector3{ (x + .5f) * voxelSize, (y + .5f) * voxelSize, (z + .5f) * voxelSize };
+								if (Interval::TriangleAabb(triangles[i], Aabb{ center, halfVoxel }))
+								{
+									mask |= bit;
+								}
+							}
+						}
+					}
+				}
+
+				for (int brick = 0; brick < layerBricks; ++brick)
+				{
+					if (dense[brick] != 0)
+					{
+						layerMasks[layer].emplace_back(brick, dense[brick]);
+					}
+				}
+			}
+		});
+
+		brickIndices.assign(static_cast<size_t>(layerBricks) * bricks[2], -1);
+
+		for (int layer = 0; layer < bricks[2]; ++layer)
+		{
+			for (const auto& [brick, mask] : layerMasks[layer])
+			{
+				brickIndices[static_cast<size_t>(layer) * layerBricks + brick] = static_cast<int>(masks.size());
+				masks.push_back(mask);
+			}
+		}
+	}
+
+	/**
+	 * @brief Voxelizes the triangles of a mesh
+	 * @param mesh Mesh to voxelize
+	 * @param voxelSize Edge length of a voxel
+	 */
+	VoxelGrid::VoxelGrid(const Mesh& mesh, const float voxelSize)
+		: VoxelGrid(span<const Triangle>{ mesh.triangles, static_cast<size_t>(std::max(mesh.numTriangles, 0)) }, voxelSize)
+	{
+	}
+
+	/**
+	 * @brief Tests whether the grid has any voxels
+	 * @return True if the grid was not built from valid input
+	 */
+	bool VoxelGrid::IsEmpty() const
+	{
+		return brickIndices.empty();
+	}
+
+	/**
+	 * @brief Tests whether a voxel is occupied
+	 * @param x Voxel column
+	 * @param y Voxel row
+	 * @param z Voxel layer
+	 * @return True if the voxel is inside the grid and occupied
+	 */
+	bool VoxelGrid::IsOccupied(const int x, const int y, const int z) const
+	{
+		if (x < 0 || y < 0 || z < 0 || x >= size[0] || y >= size[1] || z >= size[2])
+		{
+			return false;
+		}
+
+		const int bx = x / VOXEL_GRID_BRICK_SIZE;
+		const int by = y / VOXEL_GRID_BRICK_SIZE;
+		const int bz = z / VOXEL_GRID_BRICK_SIZE;
+		const int index = brickIndices[(static_cast<size_t>(bz) * bricks[1] + by) * bricks[0] + bx];
+
+		return index >= 0 && (masks[index] & VoxelBit(x, y, z)) != 0;
+	}
+
+	/**
+	 * @brief Tests whether the voxel containing a point is occupied
+	 * @param point World position
+	 * @return True if the point lies in an occupied voxel
+	 */
+	bool VoxelGrid::IsOccupied(const Vector3& point) const
+	{
+		const Vector3 offset = point - origin;
+
+		return IsOccupied(VoxelIndex(*this, offset.x), VoxelIndex(*this, offset.y), VoxelIndex(*this, offset.z));
+	}
+
+	/**
+	 * @brief Number of occupied voxels
+	 * @return Sum of the population counts of every brick
+	 */
+	int VoxelGrid::OccupiedCount() const
+	{
+		int total = 0;
+
+		for (const uint64_t mask : masks)
+		{
+			total += std::popcount(mask);
+		}
+
+		return total;
+	}
+
+	/**
+	 * @brief Box enclosing the whole grid
+	 * @return World-space bounds
+	 */
+	Aabb VoxelGrid::Bounds() const
+	{
+		return Aabb::FromMinMax(origin, origin + Vector3{ size[0] * voxelSize, size[1] * voxelSize, size[2] * voxelSize });
+	}
+
+	/**
+	 * @brief Tests whether any voxel touching a box is occupied
+	 * @param region World-space box
+	 * @return True if the region may contain geometry
+	 */
+	bool VoxelGrid::Overlaps(const Aabb& region) const
+	{
+		return VisitRegion(*this, region, [](const uint64_t occupied)
+		{
+			return occupied != 0;
+		});
+	}
+
+	/**
+	 * @brief Counts the occupied voxels touching a box
+	 * @param region World-space box
+	 * @return Number of occupied voxels overlapping the region
+	 */
+	int VoxelGrid::CountOccupied(const Aabb& region) const
+	{
+		int total = 0;
+
+		VisitRegion(*this, region, [&](const uint64_t occupied)
+		{
+			total += std::popcount(occupied);
+			return false;
+		});
+
+		return total;
+	}
+
+	/**
+	 * @brief Finds the first occupied voxel along a ray
+	 * @param ray Ray to cast
+	 * @param maxDistance Voxels entered beyond this distance are ignored
+	 * @return Distance at which the ray enters the voxel (0 if it starts inside), or -1 if there is none
+	 */
+	float VoxelGrid::CastRay(const Ray& ray, const float maxDistance) const
+	{
+		if (IsEmpty())
+		{
+			return -1.f;
+		}
+
+		const PreparedRay prepared{ ray, maxDistance };
+		const Aabb box = Bounds();
+
+		float enter;
+		float exit;
+		if (!prepared.Clip(box.Min(), box.Max(), enter, exit))
+		{
+			return -1.f;
+		}
+
+		const float start = std::max(enter, 0.f);
+		const float end = std::min(exit, maxDistance);
+		if (!(start <= end))
+		{
+			return -1.f;
+		}
+
+		const float local[3] = { prepared.origin[0] - origin.x, prepared.origin[1] - origin.y, prepared.origin[2] - origin.z };
+		const int none[3] = { 0, 0, 0 };
+		float hit = -1.f;
+
+		March(local, prepared.direction, start, end, voxelSize * VOXEL_GRID_BRICK_SIZE, none, bricks, [&](const int* brick, const float brickEntry)
+		{
+			const int index = brickIndices[(static_cast<size_t>(brick[2]) * bricks[1] + brick[1]) * bricks[0] + brick[0]];
+			if (index < 0)
+			{
+				return false;
+			}
+
+			const uint64_t mask = masks[index];
+			const int first[3] = { brick[0] * VOXEL_GRID_BRICK_SIZE, brick[1] * VOXEL_GRID_BRICK_SIZE, brick[2] * VOXEL_GRID_BRICK_SIZE };
+			const int last[3] = { first[0] + VOXEL_GRID_BRICK_SIZE, first[1] + VOXEL_GRID_BRICK_SIZE, first[2] + VOXEL_GRID_BRICK_SIZE };
+
+			return March(local, prepared.direction, brickEntry, end, voxelSize, first, last, [&](const int* voxel, const float voxelEntry)
+			{
+				if ((mask & VoxelBit(voxel[0], voxel[1], voxel[2])) == 0)
+				{
+					return false;
+				}
+
+				hit = voxelEntry;
+				return true;
+			});
+		});
+
+		return hit;
+	}
+
+	/**
+	 * @brief Memory held by the brick indices and masks
+	 * @return Size in bytes
+	 */
+	size_t VoxelGrid::ByteSize() const
+	{
+		return brickIndices.size() * sizeof(int) + masks.size() * sizeof(uint64_t);
+	}
+}
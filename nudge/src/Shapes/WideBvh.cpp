@@ -0,0 +1,484 @@
+#include "Nudge/Shapes/WideBvh.hpp"
+
+#include "Nudge/Shapes/LinearBvh.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using std::numeric_limits;
+
+// Number of quantization steps across a node's bounds (8-bit planes)
+constexpr int WIDE_BVH_STEPS = 255;
+
+namespace Nudge
+{
+	/**
+	 * @brief Converts a quantized plane back to world space
+	 *
+	 * Used by both the builder and the queries so they agree on rounding.
+	 */
+	static float Dequantize(const float origin, const int plane, const float scale)
+	{
+		return origin + static_cast<float>(plane) * scale;
+	}
+
+	/**
+	 * @brief Surface area of a binary node, used to pick which child to open next
+	 */
+	static float SurfaceArea(const LinearBvhNode& node)
+	{
+		const float x = node.max.x - node.min.x;
+		const float y = node.max.y - node.min.y;
+		const float z = node.max.z - node.min.z;
+
+		return x * y + y * z + z * x;
+	}
+
+	/**
+	 * @brief Records the first index slot and primitive count of every binary subtree
+	 * @param binary Source hierarchy
+	 * @param index Subtree root
+	 * @param first Receives the first slot in binary.indices per node
+	 * @param total Receives the primitive count per node
+	 */
+	static void Measure(const LinearBvh& binary, const int index, vector<int>& first, vector<int>& total)
+	{
+		const LinearBvhNode& node = binary.nodes[index];
+
+		if (node.IsLeaf())
+		{
+			first[index] = node.left;
+			total[index] = node.Count();
+			return;
+		}
+
+		Measure(binary, node.left, first, total);
+		Measure(binary, node.right, first, total);
+
+		first[index] = first[node.left];
+		total[index] = total[node.left] + total[node.right];
+	}
+
+	/**
+	 * @brief Emits the wide node for one binary subtree, recursing into internal children
+	 * @param binary Source hierarchy
+	 * @param first First slot in binary.indices per binary node
+	 * @param total Primitive count per binary node
+	 * @param index Binary node the wide node replaces
+	 * @param output Hierarchy receiving the nodes
+	 * @return Index of the emitted wide node
+	 */
+	static int Emit(const LinearBvh& binary, const vector<int>& first, const vector<int>& total, const int index, WideBvh& output)
+	{
+		auto isLeaf = [&](const int node)
+		{
+			return binary.nodes[node].IsLeaf() || total[node] <= WIDE_BVH_LEAF_SIZE;
+		};
+
+		int candidates[WIDE_BVH_WIDTH];
+		int used = 0;
+
+		if (isLeaf(index))
+		{
+			candidates[used++] = index;
+		}
+		else
+		{
+			candidates[used++] = binary.nodes[index].left;
+			candidates[used++] = binary.nodes[index].right;
+		}
+
+		// Open the largest internal candidate until the node is full
+		while (used < WIDE_BVH_WIDTH)
+		{
+			int best = -1;
+			float bestArea = -1.f;
+
+			for (int i = 0; i < used; ++i)
+			{
+				if (!isLeaf(candidates[i]) && SurfaceArea(binary.nodes[candidates[i]]) > bestArea)
+				{
+					best = i;
+					bestArea = SurfaceArea(binary.nodes[candidates[i]]);
+				}
+			}
+
+			if (best < 0)
+			{
+				break;
+			}
+
+			const LinearBvhNode& opened = binary.nodes[candidates[best]];
+			candidates[best] = opened.left;
+			candidates[used++] = opened.right;
+		}
+
+		const int result = static_cast<int>(output.nodes.size());
+		output.nodes.emplace_back();
+
+		// Quantization frame: the bounds of the binary node this wide node replaces.
+		// The step is widened until the top plane reaches the far corner despite rounding.
+		const LinearBvhNode& source = binary.nodes[index];
+		const float min[3] = { source.min.x, source.min.y, source.min.z };
+		const float max[3] = { source.max.x, source.max.y, source.max.z };
+		float scale[3];
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			scale[axis] = (max[axis] - min[axis]) / static_cast<float>(WIDE_BVH_STEPS);
+
+			while (max[axis] > min[axis] && Dequantize(min[axis], WIDE_BVH_STEPS, scale[axis]) <= max[axis])
+			{
+				scale[axis] = std::nextafter(scale[axis], numeric_limits<float>::infinity());
+			}
+		}
+
+		WideBvhNode node;
+		node.origin = Vector3{ min[0], min[1], min[2] };
+		node.scale = Vector3{ scale[0], scale[1], scale[2] };
+
+		for (int slot = 0; slot < used; ++slot)
+		{
+			const LinearBvhNode& candidate = binary.nodes[candidates[slot]];
+			const float childMin[3] = { candidate.min.x, candidate.min.y, candidate.min.z };
+			const float childMax[3] = { candidate.max.x, candidate.max.y, candidate.max.z };
+
+			// Round outwards, then step further out until the decoded planes strictly enclose the child
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				int lower = 0;
+				int upper = 0;
+
+				if (scale[axis] > 0.f)
+				{
+					lower = static_cast<int>(std::floor((childMin[axis] - min[axis]) / scale[axis]));
+					upper = static_cast<int>(std::ceil((childMax[axis] - min[axis]) / scale[axis]));
+					lower = std::clamp(lower, 0, WIDE_BVH_STEPS);
+					upper = std::clamp(upper, 0, WIDE_BVH_STEPS);
+
+					while (lower > 0 && Dequantize(min[axis], lower, scale[axis]) >= childMin[axis])
+					{
+						--lower;
+					}
+
+					while (upper < WIDE_BVH_STEPS && Dequantize(min[axis], upper, scale[axis]) <= childMax[axis])
+					{
+						++upper;
+					}
+				}
+
+				node.lower[axis][slot] = static_cast<uint8_t>(lower);
+				node.upper[axis][slot] = static_cast<uint8_t>(upper);
+			}
+
+			if (isLeaf(candidates[slot]))
+			{
+				node.child[slot] = first[candidates[slot]];
+				node.count[slot] = static_cast<uint8_t>(total[candidates[slot]]);
+			}
+			else
+			{
+				node.child[slot] = Emit(binary, first, total, candidates[slot], output);
+			}
+		}
+
+		// Children were emitted after this node, which may have moved the storage
+		output.nodes[result] = node;
+
+		return result;
+	}
+
+	/**
+	 * @brief Default constructor creating a node with every slot empty
+	 */
+	WideBvhNode::WideBvhNode()
+		: lower{}, upper{}, count{}
+	{
+		std::fill(std::begin(child), std::end(child), -1);
+	}
+
+	/**
+	 * @brief Tests whether a slot references primitives rather than a node
+	 * @param slot Child slot in [0, WIDE_BVH_WIDTH)
+	 * @return True for leaf slots
+	 */
+	bool WideBvhNode::IsLeaf(const int slot) const
+	{
+		return count[slot] > 0;
+	}
+
+	/**
+	 * @brief Tests whether a slot is unused
+	 * @param slot Child slot in [0, WIDE_BVH_WIDTH)
+	 * @return True if the slot references nothing
+	 */
+	bool WideBvhNode::IsEmpty(const int slot) const
+	{
+		return child[slot] < 0;
+	}
+
+	/**
+	 * @brief Decodes the conservative bounds of one child
+	 * @param slot Child slot in [0, WIDE_BVH_WIDTH)
+	 * @return Dequantized child bounds
+	 */
+	Aabb WideBvhNode::ChildBounds(const int slot) const
+	{
+		const Vector3 min
+		{
+			Dequantize(origin.x, lower[0][slot], scale.x),
+			Dequantize(origin.y, lower[1][slot], scale.y),
+			Dequantize(origin.z, lower[2][slot], scale.z)
+		};
+
+		const Vector3 max
+		{
+			Dequantize(origin.x, upper[0][slot], scale.x),
+			Dequantize(origin.y, upper[1][slot], scale.y),
+			Dequantize(origin.z, upper[2][slot], scale.z)
+		};
+
+		return Aabb::FromMinMax(min, max);
+	}
+
+	/**
+	 * @brief Slab-tests a ray against every child box at once
+	 * @param ray Prepared ray to test
+	 * @param maxDistance Hits entering beyond this distance are rejected
+	 * @param entries Receives the entry distance of each child (WIDE_BVH_WIDTH floats)
+	 * @return Bit mask with bit i set if child i is hit
+	 *
+	 * The inner loops run over all lanes with no early exit so the compiler can
+	 * keep each axis in vector registers. A zero direction component produces
+	 * NaN for a ray lying on a slab plane; the comparison order makes those
+	 * lanes keep their previous interval.
+	 */
+	int WideBvhNode::IntersectChildren(const PreparedRay& ray, const float maxDistance, float* entries) const
+	{
+		const float base[3] = { origin.x, origin.y, origin.z };
+		const float step[3] = { scale.x, scale.y, scale.z };
+
+		float tMin[WIDE_BVH_WIDTH];
+		float tMax[WIDE_BVH_WIDTH];
+
+		for (int i = 0; i < WIDE_BVH_WIDTH; ++i)
+		{
+			tMin[i] = 0.f;
+			tMax[i] = maxDistance;
+		}
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			// A negative direction enters through the upper plane
+			const uint8_t* near = ray.sign[axis] != 0 ? upper[axis] : lower[axis];
+			const uint8_t* far = ray.sign[axis] != 0 ? lower[axis] : upper[axis];
+			const float from = ray.origin[axis];
+			const float inverse = ray.inverseDirection[axis];
+
+			for (int i = 0; i < WIDE_BVH_WIDTH; ++i)
+			{
+				const float t1 = (Dequantize(base[axis], near[i], step[axis]) - from) * inverse;
+				const float t2 = (Dequantize(base[axis], far[i], step[axis]) - from) * inverse;
+
+				tMin[i] = t1 > tMin[i] ? t1 : tMin[i];
+				tMax[i] = t2 < tMax[i] ? t2 : tMax[i];
+			}
+		}
+
+		int mask = 0;
+
+		for (int i = 0; i < WIDE_BVH_WIDTH; ++i)
+		{
+			entries[i] = tMin[i];
+			mask |= (child[i] >= 0 && tMin[i] <= tMax[i] * BVH_SLAB_TOLERANCE) << i;
+		}
+
+		return mask;
+	}
+
+	/**
+	 * @brief Tests a box against every child box at once
+	 * @param min Minimum corner of the query box
+	 * @param max Maximum corner of the query box
+	 * @return Bit mask with bit i set if child i overlaps the box
+	 */
+	int WideBvhNode::OverlapChildren(const Vector3& min, const Vector3& max) const
+	{
+		const float base[3] = { origin.x, origin.y, origin.z };
+		const float step[3] = { scale.x, scale.y, scale.z };
+		const float queryMin[3] = { min.x, min.y, min.z };
+		const float queryMax[3] = { max.x, max.y, max.z };
+
+		int overlap[WIDE_BVH_WIDTH];
+
+		for (int i = 0; i < WIDE_BVH_WIDTH; ++i)
+		{
+			overlap[i] = child[i] >= 0;
+		}
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			for (int i = 0; i < WIDE_BVH_WIDTH; ++i)
+			{
+				overlap[i] &= Dequantize(base[axis], lower[axis][i], step[axis]) <= queryMax[axis] &&
+				              Dequantize(base[axis], upper[axis][i], step[axis]) >= queryMin[axis];
+			}
+		}
+
+		int mask = 0;
+
+		for (int i = 0; i < WIDE_BVH_WIDTH; ++i)
+		{
+			mask |= overlap[i] << i;
+		}
+
+		return mask;
+	}
+
+	/**
+	 * @brief Computes the aggregated flags of every child slot in a subtree
+	 * @param bvh Hierarchy whose masks are filled, already sized to its nodes
+	 * @param flags Flags of each primitive
+	 * @param index Root node of the subtree
+	 * @return Bitwise OR of the flags of every primitive in the subtree
+	 */
+	static uint32_t GatherMask(WideBvh& bvh, const uint32_t* flags, const int index)
+	{
+		const WideBvhNode& node = bvh.nodes[index];
+		uint32_t total = 0;
+
+		for (int slot = 0; slot < WIDE_BVH_WIDTH; ++slot)
+		{
+			if (node.IsEmpty(slot))
+			{
+				continue;
+			}
+
+			uint32_t mask = 0;
+
+			if (node.IsLeaf(slot))
+			{
+				for (int i = node.child[slot]; i < node.child[slot] + node.count[slot]; ++i)
+				{
+					mask |= flags[bvh.indices.empty() ? i : bvh.indices[i]];
+				}
+			}
+			else
+			{
+				mask = GatherMask(bvh, flags, node.child[slot]);
+			}
+
+			bvh.masks[static_cast<size_t>(index) * WIDE_BVH_WIDTH + slot] = mask;
+			total |= mask;
+		}
+
+		return total;
+	}
+
+	/**
+	 * @brief Default constructor creating an empty hierarchy
+	 */
+	WideBvh::WideBvh() = default;
+
+	/**
+	 * @brief Rebuilds this hierarchy by collapsing a binary one
+	 * @param binary Source hierarchy
+	 *
+	 * Algorithm:
+	 * 1. Measure the index range covered by every binary subtree
+	 * 2. Copy the binary primitive order, which leaf ranges refer to
+	 * 3. Emit wide nodes depth-first from the binary root
+	 */
+	void WideBvh::Collapse(const LinearBvh& binary)
+	{
+		nodes.clear();
+		masks.clear();
+
+		if (binary.IsEmpty())
+		{
+			indices.clear();
+			return;
+		}
+
+		rangeFirst.resize(binary.nodes.size());
+		rangeCount.resize(binary.nodes.size());
+		Measure(binary, 0, rangeFirst, rangeCount);
+
+		indices = binary.indices;
+
+		// A binary tree with n leaves collapses into at most n / 2 wide nodes
+		nodes.reserve(binary.indices.size() / 2 + 1);
+
+		Emit(binary, rangeFirst, rangeCount, 0, *this);
+	}
+
+	/**
+	 * @brief Aggregates per-primitive flags into every child slot
+	 * @param primitiveFlags Flags of each primitive, or nullptr to drop the masks
+	 */
+	void WideBvh::BuildMasks(const uint32_t* primitiveFlags)
+	{
+		if (primitiveFlags == nullptr || nodes.empty())
+		{
+			masks.clear();
+			return;
+		}
+
+		masks.assign(nodes.size() * WIDE_BVH_WIDTH, 0);
+		GatherMask(*this, primitiveFlags, 0);
+	}
+
+	/**
+	 * @brief Finds the children of a node that may hold primitives with some of the given flags
+	 * @param node Index of the node
+	 * @param mask Flags looked for
+	 * @return Bit mask with bit i set unless child i holds none of the flags
+	 */
+	int WideBvh::MatchingChildren(const int node, const uint32_t mask) const
+	{
+		if (masks.empty())
+		{
+			return (1 << WIDE_BVH_WIDTH) - 1;
+		}
+
+		const uint32_t* slots = &masks[static_cast<size_t>(node) * WIDE_BVH_WIDTH];
+		int matching = 0;
+
+		for (int slot = 0; slot < WIDE_BVH_WIDTH; ++slot)
+		{
+			matching |= (slots[slot] & mask) != 0 ? 1 << slot : 0;
+		}
+
+		return matching;
+	}
+
+	/**
+	 * @brief Removes all nodes and primitive references
+	 */
+	void WideBvh::Clear()
+	{
+		nodes.clear();
+		indices.clear();
+		masks.clear();
+	}
+
+	/**
+	 * @brief Frees the working storage kept for the next Collapse()
+	 */
+	void WideBvh::ReleaseScratch()
+	{
+		vector<int>().swap(rangeFirst);
+		vector<int>().swap(rangeCount);
+	}
+
+	/**
+	 * @brief Tests whether the hierarchy contains any nodes
+	 * @return True if no hierarchy has been built
+	 */
+	bool WideBvh::IsEmpty() const
+	{
+		return nodes.empty();
+	}
+}
@@ -0,0 +1,108 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Core/Parallel.hpp"
+
+using std::atomic;
+using std::runtime_error;
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class ParallelTests : public Test
+    {
+    };
+
+    TEST_F(ParallelTests, For_ManyCalls_VisitsEveryIndexOnce)
+    {
+        vector<atomic<int>> visits(10000);
+
+        // Many calls in a row reuse the same workers
+        for (int call = 0; call < 200; ++call)
+        {
+            Parallel::For(static_cast<int>(visits.size()), 16, [&](const int, const int begin, const int end)
+            {
+                for (int i = begin; i < end; ++i)
+                {
+                    ++visits[i];
+                }
+            });
+        }
+
+        for (const atomic<int>& count : visits)
+        {
+            EXPECT_EQ(200, count.load());
+        }
+    }
+
+    TEST_F(ParallelTests, For_ChunksMatchChunkCount)
+    {
+        const int chunks = Parallel::ChunkCount(5000, 10);
+        vector<int> sizes(chunks, -1);
+
+        Parallel::For(5000, 10, [&](const int chunk, const int begin, const int end)
+        {
+            sizes[chunk] = end - begin;
+        });
+
+        int total = 0;
+        for (const int size : sizes)
+        {
+            EXPECT_GT(size, 0);
+            total += size;
+        }
+
+        EXPECT_EQ(5000, total);
+    }
+
+    TEST_F(ParallelTests, For_Nested_Completes)
+    {
+        atomic<int> total{ 0 };
+
+        Parallel::For(64, 1, [&](const int, const int begin, const int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                Parallel::For(100, 1, [&](const int, const int innerBegin, const int innerEnd)
+                {
+                    total += innerEnd - innerBegin;
+                });
+            }
+        });
+
+        EXPECT_EQ(6400, total.load());
+    }
+
+    TEST_F(ParallelTests, For_BodyThrows_RethrowsAfterOtherChunks)
+    {
+        atomic<int> running{ 0 };
+
+        EXPECT_THROW(Parallel::For(1000, 1, [&](const int chunk, const int, const int)
+        {
+            ++running;
+            if (chunk == 0)
+            {
+                throw runtime_error("chunk failed");
+            }
+
+            --running;
+        }), runtime_error);
+
+        // No chunk is still running once the exception reaches the caller
+        EXPECT_EQ(1, running.load());
+
+        // The workers survive and take later calls
+        atomic<int> covered{ 0 };
+        Parallel::For(1000, 1, [&](const int, const int begin, const int end)
+        {
+            covered += end - begin;
+        });
+
+        EXPECT_EQ(1000, covered.load());
+    }
+}
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Bvh.hpp"
+#include "Nudge/Shapes/Line.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    /**
+     * @brief User type indexed through its own BvhTraits specialization
+     */
+    class Marker
+    {
+    public:
+        Vector3 position;
+        float reach;
+    };
+
+    template <>
+    class BvhTraits<Marker>
+    {
+    public:
+        static Aabb Bounds(const Marker& primitive)
+        {
+            return { primitive.position, Vector3{ primitive.reach } };
+        }
+
+        static Vector3 Centroid(const Marker& primitive)
+        {
+            return primitive.position;
+        }
+    };
+
+    class BvhTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        static vector<Sphere> ScatterSpheres(const int count)
+        {
+            vector<Sphere> spheres;
+            for (int i = 0; i < count; ++i)
+            {
+                spheres.emplace_back(ScatterPoint(i, -20.f, 20.f), Scatter(i + 9000, .2f, 1.5f));
+            }
+
+            return spheres;
+        }
+
+        // Indices visited by a query, sorted
+        template <typename Primitive, typename Accept>
+        static vector<int> Collect(const Bvh<Primitive>& bvh, const Aabb& region, Accept&& accept)
+        {
+            vector<int> found;
+            bvh.Query(region, [&](const int index)
+            {
+                if (accept(index))
+                {
+                    found.push_back(index);
+                }
+
+                return false;
+            });
+
+            std::sort(found.begin(), found.end());
+            found.erase(std::unique(found.begin(), found.end()), found.end());
+
+            return found;
+        }
+    };
+
+    TEST_F(BvhTests, Constructor_Default_IsEmpty)
+    {
+        const Bvh<Sphere> bvh;
+
+        EXPECT_TRUE(bvh.IsEmpty());
+        EXPECT_EQ(0, bvh.count);
+        EXPECT_EQ(-1, bvh.Query(Aabb{ Vector3{ 0.f }, Vector3{ 100.f } }, [](int) { return true; }));
+
+        float distance = 5.f;
+        EXPECT_EQ(-1, bvh.CastRay(Ray{ Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f } }, [](int, float) { return 0.f; }, distance));
+        EXPECT_EQ(5.f, distance);
+    }
+
+    TEST_F(BvhTests, Query_Spheres_MatchesBruteForce)
+    {
+        const vector<Sphere> spheres = ScatterSpheres(500);
+
+        Bvh<Sphere> bvh;
+        bvh.Build(spheres);
+
+        EXPECT_FALSE(bvh.IsEmpty());
+        EXPECT_EQ(500, bvh.count);
+
+        for (unsigned q = 0; q < 30; ++q)
+        {
+            const Aabb region{ ScatterPoint(q + 500, -20.f, 20.f), ScatterPoint(q + 700, .5f, 6.f) };
+
+            const vector<int> found = Collect(bvh, region, [&](const int index)
+            {
+                return region.Intersects(spheres[index]);
+            });
+
+            vector<int> expected;
+            for (int i = 0; i < static_cast<int>(spheres.size()); ++i)
+            {
+                if (region.Intersects(spheres[i]))
+                {
+                    expected.push_back(i);
+                }
+            }
+
+            EXPECT_EQ(expected, found);
+        }
+    }
+
+    TEST_F(BvhTests, Query_OrientedBoxes_MatchesBruteForce)
+    {
+        vector<Obb> boxes;
+        for (int i = 0; i < 300; ++i)
+        {
+            const Matrix3 orientation = Matrix3::Rotation(ScatterPoint(i + 100, 0.f, 360.f));
+            boxes.emplace_back(ScatterPoint(i, -15.f, 15.f), ScatterPoint(i + 400, .2f, 1.5f), orientation);
+        }
+
+        Bvh<Obb> bvh;
+        bvh.Build(boxes);
+
+        for (unsigned q = 0; q < 30; ++q)
+        {
+            const Aabb region{ ScatterPoint(q + 900, -15.f, 15.f), ScatterPoint(q + 1100, .5f, 4.f) };
+
+            const vector<int> found = Collect(bvh, region, [&](const int index)
+            {
+                return boxes[index].Intersects(region);
+            });
+
+            vector<int> expected;
+            for (int i = 0; i < static_cast<int>(boxes.size()); ++i)
+            {
+                if (boxes[i].Intersects(region))
+                {
+                    expected.push_back(i);
+                }
+            }
+
+            EXPECT_EQ(expected, found);
+        }
+    }
+
+    TEST_F(BvhTests, Query_LineSegments_MatchesBruteForce)
+    {
+        vector<Line> lines;
+        for (int i = 0; i < 400; ++i)
+        {
+            const Vector3 start = ScatterPoint(i, -20.f, 20.f);
+            lines.emplace_back(start, start + ScatterPoint(i + 2000, -3.f, 3.f));
+        }
+
+        Bvh<Line> bvh;
+        bvh.Build(lines);
+
+        for (unsigned q = 0; q < 30; ++q)
+        {
+            const Aabb region{ ScatterPoint(q + 3000, -20.f, 20.f), ScatterPoint(q + 3100, .5f, 5.f) };
+
+            const vector<int> found = Collect(bvh, region, [&](const int index)
+            {
+                return lines[index].Test(region);
+            });
+
+            vector<int> expected;
+            for (int i = 0; i < static_cast<int>(lines.size()); ++i)
+            {
+                if (lines[i].Test(region))
+                {
+                    expected.push_back(i);
+                }
+            }
+
+            EXPECT_EQ(expected, found);
+        }
+    }
+
+    TEST_F(BvhTests, Query_VisitReturnsTrue_StopsAtThatIndex)
+    {
+        const vector<Sphere> spheres = ScatterSpheres(200);
+
+        Bvh<Sphere> bvh;
+        bvh.Build(spheres);
+
+        int visited = 0;
+        const int stopped = bvh.Query(Aabb{ Vector3{ 0.f }, Vector3{ 100.f } }, [&](int)
+        {
+            return ++visited == 3;
+        });
+
+        EXPECT_EQ(3, visited);
+        EXPECT_GE(stopped, 0);
+        EXPECT_LT(stopped, 200);
+    }
+
+    TEST_F(BvhTests, CastRay_Spheres_ReturnsNearestLikeBruteForce)
+    {
+        const vector<Sphere> spheres = ScatterSpheres(500);
+
+        Bvh<Sphere> bvh;
+        bvh.Build(spheres);
+
+        for (unsigned q = 0; q < 50; ++q)
+        {
+            const Ray ray = Ray::FromPoints(ScatterPoint(q + 5000, -25.f, 25.f), ScatterPoint(q + 6000, -10.f, 10.f));
+
+            int expected = -1;
+            float expectedDistance = 0.f;
+            for (int i = 0; i < static_cast<int>(spheres.size()); ++i)
+            {
+                const float hit = ray.CastAgainst(spheres[i]);
+                if (hit >= 0.f && (expected < 0 || hit < expectedDistance))
+                {
+                    expected = i;
+                    expectedDistance = hit;
+                }
+            }
+
+            float distance = -1.f;
+            const int nearest = bvh.CastRay(ray, [&](const int index, float)
+            {
+                return ray.CastAgainst(spheres[index]);
+            }, distance);
+
+            ASSERT_EQ(expected >= 0, nearest >= 0);
+            if (expected >= 0)
+            {
+                AssertFloatEqual(expectedDistance, distance, 0.001f);
+            }
+        }
+    }
+
+    TEST_F(BvhTests, CastRay_HitBeyondMaxDistance_Misses)
+    {
+        const vector<Sphere> spheres{ Sphere{ Vector3{ 10.f, 0.f, 0.f }, 1.f } };
+
+        Bvh<Sphere> bvh;
+        bvh.Build(spheres);
+
+        const Ray ray{ Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f } };
+        const auto cast = [&](const int index, float) { return ray.CastAgainst(spheres[index]); };
+
+        float distance = -1.f;
+        EXPECT_EQ(-1, bvh.CastRay(ray, cast, distance, 5.f));
+        EXPECT_EQ(0, bvh.CastRay(ray, cast, distance, 20.f));
+        AssertFloatEqual(9.f, distance);
+    }
+
+    TEST_F(BvhTests, Build_UserType_UsesItsTraits)
+    {
+        vector<Marker> markers;
+        for (int i = 0; i < 100; ++i)
+        {
+            markers.push_back({ Vector3{ static_cast<float>(i) * 4.f, 0.f, 0.f }, 1.f });
+        }
+
+        Bvh<Marker> bvh;
+        bvh.Build(markers);
+
+        const vector<int> found = Collect(bvh, Aabb{ Vector3{ 40.f, 0.f, 0.f }, Vector3{ 2.5f } }, [](int) { return true; });
+
+        EXPECT_EQ((vector<int>{ 10 }), found);
+    }
+
+    TEST_F(BvhTests, Build_AgainAfterClear_IndexesNewPrimitives)
+    {
+        const vector<Sphere> first = ScatterSpheres(50);
+        const vector<Sphere> second{ Sphere{ Vector3{ 0.f }, 1.f } };
+
+        Bvh<Sphere> bvh;
+        bvh.Build(first);
+        bvh.Clear();
+
+        EXPECT_TRUE(bvh.IsEmpty());
+
+        bvh.Build(second);
+
+        EXPECT_EQ(1, bvh.count);
+        EXPECT_EQ((vector<int>{ 0 }), Collect(bvh, Aabb{ Vector3{ 0.f }, Vector3{ 1.f } }, [](int) { return true; }));
+    }
+
+    TEST_F(BvhTests, Traits_Triangle_BoundsAndCentroid)
+    {
+        const Triangle triangle{ Vector3{ 0.f, 0.f, 0.f }, Vector3{ 3.f, 0.f, 0.f }, Vector3{ 0.f, 6.f, -3.f } };
+
+        const Aabb bounds = BvhTraits<Triangle>::Bounds(triangle);
+        const Vector3 centroid = BvhTraits<Triangle>::Centroid(triangle);
+
+        AssertFloatEqual(1.5f, bounds.origin.x);
+        AssertFloatEqual(3.f, bounds.origin.y);
+        AssertFloatEqual(-1.5f, bounds.origin.z);
+        AssertFloatEqual(1.5f, bounds.extents.x);
+        AssertFloatEqual(3.f, bounds.extents.y);
+        AssertFloatEqual(1.5f, bounds.extents.z);
+        AssertFloatEqual(1.f, centroid.x);
+        AssertFloatEqual(2.f, centroid.y);
+        AssertFloatEqual(-1.f, centroid.z);
+    }
+}
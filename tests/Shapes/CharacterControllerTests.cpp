@@ -0,0 +1,366 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/CharacterController.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class CharacterControllerTests : public Test
+    {
+    public:
+        static constexpr float SKIN = CHARACTER_DEFAULT_SKIN_WIDTH;
+
+        CharacterController controller;
+
+    public:
+        // A 100 x 100 floor whose top is at y = 0
+        void SetUp() override
+        {
+            controller.Add(Aabb{ Vector3{ 0.f, -.5f, 0.f }, Vector3{ 50.f, .5f, 50.f } });
+        }
+
+        // Capsule 2 units tall standing with its bottom at the given height
+        static Character Standing(const float x, const float bottom, const float z)
+        {
+            Character character{ Vector3{ x, bottom + 1.f + SKIN, z }, .5f, .5f };
+            character.grounded = true;
+
+            return character;
+        }
+
+        // Moves a character by the same displacement several times
+        void Walk(Character& character, const Vector3& displacement, const int ticks)
+        {
+            for (int tick = 0; tick < ticks; ++tick)
+            {
+                character.displacement = displacement;
+                controller.Move(character);
+            }
+        }
+
+        // Ramp through the origin rising along +x at the given angle
+        void AddRamp(const float degrees)
+        {
+            const float rise = MathF::Tan(MathF::Radians(degrees)) * 20.f;
+
+            const Vector3 a{ -20.f, -rise, -20.f };
+            const Vector3 b{ -20.f, -rise, 20.f };
+            const Vector3 c{ 20.f, rise, 20.f };
+            const Vector3 d{ 20.f, rise, -20.f };
+
+            controller.Clear();
+            controller.Add(Triangle{ a, b, c });
+            controller.Add(Triangle{ a, c, d });
+        }
+    };
+
+    TEST_F(CharacterControllerTests, Move_Falling_LandsOnFloorGrounded)
+    {
+        Character character{ Vector3{ 0.f, 3.f, 0.f }, .5f, .5f };
+        Walk(character, Vector3{ 0.f, -.4f, 0.f }, 10);
+
+        EXPECT_TRUE(character.grounded);
+        EXPECT_NEAR(1.f + SKIN, character.position.y, SKIN);
+        EXPECT_NEAR(1.f, character.groundNormal.y, .0001f);
+
+        // Standing still keeps the character on the ground
+        Walk(character, Vector3{ 0.f }, 3);
+        EXPECT_TRUE(character.grounded);
+        EXPECT_NEAR(1.f + SKIN, character.position.y, SKIN);
+    }
+
+    TEST_F(CharacterControllerTests, Move_IntoWall_SlidesAlongIt)
+    {
+        controller.Add(Aabb{ Vector3{ 2.5f, 2.f, 0.f }, Vector3{ .5f, 2.f, 10.f } });
+
+        Character character = Standing(0.f, 0.f, 0.f);
+        Walk(character, Vector3{ .5f, 0.f, .25f }, 8);
+
+        EXPECT_LE(character.position.x, 1.5f - SKIN * .99f);
+        EXPECT_GE(character.position.x, 1.5f - SKIN * 2.f);
+        EXPECT_NEAR(2.f, character.position.z, .001f);
+        EXPECT_NEAR(1.f + SKIN, character.position.y, SKIN);
+        EXPECT_TRUE(character.grounded);
+    }
+
+    TEST_F(CharacterControllerTests, Move_IntoCorner_StopsInCrease)
+    {
+        controller.Add(Aabb{ Vector3{ 2.5f, 2.f, 0.f }, Vector3{ .5f, 2.f, 10.f } });
+        controller.Add(Obb{ Vector3{ 0.f, 2.f, 2.5f }, Vector3{ 10.f, 2.f, .5f } });
+
+        Character character = Standing(0.f, 0.f, 0.f);
+        Walk(character, Vector3{ .4f, 0.f, .4f }, 10);
+
+        EXPECT_NEAR(1.5f - SKIN, character.position.x, SKIN);
+        EXPECT_NEAR(1.5f - SKIN, character.position.z, SKIN);
+        EXPECT_TRUE(character.grounded);
+    }
+
+    TEST_F(CharacterControllerTests, Move_LowLedge_StepsOnto)
+    {
+        controller.Add(Aabb{ Vector3{ 5.f, .1f, 0.f }, Vector3{ 3.f, .1f, 3.f } });
+
+        Character character = Standing(0.f, 0.f, 0.f);
+        Walk(character, Vector3{ .25f, 0.f, 0.f }, 20);
+
+        EXPECT_GT(character.position.x, 4.5f);
+        EXPECT_NEAR(1.2f + SKIN, character.position.y, SKIN);
+        EXPECT_TRUE(character.grounded);
+    }
+
+    TEST_F(CharacterControllerTests, Move_TallLedge_Blocks)
+    {
+        controller.Add(Aabb{ Vector3{ 5.f, .3f, 0.f }, Vector3{ 3.f, .3f, 3.f } });
+
+        Character character = Standing(0.f, 0.f, 0.f);
+        Walk(character, Vector3{ .25f, 0.f, 0.f }, 16);
+
+        EXPECT_LT(character.position.x, 1.5f);
+        EXPECT_NEAR(1.f + SKIN, character.position.y, SKIN);
+        EXPECT_TRUE(character.grounded);
+
+        // Airborne characters never step
+        Character floating = Standing(0.f, .05f, 0.f);
+        floating.grounded = false;
+        controller.stepHeight = 1.f;
+        Walk(floating, Vector3{ .25f, 0.f, 0.f }, 16);
+
+        EXPECT_LT(floating.position.x, 1.5f);
+        EXPECT_FALSE(floating.grounded);
+    }
+
+    TEST_F(CharacterControllerTests, Move_OffSmallDrop_SnapsDown)
+    {
+        controller.Clear();
+        controller.Add(Aabb{ Vector3{ -10.f, -.5f, 0.f }, Vector3{ 10.f, .5f, 10.f } });
+        controller.Add(Aabb{ Vector3{ 10.f, -.65f, 0.f }, Vector3{ 10.f, .5f, 10.f } });
+
+        Character character = Standing(-1.f, 0.f, 0.f);
+        Walk(character, Vector3{ .25f, 0.f, 0.f }, 12);
+
+        EXPECT_GT(character.position.x, 1.9f);
+        EXPECT_NEAR(.85f + SKIN, character.position.y, SKIN);
+        EXPECT_TRUE(character.grounded);
+    }
+
+    TEST_F(CharacterControllerTests, Move_OffTallDrop_LeavesGround)
+    {
+        controller.Clear();
+        controller.Add(Aabb{ Vector3{ -10.f, -.5f, 0.f }, Vector3{ 10.f, .5f, 10.f } });
+        controller.Add(Aabb{ Vector3{ 10.f, -2.5f, 0.f }, Vector3{ 10.f, .5f, 10.f } });
+
+        Character character = Standing(-1.f, 0.f, 0.f);
+        Walk(character, Vector3{ .25f, 0.f, 0.f }, 12);
+
+        // Rounding the edge may lower it a little, but it never snaps to the floor below
+        EXPECT_GT(character.position.x, 1.9f);
+        EXPECT_GT(character.position.y, .5f);
+        EXPECT_FALSE(character.grounded);
+    }
+
+    TEST_F(CharacterControllerTests, Move_GentleSlope_StandsStill)
+    {
+        AddRamp(30.f);
+
+        Character character{ Vector3{ 0.f, 3.f, 0.f }, .5f, .5f };
+        Walk(character, Vector3{ 0.f, -.3f, 0.f }, 20);
+
+        EXPECT_TRUE(character.grounded);
+        EXPECT_NEAR(0.f, character.position.x, .001f);
+        EXPECT_NEAR(MathF::Cos(MathF::Radians(30.f)), character.groundNormal.y, .001f);
+    }
+
+    TEST_F(CharacterControllerTests, Move_SteepSlope_SlidesDown)
+    {
+        AddRamp(60.f);
+
+        Character character{ Vector3{ 0.f, 3.f, 0.f }, .5f, .5f };
+        Walk(character, Vector3{ 0.f, -.3f, 0.f }, 20);
+
+        EXPECT_FALSE(character.grounded);
+        EXPECT_LT(character.position.x, -.5f);
+
+        controller.SetMaxSlope(70.f);
+        Walk(character, Vector3{ 0.f, -.3f, 0.f }, 2);
+        EXPECT_TRUE(character.grounded);
+    }
+
+    TEST_F(CharacterControllerTests, Move_Sphere_GoesAroundSphereCollider)
+    {
+        controller.Add(Sphere{ Vector3{ 3.f, 0.f, .2f }, 1.f });
+
+        Character character{ Vector3{ 0.f, .5f + SKIN, 0.f }, .5f };
+        character.grounded = true;
+        Walk(character, Vector3{ .2f, 0.f, 0.f }, 30);
+
+        // Pushed sideways around the sphere instead of stopping against it
+        EXPECT_GT(character.position.x, 3.f);
+        EXPECT_LT(character.position.z, 0.f);
+
+        const Vector3 center{ 3.f, 0.f, .2f };
+        EXPECT_GE(Vector3::Distance(center, character.position), 1.5f);
+    }
+
+    TEST_F(CharacterControllerTests, Move_MeshTerrain_MatchesOneAtATimeWithoutPenetrating)
+    {
+        // Bumpy 48 x 48 terrain mesh with boxes and spheres on top
+        vector<Triangle> triangles;
+        const auto height = [](const float x, const float z)
+        {
+            return .3f * MathF::Sin(x * .5f) + .3f * MathF::Cos(z * .4f);
+        };
+
+        for (int x = -24; x < 24; ++x)
+        {
+            for (int z = -24; z < 24; ++z)
+            {
+                const float fx = static_cast<float>(x);
+                const float fz = static_cast<float>(z);
+
+                const Vector3 a{ fx, height(fx, fz), fz };
+                const Vector3 b{ fx, height(fx, fz + 1.f), fz + 1.f };
+                const Vector3 c{ fx + 1.f, height(fx + 1.f, fz), fz };
+                const Vector3 d{ fx + 1.f, height(fx + 1.f, fz + 1.f), fz + 1.f };
+
+                triangles.emplace_back(a, b, c);
+                triangles.emplace_back(c, b, d);
+            }
+        }
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+        mesh.Accelerate(BvhBuildMode::Wide);
+
+        controller.Clear();
+        controller.Add(mesh);
+
+        for (unsigned i = 0; i < 20; ++i)
+        {
+            const Vector3 origin{ Scatter(i * 5, -20.f, 20.f), 0.f, Scatter(i * 5 + 1, -20.f, 20.f) };
+            if (i % 2 == 0)
+            {
+                controller.Add(Obb{ origin, Vector3{ 1.f, 1.f, .5f }, Matrix3::RotationY(Scatter(i * 5 + 2, 0.f, 90.f)) });
+            }
+            else
+            {
+                controller.Add(Sphere{ origin, Scatter(i * 5 + 3, .5f, 1.5f) });
+            }
+        }
+
+        vector<Character> batch;
+        for (unsigned i = 0; i < 2000; ++i)
+        {
+            const Vector3 position{ Scatter(i * 3 + 100, -22.f, 22.f), 1.5f + Scatter(i * 3 + 101, 0.f, 1.f), Scatter(i * 3 + 102, -22.f, 22.f) };
+            batch.emplace_back(position, .3f, i % 3 == 0 ? 0.f : .4f);
+        }
+
+        vector<Character> single = batch;
+
+        for (unsigned tick = 0; tick < 12; ++tick)
+        {
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                const unsigned seed = tick * 4001 + static_cast<unsigned>(i) * 2;
+                batch[i].displacement = Vector3{ Scatter(seed, -.3f, .3f), -.3f, Scatter(seed + 1, -.3f, .3f) };
+                single[i].displacement = batch[i].displacement;
+                controller.Move(single[i]);
+            }
+
+            controller.Move(batch);
+        }
+
+        int grounded = 0;
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            EXPECT_NEAR(single[i].position.x, batch[i].position.x, .00001f);
+            EXPECT_NEAR(single[i].position.y, batch[i].position.y, .00001f);
+            EXPECT_NEAR(single[i].position.z, batch[i].position.z, .00001f);
+            EXPECT_EQ(single[i].grounded, batch[i].grounded);
+            grounded += batch[i].grounded ? 1 : 0;
+
+            // The core of every character stays clear of the terrain
+            if (batch[i].halfHeight == 0.f)
+            {
+                EXPECT_FALSE(mesh.Intersects(Sphere{ batch[i].position, batch[i].radius * .95f })) << i;
+            }
+        }
+
+        EXPECT_GT(grounded, 1800);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(CharacterControllerTests, Move_OctreeMesh_MatchesWideMesh)
+    {
+        // The octree lists triangles crossing octant boundaries in several leaves
+        vector<Triangle> triangles;
+        for (int x = -10; x < 10; ++x)
+        {
+            for (int z = -10; z < 10; ++z)
+            {
+                const float fx = static_cast<float>(x);
+                const float fz = static_cast<float>(z);
+                const float y = .2f * MathF::Sin(fx) * MathF::Cos(fz);
+
+                triangles.emplace_back(Vector3{ fx, y, fz }, Vector3{ fx, 0.f, fz + 1.f }, Vector3{ fx + 1.f, 0.f, fz });
+                triangles.emplace_back(Vector3{ fx + 1.f, 0.f, fz }, Vector3{ fx, 0.f, fz + 1.f }, Vector3{ fx + 1.f, -y, fz + 1.f });
+            }
+        }
+
+        Mesh octree = MakeMesh(triangles, BvhBuildMode::Octree);
+        Mesh wide = MakeMesh(triangles, BvhBuildMode::Wide);
+
+        CharacterController octreeController;
+        CharacterController wideController;
+        octreeController.Add(octree);
+        wideController.Add(wide);
+
+        vector<Character> onOctree;
+        for (unsigned i = 0; i < 300; ++i)
+        {
+            onOctree.emplace_back(Vector3{ Scatter(i * 3, -8.f, 8.f), 1.f + Scatter(i * 3 + 1, 0.f, 1.f), Scatter(i * 3 + 2, -8.f, 8.f) }, .3f, .4f);
+        }
+
+        vector<Character> onWide = onOctree;
+
+        for (unsigned tick = 0; tick < 8; ++tick)
+        {
+            for (size_t i = 0; i < onOctree.size(); ++i)
+            {
+                const unsigned seed = tick * 907 + static_cast<unsigned>(i) * 2;
+                onOctree[i].displacement = Vector3{ Scatter(seed, -.3f, .3f), -.3f, Scatter(seed + 1, -.3f, .3f) };
+                onWide[i].displacement = onOctree[i].displacement;
+            }
+
+            octreeController.Move(onOctree);
+            wideController.Move(onWide);
+        }
+
+        // Triangles arrive in another order, so sweeps may settle at a different point within the skin
+        for (size_t i = 0; i < onOctree.size(); ++i)
+        {
+            EXPECT_NEAR(onWide[i].position.x, onOctree[i].position.x, SKIN);
+            EXPECT_NEAR(onWide[i].position.y, onOctree[i].position.y, SKIN);
+            EXPECT_NEAR(onWide[i].position.z, onOctree[i].position.z, SKIN);
+            EXPECT_EQ(onWide[i].grounded, onOctree[i].grounded);
+        }
+
+        octree.ReleaseAccelerator();
+        wide.ReleaseAccelerator();
+    }
+}
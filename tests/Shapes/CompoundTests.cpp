@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Compound.hpp"
+#include "Nudge/Shapes/Line.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Plane.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Shape.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::pair;
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class CompoundTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance)) << expected << " vs " << actual;
+        }
+
+        // Body of count parts cycling through every child kind, like a machine built from primitives
+        static Compound MakeBody(const int count, const unsigned seed, const Vector3& position, const Matrix3& orientation)
+        {
+            Compound body{ position, orientation };
+            for (int i = 0; i < count; ++i)
+            {
+                const unsigned s = seed + static_cast<unsigned>(i) * 7;
+                const Vector3 center = ScatterPoint(s, -6.f, 6.f);
+
+                switch (i % 4)
+                {
+                case 0:
+                    body.Add(Sphere{ center, Scatter(s + 1, .2f, .8f) });
+                    break;
+                case 1:
+                    body.Add(Aabb{ center, ScatterPoint(s + 2, .1f, .6f) });
+                    break;
+                case 2:
+                    body.Add(Obb{ center, ScatterPoint(s + 3, .1f, .6f), Matrix3::Rotation(ScatterPoint(s + 4, 0.f, 360.f)) });
+                    break;
+                default:
+                    body.Add(Triangle{ center, center + ScatterPoint(s + 5, -1.f, 1.f), center + ScatterPoint(s + 6, -1.f, 1.f) });
+                    break;
+                }
+            }
+
+            return body;
+        }
+
+        template <typename Shape>
+        static bool ChildIntersects(const Compound& body, const int child, const Shape& other)
+        {
+            const CompoundChild& entry = body.children[child];
+            switch (entry.shape)
+            {
+            case CompoundShape::Sphere:
+                return body.ToWorld(body.spheres[entry.index]).Intersects(other);
+            case CompoundShape::Obb:
+                return body.ToWorld(body.boxes[entry.index]).Intersects(other);
+            default:
+                return body.ToWorld(body.triangles[entry.index]).Intersects(other);
+            }
+        }
+
+        static bool ChildIntersects(const Compound& body, const int child, const Line& other)
+        {
+            const CompoundChild& entry = body.children[child];
+            switch (entry.shape)
+            {
+            case CompoundShape::Sphere:
+                return other.Test(body.ToWorld(body.spheres[entry.index]));
+            case CompoundShape::Obb:
+                return other.Test(body.ToWorld(body.boxes[entry.index]));
+            default:
+                return other.Test(body.ToWorld(body.triangles[entry.index]));
+            }
+        }
+
+        template <typename Shape>
+        static bool BruteIntersects(const Compound& body, const Shape& other)
+        {
+            for (int i = 0; i < body.ChildCount(); ++i)
+            {
+                if (ChildIntersects(body, i, other))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        static bool ChildrenIntersect(const Compound& body, const int child, const Compound& other, const int otherChild)
+        {
+            const CompoundChild& entry = other.children[otherChild];
+            switch (entry.shape)
+            {
+            case CompoundShape::Sphere:
+                return ChildIntersects(body, child, other.ToWorld(other.spheres[entry.index]));
+            case CompoundShape::Obb:
+                return ChildIntersects(body, child, other.ToWorld(other.boxes[entry.index]));
+            default:
+                return ChildIntersects(body, child, other.ToWorld(other.triangles[entry.index]));
+            }
+        }
+
+        static float BruteCast(const Compound& body, const Ray& ray, int& child)
+        {
+            float nearest = -1.f;
+            for (int i = 0; i < body.ChildCount(); ++i)
+            {
+                const CompoundChild& entry = body.children[i];
+                const float hit = entry.shape == CompoundShape::Sphere ? ray.CastAgainst(body.ToWorld(body.spheres[entry.index]))
+                    : entry.shape == CompoundShape::Obb ? ray.CastAgainst(body.ToWorld(body.boxes[entry.index]))
+                    : ray.CastAgainst(body.ToWorld(body.triangles[entry.index]));
+
+                if (hit >= 0.f && (nearest < 0.f || hit < nearest))
+                {
+                    nearest = hit;
+                    child = i;
+                }
+            }
+
+            return nearest;
+        }
+    };
+
+    TEST_F(CompoundTests, Empty_HitsNothing)
+    {
+        const Compound body{ Vector3{ 1.f, 2.f, 3.f }, Matrix3() };
+
+        EXPECT_TRUE(body.IsEmpty());
+        EXPECT_EQ(0, body.ChildCount());
+        EXPECT_EQ(Vector3(1.f, 2.f, 3.f), body.Bounds().origin);
+        EXPECT_FALSE(body.Intersects(Sphere{ Vector3{ 1.f, 2.f, 3.f }, 5.f }));
+        EXPECT_FALSE(body.Intersects(MakeBody(8, 1, Vector3{ 1.f, 2.f, 3.f }, Matrix3())));
+        EXPECT_EQ(-1.f, body.CastRay(Ray{ Vector3{ 0.f }, Vector3{ 0.f, 0.f, 1.f } }));
+    }
+
+    TEST_F(CompoundTests, Add_AssignsIndicesInOrderAndPlacesChildren)
+    {
+        Compound body{ Vector3{ 10.f, 0.f, 0.f }, Matrix3::RotationZ(90.f) };
+
+        EXPECT_EQ(0, body.Add(Sphere{ Vector3{ 2.f, 0.f, 0.f }, .5f }));
+        EXPECT_EQ(1, body.Add(Aabb{ Vector3{ 0.f, 0.f, 3.f }, Vector3{ 1.f, 2.f, .5f } }));
+        EXPECT_EQ(2, body.Add(Triangle{ Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f }, Vector3{ 0.f, 1.f, 0.f } }));
+
+        ASSERT_EQ(3, body.ChildCount());
+        EXPECT_EQ(CompoundShape::Obb, body.children[1].shape);
+
+        // A quarter turn about z takes local +x to world +y
+        const Vector3 sphere = body.ToWorld(body.spheres[0]).origin;
+        AssertFloatEqual(10.f, sphere.x);
+        AssertFloatEqual(2.f, sphere.y);
+        AssertFloatEqual(0.f, sphere.z);
+
+        EXPECT_TRUE(body.Intersects(Sphere{ Vector3{ 10.f, 2.6f, 0.f }, .2f }));
+        EXPECT_FALSE(body.Intersects(Sphere{ Vector3{ 12.f, 0.f, 0.f }, .2f }));
+
+        // The box's long local y side now runs along world x
+        EXPECT_TRUE(body.Intersects(Aabb{ Vector3{ 11.9f, 0.f, 3.f }, Vector3{ .05f } }));
+        EXPECT_FALSE(body.Intersects(Aabb{ Vector3{ 10.f, 1.9f, 3.f }, Vector3{ .05f } }));
+
+        const Aabb bounds = body.Bounds();
+        EXPECT_LE(bounds.Min().x, 8.f);
+        EXPECT_GE(bounds.Max().z, 3.5f);
+    }
+
+    TEST_F(CompoundTests, SetTransform_MovesEveryChild)
+    {
+        Compound body = MakeBody(40, 11, Vector3{ 0.f }, Matrix3());
+        const Sphere probe{ Vector3{ 100.f, 0.f, 0.f }, 8.f };
+        EXPECT_FALSE(body.Intersects(probe));
+
+        body.SetTransform(Vector3{ 100.f, 0.f, 0.f }, Matrix3::RotationY(30.f));
+
+        EXPECT_TRUE(body.Intersects(probe));
+        EXPECT_EQ(BruteIntersects(body, Sphere{ Vector3{ 0.f }, 8.f }), body.Intersects(Sphere{ Vector3{ 0.f }, 8.f }));
+        EXPECT_GE(body.Bounds().origin.x, 90.f);
+    }
+
+    TEST_F(CompoundTests, Intersects_MatchesEveryChild)
+    {
+        const Compound body = MakeBody(160, 3, Vector3{ 1.f, -2.f, 4.f }, Matrix3::Rotation(Vector3{ 20.f, 45.f, 10.f }));
+
+        int hits = 0;
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const Vector3 center = ScatterPoint(i + 500, -8.f, 10.f);
+
+            const Aabb box{ center, ScatterPoint(i + 900, .05f, .5f) };
+            const Obb oriented{ center, ScatterPoint(i + 1300, .05f, .5f), Matrix3::Rotation(ScatterPoint(i + 1700, 0.f, 360.f)) };
+            const Sphere sphere{ center, Scatter(i + 2100, .05f, .6f) };
+            const Triangle triangle{ center, center + ScatterPoint(i + 2500, -.8f, .8f), center + ScatterPoint(i + 2900, -.8f, .8f) };
+
+            EXPECT_EQ(BruteIntersects(body, box), body.Intersects(box));
+            EXPECT_EQ(BruteIntersects(body, oriented), body.Intersects(oriented));
+            EXPECT_EQ(BruteIntersects(body, sphere), body.Intersects(sphere));
+            EXPECT_EQ(BruteIntersects(body, triangle), body.Intersects(triangle));
+
+            hits += body.Intersects(sphere) ? 1 : 0;
+        }
+
+        // Make sure both outcomes were exercised
+        EXPECT_GT(hits, 0);
+        EXPECT_LT(hits, 200);
+    }
+
+    TEST_F(CompoundTests, Intersects_PlaneAndLine_MatchEveryChild)
+    {
+        const Compound body = MakeBody(160, 13, Vector3{ -2.f, 1.f, 3.f }, Matrix3::Rotation(Vector3{ 35.f, 10.f, 70.f }));
+
+        int planeHits = 0;
+        int lineHits = 0;
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const Vector3 normal = (ScatterPoint(i + 6000, -1.f, 1.f) + Vector3{ .01f }).Normalized();
+            const Plane plane{ normal, Scatter(i + 6400, -14.f, 14.f) };
+
+            const Vector3 start = ScatterPoint(i + 6800, -10.f, 10.f);
+            const Line line{ start, start + ScatterPoint(i + 7200, -3.f, 3.f) };
+
+            EXPECT_EQ(BruteIntersects(body, plane), body.Intersects(plane));
+            EXPECT_EQ(BruteIntersects(body, line), body.Intersects(line));
+
+            // Shape dispatches to the overload for the primitive it holds
+            EXPECT_EQ(body.Intersects(plane), body.Intersects(Shape{ plane }));
+            EXPECT_EQ(body.Intersects(line), body.Intersects(Shape{ line }));
+
+            planeHits += body.Intersects(plane) ? 1 : 0;
+            lineHits += body.Intersects(line) ? 1 : 0;
+        }
+
+        EXPECT_GT(planeHits, 0);
+        EXPECT_LT(planeHits, 200);
+        EXPECT_GT(lineHits, 0);
+        EXPECT_LT(lineHits, 200);
+    }
+
+    TEST_F(CompoundTests, Overlaps_MatchesEveryChildPair)
+    {
+        const Compound a = MakeBody(120, 40, Vector3{ 0.f }, Matrix3());
+        const Compound b = MakeBody(90, 70, Vector3{ 7.f, 1.f, 0.f }, Matrix3::RotationX(60.f));
+
+        vector<pair<int, int>> expected;
+        for (int i = 0; i < a.ChildCount(); ++i)
+        {
+            for (int j = 0; j < b.ChildCount(); ++j)
+            {
+                if (ChildrenIntersect(a, i, b, j))
+                {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+
+        ASSERT_FALSE(expected.empty());
+
+        vector<CompoundPair> pairs(a.ChildCount() * b.ChildCount());
+        const int count = a.Overlaps(b, pairs);
+
+        vector<pair<int, int>> found;
+        for (int i = 0; i < count; ++i)
+        {
+            found.emplace_back(pairs[i].first, pairs[i].second);
+        }
+
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(expected, found);
+        EXPECT_TRUE(a.Intersects(b));
+        EXPECT_TRUE(b.Intersects(a));
+
+        // A full output stops the query early
+        vector<CompoundPair> one(1);
+        EXPECT_EQ(1, a.Overlaps(b, one));
+
+        const Compound far = MakeBody(90, 70, Vector3{ 50.f, 0.f, 0.f }, Matrix3());
+        EXPECT_FALSE(a.Intersects(far));
+        EXPECT_EQ(0, a.Overlaps(far, pairs));
+    }
+
+    TEST_F(CompoundTests, Overlaps_BothRotated_MatchesEveryChildPair)
+    {
+        const Compound a = MakeBody(120, 140, Vector3{ -1.f, 2.f, 0.f }, Matrix3::Rotation(Vector3{ 15.f, 50.f, 25.f }));
+        const Compound b = MakeBody(90, 170, Vector3{ 6.f, 0.f, 2.f }, Matrix3::Rotation(Vector3{ 70.f, 5.f, 40.f }));
+
+        vector<pair<int, int>> expected;
+        for (int i = 0; i < a.ChildCount(); ++i)
+        {
+            for (int j = 0; j < b.ChildCount(); ++j)
+            {
+                if (ChildrenIntersect(a, i, b, j))
+                {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+
+        ASSERT_FALSE(expected.empty());
+
+        vector<CompoundPair> pairs(a.ChildCount() * b.ChildCount());
+        const int count = a.Overlaps(b, pairs);
+
+        vector<pair<int, int>> found;
+        for (int i = 0; i < count; ++i)
+        {
+            found.emplace_back(pairs[i].first, pairs[i].second);
+        }
+
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(expected, found);
+    }
+
+    TEST_F(CompoundTests, CastRay_FindsNearestChild)
+    {
+        const Compound body = MakeBody(160, 5, Vector3{ 0.f, 3.f, 0.f }, Matrix3::RotationY(45.f));
+
+        int hits = 0;
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const Vector3 origin = ScatterPoint(i + 4000, -15.f, 15.f);
+            const Vector3 target = ScatterPoint(i + 4400, -4.f, 4.f) + Vector3{ 0.f, 3.f, 0.f };
+            const Ray ray{ origin, (target - origin).Normalized() };
+
+            int expectedChild = -1;
+            const float expected = BruteCast(body, ray, expectedChild);
+
+            int child = -1;
+            const float distance = body.CastRay(ray, &child);
+
+            if (expected < 0.f)
+            {
+                EXPECT_EQ(-1.f, distance);
+                EXPECT_EQ(-1, child);
+                continue;
+            }
+
+            ++hits;
+            AssertFloatEqual(expected, distance);
+            AssertFloatEqual(expected, ray.CastAgainst(body));
+            EXPECT_EQ(expectedChild, child);
+
+            EXPECT_EQ(-1.f, body.CastRay(ray, nullptr, expected * .5f));
+        }
+
+        EXPECT_GT(hits, 0);
+    }
+
+    TEST_F(CompoundTests, Copy_QueriesItsOwnChildren)
+    {
+        Compound original = MakeBody(30, 9, Vector3{ 0.f }, Matrix3());
+        const Compound copy = original;
+
+        original.SetTransform(Vector3{ 100.f, 0.f, 0.f }, Matrix3());
+
+        EXPECT_TRUE(copy.Intersects(Sphere{ Vector3{ 0.f }, 10.f }));
+        EXPECT_FALSE(copy.Intersects(Sphere{ Vector3{ 100.f, 0.f, 0.f }, 10.f }));
+        EXPECT_TRUE(original.Intersects(Sphere{ Vector3{ 100.f, 0.f, 0.f }, 10.f }));
+        EXPECT_EQ(copy.children.data(), copy.tree.primitives);
+
+        // A copy of a built body shares nothing with the original either
+        const Compound built = original;
+        EXPECT_EQ(built.children.data(), built.tree.primitives);
+        EXPECT_TRUE(built.Intersects(Sphere{ Vector3{ 100.f, 0.f, 0.f }, 10.f }));
+    }
+
+    TEST_F(CompoundTests, SetTransform_KeepsTheLocalTree)
+    {
+        Compound body = MakeBody(40, 17, Vector3{ 0.f }, Matrix3());
+        EXPECT_TRUE(body.Intersects(Sphere{ Vector3{ 0.f }, 10.f }));
+
+        const vector<LinearBvhNode> nodes = body.tree.hierarchy.nodes;
+        body.SetTransform(Vector3{ 0.f, 50.f, 0.f }, Matrix3::RotationX(90.f));
+
+        EXPECT_FALSE(body.dirty);
+        EXPECT_TRUE(body.Intersects(Sphere{ Vector3{ 0.f, 50.f, 0.f }, 10.f }));
+        ASSERT_EQ(nodes.size(), body.tree.hierarchy.nodes.size());
+        EXPECT_EQ(nodes.front().left, body.tree.hierarchy.nodes.front().left);
+
+        // Adding a child leaves the rebuild to the next query
+        body.Add(Sphere{ Vector3{ 30.f, 0.f, 0.f }, 1.f });
+        EXPECT_TRUE(body.dirty);
+        EXPECT_TRUE(body.Intersects(Sphere{ Vector3{ 30.f, 50.f, 0.f }, .5f }));
+        EXPECT_FALSE(body.dirty);
+    }
+}
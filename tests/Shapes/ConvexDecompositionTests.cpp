@@ -0,0 +1,148 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Shapes/ConvexDecomposition.hpp"
+#include "Nudge/Shapes/ConvexHull.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class ConvexDecompositionTests : public Test
+    {
+    public:
+        // Appends the twelve outward-wound triangles of a box
+        static void AddBox(vector<Triangle>& triangles, const Vector3& min, const Vector3& max)
+        {
+            const auto corner = [&](const int i)
+            {
+                return Vector3{ i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z };
+            };
+
+            const int faces[6][4] = { { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+            for (const auto& face : faces)
+            {
+                triangles.emplace_back(corner(face[0]), corner(face[1]), corner(face[2]));
+                triangles.emplace_back(corner(face[0]), corner(face[2]), corner(face[3]));
+            }
+        }
+
+        static bool AnyContains(const vector<ConvexHull>& hulls, const Vector3& point)
+        {
+            for (const ConvexHull& hull : hulls)
+            {
+                if (hull.Contains(point))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        static void ExpectEnclosesVertices(const vector<ConvexHull>& hulls, const vector<Triangle>& triangles)
+        {
+            for (const Triangle& triangle : triangles)
+            {
+                for (const Vector3& point : triangle.points)
+                {
+                    EXPECT_TRUE(AnyContains(hulls, point)) << point;
+                }
+            }
+        }
+    };
+
+    TEST_F(ConvexDecompositionTests, EmptyMesh_ProducesNoHulls)
+    {
+        const Mesh mesh;
+        vector<ConvexHull> hulls(3);
+
+        EXPECT_EQ(0.f, ConvexDecomposition{}.Decompose(mesh, hulls));
+        EXPECT_TRUE(hulls.empty());
+    }
+
+    TEST_F(ConvexDecompositionTests, Box_IsOneHull)
+    {
+        vector<Triangle> triangles;
+        AddBox(triangles, Vector3{ -2.f, 0.f, -1.f }, Vector3{ 2.f, 1.f, 1.f });
+        const Mesh mesh = MakeMesh(triangles);
+
+        vector<ConvexHull> hulls;
+        const float concavity = ConvexDecomposition{}.Decompose(mesh, hulls);
+
+        ASSERT_EQ(1u, hulls.size());
+        EXPECT_NEAR(0.f, concavity, 0.0001f);
+        ExpectEnclosesVertices(hulls, triangles);
+
+        // Inflated by at most about a voxel (4 / 32) on each side
+        EXPECT_GE(hulls[0].Volume(), 8.f);
+        EXPECT_LE(hulls[0].Volume(), 4.5f * 1.5f * 2.5f);
+    }
+
+    TEST_F(ConvexDecompositionTests, SeparateBoxes_SplitAcrossGap)
+    {
+        vector<Triangle> triangles;
+        AddBox(triangles, Vector3{ 0.f }, Vector3{ 1.f });
+        AddBox(triangles, Vector3{ 3.f, 0.f, 0.f }, Vector3{ 4.f, 1.f, 1.f });
+        const Mesh mesh = MakeMesh(triangles);
+
+        vector<ConvexHull> hulls;
+        const float concavity = ConvexDecomposition{}.Decompose(mesh, hulls);
+
+        EXPECT_EQ(2u, hulls.size());
+        EXPECT_NEAR(0.f, concavity, 0.0001f);
+        ExpectEnclosesVertices(hulls, triangles);
+        EXPECT_FALSE(AnyContains(hulls, Vector3{ 2.f, .5f, .5f }));
+    }
+
+    TEST_F(ConvexDecompositionTests, LShape_NeedsTwoHullsAndLeavesNotchEmpty)
+    {
+        vector<Triangle> triangles;
+        AddBox(triangles, Vector3{ 0.f }, Vector3{ 4.f, 1.f, 1.f });
+        AddBox(triangles, Vector3{ 0.f }, Vector3{ 1.f, 4.f, 1.f });
+        const Mesh mesh = MakeMesh(triangles);
+
+        vector<ConvexHull> hulls;
+        const float concavity = ConvexDecomposition{ 8, .01f }.Decompose(mesh, hulls);
+
+        EXPECT_GE(hulls.size(), 2u);
+        EXPECT_LE(hulls.size(), 8u);
+        EXPECT_LE(concavity, .01f);
+        ExpectEnclosesVertices(hulls, triangles);
+        EXPECT_FALSE(AnyContains(hulls, Vector3{ 3.f, 3.f, .5f }));
+    }
+
+    TEST_F(ConvexDecompositionTests, MaxHulls_BoundsHullCount)
+    {
+        // Comb of five teeth that would want a hull each plus the spine
+        vector<Triangle> triangles;
+        AddBox(triangles, Vector3{ 0.f }, Vector3{ 9.f, 1.f, 1.f });
+        for (int tooth = 0; tooth < 5; ++tooth)
+        {
+            AddBox(triangles, Vector3{ tooth * 2.f, 0.f, 0.f }, Vector3{ tooth * 2.f + 1.f, 4.f, 1.f });
+        }
+
+        const Mesh mesh = MakeMesh(triangles);
+
+        vector<ConvexHull> few;
+        const float coarse = ConvexDecomposition{ 3, 0.f }.Decompose(mesh, few);
+
+        vector<ConvexHull> many;
+        const float fine = ConvexDecomposition{ 12, 0.f }.Decompose(mesh, many);
+
+        EXPECT_EQ(3u, few.size());
+        EXPECT_GT(many.size(), few.size());
+        EXPECT_LE(many.size(), 12u);
+        EXPECT_LT(fine, coarse);
+
+        ExpectEnclosesVertices(few, triangles);
+        ExpectEnclosesVertices(many, triangles);
+    }
+}
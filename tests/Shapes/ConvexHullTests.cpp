@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/ConvexHull.hpp"
+#include "Nudge/Shapes/Plane.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class ConvexHullTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance)) << expected << " vs " << actual;
+        }
+
+        static vector<Vector3> CubeCorners(const Vector3& min, const Vector3& max)
+        {
+            vector<Vector3> points;
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                points.emplace_back(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z);
+            }
+
+            return points;
+        }
+
+        // Every directed edge of a closed, consistently wound surface has its reverse on a neighbouring face
+        static void ExpectClosed(const ConvexHull& hull)
+        {
+            vector<std::pair<int, int>> edges;
+            for (size_t i = 0; i < hull.indices.size(); i += 3)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    edges.emplace_back(hull.indices[i + k], hull.indices[i + (k + 1) % 3]);
+                }
+            }
+
+            std::sort(edges.begin(), edges.end());
+            EXPECT_TRUE(std::adjacent_find(edges.begin(), edges.end()) == edges.end());
+
+            for (const auto& [from, to] : edges)
+            {
+                EXPECT_TRUE(std::binary_search(edges.begin(), edges.end(), std::make_pair(to, from)));
+            }
+        }
+    };
+
+    TEST_F(ConvexHullTests, Default_IsEmpty)
+    {
+        const ConvexHull hull;
+
+        EXPECT_TRUE(hull.IsEmpty());
+        EXPECT_EQ(0.f, hull.Volume());
+        EXPECT_FALSE(hull.Contains(Vector3{ 0.f }));
+    }
+
+    TEST_F(ConvexHullTests, DegenerateInput_IsEmpty)
+    {
+        const vector<Vector3> three{ Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f }, Vector3{ 0.f, 1.f, 0.f } };
+        EXPECT_TRUE(ConvexHull{ three }.IsEmpty());
+
+        vector<Vector3> flat;
+        for (unsigned i = 0; i < 50; ++i)
+        {
+            flat.emplace_back(Scatter(i * 2, -1.f, 1.f), 2.f, Scatter(i * 2 + 1, -1.f, 1.f));
+        }
+
+        EXPECT_TRUE(ConvexHull{ flat }.IsEmpty());
+    }
+
+    TEST_F(ConvexHullTests, CubeWithInteriorPoints_KeepsOnlyCorners)
+    {
+        vector<Vector3> points = CubeCorners(Vector3{ -1.f, 0.f, 2.f }, Vector3{ 1.f, 3.f, 4.f });
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            points.emplace_back(Scatter(i * 3, -1.f, 1.f), Scatter(i * 3 + 1, 0.f, 3.f), Scatter(i * 3 + 2, 2.f, 4.f));
+        }
+
+        const ConvexHull hull{ points };
+
+        EXPECT_EQ(8u, hull.vertices.size());
+        EXPECT_EQ(12u * 3u, hull.indices.size());
+        EXPECT_EQ(12u, hull.planes.size());
+        AssertFloatEqual(12.f, hull.Volume());
+        ExpectClosed(hull);
+
+        const Aabb bounds = hull.Bounds();
+        EXPECT_EQ(Vector3(-1.f, 0.f, 2.f), bounds.Min());
+        EXPECT_EQ(Vector3(1.f, 3.f, 4.f), bounds.Max());
+    }
+
+    TEST_F(ConvexHullTests, RandomPoints_EnclosesEveryPoint)
+    {
+        vector<Vector3> points;
+        for (unsigned i = 0; i < 2000; ++i)
+        {
+            const Vector3 p{ Scatter(i * 3, -1.f, 1.f), Scatter(i * 3 + 1, -1.f, 1.f), Scatter(i * 3 + 2, -1.f, 1.f) };
+            if (p.MagnitudeSqr() <= 1.f)
+            {
+                points.push_back(p * 5.f);
+            }
+        }
+
+        const ConvexHull hull{ points };
+
+        ASSERT_FALSE(hull.IsEmpty());
+        ExpectClosed(hull);
+
+        for (const Vector3& point : points)
+        {
+            EXPECT_TRUE(hull.Contains(point));
+        }
+
+        // Planes face outward: every vertex lies on or behind every plane
+        for (const Plane& plane : hull.planes)
+        {
+            AssertFloatEqual(1.f, plane.normal.Magnitude());
+
+            for (const Vector3& vertex : hull.vertices)
+            {
+                EXPECT_LE(Plane::PlaneEquation(vertex, plane), 0.0001f);
+            }
+        }
+
+        EXPECT_GT(hull.Volume(), 0.f);
+        EXPECT_LT(hull.Volume(), 4.f / 3.f * 3.1416f * 125.f);
+        EXPECT_FALSE(hull.Contains(Vector3{ 5.1f, 0.f, 0.f }));
+    }
+
+    TEST_F(ConvexHullTests, Support_ReturnsExtremeVertex)
+    {
+        const ConvexHull hull{ CubeCorners(Vector3{ 0.f }, Vector3{ 2.f, 4.f, 6.f }) };
+
+        EXPECT_EQ(Vector3(2.f, 4.f, 6.f), hull.Support(Vector3{ 1.f, 1.f, 1.f }));
+        EXPECT_EQ(Vector3(0.f, 0.f, 0.f), hull.Support(Vector3{ -1.f, -1.f, -1.f }));
+        EXPECT_EQ(Vector3(2.f, 0.f, 6.f), hull.Support(Vector3{ 1.f, -1.f, 1.f }));
+    }
+
+    TEST_F(ConvexHullTests, Contains_ClassifiesAgainstFacePlanes)
+    {
+        const ConvexHull hull{ CubeCorners(Vector3{ -1.f }, Vector3{ 1.f }) };
+
+        EXPECT_TRUE(hull.Contains(Vector3{ 0.f }));
+        EXPECT_TRUE(hull.Contains(Vector3{ 1.f, 1.f, 1.f }));
+        EXPECT_TRUE(hull.Contains(Vector3{ .99f, -.5f, 0.f }));
+        EXPECT_FALSE(hull.Contains(Vector3{ 1.01f, 0.f, 0.f }));
+        EXPECT_FALSE(hull.Contains(Vector3{ 0.f, -2.f, 0.f }));
+    }
+}
@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Fitting.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class FittingTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance)) << expected << " vs " << actual;
+        }
+
+        static void ExpectEncloses(const Sphere& sphere, const vector<Vector3>& points)
+        {
+            for (const Vector3& point : points)
+            {
+                EXPECT_LE((point - sphere.origin).Magnitude(), sphere.radius);
+            }
+        }
+
+        static void ExpectEncloses(const Obb& box, const vector<Vector3>& points)
+        {
+            for (const Vector3& point : points)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const float projection = Vector3::Dot(point - box.origin, box.orientation.GetColumn(axis));
+                    EXPECT_LE(MathF::Abs(projection), box.extents[axis] * 1.0001f + 0.0001f);
+                }
+            }
+        }
+
+        static void ExpectOrthonormal(const Matrix3& orientation)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    AssertFloatEqual(i == j ? 1.f : 0.f, Vector3::Dot(orientation.GetColumn(i), orientation.GetColumn(j)), 0.001f);
+                }
+            }
+        }
+
+        static float HalfArea(const Vector3& extents)
+        {
+            return 4.f * (extents.x * extents.y + extents.y * extents.z + extents.z * extents.x);
+        }
+
+        // Smallest enclosing sphere found by trying every support set of up to 4 points
+        static float BruteForceRadius(const vector<Vector3>& points)
+        {
+            float best = std::numeric_limits<float>::infinity();
+            const int count = static_cast<int>(points.size());
+
+            auto consider = [&](const Vector3& center)
+            {
+                float radius = 0.f;
+                for (const Vector3& point : points)
+                {
+                    radius = std::max(radius, (point - center).Magnitude());
+                }
+
+                best = std::min(best, radius);
+            };
+
+            for (int i = 0; i < count; ++i)
+            {
+                for (int j = i + 1; j < count; ++j)
+                {
+                    consider((points[i] + points[j]) * .5f);
+
+                    for (int k = j + 1; k < count; ++k)
+                    {
+                        const Vector3 ab = points[j] - points[i];
+                        const Vector3 ac = points[k] - points[i];
+                        const Vector3 n = Vector3::Cross(ab, ac);
+                        consider(points[i] + (Vector3::Cross(n, ab) * ac.MagnitudeSqr() + Vector3::Cross(ac, n) * ab.MagnitudeSqr()) * (.5f / n.MagnitudeSqr()));
+
+                        for (int l = k + 1; l < count; ++l)
+                        {
+                            const Vector3 ad = points[l] - points[i];
+                            const float determinant = Vector3::Dot(ab, Vector3::Cross(ac, ad));
+                            const Vector3 offset = (Vector3::Cross(ac, ad) * ab.MagnitudeSqr() + Vector3::Cross(ad, ab) * ac.MagnitudeSqr() + Vector3::Cross(ab, ac) * ad.MagnitudeSqr()) * (.5f / determinant);
+                            consider(points[i] + offset);
+                        }
+                    }
+                }
+            }
+
+            return best;
+        }
+    };
+
+    TEST_F(FittingTests, Empty_ReturnsZeroVolumes)
+    {
+        EXPECT_EQ(0.f, Fitting::MinimalSphere(span<const Vector3>{}).radius);
+        EXPECT_EQ(Vector3{ 0.f }, Fitting::TightObb(span<const Vector3>{}).extents);
+        EXPECT_EQ(Vector3{ 0.f }, Fitting::Bounds(span<const Vector3>{}).extents);
+    }
+
+    TEST_F(FittingTests, Bounds_RandomPoints_MatchesMinMax)
+    {
+        vector<Vector3> points;
+        for (unsigned i = 0; i < 10000; ++i)
+        {
+            points.push_back(ScatterPoint(i, Vector3{ -3.f, 1.f, -8.f }, Vector3{ 5.f, 2.f, -1.f }));
+        }
+
+        Vector3 min = points[0];
+        Vector3 max = points[0];
+        for (const Vector3& point : points)
+        {
+            min = Vector3::Min(min, point);
+            max = Vector3::Max(max, point);
+        }
+
+        const Aabb bounds = Fitting::Bounds(points);
+        EXPECT_EQ(min, bounds.Min());
+        EXPECT_EQ(max, bounds.Max());
+    }
+
+    TEST_F(FittingTests, MinimalSphere_TwoPoints_IsDiameter)
+    {
+        const vector<Vector3> points{ Vector3{ 1.f, 2.f, 3.f }, Vector3{ 5.f, 2.f, 0.f } };
+        const Sphere sphere = Fitting::MinimalSphere(points);
+
+        AssertFloatEqual(2.5f, sphere.radius);
+        AssertFloatEqual(3.f, sphere.origin.x);
+        AssertFloatEqual(1.5f, sphere.origin.z);
+    }
+
+    TEST_F(FittingTests, MinimalSphere_CubeCorners_CircumscribesCube)
+    {
+        vector<Vector3> points;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            points.push_back(Vector3{ corner & 1 ? 3.f : 1.f, corner & 2 ? 3.f : 1.f, corner & 4 ? 3.f : 1.f });
+        }
+
+        // Interior points must not move the sphere
+        for (unsigned i = 0; i < 100; ++i)
+        {
+            points.push_back(ScatterPoint(i, Vector3{ 1.f }, Vector3{ 3.f }));
+        }
+
+        const Sphere sphere = Fitting::MinimalSphere(points);
+
+        AssertFloatEqual(std::sqrt(3.f), sphere.radius);
+        AssertFloatEqual(2.f, sphere.origin.x);
+        AssertFloatEqual(2.f, sphere.origin.y);
+        AssertFloatEqual(2.f, sphere.origin.z);
+        ExpectEncloses(sphere, points);
+    }
+
+    TEST_F(FittingTests, MinimalSphere_SmallSets_MatchesBruteForce)
+    {
+        for (unsigned set = 0; set < 30; ++set)
+        {
+            vector<Vector3> points;
+            for (unsigned i = 0; i < 9; ++i)
+            {
+                points.push_back(ScatterPoint(set * 100 + i, Vector3{ -4.f, -1.f, -2.f }, Vector3{ 4.f, 1.f, 6.f }));
+            }
+
+            const Sphere sphere = Fitting::MinimalSphere(points);
+
+            AssertFloatEqual(BruteForceRadius(points), sphere.radius, 0.001f);
+            ExpectEncloses(sphere, points);
+        }
+    }
+
+    TEST_F(FittingTests, MinimalSphere_DegenerateSets_EnclosesEveryPoint)
+    {
+        const vector<Vector3> same(20, Vector3{ 4.f, -2.f, 1.f });
+        const Sphere point = Fitting::MinimalSphere(same);
+        AssertFloatEqual(0.f, point.radius);
+        ExpectEncloses(point, same);
+
+        vector<Vector3> line;
+        for (int i = 0; i <= 20; ++i)
+        {
+            line.push_back(Vector3{ 1.f, 2.f, 3.f } * (i * .5f));
+        }
+
+        const Sphere segment = Fitting::MinimalSphere(line);
+        AssertFloatEqual(Vector3{ 1.f, 2.f, 3.f }.Magnitude() * 5.f, segment.radius, 0.001f);
+        ExpectEncloses(segment, line);
+
+        vector<Vector3> grid;
+        for (int x = 0; x < 5; ++x)
+        {
+            for (int z = 0; z < 5; ++z)
+            {
+                grid.push_back(Vector3{ x * 1.f, 7.f, z * 1.f });
+            }
+        }
+
+        const Sphere square = Fitting::MinimalSphere(grid);
+        AssertFloatEqual(std::sqrt(8.f), square.radius, 0.001f);
+        ExpectEncloses(square, grid);
+    }
+
+    TEST_F(FittingTests, TightObb_RotatedBox_RecoversTheBox)
+    {
+        const Matrix3 rotation = Matrix3::Rotation(Vector3{ 1.f, 2.f, .5f }.Normalized(), 37.f);
+        const Vector3 center{ 2.f, -3.f, 10.f };
+        const Vector3 half{ 4.f, 1.f, .5f };
+
+        vector<Vector3> points;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const Vector3 local{ corner & 1 ? half.x : -half.x, corner & 2 ? half.y : -half.y, corner & 4 ? half.z : -half.z };
+            points.push_back(center + rotation * local);
+        }
+
+        for (unsigned i = 0; i < 5000; ++i)
+        {
+            points.push_back(center + rotation * ScatterPoint(i, half * -1.f, half));
+        }
+
+        const Obb box = Fitting::TightObb(points);
+
+        ExpectOrthonormal(box.orientation);
+        ExpectEncloses(box, points);
+        EXPECT_LE(HalfArea(box.extents), HalfArea(half) * 1.01f);
+
+        const Aabb bounds = Fitting::Bounds(points);
+        EXPECT_LT(HalfArea(box.extents), HalfArea(bounds.extents) * .75f);
+    }
+
+    TEST_F(FittingTests, TightObb_RandomClouds_EnclosesAndBeatsAabb)
+    {
+        for (unsigned set = 0; set < 10; ++set)
+        {
+            const Matrix3 rotation = Matrix3::Rotation(ScatterPoint(set + 77, Vector3{ -1.f }, Vector3{ 1.f }).Normalized(), Scatter(set, 0.f, 90.f));
+
+            vector<Vector3> points;
+            for (unsigned i = 0; i < 2000; ++i)
+            {
+                // Ellipsoidal blob, elongated along one axis
+                const Vector3 local = ScatterPoint(set * 5000 + i, Vector3{ -6.f, -2.f, -1.f }, Vector3{ 6.f, 2.f, 1.f });
+                if (local.x * local.x / 36.f + local.y * local.y / 4.f + local.z * local.z > 1.f)
+                {
+                    continue;
+                }
+
+                points.push_back(rotation * local);
+            }
+
+            const Obb box = Fitting::TightObb(points);
+            const Aabb bounds = Fitting::Bounds(points);
+
+            ExpectOrthonormal(box.orientation);
+            ExpectEncloses(box, points);
+            EXPECT_LE(HalfArea(box.extents), HalfArea(bounds.extents) * 1.0001f);
+        }
+    }
+
+    TEST_F(FittingTests, TightObb_DegenerateSets_EnclosesEveryPoint)
+    {
+        const vector<Vector3> same(10, Vector3{ 1.f, 1.f, 1.f });
+        const Obb point = Fitting::TightObb(same);
+        EXPECT_EQ(Vector3{ 0.f }, point.extents);
+        ExpectEncloses(point, same);
+
+        vector<Vector3> line;
+        for (int i = 0; i <= 10; ++i)
+        {
+            line.push_back(Vector3{ 2.f, -1.f, 2.f } * (i * .1f));
+        }
+
+        const Obb segment = Fitting::TightObb(line);
+        ExpectOrthonormal(segment.orientation);
+        ExpectEncloses(segment, line);
+        AssertFloatEqual(1.5f, std::max({ segment.extents.x, segment.extents.y, segment.extents.z }), 0.001f);
+        AssertFloatEqual(0.f, HalfArea(segment.extents), 0.001f);
+    }
+
+    TEST_F(FittingTests, Mesh_MatchesVertexSpan)
+    {
+        vector<Triangle> triangles;
+        vector<Vector3> vertices;
+        for (unsigned i = 0; i < 50; ++i)
+        {
+            const Vector3 a = ScatterPoint(i, Vector3{ -2.f }, Vector3{ 2.f });
+            const Vector3 b = ScatterPoint(i + 100, Vector3{ -2.f }, Vector3{ 2.f });
+            const Vector3 c = ScatterPoint(i + 200, Vector3{ -2.f }, Vector3{ 2.f });
+            triangles.push_back(Triangle{ a, b, c });
+            vertices.insert(vertices.end(), { a, b, c });
+        }
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        const Sphere sphere = Fitting::MinimalSphere(mesh);
+        EXPECT_EQ(Fitting::MinimalSphere(vertices).radius, sphere.radius);
+        ExpectEncloses(sphere, vertices);
+
+        const Obb box = Fitting::TightObb(mesh);
+        EXPECT_EQ(Fitting::TightObb(vertices).extents, box.extents);
+        ExpectEncloses(box, vertices);
+    }
+}
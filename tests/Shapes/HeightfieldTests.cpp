@@ -0,0 +1,307 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Heightfield.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class HeightfieldTests : public Test
+    {
+    public:
+        // Sizes that leave partial tiles on both axes
+        static constexpr int COLUMNS = 37;
+        static constexpr int ROWS = 29;
+
+        vector<float> samples;
+        Heightfield field;
+        vector<Triangle> triangles;
+
+    public:
+        // Rolling terrain with some noise, 0.5 units between samples
+        void SetUp() override
+        {
+            for (int z = 0; z < ROWS; ++z)
+            {
+                for (int x = 0; x < COLUMNS; ++x)
+                {
+                    samples.push_back(std::sin(x * .3f) * 2.f + std::cos(z * .2f) * 3.f + Scatter(z * COLUMNS + x, -.5f, .5f));
+                }
+            }
+
+            field = Heightfield{ COLUMNS, ROWS, samples, Vector3{ -5.f, 1.f, 2.f }, .5f, .5f };
+
+            for (int z = 0; z < ROWS - 1; ++z)
+            {
+                for (int x = 0; x < COLUMNS - 1; ++x)
+                {
+                    Triangle first;
+                    Triangle second;
+                    field.CellTriangles(x, z, first, second);
+                    triangles.push_back(first);
+                    triangles.push_back(second);
+                }
+            }
+        }
+
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        // Nearest front-face hit over every triangle of the field
+        float BruteForceCast(const Ray& ray) const
+        {
+            float nearest = -1.f;
+            for (const Triangle& triangle : triangles)
+            {
+                const float hit = ray.CastAgainst(triangle);
+                if (hit >= 0.f && (nearest < 0.f || hit < nearest))
+                {
+                    nearest = hit;
+                }
+            }
+
+            return nearest;
+        }
+
+        template <typename Shape>
+        bool BruteForceIntersects(const Shape& shape) const
+        {
+            for (const Triangle& triangle : triangles)
+            {
+                if (triangle.Intersects(shape))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    TEST_F(HeightfieldTests, Constructor_InvalidSampleCount_IsEmpty)
+    {
+        const vector<float> few(5, 0.f);
+        const Heightfield empty{ 3, 3, few, Vector3{ 0.f }, 1.f, 1.f };
+
+        EXPECT_TRUE(empty.IsEmpty());
+        EXPECT_EQ(-1.f, empty.CastRay(Ray{ Vector3{ 1.f, 5.f, 1.f }, Vector3{ 0.f, -1.f, 0.f } }));
+        EXPECT_FALSE(empty.Intersects(Aabb{ Vector3{ 0.f }, Vector3{ 10.f } }));
+    }
+
+    TEST_F(HeightfieldTests, Constructor_BuildsPyramidDownToOneEntry)
+    {
+        ASSERT_FALSE(field.IsEmpty());
+        EXPECT_EQ(1, field.mips.back().columns);
+        EXPECT_EQ(1, field.mips.back().rows);
+        EXPECT_EQ(9, field.mips[0].columns);
+        EXPECT_EQ(7, field.mips[0].rows);
+
+        const Aabb bounds = field.Bounds();
+        for (const Triangle& triangle : triangles)
+        {
+            for (const Vector3& point : { triangle.a, triangle.b, triangle.c })
+            {
+                EXPECT_LE(point.y, bounds.Max().y + 1e-4f);
+                EXPECT_GE(point.y, bounds.Min().y - 1e-4f);
+            }
+        }
+    }
+
+    TEST_F(HeightfieldTests, HeightAt_Samples_ReturnsSampleHeights)
+    {
+        float height = 0.f;
+
+        ASSERT_TRUE(field.HeightAt(-5.f + 3 * .5f, 2.f + 4 * .5f, height));
+        AssertFloatEqual(1.f + samples[4 * COLUMNS + 3], height);
+
+        ASSERT_TRUE(field.HeightAt(-5.f + 36 * .5f, 2.f + 28 * .5f, height));
+        AssertFloatEqual(1.f + samples.back(), height);
+
+        EXPECT_FALSE(field.HeightAt(-6.f, 3.f, height));
+    }
+
+    TEST_F(HeightfieldTests, HeightAt_InsideCell_LiesOnCastSurface)
+    {
+        for (unsigned i = 0; i < 50; ++i)
+        {
+            const float x = Scatter(i, -4.9f, 12.9f);
+            const float z = Scatter(i + 100, 2.1f, 15.9f);
+
+            float height = 0.f;
+            ASSERT_TRUE(field.HeightAt(x, z, height));
+
+            const float hit = field.CastRay(Ray{ Vector3{ x, 20.f, z }, Vector3{ 0.f, -1.f, 0.f } });
+            AssertFloatEqual(20.f - height, hit, 0.001f);
+        }
+    }
+
+    TEST_F(HeightfieldTests, CastRay_RandomRays_MatchesTriangleBruteForce)
+    {
+        const Vector3 above{ -8.f, 8.f, -1.f };
+        const Vector3 farAbove{ 16.f, 12.f, 19.f };
+
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const Vector3 from = ScatterPoint(i, above, farAbove);
+            const Vector3 to = ScatterPoint(i + 1000, Vector3{ -4.5f, -6.f, 2.5f }, Vector3{ 12.5f, 0.f, 15.5f });
+            const Ray ray = Ray::FromPoints(from, to);
+
+            const float expected = BruteForceCast(ray);
+            const float actual = field.CastRay(ray);
+
+            ASSERT_EQ(expected >= 0.f, actual >= 0.f) << "ray " << i;
+            if (expected >= 0.f)
+            {
+                AssertFloatEqual(expected, actual, 0.001f);
+            }
+        }
+    }
+
+    TEST_F(HeightfieldTests, CastRay_GrazingRays_MatchesTriangleBruteForce)
+    {
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const Vector3 from = ScatterPoint(i + 2000, Vector3{ -6.f, 2.f, 1.f }, Vector3{ 14.f, 4.f, 17.f });
+            const Vector3 to = ScatterPoint(i + 3000, Vector3{ -6.f, 0.f, 1.f }, Vector3{ 14.f, 3.f, 17.f });
+            const Ray ray = Ray::FromPoints(from, to);
+
+            const float expected = BruteForceCast(ray);
+            const float actual = field.CastRay(ray);
+
+            ASSERT_EQ(expected >= 0.f, actual >= 0.f) << "ray " << i;
+            if (expected >= 0.f)
+            {
+                AssertFloatEqual(expected, actual, 0.001f);
+            }
+        }
+    }
+
+    TEST_F(HeightfieldTests, CastRay_FromBelow_Misses)
+    {
+        EXPECT_EQ(-1.f, field.CastRay(Ray{ Vector3{ 2.f, -20.f, 8.f }, Vector3{ 0.f, 1.f, 0.f } }));
+    }
+
+    TEST_F(HeightfieldTests, CastRay_MaxDistance_IgnoresFartherHits)
+    {
+        const Ray ray{ Vector3{ 2.f, 20.f, 8.f }, Vector3{ 0.f, -1.f, 0.f } };
+        const float hit = field.CastRay(ray);
+
+        ASSERT_GT(hit, 0.f);
+        EXPECT_EQ(-1.f, field.CastRay(ray, hit - .1f));
+        AssertFloatEqual(hit, ray.CastAgainst(field));
+    }
+
+    TEST_F(HeightfieldTests, Intersects_Shapes_MatchesTriangleBruteForce)
+    {
+        const Vector3 min{ -7.f, -5.f, 0.f };
+        const Vector3 max{ 15.f, 8.f, 18.f };
+
+        for (unsigned i = 0; i < 60; ++i)
+        {
+            const Vector3 center = ScatterPoint(i + 4000, min, max);
+            const Vector3 extents = ScatterPoint(i + 5000, Vector3{ .1f }, Vector3{ 1.5f });
+
+            const Aabb box{ center, extents };
+            const Sphere sphere{ center, extents.x };
+            const Obb oriented{ center, extents, Matrix3::Rotation(ScatterPoint(i + 6000, Vector3{ 0.f }, Vector3{ 360.f })) };
+
+            EXPECT_EQ(BruteForceIntersects(box), field.Intersects(box)) << "box " << i;
+            EXPECT_EQ(BruteForceIntersects(sphere), field.Intersects(sphere)) << "sphere " << i;
+            EXPECT_EQ(BruteForceIntersects(oriented), field.Intersects(oriented)) << "obb " << i;
+        }
+    }
+
+    TEST_F(HeightfieldTests, CollectTriangles_Region_ContainsEveryIntersectingTriangle)
+    {
+        const Aabb region{ Vector3{ 3.f, 1.f, 8.f }, Vector3{ 1.2f, 6.f, 0.9f } };
+
+        vector<Triangle> collected(256);
+        const int count = field.CollectTriangles(region, collected);
+        collected.resize(count);
+
+        int expected = 0;
+        for (const Triangle& triangle : triangles)
+        {
+            expected += triangle.Intersects(region);
+        }
+
+        int intersecting = 0;
+        for (const Triangle& triangle : collected)
+        {
+            intersecting += triangle.Intersects(region);
+        }
+
+        EXPECT_GT(expected, 0);
+        EXPECT_EQ(expected, intersecting);
+
+        vector<Triangle> small(3);
+        EXPECT_EQ(3, field.CollectTriangles(region, small));
+    }
+
+    TEST_F(HeightfieldTests, Contacts_SphereOnFlatGround_PushesUp)
+    {
+        const vector<float> flat(16, 0.f);
+        const Heightfield ground{ 4, 4, flat, Vector3{ 0.f }, 1.f, 1.f };
+
+        vector<HeightfieldContact> contacts(16);
+        const int count = ground.Contacts(Sphere{ Vector3{ 1.25f, .4f, 1.6f }, .5f }, contacts);
+
+        // The triangle under the center gives the deepest contact; neighbours touched at an edge give shallower ones
+        ASSERT_GT(count, 0);
+        int deepest = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            EXPECT_GT(contacts[i].normal.y, 0.f);
+            EXPECT_LE(contacts[i].depth, .1f + 1e-5f);
+            AssertFloatEqual(0.f, contacts[i].point.y);
+            EXPECT_GE(contacts[i].triangle, 0);
+            EXPECT_LT(contacts[i].triangle, 18);
+
+            deepest = contacts[i].depth > contacts[deepest].depth ? i : deepest;
+        }
+
+        AssertFloatEqual(1.f, contacts[deepest].normal.y);
+        AssertFloatEqual(.1f, contacts[deepest].depth);
+        AssertFloatEqual(1.25f, contacts[deepest].point.x);
+        AssertFloatEqual(1.6f, contacts[deepest].point.z);
+
+        EXPECT_EQ(0, ground.Contacts(Sphere{ Vector3{ 1.25f, .6f, 1.6f }, .5f }, contacts));
+    }
+
+    TEST_F(HeightfieldTests, Quantize_HeightsWithinOneStep_AndSmaller)
+    {
+        const Heightfield quantized{ COLUMNS, ROWS, samples, field.origin, .5f, .5f, true };
+
+        ASSERT_FALSE(quantized.IsEmpty());
+        EXPECT_TRUE(quantized.heights.empty());
+        EXPECT_LT(quantized.ByteSize(), field.ByteSize());
+
+        for (int z = 0; z < ROWS; ++z)
+        {
+            for (int x = 0; x < COLUMNS; ++x)
+            {
+                EXPECT_NEAR(field.Height(x, z), quantized.Height(x, z), quantized.quantizationStep);
+            }
+        }
+
+        const Ray ray{ Vector3{ 2.f, 20.f, 8.f }, Vector3{ 0.f, -1.f, 0.f } };
+        EXPECT_NEAR(field.CastRay(ray), quantized.CastRay(ray), 0.001f);
+    }
+}
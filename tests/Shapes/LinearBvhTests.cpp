@@ -0,0 +1,400 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/LinearBvh.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class LinearBvhTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        // Long thin triangles running diagonally across the scene: stacked floor strips and upright wall strips
+        static vector<Triangle> MakeSlivers(const int count)
+        {
+            vector<Triangle> result;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const float offset = static_cast<float>(i) * .4f;
+
+                result.emplace_back(Vector3{ 0.f, offset, 0.f }, Vector3{ 40.f, offset, 40.5f }, Vector3{ 40.f, offset, 40.f });
+                result.emplace_back(Vector3{ offset, 0.f, 0.f }, Vector3{ offset + 30.f, 0.f, 40.f }, Vector3{ offset + 30.f, 20.f, 40.f });
+            }
+
+            return result;
+        }
+
+        // Expected traversal cost of a hierarchy under the surface area heuristic, relative to its root
+        static float SahCost(const LinearBvh& bvh)
+        {
+            auto area = [](const LinearBvhNode& node)
+            {
+                const Vector3 size = node.max - node.min;
+                return size.x * size.y + size.y * size.z + size.z * size.x;
+            };
+
+            float cost = 0.f;
+            for (const LinearBvhNode& node : bvh.nodes)
+            {
+                cost += area(node) * (node.IsLeaf() ? static_cast<float>(node.Count()) : 1.f);
+            }
+
+            return cost / area(bvh.nodes[0]);
+        }
+
+        static bool Encloses(const Aabb& outer, const Aabb& inner)
+        {
+            const Vector3 oMin = outer.Min();
+            const Vector3 oMax = outer.Max();
+            const Vector3 iMin = inner.Min();
+            const Vector3 iMax = inner.Max();
+
+            for (int i = 0; i < 3; ++i)
+            {
+                if (iMin[i] < oMin[i] - 0.0001f || iMax[i] > oMax[i] + 0.0001f)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Checks that every primitive is referenced at least once, within the budget, and that parents enclose children
+        static void AssertValidSpatialHierarchy(const LinearBvh& bvh, const int count, const float budget)
+        {
+            ASSERT_FALSE(bvh.IsEmpty());
+            EXPECT_LE(static_cast<float>(bvh.indices.size()), static_cast<float>(count) * (1.f + budget));
+
+            vector<int> seen(count, 0);
+            int referenced = 0;
+
+            for (const LinearBvhNode& node : bvh.nodes)
+            {
+                if (node.IsLeaf())
+                {
+                    referenced += node.Count();
+
+                    for (int i = node.left; i < node.left + node.Count(); ++i)
+                    {
+                        seen[bvh.indices[i]]++;
+                    }
+                }
+                else
+                {
+                    EXPECT_TRUE(Encloses(node.Bounds(), bvh.nodes[node.left].Bounds()));
+                    EXPECT_TRUE(Encloses(node.Bounds(), bvh.nodes[node.right].Bounds()));
+                }
+            }
+
+            EXPECT_EQ(static_cast<int>(bvh.indices.size()), referenced);
+
+            for (const int references : seen)
+            {
+                EXPECT_GE(references, 1);
+            }
+        }
+
+        // Checks node count, that every primitive is referenced exactly once and that parents enclose children
+        static void AssertValidHierarchy(const LinearBvh& bvh, const int count)
+        {
+            ASSERT_EQ(static_cast<size_t>(count) * 2 - 1, bvh.nodes.size());
+            ASSERT_EQ(static_cast<size_t>(count), bvh.indices.size());
+
+            vector<int> seen(count, 0);
+            for (const LinearBvhNode& node : bvh.nodes)
+            {
+                if (node.IsLeaf())
+                {
+                    for (int i = node.left; i < node.left + node.Count(); ++i)
+                    {
+                        seen[bvh.indices[i]]++;
+                    }
+                }
+                else
+                {
+                    EXPECT_TRUE(Encloses(node.Bounds(), bvh.nodes[node.left].Bounds()));
+                    EXPECT_TRUE(Encloses(node.Bounds(), bvh.nodes[node.right].Bounds()));
+                }
+            }
+
+            for (const int references : seen)
+            {
+                EXPECT_EQ(1, references);
+            }
+        }
+    };
+
+    TEST_F(LinearBvhTests, BuildMorton_Empty_LeavesHierarchyEmpty)
+    {
+        LinearBvh bvh;
+        bvh.BuildMorton(nullptr, 0);
+
+        EXPECT_TRUE(bvh.IsEmpty());
+    }
+
+    TEST_F(LinearBvhTests, BuildMorton_SinglePrimitive_CreatesSingleLeaf)
+    {
+        const Aabb bounds{ Vector3{ 1.f, 2.f, 3.f }, Vector3{ 0.5f } };
+
+        LinearBvh bvh;
+        bvh.BuildMorton(&bounds, 1);
+
+        ASSERT_EQ(1u, bvh.nodes.size());
+        EXPECT_TRUE(bvh.nodes[0].IsLeaf());
+        EXPECT_EQ(1, bvh.nodes[0].Count());
+        EXPECT_EQ(0, bvh.indices[0]);
+    }
+
+    TEST_F(LinearBvhTests, BuildMorton_PointsAlongAxis_OrdersLeavesSpatially)
+    {
+        vector<Aabb> bounds;
+        for (int i = 0; i < 100; ++i)
+        {
+            // Visit 0..99 in a scrambled order (37 is coprime with 100)
+            bounds.emplace_back(Vector3{ static_cast<float>(i * 37 % 100), 0.f, 0.f }, Vector3{ 0.25f });
+        }
+
+        LinearBvh bvh;
+        bvh.BuildMorton(bounds.data(), static_cast<int>(bounds.size()));
+
+        for (int i = 1; i < 100; ++i)
+        {
+            EXPECT_LT(bounds[bvh.indices[i - 1]].origin.x, bounds[bvh.indices[i]].origin.x);
+        }
+    }
+
+    TEST_F(LinearBvhTests, BuildMorton_Grid_ProducesValidHierarchy)
+    {
+        vector<Triangle> triangles = MakeLayers(40, { 0.f, 2.f, 4.f });
+        Mesh mesh = MakeMesh(triangles);
+
+        mesh.Accelerate(BvhBuildMode::Morton);
+
+        ASSERT_NE(nullptr, mesh.hierarchy);
+        EXPECT_EQ(nullptr, mesh.accelerator);
+        AssertValidHierarchy(*mesh.hierarchy, mesh.numTriangles);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, BuildMorton_PreciseCodes_ProducesValidHierarchy)
+    {
+        vector<Triangle> triangles = MakeLayers(40, { 0.f, 2.f, 4.f });
+        Mesh mesh = MakeMesh(triangles);
+
+        mesh.Accelerate(BvhBuildMode::MortonPrecise);
+
+        AssertValidHierarchy(*mesh.hierarchy, mesh.numTriangles);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, BuildMorton_DuplicateCentroids_ProducesValidHierarchy)
+    {
+        vector<Aabb> bounds(1000, Aabb{ Vector3{ 3.f }, Vector3{ 1.f } });
+
+        LinearBvh bvh;
+        bvh.BuildMorton(bounds.data(), static_cast<int>(bounds.size()));
+
+        AssertValidHierarchy(bvh, static_cast<int>(bounds.size()));
+    }
+
+    TEST_F(LinearBvhTests, CastAgainstMesh_Morton_ReturnsNearestLayer)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 0.f, 2.f, 4.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Morton);
+
+        const Ray ray{ Vector3{ 5.3f, 10.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        AssertFloatEqual(6.f, ray.CastAgainst(mesh));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, CastAgainstMesh_Morton_MatchesBruteForce)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 0.f, 1.5f, 3.f });
+        Mesh bruteForce = MakeMesh(triangles);
+        Mesh accelerated = MakeMesh(triangles);
+        accelerated.Accelerate(BvhBuildMode::Morton);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            for (int j = 0; j < 20; ++j)
+            {
+                const Vector3 origin{ -2.f + static_cast<float>(i), 8.f, -2.f + static_cast<float>(j) };
+                const Vector3 target{ 0.37f + 0.8f * static_cast<float>(j), 0.f, 0.61f + 0.8f * static_cast<float>(i) };
+                const Ray ray = Ray::FromPoints(origin, target);
+
+                AssertFloatEqual(ray.CastAgainst(bruteForce), ray.CastAgainst(accelerated));
+            }
+        }
+
+        accelerated.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, Rebuild_AfterMovingVertices_TracksNewGeometry)
+    {
+        vector<Triangle> triangles = MakeLayers(8, { 0.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Morton);
+
+        const Ray ray{ Vector3{ 3.3f, 10.f, 3.6f }, Vector3{ 0.f, -1.f, 0.f } };
+        AssertFloatEqual(10.f, ray.CastAgainst(mesh));
+
+        for (int i = 0; i < mesh.numTriangles * 3; ++i)
+        {
+            mesh.vertices[i].y += 5.f;
+        }
+
+        const LinearBvh* previous = mesh.hierarchy;
+        mesh.Rebuild();
+
+        EXPECT_EQ(previous, mesh.hierarchy);
+        AssertValidHierarchy(*mesh.hierarchy, mesh.numTriangles);
+        AssertFloatEqual(5.f, ray.CastAgainst(mesh));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, Rebuild_SameSize_ReusesStorage)
+    {
+        vector<Triangle> triangles = MakeLayers(30, { 0.f, 3.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Rebuild(BvhBuildMode::Morton);
+
+        const LinearBvhNode* nodes = mesh.hierarchy->nodes.data();
+        const int* indices = mesh.hierarchy->indices.data();
+        const int* pending = mesh.hierarchy->scratch.pending.data();
+        const Aabb* bounds = mesh.BuildState().triangleBounds.data();
+
+        for (int i = 0; i < mesh.numTriangles * 3; ++i)
+        {
+            mesh.vertices[i].x += 0.5f * static_cast<float>(i % 3);
+        }
+
+        mesh.Rebuild(BvhBuildMode::Morton);
+
+        EXPECT_EQ(nodes, mesh.hierarchy->nodes.data());
+        EXPECT_EQ(indices, mesh.hierarchy->indices.data());
+        EXPECT_EQ(pending, mesh.hierarchy->scratch.pending.data());
+        EXPECT_EQ(bounds, mesh.BuildState().triangleBounds.data());
+        AssertValidHierarchy(*mesh.hierarchy, mesh.numTriangles);
+
+        // Wide rebuilds keep the binary hierarchy they collapse
+        mesh.Rebuild(BvhBuildMode::Wide);
+        const LinearBvh* source = mesh.BuildState().collapseSource;
+        const LinearBvhNode* sourceNodes = source->nodes.data();
+
+        mesh.Rebuild(BvhBuildMode::Wide);
+
+        EXPECT_EQ(source, mesh.BuildState().collapseSource);
+        EXPECT_EQ(sourceNodes, mesh.BuildState().collapseSource->nodes.data());
+
+        // A structure built once keeps nothing for rebuilds
+        mesh.ReleaseAccelerator();
+        EXPECT_EQ(nullptr, mesh.BuildState().collapseSource);
+
+        mesh.Accelerate(BvhBuildMode::Morton);
+        EXPECT_EQ(0u, mesh.BuildState().triangleBounds.capacity());
+        EXPECT_EQ(0u, mesh.hierarchy->scratch.keys.capacity());
+        AssertValidHierarchy(*mesh.hierarchy, mesh.numTriangles);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, CastAgainstMesh_Octree_ReturnsNearestLayer)
+    {
+        vector<Triangle> triangles = MakeLayers(8, { 0.f, 2.f, 4.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate();
+
+        const Ray ray{ Vector3{ 5.3f, 10.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        AssertFloatEqual(6.f, ray.CastAgainst(mesh));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, BuildSpatial_ThinTriangles_ProducesValidHierarchyWithinBudget)
+    {
+        const vector<Triangle> triangles = MakeSlivers(100);
+
+        LinearBvh bvh;
+        bvh.BuildSpatial(triangles.data(), static_cast<int>(triangles.size()));
+
+        AssertValidSpatialHierarchy(bvh, static_cast<int>(triangles.size()), SBVH_DUPLICATION_BUDGET);
+        EXPECT_GT(bvh.indices.size(), triangles.size());
+    }
+
+    TEST_F(LinearBvhTests, BuildSpatial_ZeroBudget_ReferencesEachTriangleOnce)
+    {
+        const vector<Triangle> triangles = MakeSlivers(100);
+
+        LinearBvh bvh;
+        bvh.BuildSpatial(triangles.data(), static_cast<int>(triangles.size()), 0.f);
+
+        AssertValidSpatialHierarchy(bvh, static_cast<int>(triangles.size()), 0.f);
+        EXPECT_EQ(triangles.size(), bvh.indices.size());
+    }
+
+    TEST_F(LinearBvhTests, BuildSpatial_ThinTriangles_CheaperThanMorton)
+    {
+        vector<Triangle> triangles = MakeSlivers(100);
+        Mesh mesh = MakeMesh(triangles);
+
+        mesh.Accelerate(BvhBuildMode::Morton);
+        const float morton = SahCost(*mesh.hierarchy);
+
+        mesh.Rebuild(BvhBuildMode::Spatial);
+        const float spatial = SahCost(*mesh.hierarchy);
+
+        EXPECT_LT(spatial * 1.5f, morton);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(LinearBvhTests, CastAgainstMesh_Spatial_MatchesBruteForce)
+    {
+        vector<Triangle> triangles = MakeSlivers(60);
+        vector<Triangle> layers = MakeLayers(16, { 0.5f, 13.f });
+        triangles.insert(triangles.end(), layers.begin(), layers.end());
+
+        Mesh bruteForce = MakeMesh(triangles);
+        Mesh accelerated = MakeMesh(triangles);
+        accelerated.Accelerate(BvhBuildMode::Spatial);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            for (int j = 0; j < 20; ++j)
+            {
+                const Vector3 origin{ -2.f + 2.f * static_cast<float>(i), 30.f, -2.f + 2.f * static_cast<float>(j) };
+                const Vector3 target{ 0.37f + 2.f * static_cast<float>(j), 0.f, 0.61f + 2.f * static_cast<float>(i) };
+                const Ray ray = Ray::FromPoints(origin, target);
+
+                AssertFloatEqual(ray.CastAgainst(bruteForce), ray.CastAgainst(accelerated));
+            }
+        }
+
+        accelerated.ReleaseAccelerator();
+    }
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/LooseOctree.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class LooseOctreeTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        static vector<int> Collect(const LooseOctree& tree, const Aabb& region)
+        {
+            vector<int> found;
+            tree.Query(region, [&](const int proxy)
+            {
+                found.push_back(proxy);
+                return false;
+            });
+
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+        // Ids of live proxies whose bounds overlap a region, sorted
+        static vector<int> BruteForce(const LooseOctree& tree, const Aabb& region)
+        {
+            vector<int> expected;
+            for (int i = 0; i < static_cast<int>(tree.proxies.size()); ++i)
+            {
+                if (tree.proxies[i].node >= 0 && tree.proxies[i].bounds.Intersects(region))
+                {
+                    expected.push_back(i);
+                }
+            }
+
+            return expected;
+        }
+    };
+
+    TEST_F(LooseOctreeTests, Constructor_Empty_HasOnlyRoot)
+    {
+        const LooseOctree tree{ Vector3{ 0.f }, 1000.f };
+
+        EXPECT_EQ(1, tree.NodeCount());
+        EXPECT_EQ(0, tree.count);
+        EXPECT_TRUE(Collect(tree, Aabb{ Vector3{ 0.f }, Vector3{ 1000.f } }).empty());
+    }
+
+    TEST_F(LooseOctreeTests, Insert_SmallObject_StoredDeep)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 1024.f, 8 };
+
+        const int small = tree.Insert(Aabb{ Vector3{ 100.f, 200.f, -300.f }, Vector3{ 1.f } });
+        const int large = tree.Insert(Aabb{ Vector3{ 100.f, 200.f, -300.f }, Vector3{ 600.f } });
+
+        EXPECT_EQ(8, tree.proxies[small].depth);
+        EXPECT_EQ(0, tree.proxies[large].depth);
+        EXPECT_EQ(9, tree.NodeCount());
+        EXPECT_EQ(2, tree.nodes[0].population);
+    }
+
+    TEST_F(LooseOctreeTests, Insert_ObjectInsideLooseBoundsOfItsNode)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 1024.f, 10 };
+
+        for (unsigned i = 0; i < 500; ++i)
+        {
+            const Aabb bounds{ ScatterPoint(i, -1000.f, 1000.f), ScatterPoint(i + 1000, .1f, 50.f) };
+            const int id = tree.Insert(bounds);
+
+            const LooseOctreeNode& node = tree.nodes[tree.proxies[id].node];
+            const float reach = node.halfSize * tree.looseness;
+
+            EXPECT_LE(node.center.x - reach, bounds.Min().x);
+            EXPECT_GE(node.center.x + reach, bounds.Max().x);
+            EXPECT_LE(node.center.y - reach, bounds.Min().y);
+            EXPECT_GE(node.center.y + reach, bounds.Max().y);
+            EXPECT_LE(node.center.z - reach, bounds.Min().z);
+            EXPECT_GE(node.center.z + reach, bounds.Max().z);
+        }
+    }
+
+    TEST_F(LooseOctreeTests, Query_ScatteredObjects_MatchesBruteForce)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 2048.f };
+
+        for (unsigned i = 0; i < 1000; ++i)
+        {
+            tree.Insert(Aabb{ ScatterPoint(i, -2000.f, 2000.f), ScatterPoint(i + 5000, .5f, 40.f) });
+        }
+
+        for (unsigned q = 0; q < 40; ++q)
+        {
+            const Aabb region{ ScatterPoint(q + 9000, -2000.f, 2000.f), ScatterPoint(q + 9500, 10.f, 400.f) };
+
+            EXPECT_EQ(BruteForce(tree, region), Collect(tree, region));
+        }
+    }
+
+    TEST_F(LooseOctreeTests, Query_ObjectCenteredOutsideRoot_StillFound)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 100.f };
+
+        const int outside = tree.Insert(Sphere{ Vector3{ 500.f, 0.f, 0.f }, 2.f });
+
+        EXPECT_EQ(0, tree.proxies[outside].node);
+        EXPECT_EQ((vector<int>{ outside }), Collect(tree, Aabb{ Vector3{ 501.f, 0.f, 0.f }, Vector3{ 1.f } }));
+    }
+
+    TEST_F(LooseOctreeTests, Query_Sphere_TestsAgainstSphere)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 100.f };
+
+        const int touching = tree.Insert(Aabb{ Vector3{ 3.f, 0.f, 0.f }, Vector3{ 1.f } });
+        tree.Insert(Aabb{ Vector3{ 4.f, 4.f, 4.f }, Vector3{ .5f } });
+
+        vector<int> found;
+        tree.Query(Sphere{ Vector3{ 0.f }, 3.f }, [&](const int proxy)
+        {
+            found.push_back(proxy);
+            return false;
+        });
+
+        EXPECT_EQ((vector<int>{ touching }), found);
+    }
+
+    TEST_F(LooseOctreeTests, Move_WithinCell_KeepsNode)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 1024.f, 6 };
+
+        const int id = tree.Insert(Aabb{ Vector3{ 10.f, 10.f, 10.f }, Vector3{ 1.f } });
+        const int node = tree.proxies[id].node;
+
+        tree.Move(id, Aabb{ Vector3{ 10.5f, 10.f, 10.f }, Vector3{ 1.f } });
+
+        EXPECT_EQ(node, tree.proxies[id].node);
+        AssertFloatEqual(10.5f, tree.proxies[id].bounds.origin.x);
+    }
+
+    TEST_F(LooseOctreeTests, Move_AcrossZone_RelinksAndPrunesNodes)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 1024.f, 6 };
+
+        const int id = tree.Insert(Sphere{ Vector3{ -900.f, -900.f, -900.f }, 1.f });
+        EXPECT_EQ(7, tree.NodeCount());
+
+        tree.Move(id, Sphere{ Vector3{ 900.f, 900.f, 900.f }, 1.f });
+
+        EXPECT_EQ(7, tree.NodeCount());
+        EXPECT_TRUE(Collect(tree, Aabb{ Vector3{ -900.f }, Vector3{ 5.f } }).empty());
+        EXPECT_EQ((vector<int>{ id }), Collect(tree, Aabb{ Vector3{ 900.f }, Vector3{ 5.f } }));
+    }
+
+    TEST_F(LooseOctreeTests, Remove_LastObject_ReturnsNodesToPool)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 1024.f, 6 };
+
+        const int a = tree.Insert(Aabb{ Vector3{ 10.f }, Vector3{ 1.f } });
+        const int b = tree.Insert(Aabb{ Vector3{ -10.f }, Vector3{ 1.f } });
+
+        tree.Remove(a);
+        tree.Remove(a);
+
+        EXPECT_EQ(1, tree.count);
+        EXPECT_EQ((vector<int>{ b }), Collect(tree, Aabb{ Vector3{ 0.f }, Vector3{ 100.f } }));
+
+        tree.Remove(b);
+
+        EXPECT_EQ(0, tree.count);
+        EXPECT_EQ(1, tree.NodeCount());
+        EXPECT_EQ(0, tree.nodes[0].population);
+
+        // Freed slots are reused
+        const int c = tree.Insert(Aabb{ Vector3{ 10.f }, Vector3{ 1.f } });
+        EXPECT_TRUE(c == a || c == b);
+        EXPECT_EQ(2u, tree.proxies.size());
+    }
+
+    TEST_F(LooseOctreeTests, RandomOperations_QueriesMatchBruteForce)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 512.f, 7 };
+        vector<int> live;
+
+        for (unsigned step = 0; step < 3000; ++step)
+        {
+            const float action = Scatter(step, 0.f, 1.f);
+
+            if (action < .4f || live.empty())
+            {
+                live.push_back(tree.Insert(Aabb{ ScatterPoint(step, -600.f, 600.f), ScatterPoint(step + 7000, .1f, 30.f) }));
+            }
+            else if (action < .6f)
+            {
+                const size_t slot = static_cast<size_t>(Scatter(step + 1, 0.f, static_cast<float>(live.size())));
+                tree.Remove(live[slot]);
+                live.erase(live.begin() + slot);
+            }
+            else
+            {
+                const size_t slot = static_cast<size_t>(Scatter(step + 2, 0.f, static_cast<float>(live.size())));
+                const Aabb& current = tree.proxies[live[slot]].bounds;
+                tree.Move(live[slot], Aabb{ current.origin + ScatterPoint(step + 3, -20.f, 20.f), current.extents });
+            }
+        }
+
+        EXPECT_EQ(static_cast<int>(live.size()), tree.count);
+        EXPECT_EQ(tree.count, tree.nodes[0].population);
+
+        for (unsigned q = 0; q < 30; ++q)
+        {
+            const Aabb region{ ScatterPoint(q + 11000, -500.f, 500.f), ScatterPoint(q + 12000, 5.f, 150.f) };
+
+            EXPECT_EQ(BruteForce(tree, region), Collect(tree, region));
+        }
+    }
+
+    TEST_F(LooseOctreeTests, CastRay_Boxes_ReturnsNearestLikeBruteForce)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 1024.f };
+
+        for (unsigned i = 0; i < 800; ++i)
+        {
+            tree.Insert(Aabb{ ScatterPoint(i, -1000.f, 1000.f), ScatterPoint(i + 3000, 1.f, 30.f) });
+        }
+
+        for (unsigned q = 0; q < 40; ++q)
+        {
+            const Ray ray = Ray::FromPoints(ScatterPoint(q + 20000, -1000.f, 1000.f), ScatterPoint(q + 21000, -1000.f, 1000.f));
+
+            float expected = -1.f;
+            for (const LooseOctreeProxy& proxy : tree.proxies)
+            {
+                const float hit = ray.CastAgainst(proxy.bounds);
+                if (hit >= 0.f && (expected < 0.f || hit < expected))
+                {
+                    expected = hit;
+                }
+            }
+
+            float distance = -1.f;
+            const int nearest = tree.CastRay(ray, distance);
+
+            ASSERT_EQ(expected >= 0.f, nearest >= 0);
+            if (nearest >= 0)
+            {
+                AssertFloatEqual(expected, distance, 0.01f);
+            }
+        }
+    }
+
+    TEST_F(LooseOctreeTests, CastRay_ExactCallback_SkipsBoundsOnlyHits)
+    {
+        LooseOctree tree{ Vector3{ 0.f }, 100.f };
+
+        const vector<Sphere> spheres
+        {
+            Sphere{ Vector3{ 5.f, 1.8f, 1.8f }, 2.f },
+            Sphere{ Vector3{ 10.f, 0.f, 0.f }, 1.f }
+        };
+
+        for (const Sphere& sphere : spheres)
+        {
+            tree.Insert(sphere);
+        }
+
+        const Ray ray{ Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f } };
+
+        float distance = -1.f;
+        EXPECT_EQ(0, tree.CastRay(ray, distance));
+
+        const int nearest = tree.CastRay(ray, [&](const int proxy, float)
+        {
+            return ray.CastAgainst(spheres[proxy]);
+        }, distance);
+
+        EXPECT_EQ(1, nearest);
+        AssertFloatEqual(9.f, distance);
+    }
+}
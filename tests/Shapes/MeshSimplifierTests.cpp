@@ -0,0 +1,356 @@
+#include <array>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/MeshSimplifier.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::array;
+using std::map;
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class MeshSimplifierTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance)) << expected << " vs " << actual;
+        }
+
+        // Open size x size grid of quads on the plane y = 0, spanning [0, size] in x and z
+        static vector<Triangle> MakeGrid(const int size)
+        {
+            vector<Triangle> result;
+            for (int x = 0; x < size; ++x)
+            {
+                for (int z = 0; z < size; ++z)
+                {
+                    const Vector3 p00{ static_cast<float>(x), 0.f, static_cast<float>(z) };
+                    const Vector3 p10{ static_cast<float>(x + 1), 0.f, static_cast<float>(z) };
+                    const Vector3 p01{ static_cast<float>(x), 0.f, static_cast<float>(z + 1) };
+                    const Vector3 p11{ static_cast<float>(x + 1), 0.f, static_cast<float>(z + 1) };
+
+                    result.emplace_back(p00, p01, p11);
+                    result.emplace_back(p00, p11, p10);
+                }
+            }
+
+            return result;
+        }
+
+        // Closed surface of [-1, 1]^3 with every face split into size x size quads,
+        // optionally pushed out onto the unit sphere
+        static vector<Triangle> MakeCube(const int size, const bool sphere)
+        {
+            const auto point = [size, sphere](const int x, const int y, const int z)
+            {
+                Vector3 p{ static_cast<float>(x) * 2.f / static_cast<float>(size) - 1.f,
+                    static_cast<float>(y) * 2.f / static_cast<float>(size) - 1.f,
+                    static_cast<float>(z) * 2.f / static_cast<float>(size) - 1.f };
+
+                return sphere ? p.Normalized() : p;
+            };
+
+            vector<Triangle> result;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (int side = 0; side <= size; side += size)
+                {
+                    for (int u = 0; u < size; ++u)
+                    {
+                        for (int v = 0; v < size; ++v)
+                        {
+                            int corners[4][3];
+                            const int offsets[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+                            for (int k = 0; k < 4; ++k)
+                            {
+                                corners[k][axis] = side;
+                                corners[k][(axis + 1) % 3] = u + offsets[k][0];
+                                corners[k][(axis + 2) % 3] = v + offsets[k][1];
+                            }
+
+                            Vector3 p[4];
+                            for (int k = 0; k < 4; ++k)
+                            {
+                                p[k] = point(corners[k][0], corners[k][1], corners[k][2]);
+                            }
+
+                            // Wind outwards on the positive side, inwards flipped on the negative side
+                            if (side == size)
+                            {
+                                result.emplace_back(p[0], p[1], p[2]);
+                                result.emplace_back(p[0], p[2], p[3]);
+                            }
+                            else
+                            {
+                                result.emplace_back(p[0], p[2], p[1]);
+                                result.emplace_back(p[0], p[3], p[2]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        // Number of edges used by exactly one triangle, and number used by more than two
+        static void CountEdges(const vector<Triangle>& triangles, int& open, int& nonManifold)
+        {
+            map<array<float, 6>, int> uses;
+            for (const Triangle& triangle : triangles)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    Vector3 a = triangle.points[k];
+                    Vector3 b = triangle.points[(k + 1) % 3];
+                    if (array<float, 3>{ b.x, b.y, b.z } < array<float, 3>{ a.x, a.y, a.z })
+                    {
+                        std::swap(a, b);
+                    }
+
+                    ++uses[{ a.x, a.y, a.z, b.x, b.y, b.z }];
+                }
+            }
+
+            open = 0;
+            nonManifold = 0;
+            for (const auto& [edge, count] : uses)
+            {
+                open += count == 1 ? 1 : 0;
+                nonManifold += count > 2 ? 1 : 0;
+            }
+        }
+
+        static float Area(const vector<Triangle>& triangles)
+        {
+            float area = 0.f;
+            for (const Triangle& triangle : triangles)
+            {
+                area += Vector3::Cross(triangle.b - triangle.a, triangle.c - triangle.a).Magnitude() * .5f;
+            }
+
+            return area;
+        }
+
+        static Aabb Bounds(const vector<Triangle>& triangles)
+        {
+            Vector3 min = triangles[0].a;
+            Vector3 max = triangles[0].a;
+            for (const Triangle& triangle : triangles)
+            {
+                for (const Vector3& point : triangle.points)
+                {
+                    min = Vector3::Min(min, point);
+                    max = Vector3::Max(max, point);
+                }
+            }
+
+            return Aabb::FromMinMax(min, max);
+        }
+    };
+
+    TEST_F(MeshSimplifierTests, Default_HalvesTriangleCountAndAccelerates)
+    {
+        vector<Triangle> source = MakeCube(8, true);
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{}.Simplify(mesh, triangles);
+
+        EXPECT_LE(simplified.numTriangles, mesh.numTriangles / 2);
+        EXPECT_GT(simplified.numTriangles, mesh.numTriangles / 2 - 3);
+        EXPECT_EQ(triangles.data(), simplified.triangles);
+        EXPECT_NE(nullptr, simplified.wideHierarchy);
+
+        simplified.ReleaseAccelerator();
+    }
+
+    TEST_F(MeshSimplifierTests, Simplify_LeavesSourceUntouched)
+    {
+        vector<Triangle> source = MakeCube(4, true);
+        const vector<Triangle> copy = source;
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{ 20 }.Simplify(mesh, triangles);
+        simplified.ReleaseAccelerator();
+
+        ASSERT_EQ(copy.size(), source.size());
+        for (size_t i = 0; i < copy.size(); ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                EXPECT_EQ(copy[i].points[k], source[i].points[k]);
+            }
+        }
+    }
+
+    TEST_F(MeshSimplifierTests, ClosedMesh_StaysClosedAndManifold)
+    {
+        vector<Triangle> source = MakeCube(10, true);
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{ 60 }.Simplify(mesh, triangles, BvhBuildMode::Morton);
+
+        EXPECT_LE(simplified.numTriangles, 60);
+        EXPECT_NE(nullptr, simplified.hierarchy);
+
+        int open = 0;
+        int nonManifold = 0;
+        CountEdges(triangles, open, nonManifold);
+        EXPECT_EQ(0, open);
+        EXPECT_EQ(0, nonManifold);
+
+        // Still encloses its centre, and stays close to the unit sphere
+        EXPECT_TRUE(simplified.Contains(Vector3{ 0.f }));
+        EXPECT_FALSE(simplified.Contains(Vector3{ 1.5f, 0.f, 0.f }));
+
+        for (const Triangle& triangle : triangles)
+        {
+            for (const Vector3& point : triangle.points)
+            {
+                EXPECT_NEAR(1.f, point.Magnitude(), 0.25f);
+            }
+        }
+
+        simplified.ReleaseAccelerator();
+    }
+
+    TEST_F(MeshSimplifierTests, ClosedMesh_KeepsOutwardWinding)
+    {
+        vector<Triangle> source = MakeCube(6, true);
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{ 40 }.Simplify(mesh, triangles);
+        simplified.ReleaseAccelerator();
+
+        for (const Triangle& triangle : triangles)
+        {
+            const Vector3 normal = Vector3::Cross(triangle.b - triangle.a, triangle.c - triangle.a);
+            const Vector3 centre = (triangle.a + triangle.b + triangle.c) / 3.f;
+            EXPECT_GT(Vector3::Dot(normal, centre), 0.f);
+        }
+    }
+
+    TEST_F(MeshSimplifierTests, FlatGrid_PreservesBoundaryAndArea)
+    {
+        vector<Triangle> source = MakeGrid(12);
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{ 40 }.Simplify(mesh, triangles);
+        simplified.ReleaseAccelerator();
+
+        EXPECT_LE(simplified.numTriangles, 40);
+        AssertFloatEqual(144.f, Area(triangles), 0.01f);
+
+        const Aabb bounds = Bounds(triangles);
+        EXPECT_EQ(Vector3(0.f, 0.f, 0.f), bounds.Min());
+        EXPECT_EQ(Vector3(12.f, 0.f, 12.f), bounds.Max());
+
+        // Boundary vertices slide along the boundary but never leave it
+        int open = 0;
+        int nonManifold = 0;
+        CountEdges(triangles, open, nonManifold);
+        EXPECT_EQ(0, nonManifold);
+
+        for (const Triangle& triangle : triangles)
+        {
+            for (const Vector3& point : triangle.points)
+            {
+                EXPECT_NEAR(0.f, point.y, 0.0001f);
+                EXPECT_GE(point.x, -0.0001f);
+                EXPECT_LE(point.x, 12.0001f);
+                EXPECT_GE(point.z, -0.0001f);
+                EXPECT_LE(point.z, 12.0001f);
+            }
+        }
+    }
+
+    TEST_F(MeshSimplifierTests, MaxError_FlatFacesCollapseButCornersStay)
+    {
+        vector<Triangle> source = MakeCube(6, false);
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{ 0, 0.001f }.Simplify(mesh, triangles);
+        simplified.ReleaseAccelerator();
+
+        // Every collapse within a face is free, so far fewer triangles remain
+        EXPECT_LT(simplified.numTriangles, mesh.numTriangles / 4);
+        AssertFloatEqual(24.f, Area(triangles), 0.01f);
+
+        const Aabb bounds = Bounds(triangles);
+        EXPECT_EQ(Vector3(-1.f), bounds.Min());
+        EXPECT_EQ(Vector3(1.f), bounds.Max());
+
+        int open = 0;
+        int nonManifold = 0;
+        CountEdges(triangles, open, nonManifold);
+        EXPECT_EQ(0, open);
+        EXPECT_EQ(0, nonManifold);
+    }
+
+    TEST_F(MeshSimplifierTests, MaxError_CurvedSurfaceStopsEarly)
+    {
+        vector<Triangle> source = MakeCube(8, true);
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> loose;
+        Mesh coarse = MeshSimplifier{ 0, 0.1f }.Simplify(mesh, loose);
+        coarse.ReleaseAccelerator();
+
+        vector<Triangle> tight;
+        Mesh fine = MeshSimplifier{ 0, 0.001f }.Simplify(mesh, tight);
+        fine.ReleaseAccelerator();
+
+        EXPECT_LT(coarse.numTriangles, fine.numTriangles);
+        EXPECT_LE(fine.numTriangles, mesh.numTriangles);
+    }
+
+    TEST_F(MeshSimplifierTests, DegenerateTriangles_AreDropped)
+    {
+        vector<Triangle> source = MakeGrid(2);
+        source.emplace_back(Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f }, Vector3{ 2.f, 0.f, 0.f });
+        source.emplace_back(Vector3{ 1.f }, Vector3{ 1.f }, Vector3{ 0.f });
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{ 100 }.Simplify(mesh, triangles);
+        simplified.ReleaseAccelerator();
+
+        EXPECT_EQ(8, simplified.numTriangles);
+    }
+
+    TEST_F(MeshSimplifierTests, RayCast_HitsSimplifiedSurface)
+    {
+        vector<Triangle> source = MakeGrid(16);
+        const Mesh mesh = MakeMesh(source);
+
+        vector<Triangle> triangles;
+        Mesh simplified = MeshSimplifier{ 8 }.Simplify(mesh, triangles);
+
+        const Ray ray{ Vector3{ 5.5f, 3.f, 7.25f }, Vector3{ 0.f, -1.f, 0.f } };
+        AssertFloatEqual(3.f, ray.CastAgainst(simplified));
+
+        simplified.ReleaseAccelerator();
+    }
+}
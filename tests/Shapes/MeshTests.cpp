@@ -0,0 +1,748 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::future_status;
+using std::vector;
+
+using testing::Test;
+using testing::TestWithParam;
+using testing::Values;
+
+namespace Nudge
+{
+    class MeshTests : public TestWithParam<BvhBuildMode>
+    {
+    };
+
+    TEST_P(MeshTests, IntersectsAabb_CrossingGrid_ReturnsTrue)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 2.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        EXPECT_TRUE(mesh.Intersects(Aabb{ Vector3{ 11.3f, 2.f, 4.7f }, Vector3{ 0.2f } }));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshTests, IntersectsAabb_AboveGrid_ReturnsFalse)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 2.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        EXPECT_FALSE(mesh.Intersects(Aabb{ Vector3{ 11.3f, 3.f, 4.7f }, Vector3{ 0.5f } }));
+        EXPECT_FALSE(mesh.Intersects(Aabb{ Vector3{ 20.f, 2.f, 4.7f }, Vector3{ 0.5f } }));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshTests, IntersectsSphere_TouchingGrid_ReturnsTrue)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 2.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        EXPECT_TRUE(mesh.Intersects(Sphere{ Vector3{ 6.5f, 2.9f, 9.2f }, 1.f }));
+        EXPECT_FALSE(mesh.Intersects(Sphere{ Vector3{ 6.5f, 3.1f, 9.2f }, 1.f }));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshTests, IntersectsObb_RotatedAcrossGrid_ReturnsTrue)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 2.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        // Rotated 45 degrees about Z: the corner reaches 0.5 * sqrt(2) below the center
+        const float c = 0.70710678f;
+        const Matrix3 rotation{ Vector3{ c, c, 0.f }, Vector3{ -c, c, 0.f }, Vector3{ 0.f, 0.f, 1.f } };
+
+        EXPECT_TRUE(mesh.Intersects(Obb{ Vector3{ 3.5f, 2.6f, 3.5f }, Vector3{ 0.5f }, rotation }));
+        EXPECT_FALSE(mesh.Intersects(Obb{ Vector3{ 3.5f, 2.8f, 3.5f }, Vector3{ 0.5f }, rotation }));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshTests, IntersectsTriangle_PiercingGrid_ReturnsTrue)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 2.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        const Triangle vertical{ Vector3{ 8.2f, 1.f, 8.2f }, Vector3{ 8.2f, 3.f, 8.2f }, Vector3{ 8.8f, 3.f, 8.6f } };
+        const Triangle floating{ Vector3{ 8.2f, 2.5f, 8.2f }, Vector3{ 8.2f, 3.f, 8.2f }, Vector3{ 8.8f, 3.f, 8.6f } };
+
+        EXPECT_TRUE(mesh.Intersects(vertical));
+        EXPECT_FALSE(mesh.Intersects(floating));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    INSTANTIATE_TEST_SUITE_P(BuildModes, MeshTests,
+        Values(BvhBuildMode::Octree, BvhBuildMode::Morton, BvhBuildMode::Wide, BvhBuildMode::Spatial));
+
+    // Five stacked grids at heights 0 to 4
+    class MeshMultiHitTests : public TestWithParam<BvhBuildMode>
+    {
+    };
+
+    TEST_P(MeshMultiHitTests, CastAgainstMesh_StackedLayers_ReturnsAllHitsSorted)
+    {
+        vector<Triangle> triangles = MakeLayers(12, { 0.f, 1.f, 2.f, 3.f, 4.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        RayHit hits[16];
+        const Ray ray{ Vector3{ 5.3f, 10.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        ASSERT_EQ(5, ray.CastAgainst(mesh, hits, 16));
+
+        for (int i = 0; i < 5; ++i)
+        {
+            EXPECT_FLOAT_EQ(6.f + static_cast<float>(i), hits[i].distance);
+            EXPECT_FLOAT_EQ(4.f - static_cast<float>(i), triangles[hits[i].triangle].a.y);
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshMultiHitTests, CastAgainstMesh_SmallBuffer_KeepsNearestHits)
+    {
+        vector<Triangle> triangles = MakeLayers(12, { 0.f, 1.f, 2.f, 3.f, 4.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        RayHit hits[2];
+        const Ray ray{ Vector3{ 2.6f, 10.f, 9.1f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        ASSERT_EQ(2, ray.CastAgainst(mesh, hits, 2));
+        EXPECT_FLOAT_EQ(6.f, hits[0].distance);
+        EXPECT_FLOAT_EQ(7.f, hits[1].distance);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshMultiHitTests, CastAgainstMesh_MaxDistance_IgnoresFartherHits)
+    {
+        vector<Triangle> triangles = MakeLayers(12, { 0.f, 1.f, 2.f, 3.f, 4.f });
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        RayHit hits[16];
+        const Ray ray{ Vector3{ 2.6f, 10.f, 9.1f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        EXPECT_EQ(3, ray.CastAgainst(mesh, hits, 16, 8.5f));
+        EXPECT_EQ(0, ray.CastAgainst(mesh, hits, 16, 5.5f));
+        EXPECT_EQ(0, ray.CastAgainst(mesh, hits, 0));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshMultiHitTests, CastAgainstMesh_ObliqueRays_MatchBruteForce)
+    {
+        vector<Triangle> triangles = MakeLayers(12, { 0.f, 1.f, 2.f, 3.f, 4.f });
+        Mesh bruteForce = MakeMesh(triangles, GetParam());
+        bruteForce.ReleaseAccelerator();
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        for (int i = 0; i < 12; ++i)
+        {
+            const Vector3 from{ 0.37f + static_cast<float>(i), 9.f, 11.2f - 0.9f * static_cast<float>(i) };
+            const Vector3 to{ 11.1f - 0.8f * static_cast<float>(i), -1.f, 0.53f + static_cast<float>(i) };
+            const Ray ray = Ray::FromPoints(from, to);
+
+            RayHit expected[16];
+            RayHit actual[16];
+            const int count = ray.CastAgainst(bruteForce, expected, 16);
+
+            ASSERT_EQ(count, ray.CastAgainst(mesh, actual, 16));
+            EXPECT_EQ(ray.CastAgainst(mesh), count > 0 ? actual[0].distance : -1.f);
+
+            for (int j = 0; j < count; ++j)
+            {
+                EXPECT_FLOAT_EQ(expected[j].distance, actual[j].distance);
+                EXPECT_EQ(expected[j].triangle, actual[j].triangle);
+            }
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    INSTANTIATE_TEST_SUITE_P(BuildModes, MeshMultiHitTests,
+        Values(BvhBuildMode::Octree, BvhBuildMode::Morton, BvhBuildMode::Wide, BvhBuildMode::Spatial));
+
+    class MeshBatchTests : public TestWithParam<bool>
+    {
+    public:
+        // Downward and oblique rays scattered over a grid, some of them missing it
+        static vector<Ray> MakeRays(const int count)
+        {
+            vector<Ray> result;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const float u = static_cast<float>(i * 37 % 101) * 0.2f - 1.f;
+                const float v = static_cast<float>(i * 53 % 97) * 0.2f - 1.f;
+                const Vector3 target{ static_cast<float>(i * 13 % 89) * 0.2f, 0.f, static_cast<float>(i * 29 % 83) * 0.2f };
+
+                result.push_back(Ray::FromPoints(Vector3{ u, 5.f + static_cast<float>(i % 3), v }, target));
+            }
+
+            return result;
+        }
+    };
+
+    TEST_P(MeshBatchTests, CastBatch_MatchesSingleCasts)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 1.f });
+        Mesh mesh = MakeMesh(triangles, BvhBuildMode::Wide);
+
+        const vector<Ray> rays = MakeRays(3000);
+        vector<RayHit> results(rays.size());
+
+        const int hits = Ray::CastBatch(mesh, rays, results, GetParam());
+
+        int expectedHits = 0;
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            const float expected = rays[i].CastAgainst(mesh);
+            EXPECT_EQ(expected, results[i].distance);
+
+            if (expected >= 0.f)
+            {
+                ++expectedHits;
+                EXPECT_TRUE(triangles[results[i].triangle].Intersects(Sphere{ rays[i].origin + rays[i].direction * expected, 0.001f }));
+            }
+            else
+            {
+                EXPECT_EQ(-1, results[i].triangle);
+            }
+        }
+
+        EXPECT_EQ(expectedHits, hits);
+        EXPECT_GT(hits, 0);
+        EXPECT_LT(hits, static_cast<int>(rays.size()));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshBatchTests, CastBatch_ShortResultSpan_CastsOnlyThatMany)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 1.f });
+        Mesh mesh = MakeMesh(triangles, BvhBuildMode::Morton);
+
+        const vector<Ray> rays(10, Ray{ Vector3{ 4.3f, 3.f, 4.6f }, Vector3{ 0.f, -1.f, 0.f } });
+        vector<RayHit> results(4, RayHit{ 7.f, 7 });
+
+        EXPECT_EQ(0, Ray::CastBatch(mesh, span<const Ray>(rays).first(0), results, GetParam()));
+        EXPECT_FLOAT_EQ(7.f, results[0].distance);
+
+        EXPECT_EQ(4, Ray::CastBatch(mesh, rays, results, GetParam()));
+        EXPECT_FLOAT_EQ(2.f, results[3].distance);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    INSTANTIATE_TEST_SUITE_P(Coherence, MeshBatchTests, Values(false, true));
+
+    TEST(MeshBruteForceTests, IntersectsSphere_NoAccelerator_TestsEveryTriangle)
+    {
+        vector<Triangle> triangles = MakeLayers(4, { 0.f });
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        EXPECT_TRUE(mesh.Intersects(Sphere{ Vector3{ 3.5f, 0.5f, 3.5f }, 1.f }));
+        EXPECT_FALSE(mesh.Intersects(Sphere{ Vector3{ 3.5f, 1.5f, 3.5f }, 1.f }));
+    }
+
+    TEST(MeshAsyncTests, AccelerateAsync_Wait_PublishesStructure)
+    {
+        vector<Triangle> triangles = MakeLayers(32, { 1.f });
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        mesh.AccelerateAsync(BvhBuildMode::Wide).wait();
+
+        ASSERT_NE(nullptr, mesh.wideHierarchy);
+        EXPECT_EQ(nullptr, mesh.hierarchy);
+        EXPECT_TRUE(mesh.Intersects(Sphere{ Vector3{ 20.5f, 1.5f, 3.2f }, 1.f }));
+        EXPECT_FLOAT_EQ(4.f, (Ray{ Vector3{ 20.5f, 5.f, 3.2f }, Vector3{ 0.f, -1.f, 0.f } }.CastAgainst(mesh)));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST(MeshAsyncTests, AccelerateAsync_QueriesDuringBuild_ReturnSameResults)
+    {
+        vector<Triangle> triangles = MakeLayers(160, { 2.f });
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        const std::shared_future<void> build = mesh.AccelerateAsync(BvhBuildMode::Spatial);
+
+        // Queries fall back to brute force until the structure is swapped in
+        int queries = 0;
+        do
+        {
+            const float x = 0.3f + static_cast<float>(queries % 150);
+            const Ray ray{ Vector3{ x, 6.f, 150.7f - x }, Vector3{ 0.f, -1.f, 0.f } };
+
+            EXPECT_FLOAT_EQ(4.f, ray.CastAgainst(mesh));
+            EXPECT_TRUE(mesh.Intersects(Aabb{ Vector3{ x, 2.f, x }, Vector3{ 0.1f } }));
+            ++queries;
+        }
+        while (build.wait_for(std::chrono::seconds(0)) != future_status::ready);
+
+        ASSERT_NE(nullptr, mesh.hierarchy);
+        EXPECT_FLOAT_EQ(4.f, (Ray{ Vector3{ 80.5f, 6.f, 3.2f }, Vector3{ 0.f, -1.f, 0.f } }.CastAgainst(mesh)));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST(MeshAsyncTests, AccelerateAsync_CalledTwice_ReturnsSameBuild)
+    {
+        vector<Triangle> triangles = MakeLayers(64, { 0.f });
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        const std::shared_future<void> first = mesh.AccelerateAsync();
+        const std::shared_future<void> second = mesh.AccelerateAsync(BvhBuildMode::Wide);
+
+        second.wait();
+        EXPECT_EQ(future_status::ready, first.wait_for(std::chrono::seconds(0)));
+
+        mesh.WaitForBuild();
+        EXPECT_NE(nullptr, mesh.hierarchy);
+        EXPECT_EQ(nullptr, mesh.wideHierarchy);
+
+        // Already built: the handle is ready immediately
+        EXPECT_EQ(future_status::ready, mesh.AccelerateAsync().wait_for(std::chrono::seconds(0)));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST(MeshAsyncTests, Copy_StartsWithNoBuildState)
+    {
+        vector<Triangle> triangles = MakeLayers(32, { 0.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Rebuild(BvhBuildMode::Wide);
+        ASSERT_NE(nullptr, mesh.BuildState().collapseSource);
+
+        // The copy owns no scratch, so releasing both cannot free it twice
+        Mesh copy = mesh;
+        EXPECT_EQ(nullptr, copy.BuildState().collapseSource);
+        EXPECT_TRUE(copy.BuildState().triangleBounds.empty());
+        EXPECT_FALSE(copy.BuildState().IsPending());
+        EXPECT_NE(nullptr, mesh.BuildState().collapseSource);
+
+        // A finished build may be copied before it is waited for
+        Mesh other = MakeMesh(triangles);
+        other.AccelerateAsync(BvhBuildMode::Morton).wait();
+        EXPECT_TRUE(other.BuildState().IsPending());
+        EXPECT_FALSE(other.BuildState().IsRunning());
+
+        const Mesh finished = other;
+        EXPECT_FALSE(finished.BuildState().IsPending());
+
+        other.ReleaseAccelerator();
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST(MeshAsyncTests, ReleaseAccelerator_DuringBuild_WaitsAndFrees)
+    {
+        vector<Triangle> triangles = MakeLayers(64, { 0.f });
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        mesh.AccelerateAsync(BvhBuildMode::Octree);
+        mesh.ReleaseAccelerator();
+
+        EXPECT_EQ(nullptr, mesh.accelerator);
+        EXPECT_FALSE(mesh.BuildState().IsPending());
+    }
+
+    TEST(MeshAsyncTests, AccelerateAsync_EmptyMesh_ReturnsReadyHandle)
+    {
+        Mesh mesh;
+
+        EXPECT_EQ(future_status::ready, mesh.AccelerateAsync().wait_for(std::chrono::seconds(0)));
+        EXPECT_EQ(nullptr, mesh.hierarchy);
+    }
+
+    class MeshReorderTests : public Test
+    {
+    public:
+        // Grid triangles in a scrambled order, so leaf order differs from storage order
+        static vector<Triangle> MakeScrambledGrid(const int size)
+        {
+            const vector<Triangle> grid = MakeLayers(size, { 0.f });
+            const int count = static_cast<int>(grid.size());
+
+            vector<Triangle> result;
+            for (int i = 0; i < count; ++i)
+            {
+                // 7919 is prime, so this visits every triangle exactly once
+                result.push_back(grid[static_cast<size_t>(i) * 7919 % count]);
+            }
+
+            return result;
+        }
+
+        static bool SameTriangle(const Triangle& a, const Triangle& b)
+        {
+            for (int i = 0; i < 9; ++i)
+            {
+                if (a.values[i] != b.values[i])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    TEST_F(MeshReorderTests, ReorderTriangles_Morton_IdsFollowTriangles)
+    {
+        vector<Triangle> triangles = MakeScrambledGrid(16);
+        const vector<Triangle> original = triangles;
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Morton);
+
+        vector<int> ids(mesh.numTriangles);
+        for (int i = 0; i < mesh.numTriangles; ++i)
+        {
+            ids[i] = i;
+        }
+
+        ASSERT_TRUE(mesh.ReorderTriangles(ids.data()));
+        EXPECT_TRUE(mesh.hierarchy->indices.empty());
+
+        for (int i = 0; i < mesh.numTriangles; ++i)
+        {
+            EXPECT_TRUE(SameTriangle(original[ids[i]], triangles[i]));
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(MeshReorderTests, ReorderTriangles_Wide_LeavesAreContiguousAndQueriesMatch)
+    {
+        vector<Triangle> triangles = MakeScrambledGrid(16);
+        vector<Triangle> original = triangles;
+        Mesh bruteForce = MakeMesh(original);
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Wide);
+
+        ASSERT_TRUE(mesh.ReorderTriangles());
+        EXPECT_TRUE(mesh.wideHierarchy->indices.empty());
+
+        for (int i = 0; i < 16; ++i)
+        {
+            const Vector3 origin{ 0.3f + static_cast<float>(i), 4.f, 15.7f - static_cast<float>(i) };
+            const Ray ray{ origin, Vector3{ 0.f, -1.f, 0.f } };
+
+            EXPECT_EQ(ray.CastAgainst(bruteForce), ray.CastAgainst(mesh));
+            EXPECT_EQ(bruteForce.Intersects(Sphere{ origin, 3.9f }), mesh.Intersects(Sphere{ origin, 3.9f }));
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(MeshReorderTests, ReorderTriangles_CalledTwice_IsNoOp)
+    {
+        vector<Triangle> triangles = MakeScrambledGrid(8);
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Morton);
+
+        ASSERT_TRUE(mesh.ReorderTriangles());
+        const vector<Triangle> reordered = triangles;
+
+        EXPECT_TRUE(mesh.ReorderTriangles());
+
+        for (int i = 0; i < mesh.numTriangles; ++i)
+        {
+            EXPECT_TRUE(SameTriangle(reordered[i], triangles[i]));
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(MeshReorderTests, ReorderTriangles_AfterRebuild_RestoresIndices)
+    {
+        vector<Triangle> triangles = MakeScrambledGrid(8);
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Morton);
+        mesh.ReorderTriangles();
+
+        mesh.Rebuild(BvhBuildMode::Morton);
+
+        EXPECT_EQ(static_cast<size_t>(mesh.numTriangles), mesh.hierarchy->indices.size());
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(MeshReorderTests, ReorderTriangles_Octree_ReturnsFalse)
+    {
+        vector<Triangle> triangles = MakeScrambledGrid(8);
+        const vector<Triangle> original = triangles;
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Octree);
+
+        EXPECT_FALSE(mesh.ReorderTriangles());
+        EXPECT_TRUE(SameTriangle(original[0], triangles[0]));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(MeshReorderTests, ReorderTriangles_SpatialWithDuplicates_ReturnsFalse)
+    {
+        // Crossing diagonal floor and wall slivers force clipped duplicates
+        vector<Triangle> triangles;
+        for (int i = 0; i < 100; ++i)
+        {
+            const float offset = static_cast<float>(i) * .4f;
+            triangles.emplace_back(Vector3{ 0.f, offset, 0.f }, Vector3{ 40.f, offset, 40.5f }, Vector3{ 40.f, offset, 40.f });
+            triangles.emplace_back(Vector3{ offset, 0.f, 0.f }, Vector3{ offset + 30.f, 0.f, 40.f }, Vector3{ offset + 30.f, 20.f, 40.f });
+        }
+
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Spatial);
+        ASSERT_GT(mesh.hierarchy->indices.size(), triangles.size());
+
+        EXPECT_FALSE(mesh.ReorderTriangles());
+
+        mesh.ReleaseAccelerator();
+    }
+
+    class MeshContainsTests : public TestWithParam<BvhBuildMode>
+    {
+    public:
+        // Closed cube [-1, 1]^3 with every face split into size x size quads
+        static vector<Triangle> MakeCube(const int size)
+        {
+            vector<Triangle> result;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (const float side : { -1.f, 1.f })
+                {
+                    for (int i = 0; i < size; ++i)
+                    {
+                        for (int j = 0; j < size; ++j)
+                        {
+                            const float u0 = -1.f + 2.f * static_cast<float>(i) / static_cast<float>(size);
+                            const float u1 = -1.f + 2.f * static_cast<float>(i + 1) / static_cast<float>(size);
+                            const float v0 = -1.f + 2.f * static_cast<float>(j) / static_cast<float>(size);
+                            const float v1 = -1.f + 2.f * static_cast<float>(j + 1) / static_cast<float>(size);
+
+                            auto corner = [&](const float u, const float v)
+                            {
+                                float values[3];
+                                values[axis] = side;
+                                values[(axis + 1) % 3] = u;
+                                values[(axis + 2) % 3] = v;
+
+                                return Vector3{ values[0], values[1], values[2] };
+                            };
+
+                            result.emplace_back(corner(u0, v0), corner(u1, v0), corner(u1, v1));
+                            result.emplace_back(corner(u0, v0), corner(u1, v1), corner(u0, v1));
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        // Closed unit sphere made of rings of quads and pole fans
+        static vector<Triangle> MakeSphere(const int rings, const int segments)
+        {
+            auto point = [&](const int ring, const int segment)
+            {
+                const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(rings);
+                const float phi = 6.28318531f * static_cast<float>(segment % segments) / static_cast<float>(segments);
+
+                return Vector3{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+            };
+
+            vector<Triangle> result;
+
+            for (int ring = 0; ring < rings; ++ring)
+            {
+                for (int segment = 0; segment < segments; ++segment)
+                {
+                    if (ring > 0)
+                    {
+                        result.emplace_back(point(ring, segment), point(ring, segment + 1), point(ring + 1, segment));
+                    }
+
+                    if (ring < rings - 1)
+                    {
+                        result.emplace_back(point(ring, segment + 1), point(ring + 1, segment + 1), point(ring + 1, segment));
+                    }
+                }
+            }
+
+            return result;
+        }
+    };
+
+    TEST_P(MeshContainsTests, Contains_CubeLattice_MatchesBox)
+    {
+        vector<Triangle> triangles = MakeCube(4);
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        // Lattice points line up with the cube's vertices and edges
+        for (int x = -6; x <= 6; ++x)
+        {
+            for (int y = -6; y <= 6; ++y)
+            {
+                for (int z = -6; z <= 6; ++z)
+                {
+                    const Vector3 point{ static_cast<float>(x) * .25f, static_cast<float>(y) * .25f, static_cast<float>(z) * .25f };
+                    const bool expected = std::abs(x) <= 4 && std::abs(y) <= 4 && std::abs(z) <= 4;
+
+                    EXPECT_EQ(expected, mesh.Contains(point)) << x << " " << y << " " << z;
+                }
+            }
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshContainsTests, Contains_Sphere_MatchesRadius)
+    {
+        vector<Triangle> triangles = MakeSphere(16, 24);
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        for (int i = 0; i < 500; ++i)
+        {
+            const float f = static_cast<float>(i);
+            const Vector3 direction = Vector3{ std::sin(f * 1.7f), std::cos(f * 2.3f), std::sin(f * 0.9f + 1.f) }.Normalized();
+            const float radius = static_cast<float>(i % 25) * .08f;
+
+            // The tessellation lies between radius cos(pi / 16) and 1
+            if (radius > .95f && radius < 1.05f)
+            {
+                continue;
+            }
+
+            EXPECT_EQ(radius < 1.f, mesh.Contains(direction * radius));
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshContainsTests, Contains_EveryFixedDirectionHitsAVertex_StillClassifies)
+    {
+        // The four directions Contains() tries first; each ray from the center
+        // runs straight into a corner of this tetrahedron, which encloses it
+        const Vector3 directions[] =
+        {
+            Vector3{ 0.5318143f, 0.7153192f, 0.4533122f },
+            Vector3{ -0.6137614f, 0.3219322f, 0.7208721f },
+            Vector3{ 0.2740971f, -0.8865906f, 0.3725961f },
+            Vector3{ -0.4417330f, -0.5183387f, -0.7322547f }
+        };
+
+        const Vector3 center{ .5f, -.25f, 1.f };
+        Vector3 corners[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            corners[i] = center + directions[i] * 2.f;
+        }
+
+        vector<Triangle> triangles
+        {
+            Triangle{ corners[0], corners[1], corners[2] },
+            Triangle{ corners[0], corners[3], corners[1] },
+            Triangle{ corners[0], corners[2], corners[3] },
+            Triangle{ corners[1], corners[3], corners[2] }
+        };
+
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        EXPECT_TRUE(mesh.Contains(center));
+        EXPECT_FALSE(mesh.Contains(center + directions[0] * 3.f));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshContainsTests, Contains_PointOnFace_ReturnsTrue)
+    {
+        vector<Triangle> triangles = MakeCube(2);
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        EXPECT_TRUE(mesh.Contains(Vector3{ 1.f, .3f, -.6f }));
+        EXPECT_TRUE(mesh.Contains(Vector3{ 0.f, 0.f, -1.f }));
+        EXPECT_TRUE(mesh.Contains(Vector3{ 1.f, 1.f, 1.f }));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_P(MeshContainsTests, ContainsBatch_MatchesSingleQueries)
+    {
+        vector<Triangle> triangles = MakeSphere(12, 18);
+        Mesh mesh = MakeMesh(triangles, GetParam());
+
+        vector<Vector3> points;
+        for (int i = 0; i < 1500; ++i)
+        {
+            const float f = static_cast<float>(i);
+            points.emplace_back(std::sin(f * .37f) * 1.3f, std::cos(f * .61f) * 1.3f, std::sin(f * .23f + 2.f) * 1.3f);
+        }
+
+        vector<uint8_t> inside(points.size());
+        const int count = mesh.ContainsBatch(points, inside);
+
+        int expected = 0;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            EXPECT_EQ(mesh.Contains(points[i]), inside[i] == 1);
+            expected += mesh.Contains(points[i]);
+        }
+
+        EXPECT_EQ(expected, count);
+        EXPECT_GT(count, 0);
+        EXPECT_LT(count, static_cast<int>(points.size()));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    INSTANTIATE_TEST_SUITE_P(BuildModes, MeshContainsTests,
+        Values(BvhBuildMode::Octree, BvhBuildMode::Morton, BvhBuildMode::Wide, BvhBuildMode::Spatial));
+
+    TEST(MeshContainsBruteForceTests, Contains_NoStructure_MatchesBox)
+    {
+        vector<Triangle> triangles = MeshContainsTests::MakeCube(3);
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        EXPECT_TRUE(mesh.Contains(Vector3{ .1f, -.2f, .3f }));
+        EXPECT_TRUE(mesh.Contains(Vector3{ 1.f / 3.f, 1.f / 3.f, 0.f }));
+        EXPECT_FALSE(mesh.Contains(Vector3{ 1.5f, 0.f, 0.f }));
+        EXPECT_FALSE(mesh.Contains(Vector3{ -1.f / 3.f, 4.f, 1.f / 3.f }));
+    }
+}
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/PointCloud.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class PointCloudTests : public Test
+    {
+    public:
+        vector<Vector3> points;
+        PointCloud cloud;
+
+    public:
+        // A dense cluster, a sparse halo and a few exact duplicates
+        void SetUp() override
+        {
+            for (unsigned i = 0; i < 1500; ++i)
+            {
+                points.push_back(ScatterPoint(i, Vector3{ -2.f, -1.f, 0.f }, Vector3{ 2.f, 1.f, 3.f }));
+            }
+
+            for (unsigned i = 0; i < 500; ++i)
+            {
+                points.push_back(ScatterPoint(i + 10000, Vector3{ -20.f }, Vector3{ 20.f }));
+            }
+
+            for (int i = 0; i < 10; ++i)
+            {
+                points.push_back(points[i * 7]);
+            }
+
+            cloud = PointCloud{ points };
+        }
+
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        // Distances from a position to every point, ascending
+        vector<float> SortedDistances(const Vector3& point) const
+        {
+            vector<float> distances;
+            for (const Vector3& other : points)
+            {
+                distances.push_back((other - point).Magnitude());
+            }
+
+            std::sort(distances.begin(), distances.end());
+
+            return distances;
+        }
+
+        static float RayDistance(const Ray& ray, const Vector3& point, const float maxDistance)
+        {
+            const float along = std::clamp(Vector3::Dot(point - ray.origin, ray.direction), 0.f, maxDistance);
+
+            return (point - (ray.origin + ray.direction * along)).Magnitude();
+        }
+    };
+
+    TEST_F(PointCloudTests, Build_Empty_QueriesFindNothing)
+    {
+        const PointCloud empty{ span<const Vector3>{} };
+        int neighbours[3];
+        float distances[3];
+        float distance = 7.f;
+
+        EXPECT_TRUE(empty.IsEmpty());
+        EXPECT_EQ(0, empty.Count());
+        EXPECT_EQ(0, empty.Nearest(Vector3{ 0.f }, neighbours, distances));
+        EXPECT_EQ(-1, empty.NearestToRay(Ray{ Vector3{ 0.f }, Vector3{ 0.f, 0.f, 1.f } }, distance));
+        EXPECT_EQ(7.f, distance);
+        EXPECT_EQ(-1, empty.Query(Sphere{ Vector3{ 0.f }, 100.f }, [](int) { return true; }));
+    }
+
+    TEST_F(PointCloudTests, Build_NodesPartitionSlots_AndBoundTheirPoints)
+    {
+        ASSERT_EQ(static_cast<int>(points.size()), cloud.Count());
+
+        vector<int> sorted = cloud.indices;
+        std::sort(sorted.begin(), sorted.end());
+        for (int i = 0; i < cloud.Count(); ++i)
+        {
+            ASSERT_EQ(i, sorted[i]);
+            EXPECT_EQ(points[cloud.indices[i]].x, cloud.x[i]);
+            EXPECT_EQ(points[cloud.indices[i]].y, cloud.y[i]);
+            EXPECT_EQ(points[cloud.indices[i]].z, cloud.z[i]);
+        }
+
+        const int count = static_cast<int>(cloud.nodes.size());
+        for (int index = 0; index < count; ++index)
+        {
+            const PointCloudNode& node = cloud.nodes[index];
+
+            if (index * 2 + 1 < count)
+            {
+                EXPECT_EQ(node.begin, cloud.nodes[index * 2 + 1].begin);
+                EXPECT_EQ(cloud.nodes[index * 2 + 1].end, cloud.nodes[index * 2 + 2].begin);
+                EXPECT_EQ(node.end, cloud.nodes[index * 2 + 2].end);
+            }
+            else
+            {
+                EXPECT_LE(node.end - node.begin, POINT_CLOUD_LEAF_SIZE);
+            }
+
+            for (int slot = node.begin; slot < node.end; ++slot)
+            {
+                EXPECT_TRUE(cloud.x[slot] >= node.min.x && cloud.x[slot] <= node.max.x);
+                EXPECT_TRUE(cloud.y[slot] >= node.min.y && cloud.y[slot] <= node.max.y);
+                EXPECT_TRUE(cloud.z[slot] >= node.min.z && cloud.z[slot] <= node.max.z);
+            }
+        }
+    }
+
+    TEST_F(PointCloudTests, Nearest_RandomPositions_MatchesBruteForce)
+    {
+        constexpr int K = 12;
+
+        for (unsigned i = 0; i < 100; ++i)
+        {
+            const Vector3 point = ScatterPoint(i + 500, Vector3{ -6.f }, Vector3{ 6.f });
+            const vector<float> expected = SortedDistances(point);
+
+            int neighbours[K];
+            float distances[K];
+            ASSERT_EQ(K, cloud.Nearest(point, neighbours, distances));
+
+            for (int j = 0; j < K; ++j)
+            {
+                AssertFloatEqual(expected[j], distances[j]);
+                AssertFloatEqual(distances[j], (points[neighbours[j]] - point).Magnitude());
+            }
+        }
+    }
+
+    TEST_F(PointCloudTests, Nearest_MaxDistance_ReturnsOnlyPointsInRange)
+    {
+        const Vector3 point{ 15.f, 15.f, 15.f };
+        const vector<float> expected = SortedDistances(point);
+        const float maxDistance = expected[2] + (expected[3] - expected[2]) * .5f;
+
+        int neighbours[8];
+        float distances[8];
+        ASSERT_EQ(3, cloud.Nearest(point, neighbours, distances, maxDistance));
+        AssertFloatEqual(expected[2], distances[2]);
+    }
+
+    TEST_F(PointCloudTests, Nearest_MoreThanCount_ReturnsEveryPoint)
+    {
+        const PointCloud small{ span<const Vector3>{ points.data(), 5 } };
+        int neighbours[8];
+        float distances[8];
+
+        ASSERT_EQ(5, small.Nearest(Vector3{ 0.f }, neighbours, distances));
+        EXPECT_TRUE(std::is_sorted(distances, distances + 5));
+    }
+
+    TEST_F(PointCloudTests, NearestBatch_MatchesSingleQueries)
+    {
+        constexpr int K = 4;
+        vector<Vector3> queries;
+        for (unsigned i = 0; i < 300; ++i)
+        {
+            queries.push_back(ScatterPoint(i + 900, Vector3{ -25.f }, Vector3{ 25.f }));
+        }
+
+        vector<int> neighbours(queries.size() * K);
+        vector<float> distances(queries.size() * K);
+        EXPECT_EQ(static_cast<int>(queries.size()) * K, cloud.NearestBatch(queries, K, neighbours, distances));
+
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            int expected[K];
+            float expectedDistances[K];
+            cloud.Nearest(queries[i], expected, expectedDistances);
+
+            for (int j = 0; j < K; ++j)
+            {
+                EXPECT_EQ(expectedDistances[j], distances[i * K + j]);
+            }
+        }
+    }
+
+    TEST_F(PointCloudTests, Query_Spheres_MatchesBruteForce)
+    {
+        for (unsigned i = 0; i < 50; ++i)
+        {
+            const Sphere region{ ScatterPoint(i + 700, Vector3{ -8.f }, Vector3{ 8.f }), Scatter(i + 800, .1f, 4.f) };
+
+            vector<int> found;
+            EXPECT_EQ(-1, cloud.Query(region, [&](const int index)
+            {
+                found.push_back(index);
+                return false;
+            }));
+
+            vector<int> expected;
+            for (int j = 0; j < static_cast<int>(points.size()); ++j)
+            {
+                if ((points[j] - region.origin).MagnitudeSqr() <= region.radius * region.radius)
+                {
+                    expected.push_back(j);
+                }
+            }
+
+            std::sort(found.begin(), found.end());
+            EXPECT_EQ(expected, found) << "sphere " << i;
+        }
+    }
+
+    TEST_F(PointCloudTests, Query_Boxes_MatchesBruteForce_AndStops)
+    {
+        for (unsigned i = 0; i < 50; ++i)
+        {
+            const Aabb region{ ScatterPoint(i + 300, Vector3{ -8.f }, Vector3{ 8.f }), ScatterPoint(i + 400, Vector3{ .1f }, Vector3{ 3.f }) };
+            const Vector3 min = region.Min();
+            const Vector3 max = region.Max();
+
+            int count = 0;
+            cloud.Query(region, [&](const int index)
+            {
+                const Vector3& p = points[index];
+                EXPECT_TRUE(p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z);
+                ++count;
+                return false;
+            });
+
+            int expected = 0;
+            for (const Vector3& p : points)
+            {
+                expected += p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z ? 1 : 0;
+            }
+
+            EXPECT_EQ(expected, count) << "box " << i;
+
+            if (expected > 0)
+            {
+                const int stopped = cloud.Query(region, [](int) { return true; });
+                EXPECT_TRUE(region.Contains(points[stopped]));
+            }
+        }
+    }
+
+    TEST_F(PointCloudTests, NearestToRay_RandomRays_MatchesBruteForce)
+    {
+        for (unsigned i = 0; i < 100; ++i)
+        {
+            const Vector3 from = ScatterPoint(i + 1200, Vector3{ -30.f }, Vector3{ 30.f });
+            const Vector3 to = ScatterPoint(i + 1300, Vector3{ -5.f }, Vector3{ 5.f });
+            const Ray ray = Ray::FromPoints(from, to);
+            const float length = i % 2 == 0 ? std::numeric_limits<float>::infinity() : (to - from).Magnitude() * .5f;
+
+            float expected = std::numeric_limits<float>::infinity();
+            for (const Vector3& point : points)
+            {
+                expected = std::min(expected, RayDistance(ray, point, length));
+            }
+
+            float distance = -1.f;
+            const int nearest = cloud.NearestToRay(ray, distance, length);
+
+            ASSERT_GE(nearest, 0);
+            AssertFloatEqual(expected, distance, 0.001f);
+            AssertFloatEqual(distance, RayDistance(ray, points[nearest], length), 0.001f);
+        }
+    }
+
+    TEST_F(PointCloudTests, NearestToRayBatch_MatchesSingleQueries)
+    {
+        vector<Ray> rays;
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            rays.push_back(Ray::FromPoints(ScatterPoint(i + 2000, Vector3{ -30.f }, Vector3{ 30.f }), ScatterPoint(i + 2100, Vector3{ -5.f }, Vector3{ 5.f })));
+        }
+
+        vector<int> nearest(rays.size());
+        vector<float> distances(rays.size());
+        ASSERT_EQ(static_cast<int>(rays.size()), cloud.NearestToRayBatch(rays, nearest, distances));
+
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            float distance;
+            EXPECT_EQ(cloud.NearestToRay(rays[i], distance), nearest[i]);
+            EXPECT_EQ(distance, distances[i]);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Line.hpp"
+#include "Nudge/Shapes/PreparedRay.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class PreparedRayTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+    };
+
+    TEST_F(PreparedRayTests, Constructor_NegativeAndZeroComponents_SetsSignsAndInverse)
+    {
+        const PreparedRay ray{ Ray{ Vector3{ 0.f }, Vector3{ -0.5f, 0.f, 2.f } } };
+
+        EXPECT_EQ(1, ray.sign[0]);
+        EXPECT_EQ(0, ray.sign[1]);
+        EXPECT_EQ(0, ray.sign[2]);
+        AssertFloatEqual(-2.f, ray.inverseDirection[0]);
+        AssertFloatEqual(.5f, ray.inverseDirection[2]);
+        EXPECT_TRUE(std::isinf(ray.inverseDirection[1]));
+    }
+
+    TEST_F(PreparedRayTests, Enter_BoxAhead_ReturnsEntryDistance)
+    {
+        const PreparedRay ray{ Ray{ Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f } } };
+
+        AssertFloatEqual(4.f, ray.Enter(Vector3{ 4.f, -1.f, -1.f }, Vector3{ 6.f, 1.f, 1.f }));
+        AssertFloatEqual(4.f, ray.Enter(Aabb{ Vector3{ 5.f, 0.f, 0.f }, Vector3{ 1.f } }));
+    }
+
+    TEST_F(PreparedRayTests, Enter_NegativeDirection_ReturnsEntryDistance)
+    {
+        const PreparedRay ray{ Ray{ Vector3{ 10.f, 0.f, 0.f }, Vector3{ -1.f, 0.f, 0.f } } };
+
+        AssertFloatEqual(4.f, ray.Enter(Vector3{ 4.f, -1.f, -1.f }, Vector3{ 6.f, 1.f, 1.f }));
+    }
+
+    TEST_F(PreparedRayTests, Enter_OriginInside_ReturnsZero)
+    {
+        const PreparedRay ray{ Ray{ Vector3{ 5.f, 0.f, 0.f }, Vector3{ 0.f, 1.f, 0.f } } };
+
+        EXPECT_EQ(0.f, ray.Enter(Vector3{ 4.f, -1.f, -1.f }, Vector3{ 6.f, 1.f, 1.f }));
+    }
+
+    TEST_F(PreparedRayTests, Enter_BoxBehindOrBeyondMaxDistance_ReturnsMiss)
+    {
+        const PreparedRay ray{ Ray{ Vector3{ 0.f }, Vector3{ 1.f, 0.f, 0.f } }, 3.f };
+
+        EXPECT_EQ(-1.f, ray.Enter(Vector3{ -6.f, -1.f, -1.f }, Vector3{ -4.f, 1.f, 1.f }));
+        EXPECT_EQ(-1.f, ray.Enter(Vector3{ 4.f, -1.f, -1.f }, Vector3{ 6.f, 1.f, 1.f }));
+    }
+
+    TEST_F(PreparedRayTests, Enter_ZeroComponentOnSlabPlane_HitsBox)
+    {
+        // Travels along the box's top face, where 0 * infinity gives NaN
+        const PreparedRay ray{ Ray{ Vector3{ 0.f, 1.f, 0.f }, Vector3{ 1.f, 0.f, 0.f } } };
+
+        AssertFloatEqual(4.f, ray.Enter(Vector3{ 4.f, -1.f, -1.f }, Vector3{ 6.f, 1.f, 1.f }));
+        AssertFloatEqual(4.f, ray.Enter(Aabb{ Vector3{ 5.f, 0.f, 0.f }, Vector3{ 1.f } }));
+    }
+
+    TEST_F(PreparedRayTests, Enter_ZeroComponentOutsideSlab_MissesBox)
+    {
+        const PreparedRay ray{ Ray{ Vector3{ 0.f, 1.5f, 0.f }, Vector3{ 1.f, 0.f, 0.f } } };
+
+        EXPECT_EQ(-1.f, ray.Enter(Vector3{ 4.f, -1.f, -1.f }, Vector3{ 6.f, 1.f, 1.f }));
+        EXPECT_EQ(-1.f, ray.Enter(Aabb{ Vector3{ 5.f, 0.f, 0.f }, Vector3{ 1.f } }));
+    }
+
+    TEST_F(PreparedRayTests, Enter_ManyBoxes_MatchesSingleTests)
+    {
+        vector<Aabb> boxes;
+        for (int i = 0; i < 40; ++i)
+        {
+            const float f = static_cast<float>(i);
+            boxes.emplace_back(Vector3{ f * 0.7f - 10.f, (i % 5) * 1.3f - 3.f, (i % 7) * 0.9f - 2.f }, Vector3{ 0.4f + (i % 3) * 0.3f });
+        }
+
+        const PreparedRay ray{ Ray::FromPoints(Vector3{ -12.f, -2.f, -1.f }, Vector3{ 20.f, 2.f, 3.f }) };
+
+        vector<float> entries(boxes.size());
+        const int hits = ray.Enter(boxes.data(), static_cast<int>(boxes.size()), entries.data());
+
+        int expectedHits = 0;
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            const float expected = ray.Enter(boxes[i].Min(), boxes[i].Max());
+            expectedHits += expected >= 0.f;
+
+            AssertFloatEqual(expected, entries[i], 0.001f);
+        }
+
+        EXPECT_EQ(expectedHits, hits);
+        EXPECT_GT(hits, 0);
+    }
+
+    TEST_F(PreparedRayTests, Clip_LineThroughBox_ReturnsBothDistances)
+    {
+        const PreparedRay ray{ Ray{ Vector3{ 5.f, 0.f, 0.f }, Vector3{ 1.f, 0.f, 0.f } } };
+
+        float enter = 0.f;
+        float exit = 0.f;
+
+        ASSERT_TRUE(ray.Clip(Vector3{ 1.f, -1.f, -1.f }, Vector3{ 3.f, 1.f, 1.f }, enter, exit));
+        AssertFloatEqual(-4.f, enter);
+        AssertFloatEqual(-2.f, exit);
+    }
+
+    TEST_F(PreparedRayTests, FromSegment_DistancesAreSegmentFractions)
+    {
+        const PreparedRay segment = PreparedRay::FromSegment(Vector3{ 0.f }, Vector3{ 10.f, 0.f, 0.f });
+
+        AssertFloatEqual(.4f, segment.Enter(Vector3{ 4.f, -1.f, -1.f }, Vector3{ 6.f, 1.f, 1.f }));
+        EXPECT_EQ(-1.f, segment.Enter(Vector3{ 11.f, -1.f, -1.f }, Vector3{ 12.f, 1.f, 1.f }));
+    }
+
+    TEST_F(PreparedRayTests, LineTest_SegmentInsideBox_ReturnsTrue)
+    {
+        const Aabb box{ Vector3{ 0.f }, Vector3{ 2.f } };
+
+        EXPECT_TRUE((Line{ Vector3{ -0.5f, 0.f, 0.f }, Vector3{ 0.5f, 0.f, 0.f } }.Test(box)));
+        EXPECT_TRUE((Line{ Vector3{ -5.f, 0.f, 0.f }, Vector3{ 0.f, 0.f, 0.f } }.Test(box)));
+        EXPECT_FALSE((Line{ Vector3{ -5.f, 0.f, 0.f }, Vector3{ -3.f, 0.f, 0.f } }.Test(box)));
+    }
+}
@@ -0,0 +1,193 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/QueryCoherence.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+using std::vector;
+
+using testing::TestWithParam;
+using testing::Values;
+
+namespace Nudge
+{
+    class QueryCoherenceTests : public TestWithParam<BvhBuildMode>
+    {
+    public:
+        vector<Triangle> triangles;
+        Mesh mesh;
+
+    public:
+        // Two stacked horizontal grids of upward-facing triangles
+        void SetUp() override
+        {
+            for (const float y : { 1.f, 2.5f })
+            {
+                for (int x = 0; x < 16; ++x)
+                {
+                    for (int z = 0; z < 16; ++z)
+                    {
+                        const float fx = static_cast<float>(x);
+                        const float fz = static_cast<float>(z);
+
+                        triangles.emplace_back(Vector3{ fx, y, fz }, Vector3{ fx, y, fz + 1.f }, Vector3{ fx + 1.f, y, fz });
+                        triangles.emplace_back(Vector3{ fx + 1.f, y, fz }, Vector3{ fx, y, fz + 1.f }, Vector3{ fx + 1.f, y, fz + 1.f });
+                    }
+                }
+            }
+
+            mesh.numTriangles = static_cast<int>(triangles.size());
+            mesh.triangles = triangles.data();
+            mesh.Accelerate(GetParam());
+        }
+
+        void TearDown() override
+        {
+            mesh.ReleaseAccelerator();
+        }
+
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+    };
+
+    TEST_P(QueryCoherenceTests, Constructor_NoQueries_EmptyHintAndZeroRate)
+    {
+        const QueryCoherence coherence;
+
+        EXPECT_EQ(-1, coherence.triangle);
+        EXPECT_EQ(0u, coherence.hits);
+        EXPECT_EQ(0u, coherence.misses);
+        EXPECT_EQ(0.f, coherence.HitRate());
+    }
+
+    TEST_P(QueryCoherenceTests, CastAgainst_RepeatedRay_HitsHintAfterFirstCast)
+    {
+        const Ray ray{ Vector3{ 3.3f, 6.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        QueryCoherence coherence;
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            AssertFloatEqual(3.5f, ray.CastAgainst(mesh, coherence));
+        }
+
+        EXPECT_GE(coherence.triangle, 0);
+        EXPECT_EQ(9u, coherence.hits);
+        EXPECT_EQ(1u, coherence.misses);
+        AssertFloatEqual(.9f, coherence.HitRate());
+    }
+
+    TEST_P(QueryCoherenceTests, CastAgainst_HintBehindNearerTriangle_StillReturnsNearest)
+    {
+        const Ray ray{ Vector3{ 3.3f, 6.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+        const Ray below{ Vector3{ 3.3f, 2.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        // Remember a triangle of the lower grid, which the ray also hits
+        QueryCoherence coherence;
+        below.CastAgainst(mesh, coherence);
+        ASSERT_GE(coherence.triangle, 0);
+
+        AssertFloatEqual(3.5f, ray.CastAgainst(mesh, coherence));
+        EXPECT_EQ(1u, coherence.hits);
+        AssertFloatEqual(2.5f, triangles[coherence.triangle].a.y);
+    }
+
+    TEST_P(QueryCoherenceTests, CastAgainst_StaleOrMissingHint_MatchesPlainCast)
+    {
+        QueryCoherence coherence;
+        coherence.triangle = mesh.numTriangles + 10;
+
+        for (int i = 0; i < 32; ++i)
+        {
+            const float f = static_cast<float>(i);
+            const Ray ray = Ray::FromPoints(Vector3{ f * .5f, 6.f, 8.f - f * .2f }, Vector3{ 16.f - f * .4f, 0.f, f * .45f });
+
+            AssertFloatEqual(ray.CastAgainst(mesh), ray.CastAgainst(mesh, coherence), 0.001f);
+        }
+
+        EXPECT_EQ(32u, coherence.hits + coherence.misses);
+        EXPECT_LT(coherence.triangle, mesh.numTriangles);
+    }
+
+    TEST_P(QueryCoherenceTests, CastAgainst_RayMisses_KeepsHint)
+    {
+        QueryCoherence coherence;
+        Ray{ Vector3{ 3.3f, 6.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } }.CastAgainst(mesh, coherence);
+        const int remembered = coherence.triangle;
+
+        EXPECT_EQ(-1.f, (Ray{ Vector3{ 3.3f, 6.f, 7.6f }, Vector3{ 0.f, 1.f, 0.f } }.CastAgainst(mesh, coherence)));
+        EXPECT_EQ(remembered, coherence.triangle);
+        EXPECT_EQ(2u, coherence.misses);
+    }
+
+    TEST_P(QueryCoherenceTests, Intersects_SteadySphere_AcceptsFromHint)
+    {
+        const Sphere sphere{ Vector3{ 5.2f, 1.3f, 9.1f }, .5f };
+
+        QueryCoherence coherence;
+        for (int frame = 0; frame < 20; ++frame)
+        {
+            EXPECT_TRUE(mesh.Intersects(sphere, coherence));
+        }
+
+        EXPECT_EQ(19u, coherence.hits);
+        EXPECT_EQ(1u, coherence.misses);
+        EXPECT_TRUE(triangles[coherence.triangle].Intersects(sphere));
+    }
+
+    TEST_P(QueryCoherenceTests, Intersects_ShapeMovedAway_FallsBackToTraversal)
+    {
+        QueryCoherence coherence;
+        EXPECT_TRUE(mesh.Intersects(Aabb{ Vector3{ 2.5f, 1.f, 2.5f }, Vector3{ .2f } }, coherence));
+        EXPECT_TRUE(mesh.Intersects(Aabb{ Vector3{ 12.5f, 2.5f, 4.5f }, Vector3{ .2f } }, coherence));
+        EXPECT_FALSE(mesh.Intersects(Aabb{ Vector3{ 12.5f, 1.75f, 4.5f }, Vector3{ .2f } }, coherence));
+
+        EXPECT_EQ(0u, coherence.hits);
+        EXPECT_EQ(3u, coherence.misses);
+        AssertFloatEqual(2.5f, triangles[coherence.triangle].a.y);
+    }
+
+    TEST_P(QueryCoherenceTests, CastBatch_WithHints_MatchesPlainBatch)
+    {
+        vector<Ray> rays;
+        for (int i = 0; i < 600; ++i)
+        {
+            const float f = static_cast<float>(i);
+            rays.push_back(Ray::FromPoints(Vector3{ MathF::Repeat(f * .37f, 16.f), 6.f, MathF::Repeat(f * .61f, 16.f) }, Vector3{ MathF::Repeat(f * .53f, 18.f) - 1.f, 0.f, MathF::Repeat(f * .29f, 18.f) - 1.f }));
+        }
+
+        vector<RayHit> expected(rays.size());
+        vector<RayHit> results(rays.size());
+        vector<QueryCoherence> coherence(rays.size());
+
+        const int hits = Ray::CastBatch(mesh, rays, expected);
+
+        for (int frame = 0; frame < 2; ++frame)
+        {
+            EXPECT_EQ(hits, Ray::CastBatch(mesh, rays, results, true, coherence));
+
+            for (size_t i = 0; i < rays.size(); ++i)
+            {
+                AssertFloatEqual(expected[i].distance, results[i].distance, 0.001f);
+            }
+        }
+
+        uint64_t hinted = 0;
+        for (const QueryCoherence& hint : coherence)
+        {
+            hinted += hint.hits;
+        }
+
+        EXPECT_EQ(static_cast<uint64_t>(hits), hinted);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(Structures, QueryCoherenceTests, Values(BvhBuildMode::Octree, BvhBuildMode::Morton, BvhBuildMode::Wide, BvhBuildMode::Spatial));
+}
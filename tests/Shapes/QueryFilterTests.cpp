@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/OBB.hpp"
+#include "Nudge/Shapes/QueryFilter.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::uint32_t;
+using std::vector;
+
+using testing::TestWithParam;
+using testing::Values;
+
+namespace Nudge
+{
+    // Layers of the test scene
+    constexpr uint32_t FLOOR_FLAG = 1u << 0;
+    constexpr uint32_t GLASS_FLAG = 1u << 1;
+    constexpr uint32_t FOLIAGE_FLAG = 1u << 2;
+
+    class QueryFilterTests : public TestWithParam<BvhBuildMode>
+    {
+    public:
+        static constexpr int GRID_TRIANGLES = 512;
+
+        vector<Triangle> triangles;
+        vector<uint32_t> flags;
+        Mesh mesh;
+
+    public:
+        // A floor grid at y = 1 under a glass grid at y = 2.5
+        void SetUp() override
+        {
+            for (const float y : { 1.f, 2.5f })
+            {
+                for (int x = 0; x < 16; ++x)
+                {
+                    for (int z = 0; z < 16; ++z)
+                    {
+                        const float fx = static_cast<float>(x);
+                        const float fz = static_cast<float>(z);
+
+                        triangles.emplace_back(Vector3{ fx, y, fz }, Vector3{ fx, y, fz + 1.f }, Vector3{ fx + 1.f, y, fz });
+                        triangles.emplace_back(Vector3{ fx + 1.f, y, fz }, Vector3{ fx, y, fz + 1.f }, Vector3{ fx + 1.f, y, fz + 1.f });
+                        flags.push_back(y < 2.f ? FLOOR_FLAG : GLASS_FLAG);
+                        flags.push_back(y < 2.f ? FLOOR_FLAG : GLASS_FLAG);
+                    }
+                }
+            }
+
+            mesh.numTriangles = static_cast<int>(triangles.size());
+            mesh.triangles = triangles.data();
+            mesh.flags = flags.data();
+            mesh.Accelerate(GetParam());
+        }
+
+        void TearDown() override
+        {
+            mesh.ReleaseAccelerator();
+        }
+
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance)) << expected << " vs " << actual;
+        }
+    };
+
+    TEST_P(QueryFilterTests, CastAgainst_MaskedOutLayer_RayPassesThrough)
+    {
+        const Ray ray{ Vector3{ 3.3f, 6.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        AssertFloatEqual(3.5f, ray.CastAgainst(mesh));
+        AssertFloatEqual(3.5f, ray.CastAgainst(mesh, QueryFilter{}));
+        AssertFloatEqual(3.5f, ray.CastAgainst(mesh, QueryFilter{ GLASS_FLAG }));
+        AssertFloatEqual(5.f, ray.CastAgainst(mesh, QueryFilter{ FLOOR_FLAG }));
+        EXPECT_EQ(-1.f, ray.CastAgainst(mesh, QueryFilter{ FOLIAGE_FLAG }));
+    }
+
+    TEST_P(QueryFilterTests, CastAgainst_Callback_RejectsWithoutStoppingRay)
+    {
+        const Ray ray{ Vector3{ 9.6f, 6.f, 2.2f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        const QueryFilter floorOnly{ QUERY_FILTER_ALL, [](const int triangle)
+        {
+            return triangle < GRID_TRIANGLES;
+        } };
+
+        AssertFloatEqual(5.f, ray.CastAgainst(mesh, floorOnly));
+        EXPECT_EQ(-1.f, ray.CastAgainst(mesh, QueryFilter{ QUERY_FILTER_ALL, [](int) { return false; } }));
+    }
+
+    TEST_P(QueryFilterTests, Callback_OnlySeesTrianglesPassingMask)
+    {
+        int calls = 0;
+        int glass = 0;
+
+        const QueryFilter filter{ FLOOR_FLAG, [&](const int triangle)
+        {
+            ++calls;
+            glass += triangle >= GRID_TRIANGLES ? 1 : 0;
+            return true;
+        } };
+
+        const Ray ray{ Vector3{ 4.4f, 6.f, 11.3f }, Vector3{ 0.f, -1.f, 0.f } };
+        AssertFloatEqual(5.f, ray.CastAgainst(mesh, filter));
+        EXPECT_TRUE(mesh.Intersects(Aabb{ Vector3{ 8.f, 1.75f, 8.f }, Vector3{ 8.f, 1.f, 8.f } }, filter));
+
+        EXPECT_GT(calls, 0);
+        EXPECT_EQ(0, glass);
+    }
+
+    TEST_P(QueryFilterTests, Intersects_FilteredShapes_OnlyMatchingLayerCounts)
+    {
+        const Sphere sphere{ Vector3{ 5.5f, 2.6f, 5.5f }, .5f };
+        const Aabb box{ Vector3{ 3.f, 2.5f, 3.f }, Vector3{ .5f, .2f, .5f } };
+        const Obb obb{ Vector3{ 12.f, 2.5f, 3.f }, Vector3{ .5f, .2f, .5f } };
+        const Triangle triangle{ Vector3{ 1.f, 2.f, 1.f }, Vector3{ 2.f, 3.f, 1.f }, Vector3{ 1.f, 3.f, 2.f } };
+
+        EXPECT_TRUE(mesh.Intersects(sphere));
+        EXPECT_TRUE(mesh.Intersects(sphere, QueryFilter{ GLASS_FLAG }));
+        EXPECT_FALSE(mesh.Intersects(sphere, QueryFilter{ FLOOR_FLAG }));
+
+        EXPECT_TRUE(mesh.Intersects(box, QueryFilter{ GLASS_FLAG | FOLIAGE_FLAG }));
+        EXPECT_FALSE(mesh.Intersects(box, QueryFilter{ FLOOR_FLAG | FOLIAGE_FLAG }));
+
+        EXPECT_TRUE(mesh.Intersects(obb, QueryFilter{ GLASS_FLAG }));
+        EXPECT_FALSE(mesh.Intersects(obb, QueryFilter{ FLOOR_FLAG }));
+
+        EXPECT_TRUE(mesh.Intersects(triangle, QueryFilter{ GLASS_FLAG }));
+        EXPECT_FALSE(mesh.Intersects(triangle, QueryFilter{ FLOOR_FLAG }));
+    }
+
+    TEST_P(QueryFilterTests, CastAgainst_MixedFlags_MatchesFilteringAllHits)
+    {
+        for (int i = 0; i < mesh.numTriangles; ++i)
+        {
+            flags[i] = 1u << (i * 7 % 3);
+        }
+
+        mesh.RefreshFlags();
+
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const Vector3 origin{ Scatter(i * 4, -2.f, 18.f), Scatter(i * 4 + 1, 3.f, 6.f), Scatter(i * 4 + 2, -2.f, 18.f) };
+            const Vector3 target{ Scatter(i * 4 + 3, 0.f, 16.f), 0.f, Scatter(i * 4 + 5, 0.f, 16.f) };
+            const Ray ray = Ray::FromPoints(origin, target);
+
+            for (const uint32_t mask : { FLOOR_FLAG, GLASS_FLAG | FOLIAGE_FLAG, FOLIAGE_FLAG })
+            {
+                RayHit all[8];
+                const int count = ray.CastAgainst(mesh, all, 8);
+
+                float expected = -1.f;
+                for (int hit = 0; hit < count && expected < 0.f; ++hit)
+                {
+                    expected = (flags[all[hit].triangle] & mask) != 0 ? all[hit].distance : -1.f;
+                }
+
+                EXPECT_EQ(expected, ray.CastAgainst(mesh, QueryFilter{ mask }));
+
+                RayHit filtered[8];
+                const int kept = ray.CastAgainst(mesh, QueryFilter{ mask }, filtered, 8);
+                for (int hit = 0; hit < kept; ++hit)
+                {
+                    EXPECT_NE(0u, flags[filtered[hit].triangle] & mask);
+                }
+            }
+        }
+    }
+
+    TEST_P(QueryFilterTests, RefreshFlags_EditedFlags_CullingFollows)
+    {
+        const Ray ray{ Vector3{ 3.3f, 6.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        std::fill(flags.begin(), flags.end(), FLOOR_FLAG);
+        mesh.RefreshFlags();
+        EXPECT_EQ(-1.f, ray.CastAgainst(mesh, QueryFilter{ GLASS_FLAG }));
+
+        std::fill(flags.begin() + GRID_TRIANGLES, flags.end(), GLASS_FLAG);
+        mesh.RefreshFlags();
+        AssertFloatEqual(3.5f, ray.CastAgainst(mesh, QueryFilter{ GLASS_FLAG }));
+
+        // Without flags, masks no longer apply
+        mesh.flags = nullptr;
+        mesh.RefreshFlags();
+        AssertFloatEqual(3.5f, ray.CastAgainst(mesh, QueryFilter{ FOLIAGE_FLAG }));
+        EXPECT_TRUE(mesh.Intersects(Sphere{ Vector3{ 5.5f, 1.f, 5.5f }, .2f }, QueryFilter{ 0u }));
+    }
+
+    TEST_P(QueryFilterTests, ReorderTriangles_FlagsFollowTriangles)
+    {
+        if (!mesh.ReorderTriangles())
+        {
+            GTEST_SKIP() << "Structure cannot be reordered";
+        }
+
+        for (int i = 0; i < mesh.numTriangles; ++i)
+        {
+            EXPECT_EQ(triangles[i].a.y < 2.f ? FLOOR_FLAG : GLASS_FLAG, flags[i]);
+        }
+
+        const Ray ray{ Vector3{ 7.7f, 6.f, 1.4f }, Vector3{ 0.f, -1.f, 0.f } };
+        AssertFloatEqual(5.f, ray.CastAgainst(mesh, QueryFilter{ FLOOR_FLAG }));
+        AssertFloatEqual(3.5f, ray.CastAgainst(mesh, QueryFilter{ GLASS_FLAG }));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(Structures, QueryFilterTests, Values(BvhBuildMode::Octree, BvhBuildMode::Morton, BvhBuildMode::Wide, BvhBuildMode::Spatial));
+}
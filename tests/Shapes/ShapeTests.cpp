@@ -0,0 +1,259 @@
+#include <cstdint>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Shape.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::uint8_t;
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class ShapeTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance)) << expected << " vs " << actual;
+        }
+
+        // Shape of the given type near the origin, so that about half of all pairs touch
+        static Shape MakeShape(const ShapeType type, const unsigned seed)
+        {
+            const Vector3 center = ScatterPoint(seed, -3.f, 3.f);
+
+            switch (type)
+            {
+            case ShapeType::Sphere:
+                return Sphere{ center, Scatter(seed + 1, .3f, 1.5f) };
+            case ShapeType::Aabb:
+                return Aabb{ center, ScatterPoint(seed + 2, .2f, 1.2f) };
+            case ShapeType::Obb:
+                return Obb{ center, ScatterPoint(seed + 3, .2f, 1.2f), Matrix3::Rotation(ScatterPoint(seed + 4, 0.f, 360.f)) };
+            case ShapeType::Triangle:
+                return Triangle{ center, center + ScatterPoint(seed + 5, -2.f, 2.f), center + ScatterPoint(seed + 6, -2.f, 2.f) };
+            case ShapeType::Plane:
+                return Plane{ ScatterPoint(seed + 7, -1.f, 1.f).Normalized(), Scatter(seed + 8, -4.f, 4.f) };
+            default:
+                return Line{ center, center + ScatterPoint(seed + 9, -3.f, 3.f) };
+            }
+        }
+
+        static vector<Shape> MakeShapes(const int count, const unsigned seed)
+        {
+            vector<Shape> shapes;
+            for (int i = 0; i < count; ++i)
+            {
+                shapes.push_back(MakeShape(static_cast<ShapeType>(i % SHAPE_TYPE_COUNT), seed + static_cast<unsigned>(i) * 11));
+            }
+
+            return shapes;
+        }
+
+        template <typename A, typename B>
+        static bool DirectIntersects(const A& a, const B& b)
+        {
+            if constexpr (requires { a.Intersects(b); })
+            {
+                return a.Intersects(b);
+            }
+            else if constexpr (requires { a.Test(b); })
+            {
+                return a.Test(b);
+            }
+            else if constexpr (requires { b.Test(a); })
+            {
+                return b.Test(a);
+            }
+            else
+            {
+                return false;
+            }
+        }
+    };
+
+    TEST_F(ShapeTests, Type_FollowsHeldPrimitive)
+    {
+        EXPECT_EQ(ShapeType::Sphere, Shape{}.Type());
+        EXPECT_EQ(ShapeType::Aabb, Shape{ Aabb{} }.Type());
+        EXPECT_EQ(ShapeType::Obb, Shape{ Obb{} }.Type());
+        EXPECT_EQ(ShapeType::Triangle, Shape{ Triangle{} }.Type());
+        EXPECT_EQ(ShapeType::Plane, Shape{ Plane{} }.Type());
+        EXPECT_EQ(ShapeType::Line, Shape{ Line{} }.Type());
+    }
+
+    TEST_F(ShapeTests, Intersects_MatchesPrimitiveOverloads)
+    {
+        const vector<Shape> shapes = MakeShapes(120, 1);
+
+        int hits = 0;
+        for (const Shape& a : shapes)
+        {
+            for (const Shape& b : shapes)
+            {
+                if (a.Type() == ShapeType::Line && b.Type() == ShapeType::Line)
+                {
+                    continue;
+                }
+
+                const bool expected = std::visit([](const auto& first, const auto& second)
+                {
+                    return DirectIntersects(first, second);
+                }, a.value, b.value);
+
+                EXPECT_EQ(expected, a.Intersects(b));
+                hits += expected ? 1 : 0;
+            }
+        }
+
+        EXPECT_GT(hits, 0);
+        EXPECT_LT(hits, 120 * 120);
+    }
+
+    TEST_F(ShapeTests, Distance_KnownSeparations)
+    {
+        const Shape sphere = Sphere{ Vector3{ 0.f }, 1.f };
+        const Shape box = Aabb{ Vector3{ 5.f, 0.f, 0.f }, Vector3{ 1.f } };
+        const Shape rotated = Obb{ Vector3{ 0.f, 6.f, 0.f }, Vector3{ 1.f }, Matrix3::RotationZ(45.f) };
+        const Shape triangle = Triangle{ Vector3{ 0.f, 0.f, 3.f }, Vector3{ 1.f, 0.f, 3.f }, Vector3{ 0.f, 1.f, 3.f } };
+        const Shape plane = Plane{ Vector3{ 0.f, 1.f, 0.f }, -4.f };
+        const Shape line = Line{ Vector3{ -2.f, -2.f, 1.f }, Vector3{ 2.f, -2.f, 1.f } };
+
+        AssertFloatEqual(3.f, sphere.Distance(box));
+        AssertFloatEqual(3.f, box.Distance(sphere));
+        AssertFloatEqual(6.f - MathF::Sqrt(2.f) - 1.f, sphere.Distance(rotated));
+        AssertFloatEqual(2.f, sphere.Distance(triangle));
+        AssertFloatEqual(3.f, sphere.Distance(plane));
+        AssertFloatEqual(3.f, plane.Distance(box));
+        AssertFloatEqual(MathF::Sqrt(5.f) - 1.f, sphere.Distance(line));
+        AssertFloatEqual(MathF::Sqrt(8.f), line.Distance(triangle));
+        AssertFloatEqual(MathF::Sqrt(13.f), box.Distance(triangle), .001f);
+
+        // Parallel planes are apart, crossing ones are not
+        AssertFloatEqual(5.f, plane.Distance(Shape{ Plane{ Vector3{ 0.f, -1.f, 0.f }, -1.f } }));
+        EXPECT_EQ(0.f, plane.Distance(Shape{ Plane{ Vector3{ 1.f, 0.f, 0.f }, 0.f } }));
+
+        // Oriented boxes are tested against the plane's offset, not the origin's
+        const Shape level = Obb{ Vector3{ 0.f }, Vector3{ 1.f } };
+        const Shape tilted = Obb{ Vector3{ 0.f, -4.5f, 0.f }, Vector3{ 1.f }, Matrix3::RotationX(20.f) };
+        EXPECT_FALSE(level.Intersects(plane));
+        EXPECT_TRUE(tilted.Intersects(plane));
+
+        EXPECT_EQ(0.f, sphere.Distance(Shape{ Aabb{ Vector3{ 1.5f, 0.f, 0.f }, Vector3{ 1.f } } }));
+        EXPECT_EQ(0.f, box.Distance(Shape{ Obb{ Vector3{ 6.f, 1.f, 0.f }, Vector3{ 1.f }, Matrix3::RotationY(30.f) } }));
+
+        const Shape crossing = Line{ Vector3{ 0.f, -1.f, 0.f }, Vector3{ 0.f, 1.f, 0.f } };
+        EXPECT_TRUE(crossing.Intersects(Shape{ Line{ Vector3{ -1.f, 0.f, 0.f }, Vector3{ 1.f, 0.f, 0.f } } }));
+        EXPECT_FALSE(crossing.Intersects(line));
+    }
+
+    TEST_F(ShapeTests, Distance_AgreesWithIntersects)
+    {
+        const vector<Shape> shapes = MakeShapes(90, 500);
+
+        for (const Shape& a : shapes)
+        {
+            for (const Shape& b : shapes)
+            {
+                if (a.Type() == ShapeType::Plane && b.Type() == ShapeType::Plane)
+                {
+                    continue;
+                }
+
+                const float distance = a.Distance(b);
+                EXPECT_GE(distance, 0.f);
+                AssertFloatEqual(distance, b.Distance(a), .001f);
+
+                if (distance > .001f)
+                {
+                    EXPECT_FALSE(a.Intersects(b)) << distance;
+                }
+                else if (distance == 0.f)
+                {
+                    EXPECT_TRUE(a.Intersects(b));
+                }
+            }
+        }
+    }
+
+    TEST_F(ShapeTests, CastRay_MatchesRayOverloads)
+    {
+        const vector<Shape> shapes = MakeShapes(60, 900);
+
+        for (unsigned i = 0; i < 40; ++i)
+        {
+            const Vector3 origin = ScatterPoint(i + 3000, -8.f, 8.f);
+            const Ray ray{ origin, (ScatterPoint(i + 3100, -2.f, 2.f) - origin).Normalized() };
+
+            for (const Shape& shape : shapes)
+            {
+                const float expected = std::visit([&](const auto& primitive)
+                {
+                    // Segments are never hit
+                    if constexpr (std::is_same_v<std::decay_t<decltype(primitive)>, Line>)
+                    {
+                        return -1.f;
+                    }
+                    else
+                    {
+                        return ray.CastAgainst(primitive);
+                    }
+                }, shape.value);
+
+                EXPECT_EQ(expected, shape.CastRay(ray));
+                EXPECT_EQ(expected, ray.CastAgainst(shape));
+            }
+        }
+    }
+
+    TEST_F(ShapeTests, Batch_MatchesSinglePairs)
+    {
+        const vector<Shape> shapes = MakeShapes(150, 77);
+
+        vector<ShapePair> pairs;
+        for (unsigned i = 0; i < 5000; ++i)
+        {
+            pairs.push_back({ static_cast<int>(Scatter(i * 2 + 40000, 0.f, 150.f)), static_cast<int>(Scatter(i * 2 + 40001, 0.f, 150.f)) });
+        }
+
+        vector<uint8_t> overlaps(pairs.size(), 7);
+        const int found = Shape::IntersectsBatch(shapes, pairs, overlaps);
+
+        vector<float> distances(pairs.size(), -1.f);
+        EXPECT_EQ(static_cast<int>(pairs.size()), Shape::DistanceBatch(shapes, pairs, distances));
+
+        int expected = 0;
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            const Shape& a = shapes[pairs[i].first];
+            const Shape& b = shapes[pairs[i].second];
+
+            EXPECT_EQ(a.Intersects(b) ? 1 : 0, overlaps[i]);
+            EXPECT_EQ(a.Distance(b), distances[i]);
+            expected += a.Intersects(b) ? 1 : 0;
+        }
+
+        EXPECT_EQ(expected, found);
+
+        // Output shorter than the pairs limits the work
+        vector<uint8_t> few(10);
+        Shape::IntersectsBatch(shapes, pairs, few);
+        for (size_t i = 0; i < few.size(); ++i)
+        {
+            EXPECT_EQ(overlaps[i], few[i]);
+        }
+
+        EXPECT_EQ(0, Shape::IntersectsBatch(shapes, {}, overlaps));
+    }
+}
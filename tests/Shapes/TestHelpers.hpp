@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+
+#include "Nudge/Maths/Vector3.hpp"
+#include "Nudge/Shapes/LinearBvh.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+using std::vector;
+
+namespace Nudge
+{
+    // Deterministic value in [min, max) derived from a seed
+    inline float Scatter(const unsigned seed, const float min, const float max)
+    {
+        unsigned h = seed * 2654435761u;
+        h ^= h >> 15;
+        h *= 2246822519u;
+        h ^= h >> 13;
+
+        return min + (max - min) * static_cast<float>(h & 0xFFFFFF) / 16777216.f;
+    }
+
+    // Deterministic point with every coordinate in [min, max)
+    inline Vector3 ScatterPoint(const unsigned seed, const float min, const float max)
+    {
+        return { Scatter(seed * 3, min, max), Scatter(seed * 3 + 1, min, max), Scatter(seed * 3 + 2, min, max) };
+    }
+
+    // Deterministic point inside the box spanning min to max
+    inline Vector3 ScatterPoint(const unsigned seed, const Vector3& min, const Vector3& max)
+    {
+        return { Scatter(seed * 3, min.x, max.x), Scatter(seed * 3 + 1, min.y, max.y), Scatter(seed * 3 + 2, min.z, max.z) };
+    }
+
+    // Builds stacked horizontal grids of upward-facing triangles, one grid per layer height
+    inline vector<Triangle> MakeLayers(const int size, const vector<float>& heights)
+    {
+        vector<Triangle> result;
+
+        for (const float y : heights)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                for (int z = 0; z < size; ++z)
+                {
+                    const float fx = static_cast<float>(x);
+                    const float fz = static_cast<float>(z);
+
+                    result.emplace_back(Vector3{ fx, y, fz }, Vector3{ fx, y, fz + 1.f }, Vector3{ fx + 1.f, y, fz });
+                    result.emplace_back(Vector3{ fx + 1.f, y, fz }, Vector3{ fx, y, fz + 1.f }, Vector3{ fx + 1.f, y, fz + 1.f });
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Unaccelerated mesh viewing the given triangles, which must outlive it
+    inline Mesh MakeMesh(vector<Triangle>& triangles)
+    {
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        return mesh;
+    }
+
+    // Mesh viewing the given triangles, accelerated with the given build mode
+    inline Mesh MakeMesh(vector<Triangle>& triangles, const BvhBuildMode mode)
+    {
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(mode);
+
+        return mesh;
+    }
+}
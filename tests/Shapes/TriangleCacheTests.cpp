@@ -0,0 +1,246 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Sphere.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+#include "Nudge/Shapes/TriangleCache.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class TriangleCacheTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        // Arbitrarily oriented triangles in a 4 unit cube
+        static vector<Triangle> MakeTriangles(const int count)
+        {
+            vector<Triangle> result;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const unsigned seed = static_cast<unsigned>(i) * 3;
+                result.emplace_back(ScatterPoint(seed, -2.f, 2.f), ScatterPoint(seed + 1, -2.f, 2.f), ScatterPoint(seed + 2, -2.f, 2.f));
+            }
+
+            return result;
+        }
+
+        // Twice the area over the squared longest edge; near zero for slivers
+        static float Quality(const Triangle& t)
+        {
+            const Vector3 ab = t.b - t.a;
+            const Vector3 ac = t.c - t.a;
+            const Vector3 bc = t.c - t.b;
+
+            return Vector3::Cross(ab, ac).Magnitude() / MathF::Max(ab.MagnitudeSqr(), MathF::Max(ac.MagnitudeSqr(), bc.MagnitudeSqr()));
+        }
+    };
+
+    TEST_F(TriangleCacheTests, Build_SingleTriangle_StoresEdgesAndPlane)
+    {
+        const Triangle triangle{ Vector3{ 1.f, 2.f, 3.f }, Vector3{ 1.f, 2.f, 5.f }, Vector3{ 4.f, 2.f, 3.f } };
+
+        TriangleCache cache;
+        cache.Build(&triangle, 1);
+
+        ASSERT_EQ(1, cache.Count());
+        AssertFloatEqual(2.f, cache.e0z[0]);
+        AssertFloatEqual(3.f, cache.e1x[0]);
+        AssertFloatEqual(6.f, cache.ny[0]);
+        AssertFloatEqual(12.f, cache.distance[0]);
+        AssertFloatEqual(1.f / 36.f, cache.inverseDenominator[0]);
+    }
+
+    TEST_F(TriangleCacheTests, Build_DegenerateTriangle_NeverHit)
+    {
+        const Triangle triangle{ Vector3{ 0.f }, Vector3{ 1.f, 1.f, 1.f }, Vector3{ 2.f, 2.f, 2.f } };
+
+        TriangleCache cache;
+        cache.Build(&triangle, 1);
+
+        EXPECT_EQ(0.f, cache.inverseDenominator[0]);
+        EXPECT_EQ(-1.f, cache.CastRay(0, Vector3{ 1.f, 5.f, 1.f }, Vector3{ 0.f, -1.f, 0.f }));
+    }
+
+    TEST_F(TriangleCacheTests, Clear_RemovesAllTriangles)
+    {
+        const vector<Triangle> triangles = MakeTriangles(8);
+
+        TriangleCache cache;
+        cache.Build(triangles.data(), 8);
+        cache.Clear();
+
+        EXPECT_EQ(0, cache.Count());
+    }
+
+    TEST_F(TriangleCacheTests, CastRay_MatchesTriangleCast)
+    {
+        const vector<Triangle> triangles = MakeTriangles(200);
+
+        TriangleCache cache;
+        cache.Build(triangles.data(), static_cast<int>(triangles.size()));
+
+        for (int i = 0; i < cache.Count(); ++i)
+        {
+            // Triangle::Barycentric() is too imprecise on slivers to serve as the reference
+            if (Quality(triangles[i]) < .05f)
+            {
+                continue;
+            }
+
+            for (unsigned j = 0; j < 20; ++j)
+            {
+                const unsigned seed = static_cast<unsigned>(i) * 20 + j;
+                const Ray ray = Ray::FromPoints(ScatterPoint(seed + 10000, -4.f, 4.f), ScatterPoint(seed + 50000, -1.f, 1.f));
+
+                AssertFloatEqual(ray.CastAgainst(triangles[i]), cache.CastRay(i, ray.origin, ray.direction), 0.001f);
+            }
+        }
+    }
+
+    TEST_F(TriangleCacheTests, CastRay_BackFace_ReturnsMiss)
+    {
+        const Triangle triangle{ Vector3{ 0.f, 0.f, 0.f }, Vector3{ 0.f, 0.f, 1.f }, Vector3{ 1.f, 0.f, 0.f } };
+
+        TriangleCache cache;
+        cache.Build(&triangle, 1);
+
+        AssertFloatEqual(3.f, cache.CastRay(0, Vector3{ .2f, 3.f, .2f }, Vector3{ 0.f, -1.f, 0.f }));
+        EXPECT_EQ(-1.f, cache.CastRay(0, Vector3{ .2f, -3.f, .2f }, Vector3{ 0.f, 1.f, 0.f }));
+    }
+
+    TEST_F(TriangleCacheTests, IntersectsAabb_MatchesTriangleIntersects)
+    {
+        const vector<Triangle> triangles = MakeTriangles(200);
+
+        TriangleCache cache;
+        cache.Build(triangles.data(), static_cast<int>(triangles.size()));
+
+        for (int i = 0; i < cache.Count(); ++i)
+        {
+            for (unsigned j = 0; j < 20; ++j)
+            {
+                const unsigned seed = static_cast<unsigned>(i) * 20 + j;
+                const Aabb box{ ScatterPoint(seed + 10000, -3.f, 3.f), ScatterPoint(seed + 50000, .05f, .8f) };
+
+                EXPECT_EQ(triangles[i].Intersects(box), cache.IntersectsAabb(i, box.origin, box.extents));
+            }
+        }
+    }
+
+    TEST_F(TriangleCacheTests, IntersectsSphere_MatchesTriangleIntersects)
+    {
+        const vector<Triangle> triangles = MakeTriangles(200);
+
+        TriangleCache cache;
+        cache.Build(triangles.data(), static_cast<int>(triangles.size()));
+
+        for (int i = 0; i < cache.Count(); ++i)
+        {
+            for (unsigned j = 0; j < 20; ++j)
+            {
+                const unsigned seed = static_cast<unsigned>(i) * 20 + j;
+                const Sphere sphere{ ScatterPoint(seed + 10000, -3.f, 3.f), Scatter(seed + 90000, .05f, 1.f) };
+
+                EXPECT_EQ(triangles[i].Intersects(sphere), cache.IntersectsSphere(i, sphere.origin, sphere.radius));
+            }
+        }
+    }
+
+    TEST_F(TriangleCacheTests, MeshQueries_WithCache_MatchUncached)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 1.f, 2.5f });
+
+        Mesh plain;
+        plain.numTriangles = static_cast<int>(triangles.size());
+        plain.triangles = triangles.data();
+
+        for (const BvhBuildMode mode : { BvhBuildMode::Octree, BvhBuildMode::Morton, BvhBuildMode::Wide })
+        {
+            Mesh cached = plain;
+            cached.Accelerate(mode);
+            cached.BuildCache();
+
+            for (unsigned i = 0; i < 64; ++i)
+            {
+                const Vector3 origin = ScatterPoint(i, 0.f, 16.f);
+                const Ray ray = Ray::FromPoints(Vector3{ origin.x, 6.f, origin.z }, ScatterPoint(i + 100, 0.f, 16.f));
+                const Sphere sphere{ origin, Scatter(i + 200, .1f, 1.5f) };
+                const Aabb box{ origin, ScatterPoint(i + 300, .05f, 1.f) };
+
+                AssertFloatEqual(ray.CastAgainst(plain), ray.CastAgainst(cached), 0.001f);
+                EXPECT_EQ(plain.Intersects(sphere), cached.Intersects(sphere));
+                EXPECT_EQ(plain.Intersects(box), cached.Intersects(box));
+            }
+
+            cached.ReleaseCache();
+            cached.ReleaseAccelerator();
+        }
+    }
+
+    TEST_F(TriangleCacheTests, Rebuild_MovedVertices_RefreshesCache)
+    {
+        vector<Triangle> triangles = MakeLayers(4, { 0.f });
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+        mesh.Accelerate(BvhBuildMode::Morton);
+        mesh.BuildCache();
+
+        for (Triangle& triangle : triangles)
+        {
+            triangle.a.y = triangle.b.y = triangle.c.y = 1.f;
+        }
+
+        mesh.Rebuild(BvhBuildMode::Morton);
+
+        const Ray ray{ Vector3{ 1.3f, 5.f, 2.6f }, Vector3{ 0.f, -1.f, 0.f } };
+        AssertFloatEqual(4.f, ray.CastAgainst(mesh));
+
+        mesh.ReleaseCache();
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(TriangleCacheTests, ReorderTriangles_WithCache_KeepsQueriesValid)
+    {
+        vector<Triangle> triangles = MakeTriangles(300);
+        vector<Triangle> original = triangles;
+
+        Mesh plain;
+        plain.numTriangles = static_cast<int>(original.size());
+        plain.triangles = original.data();
+
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+        mesh.Accelerate(BvhBuildMode::Morton);
+        mesh.BuildCache();
+        ASSERT_TRUE(mesh.ReorderTriangles());
+
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            const Sphere sphere{ ScatterPoint(i, -3.f, 3.f), Scatter(i + 200, .05f, .3f) };
+            EXPECT_EQ(plain.Intersects(sphere), mesh.Intersects(sphere));
+        }
+
+        mesh.ReleaseCache();
+        mesh.ReleaseAccelerator();
+    }
+}
@@ -0,0 +1,206 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/Interval.hpp"
+#include "Nudge/Shapes/Line.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class TriangleTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        static void AssertVectorEqual(const Vector3& expected, const Vector3& actual, const float tolerance = 0.0001f)
+        {
+            AssertFloatEqual(expected.x, actual.x, tolerance);
+            AssertFloatEqual(expected.y, actual.y, tolerance);
+            AssertFloatEqual(expected.z, actual.z, tolerance);
+        }
+
+        // Triangles of about unit size scattered in a small cube, so roughly half the pairs intersect
+        static vector<Triangle> MakeTriangles(const int count)
+        {
+            vector<Triangle> result;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const unsigned seed = static_cast<unsigned>(i) * 4;
+                const Vector3 center = ScatterPoint(seed, -.6f, .6f);
+
+                result.emplace_back(center + ScatterPoint(seed + 1, -1.f, 1.f), center + ScatterPoint(seed + 2, -1.f, 1.f), center + ScatterPoint(seed + 3, -1.f, 1.f));
+            }
+
+            return result;
+        }
+
+        // True if the point lies on the triangle, within a tolerance
+        static bool OnTriangle(const Triangle& triangle, const Vector3& point)
+        {
+            return (triangle.ClosestPoint(point) - point).MagnitudeSqr() < 1e-6f;
+        }
+    };
+
+    TEST_F(TriangleTests, Intersects_Triangle_MatchesSeparatingAxisTest)
+    {
+        const vector<Triangle> triangles = MakeTriangles(120);
+
+        int intersecting = 0;
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            for (size_t j = 0; j < triangles.size(); ++j)
+            {
+                const bool expected = Interval::TriangleTriangle(triangles[i], triangles[j]);
+                EXPECT_EQ(expected, triangles[i].Intersects(triangles[j]));
+                intersecting += expected;
+            }
+        }
+
+        EXPECT_GT(intersecting, 120 * 120 / 10);
+    }
+
+    TEST_F(TriangleTests, Intersects_PiercingTriangle_ReturnsSegment)
+    {
+        const Triangle floor{ Vector3{ -2.f, 0.f, -2.f }, Vector3{ -2.f, 0.f, 2.f }, Vector3{ 2.f, 0.f, 0.f } };
+        const Triangle wall{ Vector3{ 0.f, -1.f, -1.f }, Vector3{ 0.f, 1.f, -1.f }, Vector3{ 0.f, -1.f, 1.f } };
+
+        Line segment;
+        ASSERT_TRUE(floor.Intersects(wall, segment));
+
+        // The wall crosses y = 0 from z = -1 to z = 0
+        const float low = MathF::Min(segment.start.z, segment.end.z);
+        const float high = MathF::Max(segment.start.z, segment.end.z);
+
+        AssertFloatEqual(-1.f, low);
+        AssertFloatEqual(0.f, high);
+        AssertFloatEqual(0.f, segment.start.x);
+        AssertFloatEqual(0.f, segment.end.y);
+    }
+
+    TEST_F(TriangleTests, Intersects_RandomPairs_SegmentLiesOnBothTriangles)
+    {
+        const vector<Triangle> triangles = MakeTriangles(60);
+
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            for (size_t j = i + 1; j < triangles.size(); ++j)
+            {
+                Line segment;
+                if (!triangles[i].Intersects(triangles[j], segment))
+                {
+                    continue;
+                }
+
+                EXPECT_TRUE(OnTriangle(triangles[i], segment.start));
+                EXPECT_TRUE(OnTriangle(triangles[i], segment.end));
+                EXPECT_TRUE(OnTriangle(triangles[j], segment.start));
+                EXPECT_TRUE(OnTriangle(triangles[j], segment.end));
+            }
+        }
+    }
+
+    TEST_F(TriangleTests, Intersects_ParallelPlanes_ReturnsFalse)
+    {
+        const Triangle lower{ Vector3{ 0.f, 0.f, 0.f }, Vector3{ 0.f, 0.f, 1.f }, Vector3{ 1.f, 0.f, 0.f } };
+        const Triangle upper{ Vector3{ 0.f, .1f, 0.f }, Vector3{ 0.f, .1f, 1.f }, Vector3{ 1.f, .1f, 0.f } };
+
+        EXPECT_FALSE(lower.Intersects(upper));
+    }
+
+    TEST_F(TriangleTests, Intersects_TouchingAtVertex_ReturnsPointSegment)
+    {
+        const Triangle floor{ Vector3{ 0.f, 0.f, 0.f }, Vector3{ 0.f, 0.f, 2.f }, Vector3{ 2.f, 0.f, 0.f } };
+        const Triangle spike{ Vector3{ .5f, 0.f, .5f }, Vector3{ .5f, 1.f, 0.f }, Vector3{ 1.f, 1.f, .5f } };
+
+        Line segment;
+        ASSERT_TRUE(floor.Intersects(spike, segment));
+        AssertVectorEqual(Vector3{ .5f, 0.f, .5f }, segment.start);
+        AssertVectorEqual(Vector3{ .5f, 0.f, .5f }, segment.end);
+    }
+
+    TEST_F(TriangleTests, Intersects_CoplanarOverlapping_ReturnsPointInBoth)
+    {
+        const Triangle first{ Vector3{ 0.f, 1.f, 0.f }, Vector3{ 0.f, 1.f, 2.f }, Vector3{ 2.f, 1.f, 0.f } };
+        const Triangle second{ Vector3{ 1.5f, 1.f, 1.5f }, Vector3{ .5f, 1.f, 1.5f }, Vector3{ 1.5f, 1.f, .5f } };
+
+        Line segment;
+        ASSERT_TRUE(first.Intersects(second, segment));
+        EXPECT_TRUE(OnTriangle(first, segment.start));
+        EXPECT_TRUE(OnTriangle(second, segment.start));
+    }
+
+    TEST_F(TriangleTests, Intersects_CoplanarContained_ReturnsTrue)
+    {
+        const Triangle outer{ Vector3{ 0.f, 0.f, 0.f }, Vector3{ 0.f, 4.f, 0.f }, Vector3{ 4.f, 0.f, 0.f } };
+        const Triangle inner{ Vector3{ .5f, .5f, 0.f }, Vector3{ .5f, 1.f, 0.f }, Vector3{ 1.f, .5f, 0.f } };
+
+        EXPECT_TRUE(outer.Intersects(inner));
+        EXPECT_TRUE(inner.Intersects(outer));
+    }
+
+    TEST_F(TriangleTests, Intersects_CoplanarDisjoint_ReturnsFalse)
+    {
+        const Triangle first{ Vector3{ 0.f, 0.f, 0.f }, Vector3{ 0.f, 1.f, 0.f }, Vector3{ 1.f, 0.f, 0.f } };
+        const Triangle second{ Vector3{ 1.f, 1.f, 0.f }, Vector3{ 1.f, 2.f, 0.f }, Vector3{ 2.f, 1.f, 0.f } };
+
+        EXPECT_FALSE(first.Intersects(second));
+    }
+
+    TEST_F(TriangleTests, Intersects_DegenerateTriangle_MatchesSeparatingAxisTest)
+    {
+        const Triangle face{ Vector3{ 0.f, 0.f, 0.f }, Vector3{ 0.f, 0.f, 2.f }, Vector3{ 2.f, 0.f, 0.f } };
+        const Triangle crossing{ Vector3{ .5f, -1.f, .5f }, Vector3{ .5f, 0.f, .5f }, Vector3{ .5f, 1.f, .5f } };
+        const Triangle beside{ Vector3{ 3.f, -1.f, 3.f }, Vector3{ 3.f, 0.f, 3.f }, Vector3{ 3.f, 1.f, 3.f } };
+
+        EXPECT_EQ(Interval::TriangleTriangle(face, crossing), face.Intersects(crossing));
+        EXPECT_EQ(Interval::TriangleTriangle(face, beside), face.Intersects(beside));
+        EXPECT_FALSE(face.Intersects(beside));
+    }
+
+    TEST_F(TriangleTests, IntersectsBatch_MatchesSingleTests)
+    {
+        const vector<Triangle> triangles = MakeTriangles(200);
+        vector<int> hits(triangles.size());
+
+        for (size_t i = 0; i < 20; ++i)
+        {
+            const int count = Triangle::IntersectsBatch(triangles[i], triangles, hits);
+
+            vector<int> expected;
+            for (size_t j = 0; j < triangles.size(); ++j)
+            {
+                if (triangles[i].Intersects(triangles[j]))
+                {
+                    expected.push_back(static_cast<int>(j));
+                }
+            }
+
+            ASSERT_EQ(static_cast<int>(expected.size()), count);
+            for (int k = 0; k < count; ++k)
+            {
+                EXPECT_EQ(expected[k], hits[k]);
+            }
+        }
+    }
+
+    TEST_F(TriangleTests, IntersectsBatch_FullBuffer_StopsEarly)
+    {
+        const vector<Triangle> triangles = MakeTriangles(200);
+        vector<int> hits(3);
+
+        EXPECT_EQ(3, Triangle::IntersectsBatch(triangles[0], triangles, hits));
+    }
+}
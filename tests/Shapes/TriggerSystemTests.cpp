@@ -0,0 +1,220 @@
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/Matrix3.hpp"
+#include "Nudge/Shapes/TriggerSystem.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::pair;
+using std::set;
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class TriggerSystemTests : public Test
+    {
+    public:
+        // Sphere, box or oriented box around a point
+        static Shape MakeVolume(const unsigned seed, const Vector3& center)
+        {
+            switch (seed % 3)
+            {
+            case 0:
+                return Sphere{ center, Scatter(seed + 1, .5f, 2.f) };
+            case 1:
+                return Aabb{ center, ScatterPoint(seed + 2, .3f, 2.f) };
+            default:
+                return Obb{ center, ScatterPoint(seed + 3, .3f, 2.f), Matrix3::Rotation(ScatterPoint(seed + 4, 0.f, 360.f)) };
+            }
+        }
+    };
+
+    TEST_F(TriggerSystemTests, Update_BodyWalksThrough_EntersOnceAndExitsOnce)
+    {
+        TriggerSystem system;
+        const int trigger = system.AddTrigger(Aabb{ Vector3{ 0.f }, Vector3{ 2.f } });
+        const int body = system.AddBody(Sphere{ Vector3{ -6.f, 0.f, 0.f }, .5f });
+
+        vector<TriggerEvent> events;
+        EXPECT_EQ(0, system.Update(events));
+
+        int enters = 0;
+        int exits = 0;
+        for (int step = 0; step <= 24; ++step)
+        {
+            system.Move(body, Sphere{ Vector3{ -6.1f + static_cast<float>(step) * .5f, 0.f, 0.f }, .5f });
+
+            events.clear();
+            system.Update(events);
+
+            for (const TriggerEvent& event : events)
+            {
+                EXPECT_EQ(trigger, event.trigger);
+                EXPECT_EQ(body, event.body);
+                enters += event.type == TriggerEventType::Enter ? 1 : 0;
+                exits += event.type == TriggerEventType::Exit ? 1 : 0;
+            }
+
+            // Overlapping while the sphere reaches into the box
+            const float x = -6.1f + static_cast<float>(step) * .5f;
+            EXPECT_EQ(x > -2.5f && x < 2.5f, system.Overlaps(trigger, body)) << x;
+        }
+
+        EXPECT_EQ(1, enters);
+        EXPECT_EQ(1, exits);
+    }
+
+    TEST_F(TriggerSystemTests, Update_NothingChanged_NoEventsAndStateKept)
+    {
+        TriggerSystem system;
+        const int trigger = system.AddTrigger(Sphere{ Vector3{ 0.f }, 3.f });
+        const int body = system.AddBody(Aabb{ Vector3{ 1.f, 0.f, 0.f }, Vector3{ .5f } });
+
+        vector<TriggerEvent> events;
+        ASSERT_EQ(1, system.Update(events));
+        EXPECT_EQ(TriggerEventType::Enter, events[0].type);
+
+        events.clear();
+        EXPECT_EQ(0, system.Update(events));
+        EXPECT_TRUE(system.Overlaps(trigger, body));
+        ASSERT_EQ(1u, system.Overlapping(body).size());
+        EXPECT_EQ(trigger, system.Overlapping(body)[0]);
+
+        // Moving within the trigger keeps the pair without a new event
+        system.Move(body, Aabb{ Vector3{ -1.f, 0.f, 0.f }, Vector3{ .5f } });
+        EXPECT_EQ(0, system.Update(events));
+    }
+
+    TEST_F(TriggerSystemTests, Update_BoundsOverlapShapesApart_NoEnter)
+    {
+        TriggerSystem system;
+        const int trigger = system.AddTrigger(Sphere{ Vector3{ 0.f }, 1.f });
+        const int body = system.AddBody(Sphere{ Vector3{ 1.5f, 1.5f, 0.f }, .5f });
+        system.AddBody(Obb{ Vector3{ 0.f, 0.f, 2.3f }, Vector3{ 1.f }, Matrix3::RotationZ(45.f) });
+
+        vector<TriggerEvent> events;
+        EXPECT_EQ(0, system.Update(events));
+        EXPECT_FALSE(system.Overlaps(trigger, body));
+    }
+
+    TEST_F(TriggerSystemTests, Remove_ReportsExitsAndReusesId)
+    {
+        TriggerSystem system;
+        const int trigger = system.AddTrigger(Aabb{ Vector3{ 0.f }, Vector3{ 5.f } });
+        const int first = system.AddBody(Sphere{ Vector3{ 1.f }, 1.f });
+        const int second = system.AddBody(Sphere{ Vector3{ -1.f }, 1.f });
+
+        vector<TriggerEvent> events;
+        EXPECT_EQ(2, system.Update(events));
+
+        events.clear();
+        system.Remove(trigger);
+        system.Remove(trigger);
+        ASSERT_EQ(2, system.Update(events));
+
+        set<int> exited;
+        for (const TriggerEvent& event : events)
+        {
+            EXPECT_EQ(TriggerEventType::Exit, event.type);
+            EXPECT_EQ(trigger, event.trigger);
+            exited.insert(event.body);
+        }
+
+        EXPECT_EQ((set<int>{ first, second }), exited);
+        EXPECT_TRUE(system.Overlapping(first).empty());
+
+        // A body added and removed before an update never reports anything
+        events.clear();
+        system.Remove(system.AddBody(Sphere{ Vector3{ 0.f }, 1.f }));
+        EXPECT_EQ(0, system.Update(events));
+
+        EXPECT_EQ(trigger, system.AddTrigger(Sphere{ Vector3{ 1.f }, .5f }));
+        EXPECT_EQ(1, system.Update(events));
+        EXPECT_EQ(-1, system.AddTrigger(Plane{ Vector3{ 0.f, 1.f, 0.f }, 0.f }));
+    }
+
+    TEST_F(TriggerSystemTests, Update_BothMoved_OneEventPerPair)
+    {
+        TriggerSystem system;
+        const int trigger = system.AddTrigger(Sphere{ Vector3{ 10.f, 0.f, 0.f }, 1.f });
+        const int body = system.AddBody(Sphere{ Vector3{ -10.f, 0.f, 0.f }, 1.f });
+
+        vector<TriggerEvent> events;
+        system.Update(events);
+
+        system.Move(trigger, Sphere{ Vector3{ .5f, 0.f, 0.f }, 1.f });
+        system.Move(body, Sphere{ Vector3{ -.5f, 0.f, 0.f }, 1.f });
+        ASSERT_EQ(1, system.Update(events));
+        EXPECT_EQ(TriggerEventType::Enter, events[0].type);
+
+        events.clear();
+        system.Move(body, Sphere{ Vector3{ -10.f, 0.f, 0.f }, 1.f });
+        system.Move(trigger, Sphere{ Vector3{ 10.f, 0.f, 0.f }, 1.f });
+        ASSERT_EQ(1, system.Update(events));
+        EXPECT_EQ(TriggerEventType::Exit, events[0].type);
+    }
+
+    TEST_F(TriggerSystemTests, Update_RandomMotion_EventsMatchBruteForce)
+    {
+        TriggerSystem system{ Vector3{ 0.f }, 64.f };
+
+        vector<int> triggers;
+        vector<int> bodies;
+        for (unsigned i = 0; i < 60; ++i)
+        {
+            triggers.push_back(system.AddTrigger(MakeVolume(i * 7, ScatterPoint(i + 100, -15.f, 15.f))));
+            bodies.push_back(system.AddBody(MakeVolume(i * 11 + 1, ScatterPoint(i + 900, -15.f, 15.f))));
+        }
+
+        set<pair<int, int>> state;
+        vector<TriggerEvent> events;
+
+        for (unsigned frame = 0; frame < 30; ++frame)
+        {
+            // Move a different handful of each kind every frame, some of them twice
+            for (unsigned i = 0; i < 12; ++i)
+            {
+                const unsigned seed = frame * 97 + i;
+                vector<int>& moved = i % 2 == 0 ? triggers : bodies;
+                const int id = moved[static_cast<int>(Scatter(seed, 0.f, 60.f))];
+
+                system.Move(id, MakeVolume(seed * 13, ScatterPoint(seed + 5000, -15.f, 15.f)));
+            }
+
+            events.clear();
+            const int count = system.Update(events);
+            EXPECT_EQ(static_cast<int>(events.size()), count);
+
+            for (const TriggerEvent& event : events)
+            {
+                const pair<int, int> key{ event.trigger, event.body };
+                if (event.type == TriggerEventType::Enter)
+                {
+                    EXPECT_TRUE(state.insert(key).second);
+                }
+                else
+                {
+                    EXPECT_EQ(1u, state.erase(key));
+                }
+            }
+
+            for (const int trigger : triggers)
+            {
+                for (const int body : bodies)
+                {
+                    const bool expected = system.shapes[trigger].Intersects(system.shapes[body]);
+                    EXPECT_EQ(expected, state.count({ trigger, body }) == 1);
+                    EXPECT_EQ(expected, system.Overlaps(trigger, body));
+                }
+            }
+        }
+
+        EXPECT_FALSE(state.empty());
+    }
+}
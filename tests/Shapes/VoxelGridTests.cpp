@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/AABB.hpp"
+#include "Nudge/Shapes/Interval.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+#include "Nudge/Shapes/VoxelGrid.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class VoxelGridTests : public Test
+    {
+    public:
+        static constexpr float VOXEL_SIZE = .25f;
+
+        vector<Vector3> corners;
+        vector<Triangle> triangles;
+        VoxelGrid grid;
+
+    public:
+        // Scattered triangles of mixed sizes, including some long thin ones
+        void SetUp() override
+        {
+            for (unsigned i = 0; i < 60; ++i)
+            {
+                const Vector3 center = ScatterPoint(i, Vector3{ -4.f, -2.f, 1.f }, Vector3{ 4.f, 3.f, 7.f });
+                const float reach = i % 5 == 0 ? 3.f : .8f;
+
+                const Vector3 a = center + ScatterPoint(i + 100, Vector3{ -reach }, Vector3{ reach });
+                const Vector3 b = center + ScatterPoint(i + 200, Vector3{ -reach }, Vector3{ reach });
+                const Vector3 c = center + ScatterPoint(i + 300, Vector3{ -.5f }, Vector3{ .5f });
+
+                corners.push_back(a);
+                corners.push_back(b);
+                corners.push_back(c);
+                triangles.push_back(Triangle{ a, b, c });
+            }
+
+            grid = VoxelGrid{ triangles, VOXEL_SIZE };
+        }
+
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        // Box of a voxel, grown or shrunk by a fraction of its size
+        Aabb VoxelBox(const int x, const int y, const int z, const float scale = 1.f) const
+        {
+            const Vector3 center = grid.origin + Vector3{ (x + .5f) * VOXEL_SIZE, (y + .5f) * VOXEL_SIZE, (z + .5f) * VOXEL_SIZE };
+
+            return Aabb{ center, Vector3{ VOXEL_SIZE * .5f * scale } };
+        }
+
+        bool TouchesAny(const Aabb& box) const
+        {
+            return std::any_of(triangles.begin(), triangles.end(), [&](const Triangle& triangle)
+            {
+                return Interval::TriangleAabb(triangle, box);
+            });
+        }
+
+        // Nearest occupied voxel entered by a ray, testing every voxel
+        float BruteForceCast(const Ray& ray, const float maxDistance) const
+        {
+            float best = -1.f;
+
+            for (int z = 0; z < grid.size[2]; ++z)
+            {
+                for (int y = 0; y < grid.size[1]; ++y)
+                {
+                    for (int x = 0; x < grid.size[0]; ++x)
+                    {
+                        if (!grid.IsOccupied(x, y, z))
+                        {
+                            continue;
+                        }
+
+                        const float hit = ray.CastAgainst(VoxelBox(x, y, z));
+                        if (hit >= 0.f && hit <= maxDistance && (best < 0.f || hit < best))
+                        {
+                            best = hit;
+                        }
+                    }
+                }
+            }
+
+            return best;
+        }
+
+        float BruteForceTriangleCast(const Ray& ray) const
+        {
+            float best = -1.f;
+
+            for (const Triangle& triangle : triangles)
+            {
+                const float hit = ray.CastAgainst(triangle);
+                if (hit >= 0.f && (best < 0.f || hit < best))
+                {
+                    best = hit;
+                }
+            }
+
+            return best;
+        }
+    };
+
+    TEST_F(VoxelGridTests, Constructor_InvalidInput_IsEmpty)
+    {
+        EXPECT_TRUE(VoxelGrid{}.IsEmpty());
+        EXPECT_TRUE((VoxelGrid{ span<const Triangle>{}, VOXEL_SIZE }.IsEmpty()));
+        EXPECT_TRUE((VoxelGrid{ triangles, 0.f }.IsEmpty()));
+
+        const VoxelGrid empty;
+        EXPECT_FALSE(empty.IsOccupied(Vector3{ 0.f }));
+        EXPECT_FALSE(empty.Overlaps(Aabb{ Vector3{ 0.f }, Vector3{ 100.f } }));
+        EXPECT_EQ(-1.f, empty.CastRay(Ray{ Vector3{ 0.f }, Vector3{ 0.f, 0.f, 1.f } }));
+    }
+
+    TEST_F(VoxelGridTests, Constructor_WholeBricks_CoverEveryTriangle)
+    {
+        ASSERT_FALSE(grid.IsEmpty());
+
+        const Vector3 min = grid.Bounds().Min();
+        const Vector3 max = grid.Bounds().Max();
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            EXPECT_EQ(0, grid.size[axis] % VOXEL_GRID_BRICK_SIZE);
+            EXPECT_EQ(grid.size[axis], grid.bricks[axis] * VOXEL_GRID_BRICK_SIZE);
+        }
+
+        for (const Vector3& corner : corners)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                EXPECT_LT(min[axis], corner[axis]);
+                EXPECT_GT(max[axis], corner[axis]);
+            }
+        }
+    }
+
+    TEST_F(VoxelGridTests, Constructor_EveryTrianglePoint_LiesInOccupiedVoxel)
+    {
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            for (unsigned j = 0; j < 50; ++j)
+            {
+                float u = Scatter(static_cast<unsigned>(i * 50 + j), 0.f, 1.f);
+                float v = Scatter(static_cast<unsigned>(i * 50 + j) + 7919, 0.f, 1.f);
+                if (u + v > 1.f)
+                {
+                    u = 1.f - u;
+                    v = 1.f - v;
+                }
+
+                const Vector3 point = corners[i * 3] + (corners[i * 3 + 1] - corners[i * 3]) * u + (corners[i * 3 + 2] - corners[i * 3]) * v;
+                EXPECT_TRUE(grid.IsOccupied(point)) << "triangle " << i << " sample " << j;
+            }
+
+            EXPECT_TRUE(grid.IsOccupied(corners[i * 3]));
+        }
+    }
+
+    TEST_F(VoxelGridTests, Constructor_Occupancy_MatchesTriangleBoxTests)
+    {
+        int occupied = 0;
+
+        for (int z = 0; z < grid.size[2]; ++z)
+        {
+            for (int y = 0; y < grid.size[1]; ++y)
+            {
+                for (int x = 0; x < grid.size[0]; ++x)
+                {
+                    // The build enlarges voxels slightly, so only compare away from that margin
+                    if (grid.IsOccupied(x, y, z))
+                    {
+                        ++occupied;
+                        EXPECT_TRUE(TouchesAny(VoxelBox(x, y, z, 1.01f))) << x << " " << y << " " << z;
+                    }
+                    else
+                    {
+                        EXPECT_FALSE(TouchesAny(VoxelBox(x, y, z, .99f))) << x << " " << y << " " << z;
+                    }
+                }
+            }
+        }
+
+        EXPECT_EQ(occupied, grid.OccupiedCount());
+        EXPECT_LT(grid.masks.size(), grid.brickIndices.size());
+    }
+
+    TEST_F(VoxelGridTests, Constructor_Mesh_MatchesTriangles)
+    {
+        Mesh mesh;
+        mesh.numTriangles = static_cast<int>(triangles.size());
+        mesh.triangles = triangles.data();
+
+        const VoxelGrid fromMesh{ mesh, VOXEL_SIZE };
+
+        EXPECT_EQ(grid.brickIndices, fromMesh.brickIndices);
+        EXPECT_EQ(grid.masks, fromMesh.masks);
+    }
+
+    TEST_F(VoxelGridTests, CastRay_RandomRays_MatchesVoxelBruteForce)
+    {
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const Vector3 from = ScatterPoint(i, Vector3{ -9.f, -7.f, -4.f }, Vector3{ 9.f, 8.f, 12.f });
+            const Vector3 to = ScatterPoint(i + 1000, Vector3{ -4.f, -2.f, 1.f }, Vector3{ 4.f, 3.f, 7.f });
+            const Ray ray = Ray::FromPoints(from, to);
+
+            const float expected = BruteForceCast(ray, 1000.f);
+            const float actual = grid.CastRay(ray);
+
+            ASSERT_EQ(expected >= 0.f, actual >= 0.f) << "ray " << i;
+            if (expected >= 0.f)
+            {
+                AssertFloatEqual(expected, actual, 0.001f);
+            }
+        }
+    }
+
+    TEST_F(VoxelGridTests, CastRay_RandomRays_NeverPassesATriangle)
+    {
+        for (unsigned i = 0; i < 300; ++i)
+        {
+            const Vector3 from = ScatterPoint(i + 5000, Vector3{ -6.f, -4.f, -1.f }, Vector3{ 6.f, 5.f, 9.f });
+            const Vector3 to = ScatterPoint(i + 6000, Vector3{ -4.f, -2.f, 1.f }, Vector3{ 4.f, 3.f, 7.f });
+            const Ray ray = Ray::FromPoints(from, to);
+
+            const float exact = BruteForceTriangleCast(ray);
+            const float coarse = grid.CastRay(ray);
+
+            if (exact >= 0.f)
+            {
+                ASSERT_GE(coarse, 0.f) << "ray " << i;
+                EXPECT_LE(coarse, exact + 0.0001f) << "ray " << i;
+            }
+        }
+    }
+
+    TEST_F(VoxelGridTests, CastRay_MaxDistance_IgnoresFartherVoxels)
+    {
+        const Ray ray = Ray::FromPoints(Vector3{ -9.f, 0.f, 4.f }, Vector3{ 0.f, 0.f, 4.f });
+        const float hit = grid.CastRay(ray);
+        ASSERT_GT(hit, 0.f);
+
+        EXPECT_EQ(-1.f, grid.CastRay(ray, hit * .5f));
+        AssertFloatEqual(hit, grid.CastRay(ray, hit + .01f));
+    }
+
+    TEST_F(VoxelGridTests, CountOccupied_Regions_MatchesVoxelBruteForce)
+    {
+        for (unsigned i = 0; i < 100; ++i)
+        {
+            const Vector3 center = ScatterPoint(i, Vector3{ -6.f, -4.f, -1.f }, Vector3{ 6.f, 5.f, 9.f });
+            const Vector3 extents = ScatterPoint(i + 500, Vector3{ .05f }, Vector3{ 1.5f });
+            const Aabb region{ center, extents };
+
+            const Vector3 min = region.Min() - grid.origin;
+            const Vector3 max = region.Max() - grid.origin;
+            int expected = 0;
+
+            for (int z = static_cast<int>(std::floor(min.z / VOXEL_SIZE)); z <= static_cast<int>(std::floor(max.z / VOXEL_SIZE)); ++z)
+            {
+                for (int y = static_cast<int>(std::floor(min.y / VOXEL_SIZE)); y <= static_cast<int>(std::floor(max.y / VOXEL_SIZE)); ++y)
+                {
+                    for (int x = static_cast<int>(std::floor(min.x / VOXEL_SIZE)); x <= static_cast<int>(std::floor(max.x / VOXEL_SIZE)); ++x)
+                    {
+                        expected += grid.IsOccupied(x, y, z) ? 1 : 0;
+                    }
+                }
+            }
+
+            EXPECT_EQ(expected, grid.CountOccupied(region)) << "region " << i;
+            EXPECT_EQ(expected > 0, grid.Overlaps(region)) << "region " << i;
+        }
+    }
+
+    TEST_F(VoxelGridTests, Overlaps_OutsideGrid_ReturnsFalse)
+    {
+        EXPECT_FALSE(grid.Overlaps(Aabb{ Vector3{ 50.f, 0.f, 0.f }, Vector3{ 1.f } }));
+        EXPECT_EQ(0, grid.CountOccupied(Aabb{ Vector3{ 0.f, -50.f, 0.f }, Vector3{ 1.f } }));
+        EXPECT_TRUE(grid.Overlaps(grid.Bounds()));
+        EXPECT_EQ(grid.OccupiedCount(), grid.CountOccupied(grid.Bounds()));
+    }
+
+    TEST_F(VoxelGridTests, ByteSize_SmallerThanDenseBitmask)
+    {
+        const size_t voxels = static_cast<size_t>(grid.size[0]) * grid.size[1] * grid.size[2];
+
+        EXPECT_EQ(grid.brickIndices.size() * sizeof(int) + grid.masks.size() * sizeof(uint64_t), grid.ByteSize());
+        EXPECT_LT(grid.ByteSize(), voxels);
+    }
+}
@@ -0,0 +1,184 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Nudge/Maths/MathF.hpp"
+#include "Nudge/Shapes/LinearBvh.hpp"
+#include "Nudge/Shapes/Mesh.hpp"
+#include "Nudge/Shapes/Ray.hpp"
+#include "Nudge/Shapes/Triangle.hpp"
+#include "Nudge/Shapes/WideBvh.hpp"
+
+#include "TestHelpers.hpp"
+
+using std::vector;
+
+using testing::Test;
+
+namespace Nudge
+{
+    class WideBvhTests : public Test
+    {
+    public:
+        // Helper method for floating point comparison
+        static void AssertFloatEqual(const float expected, const float actual, const float tolerance = 0.0001f)
+        {
+            EXPECT_TRUE(MathF::Compare(expected, actual, tolerance));
+        }
+
+        static bool Encloses(const Aabb& outer, const Vector3& point)
+        {
+            const Vector3 min = outer.Min();
+            const Vector3 max = outer.Max();
+
+            return point.x >= min.x && point.x <= max.x &&
+                   point.y >= min.y && point.y <= max.y &&
+                   point.z >= min.z && point.z <= max.z;
+        }
+
+        // Checks that every vertex below each slot lies inside that slot's decoded bounds
+        static void AssertEnclosesSubtree(const WideBvh& bvh, const Mesh& mesh, const Aabb& bounds, const int node, vector<int>& seen)
+        {
+            const WideBvhNode& wide = bvh.nodes[node];
+
+            for (int slot = 0; slot < WIDE_BVH_WIDTH; ++slot)
+            {
+                if (wide.IsEmpty(slot))
+                {
+                    continue;
+                }
+
+                const Aabb child = wide.ChildBounds(slot);
+
+                if (!wide.IsLeaf(slot))
+                {
+                    AssertEnclosesSubtree(bvh, mesh, child, wide.child[slot], seen);
+                    continue;
+                }
+
+                for (int i = wide.child[slot]; i < wide.child[slot] + wide.count[slot]; ++i)
+                {
+                    const Triangle& t = mesh.triangles[bvh.indices[i]];
+                    seen[bvh.indices[i]]++;
+
+                    for (const Vector3& vertex : { t.a, t.b, t.c })
+                    {
+                        EXPECT_TRUE(Encloses(child, vertex));
+                        EXPECT_TRUE(Encloses(bounds, vertex));
+                    }
+                }
+            }
+        }
+    };
+
+    TEST_F(WideBvhTests, Collapse_Empty_LeavesHierarchyEmpty)
+    {
+        LinearBvh binary;
+        WideBvh bvh;
+        bvh.Collapse(binary);
+
+        EXPECT_TRUE(bvh.IsEmpty());
+    }
+
+    TEST_F(WideBvhTests, Collapse_SmallMesh_CreatesSingleLeafSlot)
+    {
+        vector<Triangle> triangles = MakeLayers(1, { 0.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Wide);
+
+        ASSERT_EQ(1u, mesh.wideHierarchy->nodes.size());
+        EXPECT_TRUE(mesh.wideHierarchy->nodes[0].IsLeaf(0));
+        EXPECT_EQ(2, mesh.wideHierarchy->nodes[0].count[0]);
+        EXPECT_TRUE(mesh.wideHierarchy->nodes[0].IsEmpty(1));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(WideBvhTests, Collapse_Grid_ChildBoundsEncloseTriangles)
+    {
+        vector<Triangle> triangles = MakeLayers(24, { 0.f, 1.5f, 7.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Wide);
+
+        ASSERT_NE(nullptr, mesh.wideHierarchy);
+        EXPECT_EQ(nullptr, mesh.hierarchy);
+
+        vector<int> seen(mesh.numTriangles, 0);
+        const WideBvhNode& root = mesh.wideHierarchy->nodes[0];
+        const Aabb rootBounds = Aabb::FromMinMax(root.origin, root.origin + root.scale * 255.f);
+        AssertEnclosesSubtree(*mesh.wideHierarchy, mesh, rootBounds, 0, seen);
+
+        for (const int references : seen)
+        {
+            EXPECT_EQ(1, references);
+        }
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(WideBvhTests, Collapse_Grid_UsesLessMemoryThanBinary)
+    {
+        vector<Triangle> triangles = MakeLayers(24, { 0.f, 1.5f, 7.f });
+        Mesh mesh = MakeMesh(triangles);
+
+        mesh.Accelerate(BvhBuildMode::Morton);
+        const size_t binaryBytes = mesh.hierarchy->nodes.size() * sizeof(LinearBvhNode);
+
+        mesh.Rebuild(BvhBuildMode::Wide);
+        const size_t wideBytes = mesh.wideHierarchy->nodes.size() * sizeof(WideBvhNode);
+
+        EXPECT_EQ(nullptr, mesh.hierarchy);
+        EXPECT_LT(wideBytes * 2, binaryBytes);
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(WideBvhTests, CastAgainstMesh_Wide_ReturnsNearestLayer)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 0.f, 2.f, 4.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Wide);
+
+        const Ray ray{ Vector3{ 5.3f, 10.f, 7.6f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        AssertFloatEqual(6.f, ray.CastAgainst(mesh));
+
+        mesh.ReleaseAccelerator();
+    }
+
+    TEST_F(WideBvhTests, CastAgainstMesh_Wide_MatchesBruteForce)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 0.f, 1.5f, 3.f });
+        Mesh bruteForce = MakeMesh(triangles);
+        Mesh accelerated = MakeMesh(triangles);
+        accelerated.Accelerate(BvhBuildMode::Wide);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            for (int j = 0; j < 20; ++j)
+            {
+                const Vector3 origin{ -2.f + static_cast<float>(i), 8.f, -2.f + static_cast<float>(j) };
+                const Vector3 target{ 0.37f + 0.8f * static_cast<float>(j), 0.f, 0.61f + 0.8f * static_cast<float>(i) };
+                const Ray ray = Ray::FromPoints(origin, target);
+
+                AssertFloatEqual(ray.CastAgainst(bruteForce), ray.CastAgainst(accelerated));
+            }
+        }
+
+        accelerated.ReleaseAccelerator();
+    }
+
+    TEST_F(WideBvhTests, CastAgainstMesh_AxisAlignedRayOnNodePlane_HitsTriangle)
+    {
+        vector<Triangle> triangles = MakeLayers(16, { 0.f });
+        Mesh mesh = MakeMesh(triangles);
+        mesh.Accelerate(BvhBuildMode::Wide);
+
+        // Straight down along a grid line shared by several leaves
+        const Ray ray{ Vector3{ 8.f, 5.f, 8.f }, Vector3{ 0.f, -1.f, 0.f } };
+
+        AssertFloatEqual(5.f, ray.CastAgainst(mesh));
+
+        mesh.ReleaseAccelerator();
+    }
+}